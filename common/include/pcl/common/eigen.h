@@ -81,6 +81,14 @@ namespace pcl
   template <typename Matrix, typename Roots> void
   computeRoots (const Matrix &m, Roots &roots);
 
+  /** \brief computes the smallest root of the characteristic polynomial of the input matrix m, which is its
+    * smallest eigenvalue, without the trigonometric functions needed by \ref computeRoots for all three roots
+    * \param[in] m symmetric positive semi definite input matrix
+    * \return the smallest eigenvalue of m
+    */
+  template <typename Matrix> typename Matrix::Scalar
+  computeSmallestRoot (const Matrix &m);
+
   /** \brief determine the smallest eigenvalue and its corresponding eigenvector
     * \param[in] mat input matrix that needs to be symmetric and positive semi definite
     * \param[out] eigenvalue the smallest eigenvalue of the input matrix
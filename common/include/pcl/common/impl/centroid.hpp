@@ -44,6 +44,289 @@
 #include <pcl/common/centroid.h>
 #include <pcl/conversions.h>
 #include <boost/mpl/size.hpp>
+#include <algorithm>
+
+#if defined (__AVX__)
+#include <immintrin.h>
+#elif defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace pcl
+{
+  namespace detail
+  {
+    /* Below are the helpers shared by the covariance matrix estimation functions. They add the first and
+     * second order moments of the points [begin, end) of a cloud (or of the points indices[begin, end),
+     * if indices is not NULL), taken relative to a shift point, to a buffer laid out as
+     *
+     *   accu = [xx, xy, xz, yy, yz, zz, x, y, z]
+     *
+     * and return the number of points used. Unless the cloud is dense, points with a non finite
+     * coordinate are skipped. For float, blocks of 4 (SSE2) or 8 (AVX) points are gathered and
+     * transposed to a SoA layout, so every moment is accumulated for a whole block at once. The
+     * remaining points go through the scalar path. */
+
+    template <typename PointT, typename Scalar> inline unsigned int
+    accumulateMomentsStandard (const pcl::PointCloud<PointT> &cloud, const int *indices,
+                               size_t i, size_t end, const Scalar shift[3], Scalar accu[9])
+    {
+      unsigned int point_count = 0;
+      for (; i < end; ++i)
+      {
+        const PointT &point = cloud[indices ? static_cast<size_t> (indices[i]) : i];
+        if (!cloud.is_dense && !isFinite (point))
+          continue;
+
+        const Scalar x = static_cast<Scalar> (point.x) - shift[0];
+        const Scalar y = static_cast<Scalar> (point.y) - shift[1];
+        const Scalar z = static_cast<Scalar> (point.z) - shift[2];
+        accu[0] += x * x;
+        accu[1] += x * y;
+        accu[2] += x * z;
+        accu[3] += y * y;
+        accu[4] += y * z;
+        accu[5] += z * z;
+        accu[6] += x;
+        accu[7] += y;
+        accu[8] += z;
+        ++point_count;
+      }
+      return (point_count);
+    }
+
+#if defined (__SSE2__)
+    /** \brief Load the coordinates of 4 points as a SoA (structure of arrays) block. */
+    template <typename PointT> inline void
+    loadMomentPoints4 (const pcl::PointCloud<PointT> &cloud, const int *indices, size_t i,
+                       __m128 &x, __m128 &y, __m128 &z)
+    {
+      __m128 p0, p1, p2, p3;
+      if (indices)
+      {
+        p0 = _mm_loadu_ps (cloud[indices[i    ]].data);
+        p1 = _mm_loadu_ps (cloud[indices[i + 1]].data);
+        p2 = _mm_loadu_ps (cloud[indices[i + 2]].data);
+        p3 = _mm_loadu_ps (cloud[indices[i + 3]].data);
+      }
+      else
+      {
+        p0 = _mm_loadu_ps (cloud[i    ].data);
+        p1 = _mm_loadu_ps (cloud[i + 1].data);
+        p2 = _mm_loadu_ps (cloud[i + 2].data);
+        p3 = _mm_loadu_ps (cloud[i + 3].data);
+      }
+      _MM_TRANSPOSE4_PS (p0, p1, p2, p3);
+      x = p0;
+      y = p1;
+      z = p2;
+    }
+
+    /** \brief Sum the 4 lanes of v, in lane order. */
+    inline float
+    sumLanes (__m128 v)
+    {
+      EIGEN_ALIGN16 float lanes[4];
+      _mm_store_ps (lanes, v);
+      return (lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    }
+
+    template <typename PointT> inline unsigned int
+    accumulateMomentsSSE (const pcl::PointCloud<PointT> &cloud, const int *indices,
+                          size_t i, size_t end, const float shift[3], float accu[9])
+    {
+      const __m128 shift_x = _mm_set1_ps (shift[0]);
+      const __m128 shift_y = _mm_set1_ps (shift[1]);
+      const __m128 shift_z = _mm_set1_ps (shift[2]);
+      const __m128 zero = _mm_setzero_ps ();
+      __m128 xx = zero, xy = zero, xz = zero, yy = zero, yz = zero, zz = zero;
+      __m128 sx = zero, sy = zero, sz = zero;
+      // Every lane of the validity mask is either 0 or -1, so subtracting it counts the valid points per lane
+      __m128i counts = _mm_setzero_si128 ();
+      unsigned int point_count = 0;
+
+      for (; i + 4 <= end; i += 4)
+      {
+        __m128 x, y, z;
+        loadMomentPoints4 (cloud, indices, i, x, y, z);
+        x = _mm_sub_ps (x, shift_x);
+        y = _mm_sub_ps (y, shift_y);
+        z = _mm_sub_ps (z, shift_z);
+        if (cloud.is_dense)
+          point_count += 4;
+        else
+        {
+          // v - v is 0 for a finite v, NaN otherwise
+          const __m128 valid = _mm_and_ps (_mm_and_ps (_mm_cmpeq_ps (_mm_sub_ps (x, x), zero),
+                                                       _mm_cmpeq_ps (_mm_sub_ps (y, y), zero)),
+                                           _mm_cmpeq_ps (_mm_sub_ps (z, z), zero));
+          x = _mm_and_ps (x, valid);
+          y = _mm_and_ps (y, valid);
+          z = _mm_and_ps (z, valid);
+          counts = _mm_sub_epi32 (counts, _mm_castps_si128 (valid));
+        }
+        xx = _mm_add_ps (xx, _mm_mul_ps (x, x));
+        xy = _mm_add_ps (xy, _mm_mul_ps (x, y));
+        xz = _mm_add_ps (xz, _mm_mul_ps (x, z));
+        yy = _mm_add_ps (yy, _mm_mul_ps (y, y));
+        yz = _mm_add_ps (yz, _mm_mul_ps (y, z));
+        zz = _mm_add_ps (zz, _mm_mul_ps (z, z));
+        sx = _mm_add_ps (sx, x);
+        sy = _mm_add_ps (sy, y);
+        sz = _mm_add_ps (sz, z);
+      }
+
+      accu[0] += sumLanes (xx);
+      accu[1] += sumLanes (xy);
+      accu[2] += sumLanes (xz);
+      accu[3] += sumLanes (yy);
+      accu[4] += sumLanes (yz);
+      accu[5] += sumLanes (zz);
+      accu[6] += sumLanes (sx);
+      accu[7] += sumLanes (sy);
+      accu[8] += sumLanes (sz);
+      EIGEN_ALIGN16 int lane_counts[4];
+      _mm_store_si128 (reinterpret_cast<__m128i*> (lane_counts), counts);
+      point_count += lane_counts[0] + lane_counts[1] + lane_counts[2] + lane_counts[3];
+      return (point_count + accumulateMomentsStandard (cloud, indices, i, end, shift, accu));
+    }
+#endif
+
+#if defined (__AVX__)
+    /** \brief Sum the 8 lanes of v. */
+    inline float
+    sumLanes (__m256 v)
+    {
+      return (sumLanes (_mm_add_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1))));
+    }
+
+    template <typename PointT> inline unsigned int
+    accumulateMomentsAVX (const pcl::PointCloud<PointT> &cloud, const int *indices,
+                          size_t i, size_t end, const float shift[3], float accu[9])
+    {
+      const __m256 shift_x = _mm256_set1_ps (shift[0]);
+      const __m256 shift_y = _mm256_set1_ps (shift[1]);
+      const __m256 shift_z = _mm256_set1_ps (shift[2]);
+      const __m256 zero = _mm256_setzero_ps ();
+      __m256 xx = zero, xy = zero, xz = zero, yy = zero, yz = zero, zz = zero;
+      __m256 sx = zero, sy = zero, sz = zero;
+      // AVX has no 256 bit integer arithmetic, so the two halves of the mask are counted separately
+      __m128i counts = _mm_setzero_si128 ();
+      unsigned int point_count = 0;
+
+      for (; i + 8 <= end; i += 8)
+      {
+        __m128 x0, y0, z0, x1, y1, z1;
+        loadMomentPoints4 (cloud, indices, i, x0, y0, z0);
+        loadMomentPoints4 (cloud, indices, i + 4, x1, y1, z1);
+        __m256 x = _mm256_sub_ps (_mm256_insertf128_ps (_mm256_castps128_ps256 (x0), x1, 1), shift_x);
+        __m256 y = _mm256_sub_ps (_mm256_insertf128_ps (_mm256_castps128_ps256 (y0), y1, 1), shift_y);
+        __m256 z = _mm256_sub_ps (_mm256_insertf128_ps (_mm256_castps128_ps256 (z0), z1, 1), shift_z);
+        if (cloud.is_dense)
+          point_count += 8;
+        else
+        {
+          const __m256 valid = _mm256_and_ps (_mm256_and_ps (_mm256_cmp_ps (_mm256_sub_ps (x, x), zero, _CMP_EQ_OQ),
+                                                             _mm256_cmp_ps (_mm256_sub_ps (y, y), zero, _CMP_EQ_OQ)),
+                                              _mm256_cmp_ps (_mm256_sub_ps (z, z), zero, _CMP_EQ_OQ));
+          x = _mm256_and_ps (x, valid);
+          y = _mm256_and_ps (y, valid);
+          z = _mm256_and_ps (z, valid);
+          counts = _mm_sub_epi32 (counts, _mm_castps_si128 (_mm256_castps256_ps128 (valid)));
+          counts = _mm_sub_epi32 (counts, _mm_castps_si128 (_mm256_extractf128_ps (valid, 1)));
+        }
+        xx = _mm256_add_ps (xx, _mm256_mul_ps (x, x));
+        xy = _mm256_add_ps (xy, _mm256_mul_ps (x, y));
+        xz = _mm256_add_ps (xz, _mm256_mul_ps (x, z));
+        yy = _mm256_add_ps (yy, _mm256_mul_ps (y, y));
+        yz = _mm256_add_ps (yz, _mm256_mul_ps (y, z));
+        zz = _mm256_add_ps (zz, _mm256_mul_ps (z, z));
+        sx = _mm256_add_ps (sx, x);
+        sy = _mm256_add_ps (sy, y);
+        sz = _mm256_add_ps (sz, z);
+      }
+
+      accu[0] += sumLanes (xx);
+      accu[1] += sumLanes (xy);
+      accu[2] += sumLanes (xz);
+      accu[3] += sumLanes (yy);
+      accu[4] += sumLanes (yz);
+      accu[5] += sumLanes (zz);
+      accu[6] += sumLanes (sx);
+      accu[7] += sumLanes (sy);
+      accu[8] += sumLanes (sz);
+      EIGEN_ALIGN16 int lane_counts[4];
+      _mm_store_si128 (reinterpret_cast<__m128i*> (lane_counts), counts);
+      point_count += lane_counts[0] + lane_counts[1] + lane_counts[2] + lane_counts[3];
+      return (point_count + accumulateMomentsSSE (cloud, indices, i, end, shift, accu));
+    }
+#endif
+
+    template <typename PointT, typename Scalar> inline unsigned int
+    accumulateMoments (const pcl::PointCloud<PointT> &cloud, const int *indices, size_t size,
+                       const Scalar shift[3], Scalar accu[9])
+    {
+      std::fill (accu, accu + 9, Scalar (0));
+      return (accumulateMomentsStandard (cloud, indices, 0, size, shift, accu));
+    }
+
+    template <typename PointT> inline unsigned int
+    accumulateMoments (const pcl::PointCloud<PointT> &cloud, const int *indices, size_t size,
+                       const float shift[3], float accu[9])
+    {
+      std::fill (accu, accu + 9, 0.0f);
+#if defined (__AVX__)
+      return (accumulateMomentsAVX (cloud, indices, 0, size, shift, accu));
+#elif defined (__SSE2__)
+      return (accumulateMomentsSSE (cloud, indices, 0, size, shift, accu));
+#else
+      return (accumulateMomentsStandard (cloud, indices, 0, size, shift, accu));
+#endif
+    }
+
+    /** \brief Compute the centroid and the normalized covariance matrix of the points from their moments
+      * relative to the first valid point. Accumulating relative to a point of the set instead of the origin
+      * keeps the single pass accurate in float when the points are far from the origin.
+      */
+    template <typename PointT, typename Scalar> inline unsigned int
+    computeMeanAndCovariance (const pcl::PointCloud<PointT> &cloud, const int *indices, size_t size,
+                              Eigen::Matrix<Scalar, 3, 3> &covariance_matrix,
+                              Eigen::Matrix<Scalar, 4, 1> &centroid)
+    {
+      size_t first = 0;
+      if (!cloud.is_dense)
+        while (first < size && !isFinite (cloud[indices ? static_cast<size_t> (indices[first]) : first]))
+          ++first;
+      if (first == size)
+        return (0);
+
+      const PointT &origin = cloud[indices ? static_cast<size_t> (indices[first]) : first];
+      const Scalar shift[3] = { static_cast<Scalar> (origin.x), static_cast<Scalar> (origin.y), static_cast<Scalar> (origin.z) };
+      Scalar accu[9];
+      const unsigned int point_count = accumulateMoments (cloud, indices, size, shift, accu);
+      if (point_count == 0)
+        return (0);
+
+      const Scalar inv_count = Scalar (1) / static_cast<Scalar> (point_count);
+      for (int k = 0; k < 9; ++k)
+        accu[k] *= inv_count;
+      centroid[0] = shift[0] + accu[6];
+      centroid[1] = shift[1] + accu[7];
+      centroid[2] = shift[2] + accu[8];
+      centroid[3] = 1;
+      covariance_matrix.coeffRef (0) = accu [0] - accu [6] * accu [6];
+      covariance_matrix.coeffRef (1) = accu [1] - accu [6] * accu [7];
+      covariance_matrix.coeffRef (2) = accu [2] - accu [6] * accu [8];
+      covariance_matrix.coeffRef (4) = accu [3] - accu [7] * accu [7];
+      covariance_matrix.coeffRef (5) = accu [4] - accu [7] * accu [8];
+      covariance_matrix.coeffRef (8) = accu [5] - accu [8] * accu [8];
+      covariance_matrix.coeffRef (3) = covariance_matrix.coeff (1);
+      covariance_matrix.coeffRef (6) = covariance_matrix.coeff (2);
+      covariance_matrix.coeffRef (7) = covariance_matrix.coeff (5);
+      return (point_count);
+    }
+  }
+}
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename Scalar> inline unsigned int
@@ -185,65 +468,16 @@ pcl::computeCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
   if (cloud.empty ())
     return (0);
 
-  // Initialize to 0
-  covariance_matrix.setZero ();
-
-  unsigned point_count;
-  // If the data is dense, we don't need to check for NaN
-  if (cloud.is_dense)
-  {
-    point_count = static_cast<unsigned> (cloud.size ());
-    // For each point in the cloud
-    for (size_t i = 0; i < point_count; ++i)
-    {
-      Eigen::Matrix<Scalar, 4, 1> pt;
-      pt[0] = cloud[i].x - centroid[0];
-      pt[1] = cloud[i].y - centroid[1];
-      pt[2] = cloud[i].z - centroid[2];
-
-      covariance_matrix (1, 1) += pt.y () * pt.y ();
-      covariance_matrix (1, 2) += pt.y () * pt.z ();
-
-      covariance_matrix (2, 2) += pt.z () * pt.z ();
-
-      pt *= pt.x ();
-      covariance_matrix (0, 0) += pt.x ();
-      covariance_matrix (0, 1) += pt.y ();
-      covariance_matrix (0, 2) += pt.z ();
-    }
-  }
-  // NaN or Inf values could exist => check for them
-  else
-  {
-    point_count = 0;
-    // For each point in the cloud
-    for (size_t i = 0; i < cloud.size (); ++i)
-    {
-      // Check if the point is invalid
-      if (!isFinite (cloud [i]))
-        continue;
-
-      Eigen::Matrix<Scalar, 4, 1> pt;
-      pt[0] = cloud[i].x - centroid[0];
-      pt[1] = cloud[i].y - centroid[1];
-      pt[2] = cloud[i].z - centroid[2];
-
-      covariance_matrix (1, 1) += pt.y () * pt.y ();
-      covariance_matrix (1, 2) += pt.y () * pt.z ();
-
-      covariance_matrix (2, 2) += pt.z () * pt.z ();
-
-      pt *= pt.x ();
-      covariance_matrix (0, 0) += pt.x ();
-      covariance_matrix (0, 1) += pt.y ();
-      covariance_matrix (0, 2) += pt.z ();
-      ++point_count;
-    }
-  }
-  covariance_matrix (1, 0) = covariance_matrix (0, 1);
-  covariance_matrix (2, 0) = covariance_matrix (0, 2);
-  covariance_matrix (2, 1) = covariance_matrix (1, 2);
+  const Scalar shift[3] = { centroid[0], centroid[1], centroid[2] };
+  Scalar accu[9];
+  unsigned point_count = detail::accumulateMoments (cloud, static_cast<const int*> (NULL), cloud.size (), shift, accu);
 
+  covariance_matrix.coeffRef (0) = accu [0];
+  covariance_matrix.coeffRef (1) = covariance_matrix.coeffRef (3) = accu [1];
+  covariance_matrix.coeffRef (2) = covariance_matrix.coeffRef (6) = accu [2];
+  covariance_matrix.coeffRef (4) = accu [3];
+  covariance_matrix.coeffRef (5) = covariance_matrix.coeffRef (7) = accu [4];
+  covariance_matrix.coeffRef (8) = accu [5];
   return (point_count);
 }
 
@@ -269,65 +503,17 @@ pcl::computeCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
   if (indices.empty ())
     return (0);
 
-  // Initialize to 0
-  covariance_matrix.setZero ();
-
-  size_t point_count;
-  // If the data is dense, we don't need to check for NaN
-  if (cloud.is_dense)
-  {
-    point_count = indices.size ();
-    // For each point in the cloud
-    for (size_t i = 0; i < point_count; ++i)
-    {
-      Eigen::Matrix<Scalar, 4, 1> pt;
-      pt[0] = cloud[indices[i]].x - centroid[0];
-      pt[1] = cloud[indices[i]].y - centroid[1];
-      pt[2] = cloud[indices[i]].z - centroid[2];
-
-      covariance_matrix (1, 1) += pt.y () * pt.y ();
-      covariance_matrix (1, 2) += pt.y () * pt.z ();
-
-      covariance_matrix (2, 2) += pt.z () * pt.z ();
-
-      pt *= pt.x ();
-      covariance_matrix (0, 0) += pt.x ();
-      covariance_matrix (0, 1) += pt.y ();
-      covariance_matrix (0, 2) += pt.z ();
-    }
-  }
-  // NaN or Inf values could exist => check for them
-  else
-  {
-    point_count = 0;
-    // For each point in the cloud
-    for (size_t i = 0; i < indices.size (); ++i)
-    {
-      // Check if the point is invalid
-      if (!isFinite (cloud[indices[i]]))
-        continue;
-
-      Eigen::Matrix<Scalar, 4, 1> pt;
-      pt[0] = cloud[indices[i]].x - centroid[0];
-      pt[1] = cloud[indices[i]].y - centroid[1];
-      pt[2] = cloud[indices[i]].z - centroid[2];
-
-      covariance_matrix (1, 1) += pt.y () * pt.y ();
-      covariance_matrix (1, 2) += pt.y () * pt.z ();
+  const Scalar shift[3] = { centroid[0], centroid[1], centroid[2] };
+  Scalar accu[9];
+  unsigned int point_count = detail::accumulateMoments (cloud, &indices[0], indices.size (), shift, accu);
 
-      covariance_matrix (2, 2) += pt.z () * pt.z ();
-
-      pt *= pt.x ();
-      covariance_matrix (0, 0) += pt.x ();
-      covariance_matrix (0, 1) += pt.y ();
-      covariance_matrix (0, 2) += pt.z ();
-      ++point_count;
-    }
-  }
-  covariance_matrix (1, 0) = covariance_matrix (0, 1);
-  covariance_matrix (2, 0) = covariance_matrix (0, 2);
-  covariance_matrix (2, 1) = covariance_matrix (1, 2);
-  return (static_cast<unsigned int> (point_count));
+  covariance_matrix.coeffRef (0) = accu [0];
+  covariance_matrix.coeffRef (1) = covariance_matrix.coeffRef (3) = accu [1];
+  covariance_matrix.coeffRef (2) = covariance_matrix.coeffRef (6) = accu [2];
+  covariance_matrix.coeffRef (4) = accu [3];
+  covariance_matrix.coeffRef (5) = covariance_matrix.coeffRef (7) = accu [4];
+  covariance_matrix.coeffRef (8) = accu [5];
+  return (point_count);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -373,45 +559,14 @@ template <typename PointT, typename Scalar> inline unsigned int
 pcl::computeCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
                               Eigen::Matrix<Scalar, 3, 3> &covariance_matrix)
 {
-  // create the buffer on the stack which is much faster than using cloud[indices[i]] and centroid as a buffer
-  Eigen::Matrix<Scalar, 1, 6, Eigen::RowMajor> accu = Eigen::Matrix<Scalar, 1, 6, Eigen::RowMajor>::Zero ();
-
-  unsigned int point_count;
-  if (cloud.is_dense)
-  {
-    point_count = static_cast<unsigned int> (cloud.size ());
-    // For each point in the cloud
-    for (size_t i = 0; i < point_count; ++i)
-    {
-      accu [0] += cloud[i].x * cloud[i].x;
-      accu [1] += cloud[i].x * cloud[i].y;
-      accu [2] += cloud[i].x * cloud[i].z;
-      accu [3] += cloud[i].y * cloud[i].y;
-      accu [4] += cloud[i].y * cloud[i].z;
-      accu [5] += cloud[i].z * cloud[i].z;
-    }
-  }
-  else
-  {
-    point_count = 0;
-    for (size_t i = 0; i < cloud.size (); ++i)
-    {
-      if (!isFinite (cloud[i]))
-        continue;
-
-      accu [0] += cloud[i].x * cloud[i].x;
-      accu [1] += cloud[i].x * cloud[i].y;
-      accu [2] += cloud[i].x * cloud[i].z;
-      accu [3] += cloud[i].y * cloud[i].y;
-      accu [4] += cloud[i].y * cloud[i].z;
-      accu [5] += cloud[i].z * cloud[i].z;
-      ++point_count;
-    }
-  }
-
+  // The second order moments are taken about the origin
+  const Scalar shift[3] = { 0, 0, 0 };
+  Scalar accu[9];
+  unsigned int point_count = detail::accumulateMoments (cloud, static_cast<const int*> (NULL), cloud.size (), shift, accu);
   if (point_count != 0)
   {
-    accu /= static_cast<Scalar> (point_count);
+    for (int k = 0; k < 6; ++k)
+      accu[k] /= static_cast<Scalar> (point_count);
     covariance_matrix.coeffRef (0) = accu [0];
     covariance_matrix.coeffRef (1) = covariance_matrix.coeffRef (3) = accu [1];
     covariance_matrix.coeffRef (2) = covariance_matrix.coeffRef (6) = accu [2];
@@ -428,44 +583,17 @@ pcl::computeCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
                               const std::vector<int> &indices,
                               Eigen::Matrix<Scalar, 3, 3> &covariance_matrix)
 {
-  // create the buffer on the stack which is much faster than using cloud[indices[i]] and centroid as a buffer
-  Eigen::Matrix<Scalar, 1, 6, Eigen::RowMajor> accu = Eigen::Matrix<Scalar, 1, 6, Eigen::RowMajor>::Zero ();
-
-  unsigned int point_count;
-  if (cloud.is_dense)
-  {
-    point_count = static_cast<unsigned int> (indices.size ());
-    for (std::vector<int>::const_iterator iIt = indices.begin (); iIt != indices.end (); ++iIt)
-    {
-      //const PointT& point = cloud[*iIt];
-      accu [0] += cloud[*iIt].x * cloud[*iIt].x;
-      accu [1] += cloud[*iIt].x * cloud[*iIt].y;
-      accu [2] += cloud[*iIt].x * cloud[*iIt].z;
-      accu [3] += cloud[*iIt].y * cloud[*iIt].y;
-      accu [4] += cloud[*iIt].y * cloud[*iIt].z;
-      accu [5] += cloud[*iIt].z * cloud[*iIt].z;
-    }
-  }
-  else
-  {
-    point_count = 0;
-    for (std::vector<int>::const_iterator iIt = indices.begin (); iIt != indices.end (); ++iIt)
-    {
-      if (!isFinite (cloud[*iIt]))
-        continue;
+  if (indices.empty ())
+    return (0);
 
-      ++point_count;
-      accu [0] += cloud[*iIt].x * cloud[*iIt].x;
-      accu [1] += cloud[*iIt].x * cloud[*iIt].y;
-      accu [2] += cloud[*iIt].x * cloud[*iIt].z;
-      accu [3] += cloud[*iIt].y * cloud[*iIt].y;
-      accu [4] += cloud[*iIt].y * cloud[*iIt].z;
-      accu [5] += cloud[*iIt].z * cloud[*iIt].z;
-    }
-  }
+  // The second order moments are taken about the origin
+  const Scalar shift[3] = { 0, 0, 0 };
+  Scalar accu[9];
+  unsigned int point_count = detail::accumulateMoments (cloud, &indices[0], indices.size (), shift, accu);
   if (point_count != 0)
   {
-    accu /= static_cast<Scalar> (point_count);
+    for (int k = 0; k < 6; ++k)
+      accu[k] /= static_cast<Scalar> (point_count);
     covariance_matrix.coeffRef (0) = accu [0];
     covariance_matrix.coeffRef (1) = covariance_matrix.coeffRef (3) = accu [1];
     covariance_matrix.coeffRef (2) = covariance_matrix.coeffRef (6) = accu [2];
@@ -491,63 +619,7 @@ pcl::computeMeanAndCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
                                      Eigen::Matrix<Scalar, 3, 3> &covariance_matrix,
                                      Eigen::Matrix<Scalar, 4, 1> &centroid)
 {
-  // create the buffer on the stack which is much faster than using cloud[indices[i]] and centroid as a buffer
-  Eigen::Matrix<Scalar, 1, 9, Eigen::RowMajor> accu = Eigen::Matrix<Scalar, 1, 9, Eigen::RowMajor>::Zero ();
-  size_t point_count;
-  if (cloud.is_dense)
-  {
-    point_count = cloud.size ();
-    // For each point in the cloud
-    for (size_t i = 0; i < point_count; ++i)
-    {
-      accu [0] += cloud[i].x * cloud[i].x;
-      accu [1] += cloud[i].x * cloud[i].y;
-      accu [2] += cloud[i].x * cloud[i].z;
-      accu [3] += cloud[i].y * cloud[i].y; // 4
-      accu [4] += cloud[i].y * cloud[i].z; // 5
-      accu [5] += cloud[i].z * cloud[i].z; // 8
-      accu [6] += cloud[i].x;
-      accu [7] += cloud[i].y;
-      accu [8] += cloud[i].z;
-    }
-  }
-  else
-  {
-    point_count = 0;
-    for (size_t i = 0; i < cloud.size (); ++i)
-    {
-      if (!isFinite (cloud[i]))
-        continue;
-
-      accu [0] += cloud[i].x * cloud[i].x;
-      accu [1] += cloud[i].x * cloud[i].y;
-      accu [2] += cloud[i].x * cloud[i].z;
-      accu [3] += cloud[i].y * cloud[i].y;
-      accu [4] += cloud[i].y * cloud[i].z;
-      accu [5] += cloud[i].z * cloud[i].z;
-      accu [6] += cloud[i].x;
-      accu [7] += cloud[i].y;
-      accu [8] += cloud[i].z;
-      ++point_count;
-    }
-  }
-  accu /= static_cast<Scalar> (point_count);
-  if (point_count != 0)
-  {
-    //centroid.head<3> () = accu.tail<3> ();    -- does not compile with Clang 3.0
-    centroid[0] = accu[6]; centroid[1] = accu[7]; centroid[2] = accu[8];
-    centroid[3] = 1;
-    covariance_matrix.coeffRef (0) = accu [0] - accu [6] * accu [6];
-    covariance_matrix.coeffRef (1) = accu [1] - accu [6] * accu [7];
-    covariance_matrix.coeffRef (2) = accu [2] - accu [6] * accu [8];
-    covariance_matrix.coeffRef (4) = accu [3] - accu [7] * accu [7];
-    covariance_matrix.coeffRef (5) = accu [4] - accu [7] * accu [8];
-    covariance_matrix.coeffRef (8) = accu [5] - accu [8] * accu [8];
-    covariance_matrix.coeffRef (3) = covariance_matrix.coeff (1);
-    covariance_matrix.coeffRef (6) = covariance_matrix.coeff (2);
-    covariance_matrix.coeffRef (7) = covariance_matrix.coeff (5);
-  }
-  return (static_cast<unsigned int> (point_count));
+  return (detail::computeMeanAndCovariance (cloud, static_cast<const int*> (NULL), cloud.size (), covariance_matrix, centroid));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -557,64 +629,9 @@ pcl::computeMeanAndCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
                                      Eigen::Matrix<Scalar, 3, 3> &covariance_matrix,
                                      Eigen::Matrix<Scalar, 4, 1> &centroid)
 {
-  // create the buffer on the stack which is much faster than using cloud[indices[i]] and centroid as a buffer
-  Eigen::Matrix<Scalar, 1, 9, Eigen::RowMajor> accu = Eigen::Matrix<Scalar, 1, 9, Eigen::RowMajor>::Zero ();
-  size_t point_count;
-  if (cloud.is_dense)
-  {
-    point_count = indices.size ();
-    for (std::vector<int>::const_iterator iIt = indices.begin (); iIt != indices.end (); ++iIt)
-    {
-      //const PointT& point = cloud[*iIt];
-      accu [0] += cloud[*iIt].x * cloud[*iIt].x;
-      accu [1] += cloud[*iIt].x * cloud[*iIt].y;
-      accu [2] += cloud[*iIt].x * cloud[*iIt].z;
-      accu [3] += cloud[*iIt].y * cloud[*iIt].y;
-      accu [4] += cloud[*iIt].y * cloud[*iIt].z;
-      accu [5] += cloud[*iIt].z * cloud[*iIt].z;
-      accu [6] += cloud[*iIt].x;
-      accu [7] += cloud[*iIt].y;
-      accu [8] += cloud[*iIt].z;
-    }
-  }
-  else
-  {
-    point_count = 0;
-    for (std::vector<int>::const_iterator iIt = indices.begin (); iIt != indices.end (); ++iIt)
-    {
-      if (!isFinite (cloud[*iIt]))
-        continue;
-
-      ++point_count;
-      accu [0] += cloud[*iIt].x * cloud[*iIt].x;
-      accu [1] += cloud[*iIt].x * cloud[*iIt].y;
-      accu [2] += cloud[*iIt].x * cloud[*iIt].z;
-      accu [3] += cloud[*iIt].y * cloud[*iIt].y; // 4
-      accu [4] += cloud[*iIt].y * cloud[*iIt].z; // 5
-      accu [5] += cloud[*iIt].z * cloud[*iIt].z; // 8
-      accu [6] += cloud[*iIt].x;
-      accu [7] += cloud[*iIt].y;
-      accu [8] += cloud[*iIt].z;
-    }
-  }
-
-  accu /= static_cast<Scalar> (point_count);
-  //Eigen::Vector3f vec = accu.tail<3> ();
-  //centroid.head<3> () = vec;//= accu.tail<3> ();
-  //centroid.head<3> () = accu.tail<3> ();    -- does not compile with Clang 3.0
-  centroid[0] = accu[6]; centroid[1] = accu[7]; centroid[2] = accu[8];
-  centroid[3] = 1;
-  covariance_matrix.coeffRef (0) = accu [0] - accu [6] * accu [6];
-  covariance_matrix.coeffRef (1) = accu [1] - accu [6] * accu [7];
-  covariance_matrix.coeffRef (2) = accu [2] - accu [6] * accu [8];
-  covariance_matrix.coeffRef (4) = accu [3] - accu [7] * accu [7];
-  covariance_matrix.coeffRef (5) = accu [4] - accu [7] * accu [8];
-  covariance_matrix.coeffRef (8) = accu [5] - accu [8] * accu [8];
-  covariance_matrix.coeffRef (3) = covariance_matrix.coeff (1);
-  covariance_matrix.coeffRef (6) = covariance_matrix.coeff (2);
-  covariance_matrix.coeffRef (7) = covariance_matrix.coeff (5);
-
-  return (static_cast<unsigned int> (point_count));
+  if (indices.empty ())
+    return (0);
+  return (detail::computeMeanAndCovariance (cloud, &indices[0], indices.size (), covariance_matrix, centroid));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -121,6 +121,53 @@ pcl::computeRoots (const Matrix& m, Roots& roots)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+template <typename Matrix> inline typename Matrix::Scalar
+pcl::computeSmallestRoot (const Matrix& m)
+{
+  typedef typename Matrix::Scalar Scalar;
+
+  // The characteristic equation is x^3 - c2*x^2 + c1*x - c0 = 0 (see computeRoots)
+  Scalar c0 =      m (0, 0) * m (1, 1) * m (2, 2)
+      + Scalar (2) * m (0, 1) * m (0, 2) * m (1, 2)
+             - m (0, 0) * m (1, 2) * m (1, 2)
+             - m (1, 1) * m (0, 2) * m (0, 2)
+             - m (2, 2) * m (0, 1) * m (0, 1);
+  Scalar c1 = m (0, 0) * m (1, 1) -
+        m (0, 1) * m (0, 1) +
+        m (0, 0) * m (2, 2) -
+        m (0, 2) * m (0, 2) +
+        m (1, 1) * m (2, 2) -
+        m (1, 2) * m (1, 2);
+  Scalar c2 = m (0, 0) + m (1, 1) + m (2, 2);
+
+  // One root is 0, or the matrix is slightly indefinite from rounding and the smallest root is negative: like
+  // computeRoots, clamp it to 0, as the eigenvalues of a positive semi-definite matrix can not be negative
+  if (c0 < Eigen::NumTraits < Scalar > ::epsilon ())
+    return (Scalar (0));
+
+  // All three roots are real and non negative. Below the smallest one, the polynomial is increasing and
+  // concave, so Newton's method started at 0 converges to it from below, without overshooting. For a
+  // plane-like neighborhood the smallest root is well separated and a few iterations are enough.
+  Scalar x = 0;
+  for (int iteration = 0; iteration < 8; ++iteration)
+  {
+    const Scalar p = ((x - c2) * x + c1) * x - c0;
+    const Scalar dp = (Scalar (3) * x - Scalar (2) * c2) * x + c1;
+    if (dp <= Scalar (0))
+      break;
+    const Scalar delta = -p / dp;
+    x += delta;
+    if (delta <= Eigen::NumTraits < Scalar > ::epsilon () * x)
+      return (x);
+  }
+
+  // Close to a double root the convergence is only linear, use the closed form solution instead
+  Eigen::Matrix<Scalar, 3, 1> roots;
+  computeRoots (m, roots);
+  return (roots (0));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 template <typename Matrix, typename Vector> inline void
 pcl::eigen22 (const Matrix& mat, typename Matrix::Scalar& eigenvalue, Vector& eigenvector)
@@ -260,12 +307,11 @@ pcl::eigen33 (const Matrix& mat, typename Matrix::Scalar& eigenvalue, Vector& ei
 
   Matrix scaledMat = mat / scale;
 
-  Vector eigenvalues;
-  computeRoots (scaledMat, eigenvalues);
+  Scalar smallest = computeSmallestRoot (scaledMat);
 
-  eigenvalue = eigenvalues (0) * scale;
+  eigenvalue = smallest * scale;
 
-  scaledMat.diagonal ().array () -= eigenvalues (0);
+  scaledMat.diagonal ().array () -= smallest;
 
   Vector vec1 = scaledMat.row (0).cross (scaledMat.row (1));
   Vector vec2 = scaledMat.row (0).cross (scaledMat.row (2));
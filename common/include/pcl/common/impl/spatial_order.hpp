@@ -0,0 +1,96 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_COMMON_IMPL_SPATIAL_ORDER_H_
+#define PCL_COMMON_IMPL_SPATIAL_ORDER_H_
+
+#include <pcl/common/spatial_order.h>
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::computeSpatialOrder (const pcl::PointCloud<PointT> &cloud, SpatialOrder type, std::vector<int> &order)
+{
+  std::vector<float> points (3 * cloud.points.size ());
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    points[3 * i] = cloud.points[i].x;
+    points[3 * i + 1] = cloud.points[i].y;
+    points[3 * i + 2] = cloud.points[i].z;
+  }
+  computeSpatialOrder (points.empty () ? NULL : &points[0], cloud.points.size (), 3, type, order);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::computeSpatialOrder (const pcl::PointCloud<PointT> &cloud, const std::vector<int> &indices,
+                          SpatialOrder type, std::vector<int> &order)
+{
+  std::vector<float> points (3 * indices.size ());
+  for (size_t i = 0; i < indices.size (); ++i)
+  {
+    const PointT &point = cloud.points[indices[i]];
+    points[3 * i] = point.x;
+    points[3 * i + 1] = point.y;
+    points[3 * i + 2] = point.z;
+  }
+  computeSpatialOrder (points.empty () ? NULL : &points[0], indices.size (), 3, type, order);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::reorderPointCloud (const pcl::PointCloud<PointT> &cloud_in, SpatialOrder type,
+                        pcl::PointCloud<PointT> &cloud_out, std::vector<int> &permutation)
+{
+  computeSpatialOrder (cloud_in, type, permutation);
+
+  // Gather the points first, as cloud_out may be cloud_in
+  typename pcl::PointCloud<PointT>::VectorType points (permutation.size ());
+  for (size_t i = 0; i < permutation.size (); ++i)
+    points[i] = cloud_in.points[permutation[i]];
+
+  cloud_out.header = cloud_in.header;
+  cloud_out.is_dense = cloud_in.is_dense;
+  cloud_out.sensor_origin_ = cloud_in.sensor_origin_;
+  cloud_out.sensor_orientation_ = cloud_in.sensor_orientation_;
+  cloud_out.points.swap (points);
+  cloud_out.width = static_cast<uint32_t> (cloud_out.points.size ());
+  cloud_out.height = 1;
+}
+
+#endif  //#ifndef PCL_COMMON_IMPL_SPATIAL_ORDER_H_
@@ -0,0 +1,136 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_COMMON_SPATIAL_ORDER_H_
+#define PCL_COMMON_SPATIAL_ORDER_H_
+
+#include <pcl/pcl_macros.h>
+#include <pcl/point_cloud.h>
+#include <vector>
+
+/**
+  * \file pcl/common/spatial_order.h
+  * Define methods to sort points along a space-filling curve
+  * \ingroup common
+  */
+
+/*@{*/
+namespace pcl
+{
+  /** \brief The space-filling curves points can be sorted along.
+    *
+    * Consecutive points along such a curve are close in space, so processing a cloud in this order gives
+    * consecutive spatial queries overlapping neighborhoods and tree paths, which keeps them in cache. The
+    * Hilbert curve has better locality than the Morton (Z-order) curve, which is cheaper to compute.
+    * \ingroup common
+    */
+  enum SpatialOrder {NO_SPATIAL_ORDER, MORTON_ORDER, HILBERT_ORDER};
+
+  /** \brief Compute the 63 bit Morton code of a point, by interleaving the bits of its coordinates.
+    * \param[in] x the quantized x coordinate (21 bits)
+    * \param[in] y the quantized y coordinate (21 bits)
+    * \param[in] z the quantized z coordinate (21 bits)
+    * \ingroup common
+    */
+  PCL_EXPORTS uint64_t
+  computeMortonCode (uint32_t x, uint32_t y, uint32_t z);
+
+  /** \brief Compute the 63 bit index of a point along the 3D Hilbert curve.
+    * \param[in] x the quantized x coordinate (21 bits)
+    * \param[in] y the quantized y coordinate (21 bits)
+    * \param[in] z the quantized z coordinate (21 bits)
+    * \ingroup common
+    */
+  PCL_EXPORTS uint64_t
+  computeHilbertCode (uint32_t x, uint32_t y, uint32_t z);
+
+  /** \brief Compute the order of a set of points along a space-filling curve spanning their bounding box.
+    * \param[in] points the coordinates of the points, the x, y and z coordinates of point i being stored at
+    * points[i * stride], points[i * stride + 1] and points[i * stride + 2]
+    * \param[in] nr_points the number of points
+    * \param[in] stride the number of floats between two consecutive points (at least 3)
+    * \param[in] type the space-filling curve to use
+    * \param[out] order the point numbers, in the order of the curve. Points with non-finite coordinates
+    * come last, and points with the same code keep their relative order.
+    * \ingroup common
+    */
+  PCL_EXPORTS void
+  computeSpatialOrder (const float *points, size_t nr_points, size_t stride,
+                       SpatialOrder type, std::vector<int> &order);
+
+  /** \brief Compute the order of the points of a cloud along a space-filling curve.
+    * \param[in] cloud the input point cloud
+    * \param[in] type the space-filling curve to use
+    * \param[out] order the point indices, in the order of the curve (non-finite points last)
+    * \ingroup common
+    */
+  template <typename PointT> void
+  computeSpatialOrder (const pcl::PointCloud<PointT> &cloud,
+                       SpatialOrder type, std::vector<int> &order);
+
+  /** \brief Compute the order of a subset of the points of a cloud along a space-filling curve.
+    * \param[in] cloud the input point cloud
+    * \param[in] indices the indices of the points to sort
+    * \param[in] type the space-filling curve to use
+    * \param[out] order the positions in \a indices, in the order of the curve (non-finite points last)
+    * \ingroup common
+    */
+  template <typename PointT> void
+  computeSpatialOrder (const pcl::PointCloud<PointT> &cloud, const std::vector<int> &indices,
+                       SpatialOrder type, std::vector<int> &order);
+
+  /** \brief Sort the points of a cloud along a space-filling curve.
+    *
+    * The output cloud is unorganized. Results computed on it are mapped back to the input cloud with the
+    * permutation: output point i is input point permutation[i].
+    * \param[in] cloud_in the input point cloud
+    * \param[in] type the space-filling curve to use
+    * \param[out] cloud_out the sorted point cloud (can be the same as \a cloud_in)
+    * \param[out] permutation the index in \a cloud_in of every point of \a cloud_out
+    * \ingroup common
+    */
+  template <typename PointT> void
+  reorderPointCloud (const pcl::PointCloud<PointT> &cloud_in, SpatialOrder type,
+                     pcl::PointCloud<PointT> &cloud_out, std::vector<int> &permutation);
+}
+/*@}*/
+
+#include <pcl/common/impl/spatial_order.hpp>
+
+#endif  //#ifndef PCL_COMMON_SPATIAL_ORDER_H_
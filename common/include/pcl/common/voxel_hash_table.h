@@ -0,0 +1,227 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_COMMON_VOXEL_HASH_TABLE_H_
+#define PCL_COMMON_VOXEL_HASH_TABLE_H_
+
+#include <pcl/pcl_macros.h>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace pcl
+{
+  /** \brief Open-addressing hash table that maps integer voxel coordinates to consecutive voxel ids.
+    *
+    * Voxels get the ids 0, 1, 2, ... in order of insertion, so any per-voxel data can be kept in
+    * flat arrays indexed by id. Unlike a dense grid, the memory used only depends on the number of
+    * occupied voxels, not on the extent of the data, and unlike the fixed-size table of
+    * \ref ApproximateVoxelGrid, collisions are resolved exactly (linear probing).
+    *
+    * \ingroup common
+    */
+  class VoxelHashTable
+  {
+    public:
+      /** \brief Integer coordinates of a voxel. */
+      struct Key
+      {
+        Key () : x (0), y (0), z (0) {}
+        Key (int x_, int y_, int z_) : x (x_), y (y_), z (z_) {}
+        int x, y, z;
+      };
+
+      /** \brief Constructor.
+        * \param[in] expected_size the number of voxels the table should be able to hold without rehashing
+        */
+      VoxelHashTable (size_t expected_size = 0) : slots_ (), keys_ (), mask_ (0)
+      {
+        reserve (expected_size);
+      }
+
+      /** \brief Remove all voxels from the table, keeping the allocated memory. */
+      inline void
+      clear ()
+      {
+        std::fill (slots_.begin (), slots_.end (), -1);
+        keys_.clear ();
+      }
+
+      /** \brief Make room for at least \a size voxels without rehashing.
+        * \param[in] size the number of voxels
+        */
+      inline void
+      reserve (size_t size)
+      {
+        // Keep the load factor at or below 0.5
+        size_t capacity = 16;
+        while (capacity < 2 * size)
+          capacity <<= 1;
+        if (capacity > slots_.size ())
+          rehash (capacity);
+        keys_.reserve (size);
+      }
+
+      /** \brief Get the number of voxels in the table. */
+      inline size_t
+      size () const { return (keys_.size ()); }
+
+      /** \brief Return true if the table holds no voxel. */
+      inline bool
+      empty () const { return (keys_.empty ()); }
+
+      /** \brief Get the coordinates of the voxel with the given id.
+        * \param[in] id the voxel id, in [0, size ())
+        */
+      inline const Key&
+      getKey (int id) const { return (keys_[id]); }
+
+      /** \brief Get the id of a voxel, inserting it if it is not in the table yet.
+        * \param[in] x the voxel coordinate along X
+        * \param[in] y the voxel coordinate along Y
+        * \param[in] z the voxel coordinate along Z
+        * \return the voxel id; newly inserted voxels get the id size () - 1
+        */
+      inline int
+      insert (int x, int y, int z)
+      {
+        if (2 * (keys_.size () + 1) > slots_.size ())
+          rehash (slots_.size () * 2);
+
+        size_t slot = hash (x, y, z) & mask_;
+        while (slots_[slot] != -1)
+        {
+          const Key &key = keys_[slots_[slot]];
+          if (key.x == x && key.y == y && key.z == z)
+            return (slots_[slot]);
+          slot = (slot + 1) & mask_;
+        }
+        slots_[slot] = static_cast<int> (keys_.size ());
+        keys_.push_back (Key (x, y, z));
+        return (slots_[slot]);
+      }
+
+      /** \brief Get the id of a voxel.
+        * \param[in] x the voxel coordinate along X
+        * \param[in] y the voxel coordinate along Y
+        * \param[in] z the voxel coordinate along Z
+        * \return the voxel id, or -1 if the voxel is not in the table
+        */
+      inline int
+      find (int x, int y, int z) const
+      {
+        if (keys_.empty ())
+          return (-1);
+
+        size_t slot = hash (x, y, z) & mask_;
+        while (slots_[slot] != -1)
+        {
+          const Key &key = keys_[slots_[slot]];
+          if (key.x == x && key.y == y && key.z == z)
+            return (slots_[slot]);
+          slot = (slot + 1) & mask_;
+        }
+        return (-1);
+      }
+
+      /** \brief Compute the integer coordinate of the voxel containing a coordinate.
+        * \param[in] value the coordinate
+        * \param[in] inverse_leaf_size the inverse of the voxel size along that axis
+        * \param[out] coordinate the voxel coordinate
+        * \return false if the voxel coordinate does not fit in an int
+        */
+      static inline bool
+      getVoxelCoordinate (float value, float inverse_leaf_size, int &coordinate)
+      {
+        // The product is computed in single precision, like in VoxelGrid, so that both agree on voxel boundaries
+        const double c = static_cast<double> (std::floor (value * inverse_leaf_size));
+        if (!(c >= static_cast<double> (std::numeric_limits<int>::min ()) &&
+              c <= static_cast<double> (std::numeric_limits<int>::max ())))
+          return (false);
+        coordinate = static_cast<int> (c);
+        return (true);
+      }
+
+    protected:
+      /** \brief Hash of the voxel coordinates, mixed so that the low bits can be used directly. */
+      static inline size_t
+      hash (int x, int y, int z)
+      {
+        uint32_t h = static_cast<uint32_t> (x) * 73856093u ^
+                     static_cast<uint32_t> (y) * 19349663u ^
+                     static_cast<uint32_t> (z) * 83492791u;
+        // Finalizer of MurmurHash3
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+        return (static_cast<size_t> (h));
+      }
+
+      /** \brief Resize the slot array and reinsert all the voxels.
+        * \param[in] capacity the new number of slots, a power of 2
+        */
+      inline void
+      rehash (size_t capacity)
+      {
+        slots_.assign (capacity, -1);
+        mask_ = capacity - 1;
+        for (size_t id = 0; id < keys_.size (); ++id)
+        {
+          size_t slot = hash (keys_[id].x, keys_[id].y, keys_[id].z) & mask_;
+          while (slots_[slot] != -1)
+            slot = (slot + 1) & mask_;
+          slots_[slot] = static_cast<int> (id);
+        }
+      }
+
+      /** \brief The hash table proper: the id of the voxel stored in each slot, or -1. */
+      std::vector<int> slots_;
+
+      /** \brief The coordinates of every voxel, indexed by id. */
+      std::vector<Key> keys_;
+
+      /** \brief The number of slots minus one. */
+      size_t mask_;
+  };
+}
+
+#endif  // PCL_COMMON_VOXEL_HASH_TABLE_H_
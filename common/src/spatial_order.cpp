@@ -0,0 +1,161 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include <pcl/common/spatial_order.h>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace
+{
+  /** \brief Spread the 21 lower bits of a value, leaving two zero bits between each. */
+  inline uint64_t
+  spreadBits (uint32_t value)
+  {
+    uint64_t bits = value & 0x1fffff;
+    bits = (bits | bits << 32) & 0x001f00000000ffffULL;
+    bits = (bits | bits << 16) & 0x001f0000ff0000ffULL;
+    bits = (bits | bits << 8) & 0x100f00f00f00f00fULL;
+    bits = (bits | bits << 4) & 0x10c30c30c30c30c3ULL;
+    bits = (bits | bits << 2) & 0x1249249249249249ULL;
+    return (bits);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+uint64_t
+pcl::computeMortonCode (uint32_t x, uint32_t y, uint32_t z)
+{
+  return (spreadBits (x) << 2 | spreadBits (y) << 1 | spreadBits (z));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+uint64_t
+pcl::computeHilbertCode (uint32_t x, uint32_t y, uint32_t z)
+{
+  // Transform the coordinates into the "transposed" Hilbert index (J. Skilling, Programming the
+  // Hilbert curve, AIP Conference Proceedings 707, 2004), whose interleaved bits form the index
+  uint32_t axes[3] = {x & 0x1fffff, y & 0x1fffff, z & 0x1fffff};
+  const uint32_t top = 1u << 20;
+
+  // Inverse undo
+  for (uint32_t q = top; q > 1; q >>= 1)
+  {
+    const uint32_t p = q - 1;
+    for (int i = 0; i < 3; ++i)
+    {
+      if (axes[i] & q)
+        axes[0] ^= p;
+      else
+      {
+        const uint32_t t = (axes[0] ^ axes[i]) & p;
+        axes[0] ^= t;
+        axes[i] ^= t;
+      }
+    }
+  }
+
+  // Gray encode
+  axes[1] ^= axes[0];
+  axes[2] ^= axes[1];
+  uint32_t t = 0;
+  for (uint32_t q = top; q > 1; q >>= 1)
+    if (axes[2] & q)
+      t ^= q - 1;
+  for (int i = 0; i < 3; ++i)
+    axes[i] ^= t;
+
+  return (computeMortonCode (axes[0], axes[1], axes[2]));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::computeSpatialOrder (const float *points, size_t nr_points, size_t stride,
+                          SpatialOrder type, std::vector<int> &order)
+{
+  order.resize (nr_points);
+  for (size_t i = 0; i < nr_points; ++i)
+    order[i] = static_cast<int> (i);
+  if (type == NO_SPATIAL_ORDER || nr_points < 2)
+    return;
+
+  // Bounding box of the finite points
+  float min_p[3], max_p[3];
+  for (int d = 0; d < 3; ++d)
+  {
+    min_p[d] = std::numeric_limits<float>::max ();
+    max_p[d] = -std::numeric_limits<float>::max ();
+  }
+  for (size_t i = 0; i < nr_points; ++i)
+  {
+    const float *point = points + i * stride;
+    if (!pcl_isfinite (point[0]) || !pcl_isfinite (point[1]) || !pcl_isfinite (point[2]))
+      continue;
+    for (int d = 0; d < 3; ++d)
+    {
+      min_p[d] = std::min (min_p[d], point[d]);
+      max_p[d] = std::max (max_p[d], point[d]);
+    }
+  }
+
+  // Quantize the coordinates on 21 bits, with the same scale along the three axes
+  const float max_extent = std::max (max_p[0] - min_p[0], std::max (max_p[1] - min_p[1], max_p[2] - min_p[2]));
+  const double scale = max_extent > 0.0f ? static_cast<double> (0x1fffff) / max_extent : 0.0;
+
+  std::vector<std::pair<uint64_t, int> > codes (nr_points);
+  for (size_t i = 0; i < nr_points; ++i)
+  {
+    const float *point = points + i * stride;
+    codes[i].second = static_cast<int> (i);
+    if (!pcl_isfinite (point[0]) || !pcl_isfinite (point[1]) || !pcl_isfinite (point[2]))
+    {
+      codes[i].first = std::numeric_limits<uint64_t>::max ();
+      continue;
+    }
+    uint32_t key[3];
+    for (int d = 0; d < 3; ++d)
+      key[d] = std::min (static_cast<uint32_t> ((point[d] - min_p[d]) * scale), 0x1fffffu);
+    codes[i].first = type == HILBERT_ORDER ? computeHilbertCode (key[0], key[1], key[2])
+                                           : computeMortonCode (key[0], key[1], key[2]);
+  }
+
+  std::sort (codes.begin (), codes.end ());
+  for (size_t i = 0; i < nr_points; ++i)
+    order[i] = codes[i].second;
+}
@@ -176,7 +176,23 @@ namespace pcl
       bool
       computePoint (size_t index, const pcl::PointCloud<PointNT> &normals, float rf[9], std::vector<float> &desc);
 
+      /** \brief Estimate a descriptor for a given point, using a pre-drawn random direction for the x axis.
+        * This variant does not touch the random number generator and can be called concurrently.
+        * \param[in] index the index of the point to estimate a descriptor for
+        * \param[in] normals a pointer to the set of normals
+        * \param[in] random_axis three uniform random values in [0, 1) used to build the x axis
+        * \param[in] rf the reference frame
+        * \param[out] desc the resultant estimated descriptor
+        * \return true if the descriptor was computed successfully, false if there was an error
+        * (e.g. the nearest neighbor didn't return any neighbors)
+        */
+      bool
+      computePoint (size_t index, const pcl::PointCloud<PointNT> &normals, const float random_axis[3],
+                    float rf[9], std::vector<float> &desc) const;
+
       /** \brief Estimate the actual feature.
+        * The random x axis directions are drawn serially, so the result does not depend on
+        * the number of threads set with \ref setNumberOfThreads.
         * \param[out] output the resultant feature
         */
       void
@@ -69,15 +69,9 @@ namespace pcl
         margin_thresh_ (0.85f),
         check_margin_array_size_ (24),
         hole_size_prob_thresh_ (0.2f),
-        steep_thresh_ (0.1f),
-        check_margin_array_ (),
-        margin_array_min_angle_ (),
-        margin_array_max_angle_ (),
-        margin_array_min_angle_normal_ (),
-        margin_array_max_angle_normal_ ()
+        steep_thresh_ (0.1f)
       {
         feature_name_ = "BOARDLocalReferenceFrameEstimation";
-        setCheckMarginArraySize (check_margin_array_size_);
       }
       
       /** \brief Empty destructor */
@@ -155,21 +149,6 @@ namespace pcl
       setCheckMarginArraySize (int size)
       {
         check_margin_array_size_ = size;
-
-        check_margin_array_.clear ();
-        check_margin_array_.resize (check_margin_array_size_);
-
-        margin_array_min_angle_.clear ();
-        margin_array_min_angle_.resize (check_margin_array_size_);
-
-        margin_array_max_angle_.clear ();
-        margin_array_max_angle_.resize (check_margin_array_size_);
-
-        margin_array_min_angle_normal_.clear ();
-        margin_array_min_angle_normal_.resize (check_margin_array_size_);
-
-        margin_array_max_angle_normal_.clear ();
-        margin_array_max_angle_normal_.resize (check_margin_array_size_);
       }
 
       /** \brief Gets the number of slices in which is divided the margin for the search of missing regions.
@@ -239,12 +218,6 @@ namespace pcl
       typedef typename Feature<PointInT, PointOutT>::PointCloudIn PointCloudIn;
       typedef typename Feature<PointInT, PointOutT>::PointCloudOut PointCloudOut;
 
-      void
-      resetData ()
-      {
-        setCheckMarginArraySize (check_margin_array_size_);
-      }
-
       /** \brief Estimate the LRF descriptor for a given point based on its spatial neighborhood of 3D points with normals
         * \param[in] index the index of the point in input_
         * \param[out] lrf the resultant local reference frame
@@ -253,6 +226,8 @@ namespace pcl
       computePointLRF (const int &index, Eigen::Matrix3f &lrf);
 
       /** \brief Abstract feature estimation method.
+        * The frames are estimated using \ref setNumberOfThreads threads, unless \ref setFindHoles is enabled:
+        * the hole search draws random axes, so it runs serially to stay reproducible.
         * \param[out] output the resultant features
         */
       virtual void
@@ -353,12 +328,6 @@ namespace pcl
 
       /** \brief Threshold that defines if a missing region contains a point with the most different normal. */
       float steep_thresh_; 
-
-      std::vector<bool> check_margin_array_;
-      std::vector<float> margin_array_min_angle_;
-      std::vector<float> margin_array_max_angle_;
-      std::vector<float> margin_array_min_angle_normal_;
-      std::vector<float> margin_array_max_angle_normal_;
   };
 }
 
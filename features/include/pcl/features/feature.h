@@ -50,6 +50,11 @@
 // PCL includes
 #include <pcl/pcl_base.h>
 #include <pcl/search/search.h>
+#include <pcl/common/spatial_order.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace pcl
 {
@@ -115,6 +120,7 @@ namespace pcl
 
       typedef typename pcl::search::Search<PointInT> KdTree;
       typedef typename pcl::search::Search<PointInT>::Ptr KdTreePtr;
+      typedef typename pcl::search::Search<PointInT>::SearchContext SearchContext;
 
       typedef pcl::PointCloud<PointInT> PointCloudIn;
       typedef typename PointCloudIn::Ptr PointCloudInPtr;
@@ -123,15 +129,16 @@ namespace pcl
       typedef pcl::PointCloud<PointOutT> PointCloudOut;
 
       typedef boost::function<int (size_t, double, std::vector<int> &, std::vector<float> &)> SearchMethod;
-      typedef boost::function<int (const PointCloudIn &cloud, size_t index, double, std::vector<int> &, std::vector<float> &)> SearchMethodSurface;
+      typedef boost::function<int (const PointCloudIn &cloud, size_t index, double, std::vector<int> &, std::vector<float> &, SearchContext &)> SearchMethodSurface;
 
     public:
       /** \brief Empty constructor. */
       Feature () :
-        feature_name_ (), search_method_surface_ (),
+        feature_name_ (), search_method_surface_ (), search_contexts_ (),
         surface_(), tree_(),
         search_parameter_(0), search_radius_(0), k_(0),
-        fake_surface_(false)
+        fake_surface_(false), spatial_order_ (NO_SPATIAL_ORDER),
+        unordered_indices_ (), query_order_ (), threads_ (1)
       {}
             
       /** \brief Empty destructor */
@@ -209,6 +216,36 @@ namespace pcl
         return (search_radius_);
       }
 
+      /** \brief Set the order in which the query points are processed. Processing them along a
+        * space-filling curve rather than in the order of the indices makes consecutive queries search
+        * overlapping neighborhoods, which is faster on unorganized clouds. The output is in the order of
+        * the indices either way.
+        * \note Only meant for the features that compute the output of every query point independently from
+        * its neighborhood, such as \ref NormalEstimation, \ref FPFHEstimation or \ref SHOTEstimation. It is
+        * ignored by the estimators that fill a whole organized image, such as \ref IntegralImageNormalEstimation.
+        * \param[in] order the space-filling curve to process the query points along (NO_SPATIAL_ORDER by
+        * default)
+        */
+      inline void
+      setSpatialOrder (SpatialOrder order) { spatial_order_ = order; }
+
+      /** \brief Get the order in which the query points are processed. */
+      inline SpatialOrder
+      getSpatialOrder () const { return (spatial_order_); }
+
+      /** \brief Set the number of threads the estimation of the features of the query points is spread over.
+        * Only the estimators whose \a computeFeature loop supports it run in parallel, the others ignore it.
+        * \note The neighbor searches are run concurrently, which all the \ref pcl::search::Search methods support.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic). The
+        * estimators run serially (1 thread) by default, their *OMP variants use all the threads by default.
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+      /** \brief Get the number of threads the feature estimation uses (0 means automatic). */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
       /** \brief Base method for feature estimation for all points given in
         * <setInputCloud (), setIndices ()> using the surface in setSearchSurface ()
         * and the spatial locator in setSearchMethod ()
@@ -224,6 +261,9 @@ namespace pcl
       /** \brief The search method template for points. */
       SearchMethodSurface search_method_surface_;
 
+      /** \brief The scratch buffers of the neighbor searches, one per thread, reused from one query to the next. */
+      mutable std::vector<SearchContext> search_contexts_;
+
       /** \brief An input point cloud describing the surface that is to be used
         * for nearest neighbors estimation.
         */
@@ -253,9 +293,41 @@ namespace pcl
       virtual bool
       deinitCompute ();
 
+      /** \brief Whether the query points can be processed in \a spatial_order_. Estimators whose output is laid
+        * out by the positions of the points rather than by the order of the indices return false, and
+        * \ref setSpatialOrder is then ignored.
+        */
+      virtual bool
+      supportsSpatialOrder () const { return (true); }
+
       /** \brief If no surface is given, we use the input PointCloud as the surface. */
       bool fake_surface_;
 
+      /** \brief The order in which the query points are processed. */
+      SpatialOrder spatial_order_;
+
+      /** \brief The indices given by the user, while \a indices_ holds them in spatial order. */
+      IndicesPtr unordered_indices_;
+
+      /** \brief The position in \a unordered_indices_ of every query point, in processing order. */
+      std::vector<int> query_order_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
+      /** \brief Get the number of threads to run the loop over the query points with, i.e. \a threads_ with 0
+        * resolved to the number of available threads. Always 1 without OpenMP.
+        */
+      inline int
+      getComputeThreads () const
+      {
+#ifdef _OPENMP
+        return (threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_));
+#else
+        return (1);
+#endif
+      }
+
       /** \brief Search for k-nearest neighbors using the spatial locator from
         * \a setSearchmethod, and the given surface from \a setSearchSurface.
         * \param[in] index the index of the query point
@@ -270,7 +342,7 @@ namespace pcl
       searchForNeighbors (size_t index, double parameter,
                           std::vector<int> &indices, std::vector<float> &distances) const
       {
-        return (search_method_surface_ (*input_, index, parameter, indices, distances));
+        return (searchForNeighbors (*input_, index, parameter, indices, distances));
       }
 
       /** \brief Search for k-nearest neighbors using the spatial locator from
@@ -288,7 +360,16 @@ namespace pcl
       searchForNeighbors (const PointCloudIn &cloud, size_t index, double parameter,
                           std::vector<int> &indices, std::vector<float> &distances) const
       {
-        return (search_method_surface_ (cloud, index, parameter, indices, distances));
+#ifdef _OPENMP
+        const size_t thread = static_cast<size_t> (omp_get_thread_num ());
+#else
+        const size_t thread = 0;
+#endif
+        if (thread < search_contexts_.size ())
+          return (search_method_surface_ (cloud, index, parameter, indices, distances, search_contexts_[thread]));
+        // More threads than prepared for in initCompute ()
+        SearchContext context;
+        return (search_method_surface_ (cloud, index, parameter, indices, distances, context));
       }
 
     private:
@@ -87,6 +87,8 @@ namespace pcl
       using Feature<PointInT, PointOutT>::indices_;
       using Feature<PointInT, PointOutT>::k_;
       using Feature<PointInT, PointOutT>::search_parameter_;
+      using Feature<PointInT, PointOutT>::search_radius_;
+      using Feature<PointInT, PointOutT>::tree_;
       using Feature<PointInT, PointOutT>::input_;
       using Feature<PointInT, PointOutT>::surface_;
       using FeatureFromNormals<PointInT, PointNT, PointOutT>::normals_;
@@ -97,7 +99,8 @@ namespace pcl
       FPFHEstimation () : 
         nr_bins_f1_ (11), nr_bins_f2_ (11), nr_bins_f3_ (11), 
         hist_f1_ (), hist_f2_ (), hist_f3_ (), fpfh_histogram_ (),
-        d_pi_ (1.0f / (2.0f * static_cast<float> (M_PI)))
+        d_pi_ (1.0f / (2.0f * static_cast<float> (M_PI))),
+        approximate_ (false), tile_size_ (16384)
       {
         feature_name_ = "FPFHEstimation";
       };
@@ -179,6 +182,34 @@ namespace pcl
         nr_bins_f3 = nr_bins_f3_;
       }
 
+      /** \brief Set whether the descriptors are computed with the fast approximate scheme. The neighborhoods are
+        * searched once, in batches of \ref setTileSize points, and every neighborhood is used twice: for the
+        * SPFH signature of its point, and for adding that signature, weighted, to the FPFH signatures of the
+        * neighbors. This relies on radius neighborhoods being symmetric. The pair features are computed with
+        * SSE2/AVX and a polynomial atan2, and the weighted signatures are summed in another order, so the
+        * histograms differ from the exact ones in the last bits, and rarely by a pair moved to a neighboring bin.
+        * \note The scheme is used if the features of all the points of the input cloud are estimated with a
+        * radius search, without a separate search surface. The exact computation is used otherwise.
+        * \param[in] approximate true to use the approximate scheme, false (default) for the exact computation
+        */
+      inline void
+      setApproximate (bool approximate) { approximate_ = approximate; }
+
+      /** \brief Get whether the descriptors are computed with the fast approximate scheme. */
+      inline bool
+      getApproximate () const { return (approximate_); }
+
+      /** \brief Set the number of points whose neighborhoods the approximate scheme holds in memory at once, which
+        * bounds its memory use (see \ref setApproximate).
+        * \param[in] tile_size the number of points per batch (default 16384)
+        */
+      inline void
+      setTileSize (int tile_size) { tile_size_ = tile_size; }
+
+      /** \brief Get the number of points whose neighborhoods the approximate scheme holds in memory at once. */
+      inline int
+      getTileSize () const { return (tile_size_); }
+
     protected:
 
       /** \brief Estimate the set of all SPFH (Simple Point Feature Histograms) signatures for the input cloud
@@ -199,6 +230,14 @@ namespace pcl
       void 
       computeFeature (PointCloudOut &output);
 
+      /** \brief Estimate the FPFH descriptors with the fast approximate scheme (see \ref setApproximate), using
+        * \ref getComputeThreads threads.
+        * \param[out] output the resultant point cloud model dataset that contains the FPFH feature estimates
+        * \return false if the scheme does not apply to the current parameters, in which case \a output is untouched
+        */
+      bool
+      computeFeatureApproximate (PointCloudOut &output);
+
       /** \brief The number of subdivisions for each angular feature interval. */
       int nr_bins_f1_, nr_bins_f2_, nr_bins_f3_;
 
@@ -216,6 +255,12 @@ namespace pcl
 
       /** \brief Float constant = 1.0 / (2.0 * M_PI) */
       float d_pi_; 
+
+      /** \brief Whether to use the fast approximate scheme. */
+      bool approximate_;
+
+      /** \brief The number of points whose neighborhoods the approximate scheme searches at once. */
+      int tile_size_;
   };
 }
 
@@ -129,6 +129,16 @@ pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::initCompute ()
 template <typename PointInT, typename PointNT, typename PointOutT> bool
 pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::computePoint (
     size_t index, const pcl::PointCloud<PointNT> &normals, float rf[9], std::vector<float> &desc)
+{
+  const float random_axis[3] = {static_cast<float> (rnd ()), static_cast<float> (rnd ()), static_cast<float> (rnd ())};
+  return (computePoint (index, normals, random_axis, rf, desc));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> bool
+pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::computePoint (
+    size_t index, const pcl::PointCloud<PointNT> &normals, const float random_axis[3],
+    float rf[9], std::vector<float> &desc) const
 {
   // The RF is formed as this x_axis | y_axis | normal
   Eigen::Map<Eigen::Vector3f> x_axis (rf);
@@ -166,9 +176,9 @@ pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::computePoint (
   normal = normals[minIndex].getNormalVector3fMap ();
 
   // Compute and store the RF direction
-  x_axis[0] = static_cast<float> (rnd ());
-  x_axis[1] = static_cast<float> (rnd ());
-  x_axis[2] = static_cast<float> (rnd ());
+  x_axis[0] = random_axis[0];
+  x_axis[1] = random_axis[1];
+  x_axis[2] = random_axis[2];
   if (!pcl::utils::equal (normal[2], 0.0f))
     x_axis[2] = - (normal[0]*x_axis[0] + normal[1]*x_axis[1]) / normal[2];
   else if (!pcl::utils::equal (normal[1], 0.0f))
@@ -280,12 +290,23 @@ pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::computeFeature (Poi
 {
   assert (descriptor_length_ == 1980);
 
-  output.is_dense = true;
-  // Iterate over all points and compute the descriptors
-	for (size_t point_index = 0; point_index < indices_->size (); point_index++)
+  // Draw the random x axis directions up front, in the same order as a serial pass would
+  std::vector<float> random_axes (3 * indices_->size (), 0.0f);
+  for (size_t point_index = 0; point_index < indices_->size (); point_index++)
   {
-    //output[point_index].descriptor.resize (descriptor_length_);
+    if (!isFinite ((*input_)[(*indices_)[point_index]]))
+      continue;
+    for (int d = 0; d < 3; ++d)
+      random_axes[3 * point_index + d] = static_cast<float> (rnd ());
+  }
 
+  bool is_dense = true;
+  // Iterate over all points and compute the descriptors
+#ifdef _OPENMP
+#pragma omp parallel for reduction (&& : is_dense) schedule(dynamic, 16) num_threads(this->getComputeThreads ())
+#endif
+  for (int point_index = 0; point_index < static_cast<int> (indices_->size ()); point_index++)
+  {
     // If the point is not finite, set the descriptor to NaN and continue
     if (!isFinite ((*input_)[(*indices_)[point_index]]))
     {
@@ -293,16 +314,17 @@ pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::computeFeature (Poi
         output[point_index].descriptor[i] = std::numeric_limits<float>::quiet_NaN ();
 
       memset (output[point_index].rf, 0, sizeof (output[point_index].rf[0]) * 9);
-      output.is_dense = false;
+      is_dense = false;
       continue;
     }
 
     std::vector<float> descriptor (descriptor_length_);
-    if (!computePoint (point_index, *normals_, output[point_index].rf, descriptor))
-      output.is_dense = false;
+    if (!computePoint (point_index, *normals_, &random_axes[3 * point_index], output[point_index].rf, descriptor))
+      is_dense = false;
     for (size_t j = 0; j < descriptor_length_; ++j)
       output[point_index].descriptor[j] = descriptor[j];
   }
+  output.is_dense = is_dense;
 }
 
 #define PCL_INSTANTIATE_ShapeContext3DEstimation(T,NT,OutT) template class PCL_EXPORTS pcl::ShapeContext3DEstimation<T,NT,OutT>;
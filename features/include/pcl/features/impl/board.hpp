@@ -260,20 +260,23 @@ pcl::BOARDLocalReferenceFrameEstimation<PointInT, PointNT, PointOutT>::computePo
 
   float max_boundary_angle = 0;
 
+  std::vector<bool> check_margin_array;
+  std::vector<float> margin_array_min_angle;
+  std::vector<float> margin_array_max_angle;
+  std::vector<float> margin_array_min_angle_normal;
+  std::vector<float> margin_array_max_angle_normal;
+
   if (find_holes_)
   {
     randomOrthogonalAxis (fitted_normal, x_axis);
 
     lrf.row (0).matrix () = x_axis;
 
-    for (int i = 0; i < check_margin_array_size_; i++)
-    {
-      check_margin_array_[i] = false;
-      margin_array_min_angle_[i] = std::numeric_limits<float>::max ();
-      margin_array_max_angle_[i] = -std::numeric_limits<float>::max ();
-      margin_array_min_angle_normal_[i] = -1.0;
-      margin_array_max_angle_normal_[i] = -1.0;
-    }
+    check_margin_array.assign (check_margin_array_size_, false);
+    margin_array_min_angle.assign (check_margin_array_size_, std::numeric_limits<float>::max ());
+    margin_array_max_angle.assign (check_margin_array_size_, -std::numeric_limits<float>::max ());
+    margin_array_min_angle_normal.assign (check_margin_array_size_, -1.0f);
+    margin_array_max_angle_normal.assign (check_margin_array_size_, -1.0f);
     max_boundary_angle = (2 * static_cast<float> (M_PI)) / static_cast<float> (check_margin_array_size_);
   }
 
@@ -308,17 +311,17 @@ pcl::BOARDLocalReferenceFrameEstimation<PointInT, PointNT, PointOutT>::computePo
       float angle = getAngleBetweenUnitVectors (x_axis, indicating_normal_vect, fitted_normal);
 
       int check_margin_array_idx = std::min (static_cast<int> (floor (angle / max_boundary_angle)), check_margin_array_size_ - 1);
-      check_margin_array_[check_margin_array_idx] = true;
+      check_margin_array[check_margin_array_idx] = true;
 
-      if (angle < margin_array_min_angle_[check_margin_array_idx])
+      if (angle < margin_array_min_angle[check_margin_array_idx])
       {
-        margin_array_min_angle_[check_margin_array_idx] = angle;
-        margin_array_min_angle_normal_[check_margin_array_idx] = normal_cos;
+        margin_array_min_angle[check_margin_array_idx] = angle;
+        margin_array_min_angle_normal[check_margin_array_idx] = normal_cos;
       }
-      if (angle > margin_array_max_angle_[check_margin_array_idx])
+      if (angle > margin_array_max_angle[check_margin_array_idx])
       {
-        margin_array_max_angle_[check_margin_array_idx] = angle;
-        margin_array_max_angle_normal_[check_margin_array_idx] = normal_cos;
+        margin_array_max_angle[check_margin_array_idx] = angle;
+        margin_array_max_angle_normal[check_margin_array_idx] = normal_cos;
       }
     }
 
@@ -402,7 +405,7 @@ pcl::BOARDLocalReferenceFrameEstimation<PointInT, PointNT, PointOutT>::computePo
   bool is_hole_present = false;
   for (int i = 0; i < check_margin_array_size_; i++)
   {
-    if (!check_margin_array_[i])
+    if (!check_margin_array[i])
     {
       is_hole_present = true;
       break;
@@ -451,7 +454,7 @@ pcl::BOARDLocalReferenceFrameEstimation<PointInT, PointNT, PointOutT>::computePo
 
   //find first no border pie
   int first_no_border = -1;
-  if (check_margin_array_[check_margin_array_size_ - 1])
+  if (check_margin_array[check_margin_array_size_ - 1])
   {
     first_no_border = 0;
   }
@@ -459,7 +462,7 @@ pcl::BOARDLocalReferenceFrameEstimation<PointInT, PointNT, PointOutT>::computePo
   {
     for (int i = 0; i < check_margin_array_size_; i++)
     {
-      if (check_margin_array_[i])
+      if (check_margin_array[i])
       {
         first_no_border = i;
         break;
@@ -473,12 +476,12 @@ pcl::BOARDLocalReferenceFrameEstimation<PointInT, PointNT, PointOutT>::computePo
   //find holes
   for (int ch = first_no_border; ch < check_margin_array_size_; ch++)
   {
-    if (!check_margin_array_[ch])
+    if (!check_margin_array[ch])
     {
       //border beginning found
       hole_first = ch;
       hole_end = hole_first + 1;
-      while (!check_margin_array_[hole_end % check_margin_array_size_])
+      while (!check_margin_array[hole_end % check_margin_array_size_])
       {
         ++hole_end;
       }
@@ -490,8 +493,8 @@ pcl::BOARDLocalReferenceFrameEstimation<PointInT, PointNT, PointOutT>::computePo
         int previous_hole = (((hole_first - 1) < 0) ? (hole_first - 1) + check_margin_array_size_ : (hole_first - 1))
             % check_margin_array_size_;
         int following_hole = (hole_end) % check_margin_array_size_;
-        float normal_begin = margin_array_max_angle_normal_[previous_hole];
-        float normal_end = margin_array_min_angle_normal_[following_hole];
+        float normal_begin = margin_array_max_angle_normal[previous_hole];
+        float normal_end = margin_array_min_angle_normal[following_hole];
         normal_begin -= min_normal_cos;
         normal_end -= min_normal_cos;
         normal_begin = normal_begin / (1.0f - min_normal_cos);
@@ -503,12 +506,12 @@ pcl::BOARDLocalReferenceFrameEstimation<PointInT, PointNT, PointOutT>::computePo
         float hole_width = 0.0f;
         if (following_hole < previous_hole)
         {
-          hole_width = margin_array_min_angle_[following_hole] + 2 * static_cast<float> (M_PI)
-              - margin_array_max_angle_[previous_hole];
+          hole_width = margin_array_min_angle[following_hole] + 2 * static_cast<float> (M_PI)
+              - margin_array_max_angle[previous_hole];
         }
         else
         {
-          hole_width = margin_array_min_angle_[following_hole] - margin_array_max_angle_[previous_hole];
+          hole_width = margin_array_min_angle[following_hole] - margin_array_max_angle[previous_hole];
         }
         float hole_prob = hole_width / (2 * static_cast<float> (M_PI));
 
@@ -528,13 +531,13 @@ pcl::BOARDLocalReferenceFrameEstimation<PointInT, PointNT, PointOutT>::computePo
               float angle_weight = ((normal_end - normal_begin) + 1.0f) / 2.0f;
               if (following_hole < previous_hole)
               {
-                angle = margin_array_max_angle_[previous_hole] + (margin_array_min_angle_[following_hole] + 2
-                    * static_cast<float> (M_PI) - margin_array_max_angle_[previous_hole]) * angle_weight;
+                angle = margin_array_max_angle[previous_hole] + (margin_array_min_angle[following_hole] + 2
+                    * static_cast<float> (M_PI) - margin_array_max_angle[previous_hole]) * angle_weight;
               }
               else
               {
-                angle = margin_array_max_angle_[previous_hole] + (margin_array_min_angle_[following_hole]
-                    - margin_array_max_angle_[previous_hole]) * angle_weight;
+                angle = margin_array_max_angle[previous_hole] + (margin_array_min_angle[following_hole]
+                    - margin_array_max_angle[previous_hole]) * angle_weight;
               }
             }
           }
@@ -604,8 +607,13 @@ pcl::BOARDLocalReferenceFrameEstimation<PointInT, PointNT, PointOutT>::computeFe
     return;
   }
 
-  this->resetData ();
-  for (size_t point_idx = 0; point_idx < indices_->size (); ++point_idx)
+  bool is_dense = true;
+
+#ifdef _OPENMP
+#pragma omp parallel for shared (output) reduction (&& : is_dense) schedule(dynamic, 64) \
+  num_threads(find_holes_ ? 1 : this->getComputeThreads ())
+#endif
+  for (int point_idx = 0; point_idx < static_cast<int> (indices_->size ()); ++point_idx)
   {
     Eigen::Matrix3f currentLrf;
     PointOutT &rf = output[point_idx];
@@ -614,7 +622,7 @@ pcl::BOARDLocalReferenceFrameEstimation<PointInT, PointNT, PointOutT>::computeFe
     //if (rf.confidence == std::numeric_limits<float>::max ())
     if (computePointLRF ((*indices_)[point_idx], currentLrf) == std::numeric_limits<float>::max ())
     {
-      output.is_dense = false;
+      is_dense = false;
     }
 
     for (int d = 0; d < 3; ++d)
@@ -624,6 +632,7 @@ pcl::BOARDLocalReferenceFrameEstimation<PointInT, PointNT, PointOutT>::computeFe
       rf.z_axis[d] = currentLrf (2, d);
     }
   }
+  output.is_dense = output.is_dense && is_dense;
 }
 
 #define PCL_INSTANTIATE_BOARDLocalReferenceFrameEstimation(T,NT,OutT) template class PCL_EXPORTS pcl::BOARDLocalReferenceFrameEstimation<T,NT,OutT>;
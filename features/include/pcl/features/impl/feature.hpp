@@ -145,8 +145,8 @@ pcl::Feature<PointInT, PointOutT>::initCompute ()
       // Declare the search locator definition
       int (KdTree::*radiusSearchSurface)(const PointCloudIn &cloud, int index, double radius,
                                          std::vector<int> &k_indices, std::vector<float> &k_distances,
-                                         unsigned int max_nn) const = &pcl::search::Search<PointInT>::radiusSearch;
-      search_method_surface_ = boost::bind (radiusSearchSurface, boost::ref (tree_), _1, _2, _3, _4, _5, 0);
+                                         SearchContext &context, unsigned int max_nn) const = &pcl::search::Search<PointInT>::radiusSearch;
+      search_method_surface_ = boost::bind (radiusSearchSurface, boost::ref (tree_), _1, _2, _3, _4, _5, _6, 0);
     }
   }
   else
@@ -156,8 +156,8 @@ pcl::Feature<PointInT, PointOutT>::initCompute ()
       search_parameter_ = k_;
       // Declare the search locator definition
       int (KdTree::*nearestKSearchSurface)(const PointCloudIn &cloud, int index, int k, std::vector<int> &k_indices,
-                                           std::vector<float> &k_distances) const = &KdTree::nearestKSearch;
-      search_method_surface_ = boost::bind (nearestKSearchSurface, boost::ref (tree_), _1, _2, _3, _4, _5);
+                                           std::vector<float> &k_distances, SearchContext &context) const = &KdTree::nearestKSearch;
+      search_method_surface_ = boost::bind (nearestKSearchSurface, boost::ref (tree_), _1, _2, _3, _4, _5, _6);
     }
     else
     {
@@ -168,6 +168,13 @@ pcl::Feature<PointInT, PointOutT>::initCompute ()
       return (false);
     }
   }
+
+  // One set of search buffers per thread, kept across calls to compute ()
+#ifdef _OPENMP
+  search_contexts_.resize (std::max (omp_get_max_threads (), getComputeThreads ()));
+#else
+  search_contexts_.resize (1);
+#endif
   return (true);
 }
 
@@ -181,6 +188,13 @@ pcl::Feature<PointInT, PointOutT>::deinitCompute ()
     surface_.reset ();
     fake_surface_ = false;
   }
+
+  // Restore the indices given by the user
+  if (unordered_indices_)
+  {
+    indices_ = unordered_indices_;
+    unordered_indices_.reset ();
+  }
   return (true);
 }
 
@@ -195,6 +209,17 @@ pcl::Feature<PointInT, PointOutT>::compute (PointCloudOut &output)
     return;
   }
 
+  // Process the query points along a space-filling curve. This is done once all the checks of initCompute ()
+  // passed, so that the indices of the user are always restored below.
+  if (spatial_order_ != NO_SPATIAL_ORDER && supportsSpatialOrder ())
+  {
+    computeSpatialOrder (*input_, *indices_, spatial_order_, query_order_);
+    unordered_indices_ = indices_;
+    indices_.reset (new std::vector<int> (query_order_.size ()));
+    for (size_t i = 0; i < query_order_.size (); ++i)
+      (*indices_)[i] = (*unordered_indices_)[query_order_[i]];
+  }
+
   // Copy the header
   output.header = input_->header;
 
@@ -219,6 +244,15 @@ pcl::Feature<PointInT, PointOutT>::compute (PointCloudOut &output)
   // Perform the actual feature computation
   computeFeature (output);
 
+  // Put the results back in the order of the indices
+  if (unordered_indices_ && output.points.size () == query_order_.size ())
+  {
+    typename PointCloudOut::VectorType points (output.points.size ());
+    for (size_t i = 0; i < query_order_.size (); ++i)
+      points[query_order_[i]] = output.points[i];
+    output.points.swap (points);
+  }
+
   deinitCompute ();
 }
 
@@ -44,6 +44,294 @@
 #include <pcl/features/fpfh.h>
 #include <pcl/features/pfh_tools.h>
 
+#if defined (__AVX__)
+#include <immintrin.h>
+#elif defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace pcl
+{
+  namespace detail
+  {
+    /* pairFeatures computes the features f1, f2, f3 and f4 of the pairs made of the point p with normal n and
+     * count other points, the same way as pcl::computePairFeatures. The coordinates and normals of the other
+     * points are stored channel by channel (x, y, z, normal_x, normal_y, normal_z, channel c of the i-th point
+     * at c * stride + i), and so are the four features. All the features of a pair for which
+     * pcl::computePairFeatures fails are 0, in particular f4. The dot products are summed in the order of the
+     * vectorized Eigen::Vector4f::dot, (x + z) + y, since the choice of the source point of a pair with
+     * (almost) parallel normals depends on their last bit. The vectorized versions evaluate atan2 with a
+     * polynomial (Abramowitz and Stegun 4.4.49), whose error of 2e-8 is below the float resolution. */
+
+    inline void
+    pairFeaturesStandard (const float *p, const float *n, const float *points, int stride,
+                          int i, int count, float *features)
+    {
+      for (; i < count; ++i)
+      {
+        float dx = points[i] - p[0];
+        float dy = points[stride + i] - p[1];
+        float dz = points[2 * stride + i] - p[2];
+        const float f4 = std::sqrt (dx * dx + dz * dz + dy * dy);
+
+        float n1x = n[0], n1y = n[1], n1z = n[2];
+        float n2x = points[3 * stride + i], n2y = points[4 * stride + i], n2z = points[5 * stride + i];
+        const float angle1 = (n1x * dx + n1z * dz + n1y * dy) / f4;
+        const float angle2 = (n2x * dx + n2z * dz + n2y * dy) / f4;
+        float f3 = angle1;
+        // Make sure the same point is selected as 1 and 2 for each pair
+        if (std::acos (std::fabs (angle1)) > std::acos (std::fabs (angle2)))
+        {
+          std::swap (n1x, n2x); std::swap (n1y, n2y); std::swap (n1z, n2z);
+          dx = -dx; dy = -dy; dz = -dz;
+          f3 = -angle2;
+        }
+
+        // Darboux frame u = n1, v = dp x u / |dp x u|, w = u x v. A zero distance gives a zero v as well.
+        float vx = dy * n1z - dz * n1y;
+        float vy = dz * n1x - dx * n1z;
+        float vz = dx * n1y - dy * n1x;
+        const float v_norm = std::sqrt (vx * vx + vz * vz + vy * vy);
+        if (v_norm == 0.0f)
+        {
+          features[i] = features[stride + i] = features[2 * stride + i] = features[3 * stride + i] = 0.0f;
+          continue;
+        }
+        vx /= v_norm; vy /= v_norm; vz /= v_norm;
+        const float wx = n1y * vz - n1z * vy;
+        const float wy = n1z * vx - n1x * vz;
+        const float wz = n1x * vy - n1y * vx;
+
+        features[i]              = atan2f (wx * n2x + wz * n2z + wy * n2y, n1x * n2x + n1z * n2z + n1y * n2y);
+        features[stride + i]     = vx * n2x + vz * n2z + vy * n2y;
+        features[2 * stride + i] = f3;
+        features[3 * stride + i] = f4;
+      }
+    }
+
+#if defined (__SSE2__)
+    inline __m128
+    dotSSE (__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz)
+    {
+      return (_mm_add_ps (_mm_add_ps (_mm_mul_ps (ax, bx), _mm_mul_ps (az, bz)), _mm_mul_ps (ay, by)));
+    }
+
+    inline __m128
+    atan2SSE (__m128 y, __m128 x)
+    {
+      const __m128 sign_mask = _mm_set1_ps (-0.0f);
+      const __m128 abs_x = _mm_andnot_ps (sign_mask, x);
+      const __m128 abs_y = _mm_andnot_ps (sign_mask, y);
+      const __m128 den = _mm_max_ps (abs_x, abs_y);
+      // atan of the ratio in [0, 1], 0 for x = y = 0
+      const __m128 a = _mm_and_ps (_mm_div_ps (_mm_min_ps (abs_x, abs_y), den), _mm_cmpneq_ps (den, _mm_setzero_ps ()));
+      const __m128 s = _mm_mul_ps (a, a);
+      __m128 r = _mm_set1_ps (0.0028662257f);
+      r = _mm_add_ps (_mm_mul_ps (r, s), _mm_set1_ps (-0.0161657367f));
+      r = _mm_add_ps (_mm_mul_ps (r, s), _mm_set1_ps (0.0429096138f));
+      r = _mm_add_ps (_mm_mul_ps (r, s), _mm_set1_ps (-0.0752896400f));
+      r = _mm_add_ps (_mm_mul_ps (r, s), _mm_set1_ps (0.1065626393f));
+      r = _mm_add_ps (_mm_mul_ps (r, s), _mm_set1_ps (-0.1420889944f));
+      r = _mm_add_ps (_mm_mul_ps (r, s), _mm_set1_ps (0.1999355085f));
+      r = _mm_add_ps (_mm_mul_ps (r, s), _mm_set1_ps (-0.3333314528f));
+      r = _mm_add_ps (_mm_mul_ps (_mm_mul_ps (r, s), a), a);
+      // Back to the full circle: mirror at pi/4, at pi/2 and at 0
+      const __m128 swapped = _mm_cmpgt_ps (abs_y, abs_x);
+      r = _mm_or_ps (_mm_andnot_ps (swapped, r),
+                     _mm_and_ps (swapped, _mm_sub_ps (_mm_set1_ps (static_cast<float> (M_PI / 2)), r)));
+      const __m128 negative_x = _mm_cmplt_ps (x, _mm_setzero_ps ());
+      r = _mm_or_ps (_mm_andnot_ps (negative_x, r),
+                     _mm_and_ps (negative_x, _mm_sub_ps (_mm_set1_ps (static_cast<float> (M_PI)), r)));
+      r = _mm_or_ps (r, _mm_and_ps (sign_mask, y));
+      // NaN in, NaN out
+      return (_mm_or_ps (r, _mm_cmpunord_ps (x, y)));
+    }
+
+    inline void
+    pairFeaturesSSE (const float *p, const float *n, const float *points, int stride,
+                     int i, int count, float *features)
+    {
+      const __m128 sign_mask = _mm_set1_ps (-0.0f);
+      const float acos_resolution = 4e-7f;
+      const __m128 px = _mm_set1_ps (p[0]), py = _mm_set1_ps (p[1]), pz = _mm_set1_ps (p[2]);
+      const __m128 nx = _mm_set1_ps (n[0]), ny = _mm_set1_ps (n[1]), nz = _mm_set1_ps (n[2]);
+      for (; i + 4 <= count; i += 4)
+      {
+        __m128 dx = _mm_sub_ps (_mm_loadu_ps (points + i), px);
+        __m128 dy = _mm_sub_ps (_mm_loadu_ps (points + stride + i), py);
+        __m128 dz = _mm_sub_ps (_mm_loadu_ps (points + 2 * stride + i), pz);
+        const __m128 f4 = _mm_sqrt_ps (dotSSE (dx, dy, dz, dx, dy, dz));
+        const __m128 mx = _mm_loadu_ps (points + 3 * stride + i);
+        const __m128 my = _mm_loadu_ps (points + 4 * stride + i);
+        const __m128 mz = _mm_loadu_ps (points + 5 * stride + i);
+        const __m128 angle1 = _mm_div_ps (dotSSE (nx, ny, nz, dx, dy, dz), f4);
+        const __m128 angle2 = _mm_div_ps (dotSSE (mx, my, mz, dx, dy, dz), f4);
+
+        // Make sure the same point is selected as 1 and 2 for each pair. The angles are compared directly instead
+        // of their acos, which may round to the same value, so the pairs closer than that are redone below.
+        const __m128 abs_angle1 = _mm_andnot_ps (sign_mask, angle1);
+        const __m128 abs_angle2 = _mm_andnot_ps (sign_mask, angle2);
+        const __m128 swap = _mm_cmplt_ps (abs_angle1, abs_angle2);
+        const int ties = _mm_movemask_ps (_mm_cmplt_ps (_mm_andnot_ps (sign_mask, _mm_sub_ps (abs_angle1, abs_angle2)),
+                                                        _mm_set1_ps (acos_resolution)));
+        const __m128 n1x = _mm_or_ps (_mm_andnot_ps (swap, nx), _mm_and_ps (swap, mx));
+        const __m128 n1y = _mm_or_ps (_mm_andnot_ps (swap, ny), _mm_and_ps (swap, my));
+        const __m128 n1z = _mm_or_ps (_mm_andnot_ps (swap, nz), _mm_and_ps (swap, mz));
+        const __m128 n2x = _mm_or_ps (_mm_andnot_ps (swap, mx), _mm_and_ps (swap, nx));
+        const __m128 n2y = _mm_or_ps (_mm_andnot_ps (swap, my), _mm_and_ps (swap, ny));
+        const __m128 n2z = _mm_or_ps (_mm_andnot_ps (swap, mz), _mm_and_ps (swap, nz));
+        const __m128 flip = _mm_and_ps (swap, sign_mask);
+        dx = _mm_xor_ps (dx, flip);
+        dy = _mm_xor_ps (dy, flip);
+        dz = _mm_xor_ps (dz, flip);
+        const __m128 f3 = _mm_or_ps (_mm_andnot_ps (swap, angle1), _mm_and_ps (swap, _mm_xor_ps (angle2, sign_mask)));
+
+        // Darboux frame u = n1, v = dp x u / |dp x u|, w = u x v
+        __m128 vx = _mm_sub_ps (_mm_mul_ps (dy, n1z), _mm_mul_ps (dz, n1y));
+        __m128 vy = _mm_sub_ps (_mm_mul_ps (dz, n1x), _mm_mul_ps (dx, n1z));
+        __m128 vz = _mm_sub_ps (_mm_mul_ps (dx, n1y), _mm_mul_ps (dy, n1x));
+        const __m128 v_norm = _mm_sqrt_ps (dotSSE (vx, vy, vz, vx, vy, vz));
+        const __m128 valid = _mm_cmpneq_ps (v_norm, _mm_setzero_ps ());
+        vx = _mm_div_ps (vx, v_norm);
+        vy = _mm_div_ps (vy, v_norm);
+        vz = _mm_div_ps (vz, v_norm);
+        const __m128 wx = _mm_sub_ps (_mm_mul_ps (n1y, vz), _mm_mul_ps (n1z, vy));
+        const __m128 wy = _mm_sub_ps (_mm_mul_ps (n1z, vx), _mm_mul_ps (n1x, vz));
+        const __m128 wz = _mm_sub_ps (_mm_mul_ps (n1x, vy), _mm_mul_ps (n1y, vx));
+
+        const __m128 f1 = atan2SSE (dotSSE (wx, wy, wz, n2x, n2y, n2z),
+                                    dotSSE (n1x, n1y, n1z, n2x, n2y, n2z));
+        const __m128 f2 = dotSSE (vx, vy, vz, n2x, n2y, n2z);
+        _mm_storeu_ps (features + i, _mm_and_ps (valid, f1));
+        _mm_storeu_ps (features + stride + i, _mm_and_ps (valid, f2));
+        _mm_storeu_ps (features + 2 * stride + i, _mm_and_ps (valid, f3));
+        _mm_storeu_ps (features + 3 * stride + i, _mm_and_ps (valid, f4));
+        for (int k = 0; ties != 0 && k < 4; ++k)
+          if ((ties >> k) & 1)
+            pairFeaturesStandard (p, n, points, stride, i + k, i + k + 1, features);
+      }
+      pairFeaturesStandard (p, n, points, stride, i, count, features);
+    }
+#endif
+
+#if defined (__AVX__)
+    inline __m256
+    dotAVX (__m256 ax, __m256 ay, __m256 az, __m256 bx, __m256 by, __m256 bz)
+    {
+      return (_mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (ax, bx), _mm256_mul_ps (az, bz)), _mm256_mul_ps (ay, by)));
+    }
+
+    inline __m256
+    atan2AVX (__m256 y, __m256 x)
+    {
+      const __m256 sign_mask = _mm256_set1_ps (-0.0f);
+      const __m256 abs_x = _mm256_andnot_ps (sign_mask, x);
+      const __m256 abs_y = _mm256_andnot_ps (sign_mask, y);
+      const __m256 den = _mm256_max_ps (abs_x, abs_y);
+      // atan of the ratio in [0, 1], 0 for x = y = 0
+      const __m256 a = _mm256_and_ps (_mm256_div_ps (_mm256_min_ps (abs_x, abs_y), den),
+                                      _mm256_cmp_ps (den, _mm256_setzero_ps (), _CMP_NEQ_UQ));
+      const __m256 s = _mm256_mul_ps (a, a);
+      __m256 r = _mm256_set1_ps (0.0028662257f);
+      r = _mm256_add_ps (_mm256_mul_ps (r, s), _mm256_set1_ps (-0.0161657367f));
+      r = _mm256_add_ps (_mm256_mul_ps (r, s), _mm256_set1_ps (0.0429096138f));
+      r = _mm256_add_ps (_mm256_mul_ps (r, s), _mm256_set1_ps (-0.0752896400f));
+      r = _mm256_add_ps (_mm256_mul_ps (r, s), _mm256_set1_ps (0.1065626393f));
+      r = _mm256_add_ps (_mm256_mul_ps (r, s), _mm256_set1_ps (-0.1420889944f));
+      r = _mm256_add_ps (_mm256_mul_ps (r, s), _mm256_set1_ps (0.1999355085f));
+      r = _mm256_add_ps (_mm256_mul_ps (r, s), _mm256_set1_ps (-0.3333314528f));
+      r = _mm256_add_ps (_mm256_mul_ps (_mm256_mul_ps (r, s), a), a);
+      // Back to the full circle: mirror at pi/4, at pi/2 and at 0
+      r = _mm256_blendv_ps (r, _mm256_sub_ps (_mm256_set1_ps (static_cast<float> (M_PI / 2)), r),
+                            _mm256_cmp_ps (abs_y, abs_x, _CMP_GT_OQ));
+      r = _mm256_blendv_ps (r, _mm256_sub_ps (_mm256_set1_ps (static_cast<float> (M_PI)), r),
+                            _mm256_cmp_ps (x, _mm256_setzero_ps (), _CMP_LT_OQ));
+      r = _mm256_or_ps (r, _mm256_and_ps (sign_mask, y));
+      // NaN in, NaN out
+      return (_mm256_or_ps (r, _mm256_cmp_ps (x, y, _CMP_UNORD_Q)));
+    }
+
+    inline void
+    pairFeaturesAVX (const float *p, const float *n, const float *points, int stride,
+                     int i, int count, float *features)
+    {
+      const __m256 sign_mask = _mm256_set1_ps (-0.0f);
+      const float acos_resolution = 4e-7f;
+      const __m256 px = _mm256_set1_ps (p[0]), py = _mm256_set1_ps (p[1]), pz = _mm256_set1_ps (p[2]);
+      const __m256 nx = _mm256_set1_ps (n[0]), ny = _mm256_set1_ps (n[1]), nz = _mm256_set1_ps (n[2]);
+      for (; i + 8 <= count; i += 8)
+      {
+        __m256 dx = _mm256_sub_ps (_mm256_loadu_ps (points + i), px);
+        __m256 dy = _mm256_sub_ps (_mm256_loadu_ps (points + stride + i), py);
+        __m256 dz = _mm256_sub_ps (_mm256_loadu_ps (points + 2 * stride + i), pz);
+        const __m256 f4 = _mm256_sqrt_ps (dotAVX (dx, dy, dz, dx, dy, dz));
+        const __m256 mx = _mm256_loadu_ps (points + 3 * stride + i);
+        const __m256 my = _mm256_loadu_ps (points + 4 * stride + i);
+        const __m256 mz = _mm256_loadu_ps (points + 5 * stride + i);
+        const __m256 angle1 = _mm256_div_ps (dotAVX (nx, ny, nz, dx, dy, dz), f4);
+        const __m256 angle2 = _mm256_div_ps (dotAVX (mx, my, mz, dx, dy, dz), f4);
+
+        // Make sure the same point is selected as 1 and 2 for each pair. The angles are compared directly instead
+        // of their acos, which may round to the same value, so the pairs closer than that are redone below.
+        const __m256 abs_angle1 = _mm256_andnot_ps (sign_mask, angle1);
+        const __m256 abs_angle2 = _mm256_andnot_ps (sign_mask, angle2);
+        const __m256 swap = _mm256_cmp_ps (abs_angle1, abs_angle2, _CMP_LT_OQ);
+        const int ties = _mm256_movemask_ps (_mm256_cmp_ps (_mm256_andnot_ps (sign_mask, _mm256_sub_ps (abs_angle1, abs_angle2)),
+                                                            _mm256_set1_ps (acos_resolution), _CMP_LT_OQ));
+        const __m256 n1x = _mm256_blendv_ps (nx, mx, swap);
+        const __m256 n1y = _mm256_blendv_ps (ny, my, swap);
+        const __m256 n1z = _mm256_blendv_ps (nz, mz, swap);
+        const __m256 n2x = _mm256_blendv_ps (mx, nx, swap);
+        const __m256 n2y = _mm256_blendv_ps (my, ny, swap);
+        const __m256 n2z = _mm256_blendv_ps (mz, nz, swap);
+        const __m256 flip = _mm256_and_ps (swap, sign_mask);
+        dx = _mm256_xor_ps (dx, flip);
+        dy = _mm256_xor_ps (dy, flip);
+        dz = _mm256_xor_ps (dz, flip);
+        const __m256 f3 = _mm256_blendv_ps (angle1, _mm256_xor_ps (angle2, sign_mask), swap);
+
+        // Darboux frame u = n1, v = dp x u / |dp x u|, w = u x v
+        __m256 vx = _mm256_sub_ps (_mm256_mul_ps (dy, n1z), _mm256_mul_ps (dz, n1y));
+        __m256 vy = _mm256_sub_ps (_mm256_mul_ps (dz, n1x), _mm256_mul_ps (dx, n1z));
+        __m256 vz = _mm256_sub_ps (_mm256_mul_ps (dx, n1y), _mm256_mul_ps (dy, n1x));
+        const __m256 v_norm = _mm256_sqrt_ps (dotAVX (vx, vy, vz, vx, vy, vz));
+        const __m256 valid = _mm256_cmp_ps (v_norm, _mm256_setzero_ps (), _CMP_NEQ_UQ);
+        vx = _mm256_div_ps (vx, v_norm);
+        vy = _mm256_div_ps (vy, v_norm);
+        vz = _mm256_div_ps (vz, v_norm);
+        const __m256 wx = _mm256_sub_ps (_mm256_mul_ps (n1y, vz), _mm256_mul_ps (n1z, vy));
+        const __m256 wy = _mm256_sub_ps (_mm256_mul_ps (n1z, vx), _mm256_mul_ps (n1x, vz));
+        const __m256 wz = _mm256_sub_ps (_mm256_mul_ps (n1x, vy), _mm256_mul_ps (n1y, vx));
+
+        const __m256 f1 = atan2AVX (dotAVX (wx, wy, wz, n2x, n2y, n2z),
+                                    dotAVX (n1x, n1y, n1z, n2x, n2y, n2z));
+        const __m256 f2 = dotAVX (vx, vy, vz, n2x, n2y, n2z);
+        _mm256_storeu_ps (features + i, _mm256_and_ps (valid, f1));
+        _mm256_storeu_ps (features + stride + i, _mm256_and_ps (valid, f2));
+        _mm256_storeu_ps (features + 2 * stride + i, _mm256_and_ps (valid, f3));
+        _mm256_storeu_ps (features + 3 * stride + i, _mm256_and_ps (valid, f4));
+        for (int k = 0; ties != 0 && k < 8; ++k)
+          if ((ties >> k) & 1)
+            pairFeaturesStandard (p, n, points, stride, i + k, i + k + 1, features);
+      }
+      pairFeaturesSSE (p, n, points, stride, i, count, features);
+    }
+#endif
+
+    inline void
+    pairFeatures (const float *p, const float *n, const float *points, int stride, int count, float *features)
+    {
+#if defined (__AVX__)
+      pairFeaturesAVX (p, n, points, stride, 0, count, features);
+#elif defined (__SSE2__)
+      pairFeaturesSSE (p, n, points, stride, 0, count, features);
+#else
+      pairFeaturesStandard (p, n, points, stride, 0, count, features);
+#endif
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointNT, typename PointOutT> bool
 pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::computePairFeatures (
@@ -229,10 +517,214 @@ pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::computeSPFHSignatures (std::v
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> bool
+pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::computeFeatureApproximate (PointCloudOut &output)
+{
+  // The FPFH signatures can be accumulated from the neighborhood of every SPFH point (instead of the neighborhood of
+  // every FPFH point) only if the two are the same points and the neighborhoods are symmetric
+  if (search_radius_ == 0.0 || surface_ != input_ || indices_->size () != surface_->points.size ())
+    return (false);
+
+  // The position of every point in the output
+  const int nr_points = static_cast<int> (indices_->size ());
+  std::vector<int> slots (nr_points, -1);
+  for (int idx = 0; idx < nr_points; ++idx)
+  {
+    if (slots[(*indices_)[idx]] != -1)
+      return (false);
+    slots[(*indices_)[idx]] = idx;
+  }
+
+  const int nr_bins = nr_bins_f1_ + nr_bins_f2_ + nr_bins_f3_;
+  const int nr_threads = this->getComputeThreads ();
+  const int tile_size = (std::max) (tile_size_, 1);
+
+  // The FPFH signatures are accumulated in the output, unnormalized
+  std::vector<unsigned char> valid (nr_points, 0);
+  for (int idx = 0; idx < nr_points; ++idx)
+    for (int d = 0; d < nr_bins; ++d)
+      output.points[idx].histogram[d] = 0.0f;
+
+  std::vector<int> tile_indices, tile_slots;
+  std::vector<size_t> nn_offsets;
+  std::vector<int> nn_indices;
+  std::vector<float> nn_dists;
+  std::vector<float> tile_spfh;
+  std::vector<float> neighbors, features;
+  std::vector<size_t> bucket_offsets, bucket_ends, bucket_entries;
+  std::vector<int> bucket_rows;
+
+  const unsigned int search_threads = tree_->getNumberOfThreads ();
+  tree_->setNumberOfThreads (nr_threads);
+  for (int begin = 0; begin < nr_points; begin += tile_size)
+  {
+    const int end = (std::min) (begin + tile_size, nr_points);
+    tile_indices.clear ();
+    tile_slots.clear ();
+    for (int idx = begin; idx < end; ++idx)
+    {
+      if (!isFinite ((*input_)[(*indices_)[idx]]))
+        continue;
+      tile_indices.push_back ((*indices_)[idx]);
+      tile_slots.push_back (idx);
+    }
+    if (tile_indices.empty ())
+      continue;
+    const int tile_count = static_cast<int> (tile_indices.size ());
+
+    // One search for the whole tile, in compressed sparse row layout
+    tree_->batchRadiusSearch (*surface_, tile_indices, search_radius_, nn_offsets, nn_indices, nn_dists);
+
+    // The SPFH signatures of the tile points, one row of nr_bins values per point
+    tile_spfh.assign (static_cast<size_t> (tile_count) * nr_bins, 0.0f);
+#ifdef _OPENMP
+#pragma omp parallel for private (neighbors, features) schedule(dynamic, 64) num_threads(nr_threads)
+#endif
+    for (int t = 0; t < tile_count; ++t)
+    {
+      const int p_idx = tile_indices[t];
+      const size_t nn_begin = nn_offsets[t];
+      const size_t nn_count = nn_offsets[t + 1] - nn_begin;
+      if (nn_count == 0)
+        continue;
+      valid[tile_slots[t]] = 1;
+
+      // Gather the neighbors other than the point itself channel by channel
+      const int stride = static_cast<int> (nn_count);
+      neighbors.resize (6 * nn_count);
+      features.resize (4 * nn_count);
+      int count = 0;
+      for (size_t k = nn_begin; k < nn_begin + nn_count; ++k)
+      {
+        const int q_idx = nn_indices[k];
+        if (q_idx == p_idx)
+          continue;
+        const PointInT &q = surface_->points[q_idx];
+        const PointNT &m = normals_->points[q_idx];
+        neighbors[count]              = q.x;
+        neighbors[stride + count]     = q.y;
+        neighbors[2 * stride + count] = q.z;
+        neighbors[3 * stride + count] = m.normal_x;
+        neighbors[4 * stride + count] = m.normal_y;
+        neighbors[5 * stride + count] = m.normal_z;
+        ++count;
+      }
+      const PointInT &p = surface_->points[p_idx];
+      const PointNT &n = normals_->points[p_idx];
+      const float p_xyz[3] = { p.x, p.y, p.z };
+      const float n_xyz[3] = { n.normal_x, n.normal_y, n.normal_z };
+      detail::pairFeatures (p_xyz, n_xyz, &neighbors[0], stride, count, &features[0]);
+
+      // Same binning as in computePointSPFHSignature
+      float *hist = &tile_spfh[static_cast<size_t> (t) * nr_bins];
+      const float hist_incr = 100.0f / static_cast<float>(nn_count - 1);
+      for (int i = 0; i < count; ++i)
+      {
+        // The pairs for which the features are undefined (all 0) are binned too, as FPFHEstimation::computePairFeatures
+        // always succeeds
+        int h_index = static_cast<int> (floor (nr_bins_f1_ * ((features[i] + M_PI) * d_pi_)));
+        if (h_index < 0)            h_index = 0;
+        if (h_index >= nr_bins_f1_) h_index = nr_bins_f1_ - 1;
+        hist[h_index] += hist_incr;
+
+        h_index = static_cast<int> (floor (nr_bins_f2_ * ((features[stride + i] + 1.0) * 0.5)));
+        if (h_index < 0)            h_index = 0;
+        if (h_index >= nr_bins_f2_) h_index = nr_bins_f2_ - 1;
+        hist[nr_bins_f1_ + h_index] += hist_incr;
+
+        h_index = static_cast<int> (floor (nr_bins_f3_ * ((features[2 * stride + i] + 1.0) * 0.5)));
+        if (h_index < 0)            h_index = 0;
+        if (h_index >= nr_bins_f3_) h_index = nr_bins_f3_ - 1;
+        hist[nr_bins_f1_ + nr_bins_f2_ + h_index] += hist_incr;
+      }
+    }
+
+    // Add the weighted SPFH signatures to the FPFH signatures of the neighbors. Every thread owns a range of the
+    // output, and the neighbors of the tile are first bucketed by owner, keeping their order, so that every thread only
+    // visits its own entries and the signatures are summed in the same order whatever the number of threads. The
+    // owner of the slot s is the block b with nr_points * b / nr_threads <= s < nr_points * (b + 1) / nr_threads.
+    bucket_offsets.assign (nr_threads + 1, 0);
+    for (size_t k = 0; k < nn_indices.size (); ++k)
+    {
+      // Minus the query point itself
+      if (nn_dists[k] == 0)
+        continue;
+      const long long slot = slots[nn_indices[k]];
+      ++bucket_offsets[static_cast<int> (((slot + 1) * nr_threads - 1) / nr_points) + 1];
+    }
+    for (int block = 0; block < nr_threads; ++block)
+      bucket_offsets[block + 1] += bucket_offsets[block];
+    bucket_rows.resize (bucket_offsets[nr_threads]);
+    bucket_entries.resize (bucket_offsets[nr_threads]);
+    bucket_ends.assign (bucket_offsets.begin (), bucket_offsets.end () - 1);
+    for (int t = 0; t < tile_count; ++t)
+    {
+      for (size_t k = nn_offsets[t]; k < nn_offsets[t + 1]; ++k)
+      {
+        if (nn_dists[k] == 0)
+          continue;
+        const long long slot = slots[nn_indices[k]];
+        const size_t e = bucket_ends[static_cast<int> (((slot + 1) * nr_threads - 1) / nr_points)]++;
+        bucket_rows[e] = t;
+        bucket_entries[e] = k;
+      }
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nr_threads)
+#endif
+    for (int block = 0; block < nr_threads; ++block)
+    {
+      for (size_t e = bucket_offsets[block]; e < bucket_offsets[block + 1]; ++e)
+      {
+        const float *spfh = &tile_spfh[static_cast<size_t> (bucket_rows[e]) * nr_bins];
+        const size_t k = bucket_entries[e];
+        const int slot = slots[nn_indices[k]];
+        const float weight = 1.0f / nn_dists[k];
+        for (int d = 0; d < nr_bins; ++d)
+          output.points[slot].histogram[d] += spfh[d] * weight;
+      }
+    }
+  }
+  tree_->setNumberOfThreads (search_threads);
+
+  // Normalize the histograms of the three features to sum up to 100
+  output.is_dense = true;
+  for (int idx = 0; idx < nr_points; ++idx)
+  {
+    if (!valid[idx])
+    {
+      for (int d = 0; d < nr_bins; ++d)
+        output.points[idx].histogram[d] = std::numeric_limits<float>::quiet_NaN ();
+      output.is_dense = false;
+      continue;
+    }
+
+    int first_bin = 0;
+    const int nr_feature_bins[3] = { nr_bins_f1_, nr_bins_f2_, nr_bins_f3_ };
+    for (int f = 0; f < 3; ++f)
+    {
+      double sum = 0.0;
+      for (int d = first_bin; d < first_bin + nr_feature_bins[f]; ++d)
+        sum += output.points[idx].histogram[d];
+      if (sum != 0)
+        sum = 100.0 / sum;
+      for (int d = first_bin; d < first_bin + nr_feature_bins[f]; ++d)
+        output.points[idx].histogram[d] *= static_cast<float> (sum);
+      first_bin += nr_feature_bins[f];
+    }
+  }
+  return (true);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointNT, typename PointOutT> void
 pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
 {
+  if (approximate_ && computeFeatureApproximate (output))
+    return;
+
   // Allocate enough space to hold the NN search results
   // \note This resize is irrelevant for a radiusSearch ().
   std::vector<int> nn_indices (k_);
@@ -47,6 +47,9 @@
 template <typename PointInT, typename PointNT, typename PointOutT> void
 pcl::FPFHEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
 {
+  if (this->approximate_ && this->computeFeatureApproximate (output))
+    return;
+
   std::vector<int> spfh_indices_vec;
   std::vector<int> spfh_hist_lookup (surface_->points.size ());
 
@@ -41,6 +41,199 @@
 #define PCL_INTEGRAL_IMAGE2D_IMPL_H_
 
 #include <cstddef>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined (__AVX__)
+#include <immintrin.h>
+#elif defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace pcl
+{
+  namespace detail
+  {
+    /* Below are the row kernels of the integral images. addRow adds a row of a plane to the next one (the
+     * vertical pass of the integral image computation), boxSums evaluates the sums of count consecutive
+     * rectangles of the same width from the rows of a plane the rectangles start and end at:
+     *
+     *   sums[i] = lower[i + width] + upper[i] - upper[i + width] - lower[i]
+     *
+     * which is the expression of the single rectangle getters, evaluated in the same order. The double
+     * planes (float input) and the finite element counts are processed with SSE2 / AVX. The remaining
+     * elements go through the scalar path. */
+
+    template <typename T> inline void
+    addRowStandard (const T *previous_row, T *row, unsigned i, unsigned size)
+    {
+      for (; i < size; ++i)
+        row[i] += previous_row[i];
+    }
+
+    template <typename T> inline void
+    boxSumsStandard (const T *upper, const T *lower, unsigned width, unsigned i, unsigned count, T *sums)
+    {
+      for (; i < count; ++i)
+        sums[i] = lower[i + width] + upper[i] - upper[i + width] - lower[i];
+    }
+
+#if defined (__SSE2__)
+    inline void
+    addRowSSE (const double *previous_row, double *row, unsigned i, unsigned size)
+    {
+      for (; i + 2 <= size; i += 2)
+        _mm_storeu_pd (row + i, _mm_add_pd (_mm_loadu_pd (row + i), _mm_loadu_pd (previous_row + i)));
+      addRowStandard (previous_row, row, i, size);
+    }
+
+    inline void
+    addRowSSE (const unsigned *previous_row, unsigned *row, unsigned i, unsigned size)
+    {
+      for (; i + 4 <= size; i += 4)
+      {
+        const __m128i a = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (row + i));
+        const __m128i b = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (previous_row + i));
+        _mm_storeu_si128 (reinterpret_cast<__m128i*> (row + i), _mm_add_epi32 (a, b));
+      }
+      addRowStandard (previous_row, row, i, size);
+    }
+
+    inline void
+    boxSumsSSE (const double *upper, const double *lower, unsigned width, unsigned i, unsigned count, double *sums)
+    {
+      for (; i + 2 <= count; i += 2)
+      {
+        const __m128d sum = _mm_add_pd (_mm_loadu_pd (lower + i + width), _mm_loadu_pd (upper + i));
+        _mm_storeu_pd (sums + i, _mm_sub_pd (_mm_sub_pd (sum, _mm_loadu_pd (upper + i + width)),
+                                             _mm_loadu_pd (lower + i)));
+      }
+      boxSumsStandard (upper, lower, width, i, count, sums);
+    }
+
+    inline void
+    boxSumsSSE (const unsigned *upper, const unsigned *lower, unsigned width, unsigned i, unsigned count, unsigned *sums)
+    {
+      for (; i + 4 <= count; i += 4)
+      {
+        const __m128i lower_right = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (lower + i + width));
+        const __m128i upper_left  = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (upper + i));
+        const __m128i upper_right = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (upper + i + width));
+        const __m128i lower_left  = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (lower + i));
+        _mm_storeu_si128 (reinterpret_cast<__m128i*> (sums + i),
+                          _mm_sub_epi32 (_mm_sub_epi32 (_mm_add_epi32 (lower_right, upper_left), upper_right), lower_left));
+      }
+      boxSumsStandard (upper, lower, width, i, count, sums);
+    }
+#endif
+
+#if defined (__AVX__)
+    inline void
+    addRowAVX (const double *previous_row, double *row, unsigned i, unsigned size)
+    {
+      for (; i + 4 <= size; i += 4)
+        _mm256_storeu_pd (row + i, _mm256_add_pd (_mm256_loadu_pd (row + i), _mm256_loadu_pd (previous_row + i)));
+      addRowSSE (previous_row, row, i, size);
+    }
+
+    inline void
+    boxSumsAVX (const double *upper, const double *lower, unsigned width, unsigned i, unsigned count, double *sums)
+    {
+      for (; i + 4 <= count; i += 4)
+      {
+        const __m256d sum = _mm256_add_pd (_mm256_loadu_pd (lower + i + width), _mm256_loadu_pd (upper + i));
+        _mm256_storeu_pd (sums + i, _mm256_sub_pd (_mm256_sub_pd (sum, _mm256_loadu_pd (upper + i + width)),
+                                                   _mm256_loadu_pd (lower + i)));
+      }
+      boxSumsSSE (upper, lower, width, i, count, sums);
+    }
+#endif
+
+    template <typename T> inline void
+    addRow (const T *previous_row, T *row, unsigned size)
+    {
+      addRowStandard (previous_row, row, 0, size);
+    }
+
+    inline void
+    addRow (const double *previous_row, double *row, unsigned size)
+    {
+#if defined (__AVX__)
+      addRowAVX (previous_row, row, 0, size);
+#elif defined (__SSE2__)
+      addRowSSE (previous_row, row, 0, size);
+#else
+      addRowStandard (previous_row, row, 0, size);
+#endif
+    }
+
+    inline void
+    addRow (const unsigned *previous_row, unsigned *row, unsigned size)
+    {
+#if defined (__SSE2__)
+      addRowSSE (previous_row, row, 0, size);
+#else
+      addRowStandard (previous_row, row, 0, size);
+#endif
+    }
+
+    template <typename T> inline void
+    boxSums (const T *upper, const T *lower, unsigned width, unsigned count, T *sums)
+    {
+      boxSumsStandard (upper, lower, width, 0, count, sums);
+    }
+
+    inline void
+    boxSums (const double *upper, const double *lower, unsigned width, unsigned count, double *sums)
+    {
+#if defined (__AVX__)
+      boxSumsAVX (upper, lower, width, 0, count, sums);
+#elif defined (__SSE2__)
+      boxSumsSSE (upper, lower, width, 0, count, sums);
+#else
+      boxSumsStandard (upper, lower, width, 0, count, sums);
+#endif
+    }
+
+    inline void
+    boxSums (const unsigned *upper, const unsigned *lower, unsigned width, unsigned count, unsigned *sums)
+    {
+#if defined (__SSE2__)
+      boxSumsSSE (upper, lower, width, 0, count, sums);
+#else
+      boxSumsStandard (upper, lower, width, 0, count, sums);
+#endif
+    }
+
+    /** \brief Vertical pass of the integral image computation: accumulate the rows of nr_planes planes, which
+      * hold the prefix sums of the input rows, top to bottom. The planes are split in tiles of columns which
+      * are processed in parallel; every column is still accumulated in order, independently of the number of
+      * threads.
+      */
+    template <typename T> void
+    integrateColumns (T *planes, size_t plane_size, unsigned nr_planes, unsigned row_size, unsigned nr_rows,
+                      unsigned int threads)
+    {
+      const unsigned tile_size = 128;
+      const int nr_tiles = static_cast<int> ((row_size + tile_size - 1) / tile_size);
+#ifdef _OPENMP
+      const int nr_threads = threads == 0 ? omp_get_max_threads () : static_cast<int> (threads);
+#pragma omp parallel for num_threads(nr_threads)
+#endif
+      for (int tile = 0; tile < nr_tiles * static_cast<int> (nr_planes); ++tile)
+      {
+        const unsigned begin = static_cast<unsigned> (tile % nr_tiles) * tile_size;
+        const unsigned size = std::min (tile_size, row_size - begin);
+        T *row = planes + static_cast<size_t> (tile / nr_tiles) * plane_size + begin;
+        for (unsigned row_idx = 1; row_idx < nr_rows; ++row_idx, row += row_size)
+          addRow (row, row + row_size, size);
+      }
+    }
+  }
+}
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename DataType, unsigned Dimension> void
@@ -53,15 +246,13 @@ pcl::IntegralImage2D<DataType, Dimension>::setSecondOrderComputation (bool compu
 template <typename DataType, unsigned Dimension> void
 pcl::IntegralImage2D<DataType, Dimension>::setInput (const DataType * data, unsigned width,unsigned height, unsigned element_stride, unsigned row_stride)
 {
-  if ((width + 1) * (height + 1) > first_order_integral_image_.size () )
-  {
-    width_  = width;
-    height_ = height;
-    first_order_integral_image_.resize ( (width_ + 1) * (height_ + 1) );
-    finite_values_integral_image_.resize ( (width_ + 1) * (height_ + 1) );
-    if (compute_second_order_integral_images_)
-      second_order_integral_image_.resize ( (width_ + 1) * (height_ + 1) );
-  }
+  width_  = width;
+  height_ = height;
+  plane_size_ = static_cast<size_t> (width_ + 1) * (height_ + 1);
+  first_order_integral_image_.resize (plane_size_ * Dimension);
+  finite_values_integral_image_.resize (plane_size_);
+  if (compute_second_order_integral_images_)
+    second_order_integral_image_.resize (plane_size_ * second_order_size);
   computeIntegralImages (data, row_stride, element_stride);
 }
 
@@ -75,8 +266,11 @@ pcl::IntegralImage2D<DataType, Dimension>::getFirstOrderSum (
   const unsigned lower_left_idx      = (start_y + height) * (width_ + 1) + start_x;
   const unsigned lower_right_idx     = lower_left_idx + width;
 
-  return (first_order_integral_image_[lower_right_idx] + first_order_integral_image_[upper_left_idx]  -
-          first_order_integral_image_[upper_right_idx] - first_order_integral_image_[lower_left_idx]  );
+  ElementType sum;
+  const IntegralType *plane = &first_order_integral_image_[0];
+  for (unsigned dim = 0; dim < Dimension; ++dim, plane += plane_size_)
+    sum[dim] = plane[lower_right_idx] + plane[upper_left_idx] - plane[upper_right_idx] - plane[lower_left_idx];
+  return (sum);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -89,8 +283,11 @@ pcl::IntegralImage2D<DataType, Dimension>::getSecondOrderSum (
   const unsigned lower_left_idx      = (start_y + height) * (width_ + 1) + start_x;
   const unsigned lower_right_idx     = lower_left_idx + width;
 
-  return (second_order_integral_image_[lower_right_idx] + second_order_integral_image_[upper_left_idx]  -
-          second_order_integral_image_[upper_right_idx] - second_order_integral_image_[lower_left_idx]  );
+  SecondOrderType sum;
+  const IntegralType *plane = &second_order_integral_image_[0];
+  for (unsigned idx = 0; idx < second_order_size; ++idx, plane += plane_size_)
+    sum[idx] = plane[lower_right_idx] + plane[upper_left_idx] - plane[upper_right_idx] - plane[lower_left_idx];
+  return (sum);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -117,8 +314,11 @@ pcl::IntegralImage2D<DataType, Dimension>::getFirstOrderSumSE (
   const unsigned lower_left_idx      = end_y * (width_ + 1) + start_x;
   const unsigned lower_right_idx     = end_y * (width_ + 1) + end_x;
 
-  return (first_order_integral_image_[lower_right_idx] + first_order_integral_image_[upper_left_idx]  -
-          first_order_integral_image_[upper_right_idx] - first_order_integral_image_[lower_left_idx]  );
+  ElementType sum;
+  const IntegralType *plane = &first_order_integral_image_[0];
+  for (unsigned dim = 0; dim < Dimension; ++dim, plane += plane_size_)
+    sum[dim] = plane[lower_right_idx] + plane[upper_left_idx] - plane[upper_right_idx] - plane[lower_left_idx];
+  return (sum);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -131,8 +331,11 @@ pcl::IntegralImage2D<DataType, Dimension>::getSecondOrderSumSE (
   const unsigned lower_left_idx      = end_y * (width_ + 1) + start_x;
   const unsigned lower_right_idx     = end_y * (width_ + 1) + end_x;
 
-  return (second_order_integral_image_[lower_right_idx] + second_order_integral_image_[upper_left_idx]  -
-          second_order_integral_image_[upper_right_idx] - second_order_integral_image_[lower_left_idx]  );
+  SecondOrderType sum;
+  const IntegralType *plane = &second_order_integral_image_[0];
+  for (unsigned idx = 0; idx < second_order_size; ++idx, plane += plane_size_)
+    sum[idx] = plane[lower_right_idx] + plane[upper_left_idx] - plane[upper_right_idx] - plane[lower_left_idx];
+  return (sum);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -151,71 +354,135 @@ pcl::IntegralImage2D<DataType, Dimension>::getFiniteElementsCountSE (
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename DataType, unsigned Dimension> void
-pcl::IntegralImage2D<DataType, Dimension>::computeIntegralImages (
-    const DataType *data, unsigned row_stride, unsigned element_stride)
+pcl::IntegralImage2D<DataType, Dimension>::getFirstOrderSums (
+    unsigned start_x, unsigned start_y, unsigned width, unsigned height, unsigned count, IntegralType *sums) const
+{
+  const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
+  const unsigned lower_left_idx      = (start_y + height) * (width_ + 1) + start_x;
+
+  const IntegralType *plane = &first_order_integral_image_[0];
+  for (unsigned dim = 0; dim < Dimension; ++dim, plane += plane_size_, sums += count)
+    detail::boxSums (plane + upper_left_idx, plane + lower_left_idx, width, count, sums);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename DataType, unsigned Dimension> void
+pcl::IntegralImage2D<DataType, Dimension>::getSecondOrderSums (
+    unsigned start_x, unsigned start_y, unsigned width, unsigned height, unsigned count, IntegralType *sums) const
 {
-  ElementType* previous_row = &first_order_integral_image_[0];
-  ElementType* current_row  = previous_row + (width_ + 1);
-  memset (previous_row, 0, sizeof (ElementType) * (width_ + 1));
+  const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
+  const unsigned lower_left_idx      = (start_y + height) * (width_ + 1) + start_x;
 
-  unsigned* count_previous_row = &finite_values_integral_image_[0];
-  unsigned* count_current_row  = count_previous_row + (width_ + 1);
-  memset (count_previous_row, 0, sizeof (unsigned) * (width_ + 1));
+  const IntegralType *plane = &second_order_integral_image_[0];
+  for (unsigned idx = 0; idx < second_order_size; ++idx, plane += plane_size_, sums += count)
+    detail::boxSums (plane + upper_left_idx, plane + lower_left_idx, width, count, sums);
+}
 
-  if (!compute_second_order_integral_images_)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename DataType, unsigned Dimension> void
+pcl::IntegralImage2D<DataType, Dimension>::getFiniteElementsCounts (
+    unsigned start_x, unsigned start_y, unsigned width, unsigned height, unsigned count, unsigned *counts) const
+{
+  const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
+  const unsigned lower_left_idx      = (start_y + height) * (width_ + 1) + start_x;
+
+  detail::boxSums (&finite_values_integral_image_[upper_left_idx], &finite_values_integral_image_[lower_left_idx],
+                   width, count, counts);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename DataType, unsigned Dimension> void
+pcl::IntegralImage2D<DataType, Dimension>::computeIntegralImages (
+    const DataType *data, unsigned row_stride, unsigned element_stride)
+{
+  const unsigned row_size = width_ + 1;
+  IntegralType *first_order = &first_order_integral_image_[0];
+  IntegralType *second_order = compute_second_order_integral_images_ ? &second_order_integral_image_[0] : NULL;
+  unsigned *finite_values = &finite_values_integral_image_[0];
+
+  // the first row of the integral images is zero
+  for (unsigned dim = 0; dim < Dimension; ++dim)
+    std::fill (first_order + dim * plane_size_, first_order + dim * plane_size_ + row_size, IntegralType (0));
+  if (second_order)
+    for (unsigned idx = 0; idx < second_order_size; ++idx)
+      std::fill (second_order + idx * plane_size_, second_order + idx * plane_size_ + row_size, IntegralType (0));
+  std::fill (finite_values, finite_values + row_size, 0u);
+
+  // horizontal pass: prefix sums of every input row, written to the next row of the integral images. A
+  // single thread adds the previous row right away, while it is still in the cache, instead of running
+  // the vertical pass afterwards. Both add the same values, the result is identical.
+  int nr_threads = 1;
+#ifdef _OPENMP
+  nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+#pragma omp parallel for num_threads(nr_threads)
+#endif
+  for (int row_idx = 0; row_idx < static_cast<int> (height_); ++row_idx)
   {
-    for (unsigned rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride,
-                                                previous_row = current_row, current_row += (width_ + 1),
-                                                count_previous_row = count_current_row, count_current_row += (width_ + 1))
+    const DataType *row = data + static_cast<size_t> (row_idx) * row_stride;
+    const size_t offset = static_cast<size_t> (row_idx + 1) * row_size;
+
+    // row pointers and sizes are copied to the stack, the compiler would otherwise reload the shared
+    // variables after every store. The sums of the previous row are added right away by a single thread,
+    // otherwise the first row, which is zero, is added and the vertical pass follows.
+    const size_t plane_size = plane_size_;
+    const unsigned width = width_;
+    const size_t previous_offset = nr_threads == 1 ? offset - row_size : 0;
+    unsigned *finite_values_row = finite_values + offset;
+    const unsigned *finite_values_previous_row = finite_values + previous_offset;
+
+    // flag the finite elements first, every plane is then computed in a separate loop
+    finite_values_row[0] = 0;
+    for (unsigned colIdx = 0, valIdx = 0; colIdx < width; ++colIdx, valIdx += element_stride)
+      finite_values_row[colIdx + 1] = pcl_isfinite (reinterpret_cast <const InputType*> (&row [valIdx])->sum ());
+
+    for (unsigned dim = 0; dim < Dimension; ++dim)
     {
-      current_row [0].setZero ();
-      count_current_row [0] = 0;
-      for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
+      IntegralType *plane_row = first_order + dim * plane_size + offset;
+      const IntegralType *plane_previous_row = first_order + dim * plane_size + previous_offset;
+      IntegralType sum = 0;
+      plane_row[0] = 0;
+      for (unsigned colIdx = 0, valIdx = dim; colIdx < width; ++colIdx, valIdx += element_stride)
       {
-        current_row [colIdx + 1] = previous_row [colIdx + 1] + current_row [colIdx] - previous_row [colIdx];
-        count_current_row [colIdx + 1] = count_previous_row [colIdx + 1] + count_current_row [colIdx] - count_previous_row [colIdx];
-        const InputType* element = reinterpret_cast <const InputType*> (&data [valIdx]);
-        if (pcl_isfinite (element->sum ()))
-        {
-          current_row [colIdx + 1] += element->template cast<typename IntegralImageTypeTraits<DataType>::IntegralType>();
-          ++(count_current_row [colIdx + 1]);
-        }
+        if (finite_values_row[colIdx + 1])
+          sum += static_cast<IntegralType> (row [valIdx]);
+        plane_row[colIdx + 1] = sum + plane_previous_row[colIdx + 1];
       }
     }
-  }
-  else
-  {
-    SecondOrderType* so_previous_row = &second_order_integral_image_[0];
-    SecondOrderType* so_current_row  = so_previous_row + (width_ + 1);
-    memset (so_previous_row, 0, sizeof (SecondOrderType) * (width_ + 1));
-
-    SecondOrderType so_element;
-    for (unsigned rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride,
-                                                previous_row = current_row, current_row += (width_ + 1),
-                                                count_previous_row = count_current_row, count_current_row += (width_ + 1),
-                                                so_previous_row = so_current_row, so_current_row += (width_ + 1))
-    {
-      current_row [0].setZero ();
-      so_current_row [0].setZero ();
-      count_current_row [0] = 0;
-      for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
-      {
-        current_row [colIdx + 1] = previous_row [colIdx + 1] + current_row [colIdx] - previous_row [colIdx];
-        so_current_row [colIdx + 1] = so_previous_row [colIdx + 1] + so_current_row [colIdx] - so_previous_row [colIdx];
-        count_current_row [colIdx + 1] = count_previous_row [colIdx + 1] + count_current_row [colIdx] - count_previous_row [colIdx];
 
-        const InputType* element = reinterpret_cast <const InputType*> (&data [valIdx]);
-        if (pcl_isfinite (element->sum ()))
+    if (second_order)
+    {
+      for (unsigned myIdx = 0, elIdx = 0; myIdx < Dimension; ++myIdx)
+        for (unsigned mxIdx = myIdx; mxIdx < Dimension; ++mxIdx, ++elIdx)
         {
-          current_row [colIdx + 1] += element->template cast<typename IntegralImageTypeTraits<DataType>::IntegralType>();
-          ++(count_current_row [colIdx + 1]);
-          for (unsigned myIdx = 0, elIdx = 0; myIdx < Dimension; ++myIdx)
-            for (unsigned mxIdx = myIdx; mxIdx < Dimension; ++mxIdx, ++elIdx)
-              so_current_row [colIdx + 1][elIdx] += (*element)[myIdx] * (*element)[mxIdx];
+          IntegralType *plane_row = second_order + elIdx * plane_size + offset;
+          const IntegralType *plane_previous_row = second_order + elIdx * plane_size + previous_offset;
+          IntegralType sum = 0;
+          plane_row[0] = 0;
+          for (unsigned colIdx = 0, valIdx = 0; colIdx < width; ++colIdx, valIdx += element_stride)
+          {
+            if (finite_values_row[colIdx + 1])
+              sum += static_cast<IntegralType> (row [valIdx + myIdx]) * static_cast<IntegralType> (row [valIdx + mxIdx]);
+            plane_row[colIdx + 1] = sum + plane_previous_row[colIdx + 1];
+          }
         }
-      }
+    }
+
+    unsigned count = 0;
+    for (unsigned colIdx = 1; colIdx < row_size; ++colIdx)
+    {
+      count += finite_values_row[colIdx];
+      finite_values_row[colIdx] = count + finite_values_previous_row[colIdx];
     }
   }
+
+  // vertical pass
+  if (nr_threads != 1)
+  {
+    detail::integrateColumns (first_order, plane_size_, Dimension, row_size, height_ + 1, threads_);
+    if (second_order)
+      detail::integrateColumns (second_order, plane_size_, second_order_size, row_size, height_ + 1, threads_);
+    detail::integrateColumns (finite_values, plane_size_, 1, row_size, height_ + 1, threads_);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -223,15 +490,12 @@ pcl::IntegralImage2D<DataType, Dimension>::computeIntegralImages (
 template <typename DataType> void
 pcl::IntegralImage2D<DataType, 1>::setInput (const DataType * data, unsigned width,unsigned height, unsigned element_stride, unsigned row_stride)
 {
-  if ((width + 1) * (height + 1) > first_order_integral_image_.size () )
-  {
-    width_  = width;
-    height_ = height;
-    first_order_integral_image_.resize ( (width_ + 1) * (height_ + 1) );
-    finite_values_integral_image_.resize ( (width_ + 1) * (height_ + 1) );
-    if (compute_second_order_integral_images_)
-      second_order_integral_image_.resize ( (width_ + 1) * (height_ + 1) );
-  }
+  width_  = width;
+  height_ = height;
+  first_order_integral_image_.resize ( (width_ + 1) * (height_ + 1) );
+  finite_values_integral_image_.resize ( (width_ + 1) * (height_ + 1) );
+  if (compute_second_order_integral_images_)
+    second_order_integral_image_.resize ( (width_ + 1) * (height_ + 1) );
   computeIntegralImages (data, row_stride, element_stride);
 }
 
@@ -321,65 +585,110 @@ pcl::IntegralImage2D<DataType, 1>::getFiniteElementsCountSE (
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename DataType> void
-pcl::IntegralImage2D<DataType, 1>::computeIntegralImages (
-    const DataType *data, unsigned row_stride, unsigned element_stride)
+pcl::IntegralImage2D<DataType, 1>::getFirstOrderSums (
+    unsigned start_x, unsigned start_y, unsigned width, unsigned height, unsigned count, ElementType *sums) const
 {
-  ElementType* previous_row = &first_order_integral_image_[0];
-  ElementType* current_row  = previous_row + (width_ + 1);
-  memset (previous_row, 0, sizeof (ElementType) * (width_ + 1));
+  const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
+  const unsigned lower_left_idx      = (start_y + height) * (width_ + 1) + start_x;
+
+  detail::boxSums (&first_order_integral_image_[upper_left_idx], &first_order_integral_image_[lower_left_idx],
+                   width, count, sums);
+}
 
-  unsigned* count_previous_row = &finite_values_integral_image_[0];
-  unsigned* count_current_row  = count_previous_row + (width_ + 1);
-  memset (count_previous_row, 0, sizeof (unsigned) * (width_ + 1));
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename DataType> void
+pcl::IntegralImage2D<DataType, 1>::getSecondOrderSums (
+    unsigned start_x, unsigned start_y, unsigned width, unsigned height, unsigned count, SecondOrderType *sums) const
+{
+  const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
+  const unsigned lower_left_idx      = (start_y + height) * (width_ + 1) + start_x;
+
+  detail::boxSums (&second_order_integral_image_[upper_left_idx], &second_order_integral_image_[lower_left_idx],
+                   width, count, sums);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename DataType> void
+pcl::IntegralImage2D<DataType, 1>::getFiniteElementsCounts (
+    unsigned start_x, unsigned start_y, unsigned width, unsigned height, unsigned count, unsigned *counts) const
+{
+  const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
+  const unsigned lower_left_idx      = (start_y + height) * (width_ + 1) + start_x;
 
-  if (!compute_second_order_integral_images_)
+  detail::boxSums (&finite_values_integral_image_[upper_left_idx], &finite_values_integral_image_[lower_left_idx],
+                   width, count, counts);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename DataType> void
+pcl::IntegralImage2D<DataType, 1>::computeIntegralImages (
+    const DataType *data, unsigned row_stride, unsigned element_stride)
+{
+  const unsigned row_size = width_ + 1;
+  ElementType *first_order = &first_order_integral_image_[0];
+  SecondOrderType *second_order = compute_second_order_integral_images_ ? &second_order_integral_image_[0] : NULL;
+  unsigned *finite_values = &finite_values_integral_image_[0];
+
+  // the first row of the integral images is zero
+  std::fill (first_order, first_order + row_size, ElementType (0));
+  if (second_order)
+    std::fill (second_order, second_order + row_size, SecondOrderType (0));
+  std::fill (finite_values, finite_values + row_size, 0u);
+
+  // horizontal pass: prefix sums of every input row, written to the next row of the integral images. A
+  // single thread adds the previous row right away, while it is still in the cache, instead of running
+  // the vertical pass afterwards. Both add the same values, the result is identical.
+  int nr_threads = 1;
+#ifdef _OPENMP
+  nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+#pragma omp parallel for num_threads(nr_threads)
+#endif
+  for (int row_idx = 0; row_idx < static_cast<int> (height_); ++row_idx)
   {
-    for (unsigned rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride,
-                                                previous_row = current_row, current_row += (width_ + 1),
-                                                count_previous_row = count_current_row, count_current_row += (width_ + 1))
+    const DataType *row = data + static_cast<size_t> (row_idx) * row_stride;
+    const size_t offset = static_cast<size_t> (row_idx + 1) * row_size;
+
+    // the sums of the previous row are added right away by a single thread, otherwise the first row, which
+    // is zero, is added and the vertical pass follows
+    const unsigned width = width_;
+    const size_t previous_offset = nr_threads == 1 ? offset - row_size : 0;
+    ElementType *first_order_row = first_order + offset;
+    SecondOrderType *second_order_row = second_order ? second_order + offset : NULL;
+    unsigned *finite_values_row = finite_values + offset;
+
+    ElementType sum = 0;
+    SecondOrderType so_sum = 0;
+    unsigned count = 0;
+
+    first_order_row[0] = 0;
+    if (second_order_row)
+      second_order_row[0] = 0;
+    finite_values_row[0] = 0;
+
+    for (unsigned colIdx = 0, valIdx = 0; colIdx < width; ++colIdx, valIdx += element_stride)
     {
-      current_row [0] = 0.0;
-      count_current_row [0] = 0;
-      for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
+      if (pcl_isfinite (row [valIdx]))
       {
-        current_row [colIdx + 1] = previous_row [colIdx + 1] + current_row [colIdx] - previous_row [colIdx];
-        count_current_row [colIdx + 1] = count_previous_row [colIdx + 1] + count_current_row [colIdx] - count_previous_row [colIdx];
-        if (pcl_isfinite (data [valIdx]))
-        {
-          current_row [colIdx + 1] += data [valIdx];
-          ++(count_current_row [colIdx + 1]);
-        }
+        const ElementType value = static_cast<ElementType> (row [valIdx]);
+        sum += value;
+        so_sum += value * value;
+        ++count;
       }
+
+      first_order_row[colIdx + 1] = sum + first_order[previous_offset + colIdx + 1];
+      if (second_order_row)
+        second_order_row[colIdx + 1] = so_sum + second_order[previous_offset + colIdx + 1];
+      finite_values_row[colIdx + 1] = count + finite_values[previous_offset + colIdx + 1];
     }
   }
-  else
+
+  // vertical pass
+  if (nr_threads != 1)
   {
-    SecondOrderType* so_previous_row = &second_order_integral_image_[0];
-    SecondOrderType* so_current_row  = so_previous_row + (width_ + 1);
-    memset (so_previous_row, 0, sizeof (SecondOrderType) * (width_ + 1));
-
-    for (unsigned rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride,
-                                                previous_row = current_row, current_row += (width_ + 1),
-                                                count_previous_row = count_current_row, count_current_row += (width_ + 1),
-                                                so_previous_row = so_current_row, so_current_row += (width_ + 1))
-    {
-      current_row [0] = 0.0;
-      so_current_row [0] = 0.0;
-      count_current_row [0] = 0;
-      for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
-      {
-        current_row [colIdx + 1] = previous_row [colIdx + 1] + current_row [colIdx] - previous_row [colIdx];
-        so_current_row [colIdx + 1] = so_previous_row [colIdx + 1] + so_current_row [colIdx] - so_previous_row [colIdx];
-        count_current_row [colIdx + 1] = count_previous_row [colIdx + 1] + count_current_row [colIdx] - count_previous_row [colIdx];
-        if (pcl_isfinite (data[valIdx]))
-        {
-          current_row [colIdx + 1] += data[valIdx];
-          so_current_row [colIdx + 1] += data[valIdx] * data[valIdx];
-          ++(count_current_row [colIdx + 1]);
-        }
-      }
-    }
+    detail::integrateColumns (first_order, 0, 1, row_size, height_ + 1, threads_);
+    if (second_order)
+      detail::integrateColumns (second_order, 0, 1, row_size, height_ + 1, threads_);
+    detail::integrateColumns (finite_values, 0, 1, row_size, height_ + 1, threads_);
   }
 }
 #endif    // PCL_INTEGRAL_IMAGE2D_IMPL_H_
-
@@ -41,6 +41,104 @@
 
 #include <pcl/features/integral_image_normal.h>
 
+#if defined (__AVX__)
+#include <immintrin.h>
+#elif defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace pcl
+{
+  namespace detail
+  {
+    /* gradientNormals computes the normals of count points from the sums of their gradients along the x and
+     * y axis, as the normalized cross product gradient_y x gradient_x. The input and output vectors are
+     * stored channel by channel (channel c of the i-th point is at c * stride + i). A zero cross product
+     * results in NaN normals. The operations are the same as the ones of the Eigen based per point
+     * computation, so the normals are identical. */
+
+    inline void
+    gradientNormalsStandard (const double *gradient_x, const double *gradient_y, unsigned stride,
+                             unsigned i, unsigned count, double *normals)
+    {
+      for (; i < count; ++i)
+      {
+        const double nx = gradient_y[stride + i] * gradient_x[2 * stride + i] - gradient_y[2 * stride + i] * gradient_x[stride + i];
+        const double ny = gradient_y[2 * stride + i] * gradient_x[i] - gradient_y[i] * gradient_x[2 * stride + i];
+        const double nz = gradient_y[i] * gradient_x[stride + i] - gradient_y[stride + i] * gradient_x[i];
+        const double length = std::sqrt (nx * nx + ny * ny + nz * nz);
+        normals[i]              = nx / length;
+        normals[stride + i]     = ny / length;
+        normals[2 * stride + i] = nz / length;
+      }
+    }
+
+#if defined (__SSE2__)
+    inline void
+    gradientNormalsSSE (const double *gradient_x, const double *gradient_y, unsigned stride,
+                        unsigned i, unsigned count, double *normals)
+    {
+      for (; i + 2 <= count; i += 2)
+      {
+        const __m128d gx0 = _mm_loadu_pd (gradient_x + i);
+        const __m128d gx1 = _mm_loadu_pd (gradient_x + stride + i);
+        const __m128d gx2 = _mm_loadu_pd (gradient_x + 2 * stride + i);
+        const __m128d gy0 = _mm_loadu_pd (gradient_y + i);
+        const __m128d gy1 = _mm_loadu_pd (gradient_y + stride + i);
+        const __m128d gy2 = _mm_loadu_pd (gradient_y + 2 * stride + i);
+        const __m128d nx = _mm_sub_pd (_mm_mul_pd (gy1, gx2), _mm_mul_pd (gy2, gx1));
+        const __m128d ny = _mm_sub_pd (_mm_mul_pd (gy2, gx0), _mm_mul_pd (gy0, gx2));
+        const __m128d nz = _mm_sub_pd (_mm_mul_pd (gy0, gx1), _mm_mul_pd (gy1, gx0));
+        const __m128d length = _mm_sqrt_pd (_mm_add_pd (_mm_add_pd (_mm_mul_pd (nx, nx), _mm_mul_pd (ny, ny)),
+                                                        _mm_mul_pd (nz, nz)));
+        _mm_storeu_pd (normals + i, _mm_div_pd (nx, length));
+        _mm_storeu_pd (normals + stride + i, _mm_div_pd (ny, length));
+        _mm_storeu_pd (normals + 2 * stride + i, _mm_div_pd (nz, length));
+      }
+      gradientNormalsStandard (gradient_x, gradient_y, stride, i, count, normals);
+    }
+#endif
+
+#if defined (__AVX__)
+    inline void
+    gradientNormalsAVX (const double *gradient_x, const double *gradient_y, unsigned stride,
+                        unsigned i, unsigned count, double *normals)
+    {
+      for (; i + 4 <= count; i += 4)
+      {
+        const __m256d gx0 = _mm256_loadu_pd (gradient_x + i);
+        const __m256d gx1 = _mm256_loadu_pd (gradient_x + stride + i);
+        const __m256d gx2 = _mm256_loadu_pd (gradient_x + 2 * stride + i);
+        const __m256d gy0 = _mm256_loadu_pd (gradient_y + i);
+        const __m256d gy1 = _mm256_loadu_pd (gradient_y + stride + i);
+        const __m256d gy2 = _mm256_loadu_pd (gradient_y + 2 * stride + i);
+        const __m256d nx = _mm256_sub_pd (_mm256_mul_pd (gy1, gx2), _mm256_mul_pd (gy2, gx1));
+        const __m256d ny = _mm256_sub_pd (_mm256_mul_pd (gy2, gx0), _mm256_mul_pd (gy0, gx2));
+        const __m256d nz = _mm256_sub_pd (_mm256_mul_pd (gy0, gx1), _mm256_mul_pd (gy1, gx0));
+        const __m256d length = _mm256_sqrt_pd (_mm256_add_pd (_mm256_add_pd (_mm256_mul_pd (nx, nx), _mm256_mul_pd (ny, ny)),
+                                                              _mm256_mul_pd (nz, nz)));
+        _mm256_storeu_pd (normals + i, _mm256_div_pd (nx, length));
+        _mm256_storeu_pd (normals + stride + i, _mm256_div_pd (ny, length));
+        _mm256_storeu_pd (normals + 2 * stride + i, _mm256_div_pd (nz, length));
+      }
+      gradientNormalsSSE (gradient_x, gradient_y, stride, i, count, normals);
+    }
+#endif
+
+    inline void
+    gradientNormals (const double *gradient_x, const double *gradient_y, unsigned stride, unsigned count, double *normals)
+    {
+#if defined (__AVX__)
+      gradientNormalsAVX (gradient_x, gradient_y, stride, 0, count, normals);
+#elif defined (__SSE2__)
+      gradientNormalsSSE (gradient_x, gradient_y, stride, 0, count, normals);
+#else
+      gradientNormalsStandard (gradient_x, gradient_y, stride, 0, count, normals);
+#endif
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT>
 pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::IntegralImageNormalEstimation ()
@@ -65,9 +163,9 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::IntegralImageNormalEsti
   , vpy_ (0.0f)
   , vpz_ (0.0f)
   , use_sensor_origin_ (true)
-  , threads_(0)
 {
   feature_name_ = "IntegralImagesNormalEstimation";
+  threads_ = 0;
   tree_.reset ();
   k_ = 1;
 }
@@ -130,6 +228,7 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::initSimple3DGradientMet
   const float *data_ = reinterpret_cast<const float*> (&input_->points[0]);
 
   integral_image_XYZ_.setSecondOrderComputation (false);
+  integral_image_XYZ_.setNumberOfThreads (threads_);
   integral_image_XYZ_.setInput (data_, input_->width, input_->height, element_stride, row_stride);
 
   init_simple_3d_gradient_ = true;
@@ -148,6 +247,7 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::initCovarianceMatrixMet
   const float *data_ = reinterpret_cast<const float*> (&input_->points[0]);
 
   integral_image_XYZ_.setSecondOrderComputation (true);
+  integral_image_XYZ_.setNumberOfThreads (threads_);
   integral_image_XYZ_.setInput (data_, input_->width, input_->height, element_stride, row_stride);
 
   init_covariance_matrix_ = true;
@@ -168,23 +268,20 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::initAverage3DGradientMe
   // x u x
   // l x r
   // x d x
-  const PointInT* point_up = &(input_->points [1]);
-  const PointInT* point_dn = point_up + (input_->width << 1);//&(input_->points [1 + (input_->width << 1)]);
-  const PointInT* point_lf = &(input_->points [input_->width]);
-  const PointInT* point_rg = point_lf + 2; //&(input_->points [input_->width + 2]);
-  float* diff_x_ptr = diff_x + ((input_->width + 1) << 2);
-  float* diff_y_ptr = diff_y + ((input_->width + 1) << 2);
-  unsigned diff_skip = 8; // skip last element in row and the first in the next row
-
-  for (size_t ri = 1; ri < input_->height - 1; ++ri
-                                             , point_up += input_->width
-                                             , point_dn += input_->width
-                                             , point_lf += input_->width
-                                             , point_rg += input_->width
-                                             , diff_x_ptr += diff_skip
-                                             , diff_y_ptr += diff_skip)
+  const int width = input_->width;
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(this->getComputeThreads ())
+#endif
+  for (int ri = 1; ri < static_cast<int> (input_->height) - 1; ++ri)
   {
-    for (size_t ci = 0; ci < input_->width - 2; ++ci, diff_x_ptr += 4, diff_y_ptr += 4)
+    const PointInT* point_up = &(input_->points [(ri - 1) * width + 1]);
+    const PointInT* point_dn = &(input_->points [(ri + 1) * width + 1]);
+    const PointInT* point_lf = &(input_->points [ri * width]);
+    const PointInT* point_rg = point_lf + 2;
+    float* diff_x_ptr = diff_x + ((ri * width + 1) << 2);
+    float* diff_y_ptr = diff_y + ((ri * width + 1) << 2);
+
+    for (int ci = 0; ci < width - 2; ++ci, diff_x_ptr += 4, diff_y_ptr += 4)
     {
       diff_x_ptr[0] = point_rg[ci].x - point_lf[ci].x;
       diff_x_ptr[1] = point_rg[ci].y - point_lf[ci].y;
@@ -197,6 +294,8 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::initAverage3DGradientMe
   }
 
   // Compute integral images
+  integral_image_DX_.setNumberOfThreads (threads_);
+  integral_image_DY_.setNumberOfThreads (threads_);
   integral_image_DX_.setInput (diff_x, input_->width, input_->height, 4, input_->width << 2);
   integral_image_DY_.setInput (diff_y, input_->width, input_->height, 4, input_->width << 2);
   init_covariance_matrix_ = init_depth_change_ = init_simple_3d_gradient_ = false;
@@ -218,11 +317,120 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::initAverageDepthChangeM
   const float *data_ = reinterpret_cast<const float*> (&input_->points[0]);
 
   // integral image over the z - value
+  integral_image_depth_.setNumberOfThreads (threads_);
   integral_image_depth_.setInput (&(data_[2]), input_->width, input_->height, element_stride, row_stride);
   init_depth_change_ = true;
   init_covariance_matrix_ = init_average_3d_gradient_ = init_simple_3d_gradient_ = false;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeNormalFromMoments (
+    unsigned count, const Eigen::Vector3d &sum,
+    const typename IntegralImage2D<float, 3>::SecondOrderType &so_sum,
+    const unsigned point_index, PointOutT &normal)
+{
+  EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix;
+  Eigen::Vector3f center = sum.template cast<float> ();
+
+  covariance_matrix.coeffRef (0) = static_cast<float> (so_sum [0]);
+  covariance_matrix.coeffRef (1) = covariance_matrix.coeffRef (3) = static_cast<float> (so_sum [1]);
+  covariance_matrix.coeffRef (2) = covariance_matrix.coeffRef (6) = static_cast<float> (so_sum [2]);
+  covariance_matrix.coeffRef (4) = static_cast<float> (so_sum [3]);
+  covariance_matrix.coeffRef (5) = covariance_matrix.coeffRef (7) = static_cast<float> (so_sum [4]);
+  covariance_matrix.coeffRef (8) = static_cast<float> (so_sum [5]);
+  covariance_matrix -= (center * center.transpose ()) / static_cast<float> (count);
+  float eigen_value;
+  Eigen::Vector3f eigen_vector;
+  pcl::eigen33 (covariance_matrix, eigen_value, eigen_vector);
+  flipNormalTowardsViewpoint (input_->points[point_index], vpx_, vpy_, vpz_, eigen_vector[0], eigen_vector[1], eigen_vector[2]);
+  normal.getNormalVector3fMap () = eigen_vector;
+
+  // Compute the curvature surface change
+  if (eigen_value > 0.0)
+    normal.curvature = fabsf (eigen_value / (covariance_matrix.coeff (0) + covariance_matrix.coeff (4) + covariance_matrix.coeff (8)));
+  else
+    normal.curvature = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeNormalFromGradients (
+    const Eigen::Vector3d &gradient_x, const Eigen::Vector3d &gradient_y,
+    const unsigned point_index, PointOutT &normal)
+{
+  const float bad_point = std::numeric_limits<float>::quiet_NaN ();
+
+  Eigen::Vector3d normal_vector = gradient_y.cross (gradient_x);
+  double normal_length = normal_vector.squaredNorm ();
+  if (normal_length == 0.0f)
+  {
+    normal.getNormalVector3fMap ().setConstant (bad_point);
+    normal.curvature = bad_point;
+    return;
+  }
+
+  normal_vector /= sqrt (normal_length);
+  setGradientNormal (normal_vector.data (), 1, point_index, normal);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::setGradientNormal (
+    const double *normal_vector, unsigned stride, const unsigned point_index, PointOutT &normal)
+{
+  float nx = static_cast<float> (normal_vector [0]);
+  float ny = static_cast<float> (normal_vector [stride]);
+  float nz = static_cast<float> (normal_vector [2 * stride]);
+
+  flipNormalTowardsViewpoint (input_->points[point_index], vpx_, vpy_, vpz_, nx, ny, nz);
+
+  normal.normal_x = nx;
+  normal.normal_y = ny;
+  normal.normal_z = nz;
+  normal.curvature = std::numeric_limits<float>::quiet_NaN ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeNormalFromDepthChange (
+    float mean_L_z, float mean_R_z, float mean_U_z, float mean_D_z,
+    const PointInT &pointL, const PointInT &pointR, const PointInT &pointU, const PointInT &pointD,
+    const unsigned point_index, PointOutT &normal)
+{
+  const float bad_point = std::numeric_limits<float>::quiet_NaN ();
+
+  const float mean_x_z = mean_R_z - mean_L_z;
+  const float mean_y_z = mean_D_z - mean_U_z;
+
+  const float mean_x_x = pointR.x - pointL.x;
+  const float mean_x_y = pointR.y - pointL.y;
+  const float mean_y_x = pointD.x - pointU.x;
+  const float mean_y_y = pointD.y - pointU.y;
+
+  float normal_x = mean_x_y * mean_y_z - mean_x_z * mean_y_y;
+  float normal_y = mean_x_z * mean_y_x - mean_x_x * mean_y_z;
+  float normal_z = mean_x_x * mean_y_y - mean_x_y * mean_y_x;
+
+  const float normal_length = (normal_x * normal_x + normal_y * normal_y + normal_z * normal_z);
+
+  if (normal_length == 0.0f)
+  {
+    normal.getNormalVector3fMap ().setConstant (bad_point);
+    normal.curvature = bad_point;
+    return;
+  }
+
+  flipNormalTowardsViewpoint (input_->points[point_index], vpx_, vpy_, vpz_, normal_x, normal_y, normal_z);
+
+  const float scale = 1.0f / sqrtf (normal_length);
+
+  normal.normal_x = normal_x * scale;
+  normal.normal_y = normal_y * scale;
+  normal.normal_z = normal_z * scale;
+  normal.curvature = bad_point;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT> void
 pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormal (
@@ -252,31 +460,10 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormal (
       return;
     }
 
-    EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix;
-    Eigen::Vector3f center;
-    typename IntegralImage2D<float, 3>::SecondOrderType so_elements;
-    center = integral_image_XYZ_.getFirstOrderSum(pos_x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height).template cast<float> ();
-    so_elements = integral_image_XYZ_.getSecondOrderSum(pos_x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height);
-
-    covariance_matrix.coeffRef (0) = static_cast<float> (so_elements [0]);
-    covariance_matrix.coeffRef (1) = covariance_matrix.coeffRef (3) = static_cast<float> (so_elements [1]);
-    covariance_matrix.coeffRef (2) = covariance_matrix.coeffRef (6) = static_cast<float> (so_elements [2]);
-    covariance_matrix.coeffRef (4) = static_cast<float> (so_elements [3]);
-    covariance_matrix.coeffRef (5) = covariance_matrix.coeffRef (7) = static_cast<float> (so_elements [4]);
-    covariance_matrix.coeffRef (8) = static_cast<float> (so_elements [5]);
-    covariance_matrix -= (center * center.transpose ()) / static_cast<float> (count);
-    float eigen_value;
-    Eigen::Vector3f eigen_vector;
-    pcl::eigen33 (covariance_matrix, eigen_value, eigen_vector);
-    flipNormalTowardsViewpoint (input_->points[point_index], vpx_, vpy_, vpz_, eigen_vector[0], eigen_vector[1], eigen_vector[2]);
-    normal.getNormalVector3fMap () = eigen_vector;
-
-    // Compute the curvature surface change
-    if (eigen_value > 0.0)
-      normal.curvature = fabsf (eigen_value / (covariance_matrix.coeff (0) + covariance_matrix.coeff (4) + covariance_matrix.coeff (8)));
-    else
-      normal.curvature = 0;
-
+    computeNormalFromMoments (count,
+                              integral_image_XYZ_.getFirstOrderSum (pos_x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height),
+                              integral_image_XYZ_.getSecondOrderSum (pos_x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height),
+                              point_index, normal);
     return;
   }
   else if (normal_estimation_method_ == AVERAGE_3D_GRADIENT)
@@ -294,27 +481,7 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormal (
     Eigen::Vector3d gradient_x = integral_image_DX_.getFirstOrderSum (pos_x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height);
     Eigen::Vector3d gradient_y = integral_image_DY_.getFirstOrderSum (pos_x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height);
 
-    Eigen::Vector3d normal_vector = gradient_y.cross (gradient_x);
-    double normal_length = normal_vector.squaredNorm ();
-    if (normal_length == 0.0f)
-    {
-      normal.getNormalVector3fMap ().setConstant (bad_point);
-      normal.curvature = bad_point;
-      return;
-    }
-
-    normal_vector /= sqrt (normal_length);
-
-    float nx = static_cast<float> (normal_vector [0]);
-    float ny = static_cast<float> (normal_vector [1]);
-    float nz = static_cast<float> (normal_vector [2]);
-
-    flipNormalTowardsViewpoint (input_->points[point_index], vpx_, vpy_, vpz_, nx, ny, nz);
-
-    normal.normal_x = nx;
-    normal.normal_y = ny;
-    normal.normal_z = nz;
-    normal.curvature = bad_point;
+    computeNormalFromGradients (gradient_x, gradient_y, point_index, normal);
     return;
   }
   else if (normal_estimation_method_ == AVERAGE_DEPTH_CHANGE)
@@ -339,41 +506,12 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormal (
     float mean_U_z = static_cast<float> (integral_image_depth_.getFirstOrderSum (pos_x - rect_width_4, pos_y - rect_height_2, rect_width_2, rect_height_2) / count_U_z);
     float mean_D_z = static_cast<float> (integral_image_depth_.getFirstOrderSum (pos_x - rect_width_4, pos_y + 1             , rect_width_2, rect_height_2) / count_D_z);
 
-    PointInT pointL = input_->points[point_index - rect_width_4 - 1];
-    PointInT pointR = input_->points[point_index + rect_width_4 + 1];
-    PointInT pointU = input_->points[point_index - rect_height_4 * input_->width - 1];
-    PointInT pointD = input_->points[point_index + rect_height_4 * input_->width + 1];
-
-    const float mean_x_z = mean_R_z - mean_L_z;
-    const float mean_y_z = mean_D_z - mean_U_z;
-
-    const float mean_x_x = pointR.x - pointL.x;
-    const float mean_x_y = pointR.y - pointL.y;
-    const float mean_y_x = pointD.x - pointU.x;
-    const float mean_y_y = pointD.y - pointU.y;
-
-    float normal_x = mean_x_y * mean_y_z - mean_x_z * mean_y_y;
-    float normal_y = mean_x_z * mean_y_x - mean_x_x * mean_y_z;
-    float normal_z = mean_x_x * mean_y_y - mean_x_y * mean_y_x;
-
-    const float normal_length = (normal_x * normal_x + normal_y * normal_y + normal_z * normal_z);
-
-    if (normal_length == 0.0f)
-    {
-      normal.getNormalVector3fMap ().setConstant (bad_point);
-      normal.curvature = bad_point;
-      return;
-    }
-
-    flipNormalTowardsViewpoint (input_->points[point_index], vpx_, vpy_, vpz_, normal_x, normal_y, normal_z);
-    
-    const float scale = 1.0f / sqrtf (normal_length);
-
-    normal.normal_x = normal_x * scale;
-    normal.normal_y = normal_y * scale;
-    normal.normal_z = normal_z * scale;
-    normal.curvature = bad_point;
-
+    computeNormalFromDepthChange (mean_L_z, mean_R_z, mean_U_z, mean_D_z,
+                                  input_->points[point_index - rect_width_4 - 1],
+                                  input_->points[point_index + rect_width_4 + 1],
+                                  input_->points[point_index - rect_height_4 * input_->width - 1],
+                                  input_->points[point_index + rect_height_4 * input_->width + 1],
+                                  point_index, normal);
     return;
   }
   else if (normal_estimation_method_ == SIMPLE_3D_GRADIENT)
@@ -387,27 +525,8 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormal (
 
     Eigen::Vector3d gradient_y = integral_image_XYZ_.getFirstOrderSum (pos_x - rect_width_2, pos_y + rect_height_2, rect_width, 1) -
                                  integral_image_XYZ_.getFirstOrderSum (pos_x - rect_width_2, pos_y - rect_height_2, rect_width, 1);
-    Eigen::Vector3d normal_vector = gradient_y.cross (gradient_x);
-    double normal_length = normal_vector.squaredNorm ();
-    if (normal_length == 0.0f)
-    {
-      normal.getNormalVector3fMap ().setConstant (bad_point);
-      normal.curvature = bad_point;
-      return;
-    }
-
-    normal_vector /= sqrt (normal_length);
 
-    float nx = static_cast<float> (normal_vector [0]);
-    float ny = static_cast<float> (normal_vector [1]);
-    float nz = static_cast<float> (normal_vector [2]);
-
-    flipNormalTowardsViewpoint (input_->points[point_index], vpx_, vpy_, vpz_, nx, ny, nz);
-    
-    normal.normal_x = nx;
-    normal.normal_y = ny;
-    normal.normal_z = nz;
-    normal.curvature = bad_point;
+    computeNormalFromGradients (gradient_x, gradient_y, point_index, normal);
     return;
   }
 
@@ -416,6 +535,136 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormal (
   return;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormals (
+    const int pos_x, const int pos_y, const unsigned count, PointOutT *normals,
+    int rect_width, int rect_height)
+{
+  const int rect_width_2  = rect_width / 2;
+  const int rect_width_4  = rect_width / 4;
+  const int rect_height_2 = rect_height / 2;
+  const int rect_height_4 = rect_height / 4;
+
+  const float bad_point = std::numeric_limits<float>::quiet_NaN ();
+  const int width = input_->width;
+
+  // The rectangle sums are evaluated for blocks of points at once and stored channel by channel (the
+  // sum of channel c of the i-th point of a block of size points is sums[c * size + i]), the normals
+  // are then computed point by point from these sums.
+  const unsigned block_size = 64;
+  double sums[12 * block_size];
+  unsigned counts[4 * block_size];
+
+  for (unsigned block = 0; block < count; block += block_size)
+  {
+    const unsigned size = std::min (block_size, count - block);
+    const int x = pos_x + static_cast<int> (block);
+    const unsigned index = pos_y * width + x;
+    PointOutT *block_normals = normals + block;
+
+    if (normal_estimation_method_ == COVARIANCE_MATRIX)
+    {
+      integral_image_XYZ_.getFiniteElementsCounts (x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height, size, counts);
+      integral_image_XYZ_.getFirstOrderSums (x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height, size, sums);
+      integral_image_XYZ_.getSecondOrderSums (x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height, size, sums + 3 * size);
+
+      for (unsigned i = 0; i < size; ++i)
+      {
+        // no valid points within the rectangular reagion?
+        if (counts[i] == 0)
+        {
+          block_normals[i].normal_x = block_normals[i].normal_y = block_normals[i].normal_z = block_normals[i].curvature = bad_point;
+          continue;
+        }
+
+        typename IntegralImage2D<float, 3>::SecondOrderType so_elements;
+        for (unsigned j = 0; j < 6; ++j)
+          so_elements[j] = sums[(3 + j) * size + i];
+        computeNormalFromMoments (counts[i], Eigen::Vector3d (sums[i], sums[size + i], sums[2 * size + i]),
+                                  so_elements, index + i, block_normals[i]);
+      }
+    }
+    else if (normal_estimation_method_ == AVERAGE_3D_GRADIENT)
+    {
+      integral_image_DX_.getFiniteElementsCounts (x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height, size, counts);
+      integral_image_DY_.getFiniteElementsCounts (x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height, size, counts + size);
+      integral_image_DX_.getFirstOrderSums (x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height, size, sums);
+      integral_image_DY_.getFirstOrderSums (x - rect_width_2, pos_y - rect_height_2, rect_width, rect_height, size, sums + 3 * size);
+
+      detail::gradientNormals (sums, sums + 3 * size, size, size, sums + 6 * size);
+      for (unsigned i = 0; i < size; ++i)
+      {
+        if (counts[i] == 0 || counts[size + i] == 0)
+        {
+          block_normals[i].normal_x = block_normals[i].normal_y = block_normals[i].normal_z = block_normals[i].curvature = bad_point;
+          continue;
+        }
+
+        setGradientNormal (sums + 6 * size + i, size, index + i, block_normals[i]);
+      }
+    }
+    else if (normal_estimation_method_ == AVERAGE_DEPTH_CHANGE)
+    {
+      // left, right, upper and lower rectangles
+      integral_image_depth_.getFiniteElementsCounts (x - rect_width_2, pos_y - rect_height_4, rect_width_2, rect_height_2, size, counts);
+      integral_image_depth_.getFiniteElementsCounts (x + 1           , pos_y - rect_height_4, rect_width_2, rect_height_2, size, counts + size);
+      integral_image_depth_.getFiniteElementsCounts (x - rect_width_4, pos_y - rect_height_2, rect_width_2, rect_height_2, size, counts + 2 * size);
+      integral_image_depth_.getFiniteElementsCounts (x - rect_width_4, pos_y + 1            , rect_width_2, rect_height_2, size, counts + 3 * size);
+      integral_image_depth_.getFirstOrderSums (x - rect_width_2, pos_y - rect_height_4, rect_width_2, rect_height_2, size, sums);
+      integral_image_depth_.getFirstOrderSums (x + 1           , pos_y - rect_height_4, rect_width_2, rect_height_2, size, sums + size);
+      integral_image_depth_.getFirstOrderSums (x - rect_width_4, pos_y - rect_height_2, rect_width_2, rect_height_2, size, sums + 2 * size);
+      integral_image_depth_.getFirstOrderSums (x - rect_width_4, pos_y + 1            , rect_width_2, rect_height_2, size, sums + 3 * size);
+
+      for (unsigned i = 0; i < size; ++i)
+      {
+        if (counts[i] == 0 || counts[size + i] == 0 || counts[2 * size + i] == 0 || counts[3 * size + i] == 0)
+        {
+          block_normals[i].normal_x = block_normals[i].normal_y = block_normals[i].normal_z = block_normals[i].curvature = bad_point;
+          continue;
+        }
+
+        const unsigned point_index = index + i;
+        computeNormalFromDepthChange (static_cast<float> (sums[i] / counts[i]),
+                                      static_cast<float> (sums[size + i] / counts[size + i]),
+                                      static_cast<float> (sums[2 * size + i] / counts[2 * size + i]),
+                                      static_cast<float> (sums[3 * size + i] / counts[3 * size + i]),
+                                      input_->points[point_index - rect_width_4 - 1],
+                                      input_->points[point_index + rect_width_4 + 1],
+                                      input_->points[point_index - rect_height_4 * width - 1],
+                                      input_->points[point_index + rect_height_4 * width + 1],
+                                      point_index, block_normals[i]);
+      }
+    }
+    else if (normal_estimation_method_ == SIMPLE_3D_GRADIENT)
+    {
+      // right and left columns, lower and upper rows
+      integral_image_XYZ_.getFirstOrderSums (x + rect_width_2, pos_y - rect_height_2, 1, rect_height, size, sums);
+      integral_image_XYZ_.getFirstOrderSums (x - rect_width_2, pos_y - rect_height_2, 1, rect_height, size, sums + 3 * size);
+      integral_image_XYZ_.getFirstOrderSums (x - rect_width_2, pos_y + rect_height_2, rect_width, 1, size, sums + 6 * size);
+      integral_image_XYZ_.getFirstOrderSums (x - rect_width_2, pos_y - rect_height_2, rect_width, 1, size, sums + 9 * size);
+
+      // the gradients replace the right columns and the lower rows, the normals the left columns
+      for (unsigned i = 0; i < 3 * size; ++i)
+      {
+        sums[i] -= sums[3 * size + i];
+        sums[6 * size + i] -= sums[9 * size + i];
+      }
+      detail::gradientNormals (sums, sums + 6 * size, size, size, sums + 3 * size);
+      for (unsigned i = 0; i < size; ++i)
+        setGradientNormal (sums + 3 * size + i, size, index + i, block_normals[i]);
+    }
+    else
+    {
+      for (unsigned i = 0; i < size; ++i)
+      {
+        block_normals[i].getNormalVector3fMap ().setConstant (bad_point);
+        block_normals[i].curvature = bad_point;
+      }
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 template <typename T>
 void
@@ -525,15 +774,9 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormalMirro
       return;
     }
 
-    EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix;
-    Eigen::Vector3f center;
     typename IntegralImage2D<float, 3>::SecondOrderType so_elements;
     typename IntegralImage2D<float, 3>::ElementType tmp_center;
-    typename IntegralImage2D<float, 3>::SecondOrderType tmp_so_elements;
 
-    center[0] = 0;
-    center[1] = 0;
-    center[2] = 0;
     tmp_center[0] = 0;
     tmp_center[1] = 0;
     tmp_center[2] = 0;
@@ -547,29 +790,7 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormalMirro
     sumArea<typename IntegralImage2D<float, 3>::ElementType>(start_x, start_y, end_x, end_y, width, height, boost::bind(&IntegralImage2D<float, 3>::getFirstOrderSumSE, &integral_image_XYZ_, _1, _2, _3, _4), tmp_center);
     sumArea<typename IntegralImage2D<float, 3>::SecondOrderType>(start_x, start_y, end_x, end_y, width, height, boost::bind(&IntegralImage2D<float, 3>::getSecondOrderSumSE, &integral_image_XYZ_, _1, _2, _3, _4), so_elements);
 
-    center[0] = float (tmp_center[0]);
-    center[1] = float (tmp_center[1]);
-    center[2] = float (tmp_center[2]);
-
-    covariance_matrix.coeffRef (0) = static_cast<float> (so_elements [0]);
-    covariance_matrix.coeffRef (1) = covariance_matrix.coeffRef (3) = static_cast<float> (so_elements [1]);
-    covariance_matrix.coeffRef (2) = covariance_matrix.coeffRef (6) = static_cast<float> (so_elements [2]);
-    covariance_matrix.coeffRef (4) = static_cast<float> (so_elements [3]);
-    covariance_matrix.coeffRef (5) = covariance_matrix.coeffRef (7) = static_cast<float> (so_elements [4]);
-    covariance_matrix.coeffRef (8) = static_cast<float> (so_elements [5]);
-    covariance_matrix -= (center * center.transpose ()) / static_cast<float> (count);
-    float eigen_value;
-    Eigen::Vector3f eigen_vector;
-    pcl::eigen33 (covariance_matrix, eigen_value, eigen_vector);
-    flipNormalTowardsViewpoint (input_->points[point_index], vpx_, vpy_, vpz_, eigen_vector[0], eigen_vector[1], eigen_vector[2]);
-    normal.getNormalVector3fMap () = eigen_vector;
-
-    // Compute the curvature surface change
-    if (eigen_value > 0.0)
-      normal.curvature = fabsf (eigen_value / (covariance_matrix.coeff (0) + covariance_matrix.coeff (4) + covariance_matrix.coeff (8)));
-    else
-      normal.curvature = 0;
-
+    computeNormalFromMoments (count, tmp_center, so_elements, point_index, normal);
     return;
   }
   // =======================================================
@@ -602,27 +823,7 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormalMirro
     sumArea<typename IntegralImage2D<float, 3>::ElementType>(start_x, start_y, end_x, end_y, width, height, boost::bind(&IntegralImage2D<float, 3>::getFirstOrderSumSE, &integral_image_DY_, _1, _2, _3, _4), gradient_y);
 
 
-    Eigen::Vector3d normal_vector = gradient_y.cross (gradient_x);
-    double normal_length = normal_vector.squaredNorm ();
-    if (normal_length == 0.0f)
-    {
-      normal.getNormalVector3fMap ().setConstant (bad_point);
-      normal.curvature = bad_point;
-      return;
-    }
-
-    normal_vector /= sqrt (normal_length);
-
-    float nx = static_cast<float> (normal_vector [0]);
-    float ny = static_cast<float> (normal_vector [1]);
-    float nz = static_cast<float> (normal_vector [2]);
-
-    flipNormalTowardsViewpoint (input_->points[point_index], vpx_, vpy_, vpz_, nx, ny, nz);
-
-    normal.normal_x = nx;
-    normal.normal_y = ny;
-    normal.normal_z = nz;
-    normal.curvature = bad_point;
+    computeNormalFromGradients (gradient_x, gradient_y, point_index, normal);
     return;
   }
   // ======================================================
@@ -706,41 +907,12 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computePointNormalMirro
     mean_D_z /= float (count_D_z);
 
 
-    PointInT pointL = input_->points[point_index_L_y*width + point_index_L_x];
-    PointInT pointR = input_->points[point_index_R_y*width + point_index_R_x];
-    PointInT pointU = input_->points[point_index_U_y*width + point_index_U_x];
-    PointInT pointD = input_->points[point_index_D_y*width + point_index_D_x];
-
-    const float mean_x_z = mean_R_z - mean_L_z;
-    const float mean_y_z = mean_D_z - mean_U_z;
-
-    const float mean_x_x = pointR.x - pointL.x;
-    const float mean_x_y = pointR.y - pointL.y;
-    const float mean_y_x = pointD.x - pointU.x;
-    const float mean_y_y = pointD.y - pointU.y;
-
-    float normal_x = mean_x_y * mean_y_z - mean_x_z * mean_y_y;
-    float normal_y = mean_x_z * mean_y_x - mean_x_x * mean_y_z;
-    float normal_z = mean_x_x * mean_y_y - mean_x_y * mean_y_x;
-
-    const float normal_length = (normal_x * normal_x + normal_y * normal_y + normal_z * normal_z);
-
-    if (normal_length == 0.0f)
-    {
-      normal.getNormalVector3fMap ().setConstant (bad_point);
-      normal.curvature = bad_point;
-      return;
-    }
-
-    flipNormalTowardsViewpoint (input_->points[point_index], vpx_, vpy_, vpz_, normal_x, normal_y, normal_z);
-    
-    const float scale = 1.0f / sqrtf (normal_length);
-
-    normal.normal_x = normal_x * scale;
-    normal.normal_y = normal_y * scale;
-    normal.normal_z = normal_z * scale;
-    normal.curvature = bad_point;
-
+    computeNormalFromDepthChange (mean_L_z, mean_R_z, mean_U_z, mean_D_z,
+                                  input_->points[point_index_L_y*width + point_index_L_x],
+                                  input_->points[point_index_R_y*width + point_index_R_x],
+                                  input_->points[point_index_U_y*width + point_index_U_x],
+                                  input_->points[point_index_D_y*width + point_index_D_x],
+                                  point_index, normal);
     return;
   }
   // ========================================================
@@ -760,53 +932,71 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeFeature (PointCl
 {
   output.sensor_origin_ = input_->sensor_origin_;
   output.sensor_orientation_ = input_->sensor_orientation_;
-  
+
   float bad_point = std::numeric_limits<float>::quiet_NaN ();
 
-  // compute depth-change map
+  // the integral images of a method are otherwise computed on first use, which must not happen in parallel
+  if (normal_estimation_method_ == COVARIANCE_MATRIX && !init_covariance_matrix_)
+    initCovarianceMatrixMethod ();
+  else if (normal_estimation_method_ == AVERAGE_3D_GRADIENT && !init_average_3d_gradient_)
+    initAverage3DGradientMethod ();
+  else if (normal_estimation_method_ == AVERAGE_DEPTH_CHANGE && !init_depth_change_)
+    initAverageDepthChangeMethod ();
+  else if (normal_estimation_method_ == SIMPLE_3D_GRADIENT && !init_simple_3d_gradient_)
+    initSimple3DGradientMethod ();
+
+  const int width = input_->width;
+  const int height = input_->height;
+
+  // compute depth changes: bit 0 is set for a change to the right neighbor, bit 1 for a change to the lower one
   unsigned char * depthChangeMap = new unsigned char[input_->points.size ()];
-  memset (depthChangeMap, 255, input_->points.size ());
+  memset (depthChangeMap, 0, input_->points.size ());
 
-  unsigned index = 0;
-  for (unsigned int ri = 0; ri < input_->height-1; ++ri)
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(this->getComputeThreads ())
+#endif
+  for (int ri = 0; ri < height - 1; ++ri)
   {
-    for (unsigned int ci = 0; ci < input_->width-1; ++ci/*, ++index*/)
+    for (int ci = 0; ci < width - 1; ++ci)
     {
-      index = ri * input_->width + ci;
+      const int index = ri * width + ci;
 
       const float depth  = input_->points [index].z;
       const float depthR = input_->points [index + 1].z;
-      const float depthD = input_->points [index + input_->width].z;
+      const float depthD = input_->points [index + width].z;
 
       //const float depthDependendDepthChange = (max_depth_change_factor_ * (fabs(depth)+1.0f))/(500.0f*0.001f);
       const float depthDependendDepthChange = (max_depth_change_factor_ * (fabsf (depth) + 1.0f) * 2.0f);
 
       if (fabs (depth - depthR) > depthDependendDepthChange
         || !pcl_isfinite (depth) || !pcl_isfinite (depthR))
-      {
-        depthChangeMap[index] = 0;
-        depthChangeMap[index+1] = 0;
-      }
+        depthChangeMap[index] |= 1;
       if (fabs (depth - depthD) > depthDependendDepthChange
         || !pcl_isfinite (depth) || !pcl_isfinite (depthD))
-      {
-        depthChangeMap[index] = 0;
-        depthChangeMap[index + input_->width] = 0;
-      }
+        depthChangeMap[index] |= 2;
     }
   }
 
-  // compute distance map
+  // compute distance map, starting from 0 at both sides of every depth change
   //float *distanceMap = new float[input_->points.size ()];
   if (distance_map_ != NULL) delete[] distance_map_;
   distance_map_ = new float[input_->points.size ()];
   float *distanceMap = distance_map_;
-  for (size_t index = 0; index < input_->points.size (); ++index)
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(this->getComputeThreads ())
+#endif
+  for (int ri = 0; ri < height; ++ri)
   {
-    if (depthChangeMap[index] == 0)
-      distanceMap[index] = 0.0f;
-    else
-      distanceMap[index] = static_cast<float> (input_->width + input_->height);
+    for (int ci = 0; ci < width; ++ci)
+    {
+      const int index = ri * width + ci;
+      if (depthChangeMap[index] != 0
+          || (ci > 0 && (depthChangeMap[index - 1] & 1) != 0)
+          || (ri > 0 && (depthChangeMap[index - width] & 2) != 0))
+        distanceMap[index] = 0.0f;
+      else
+        distanceMap[index] = static_cast<float> (input_->width + input_->height);
+    }
   }
 
   // first pass
@@ -867,8 +1057,6 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeFeatureFull (con
                                                                              const float &bad_point,
                                                                              PointCloudOut &output)
 {
-  unsigned index = 0;
-
   if (border_policy_ == BORDER_POLICY_IGNORE)
   {
     // Set all normals that we do not touch to NaN
@@ -902,77 +1090,58 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeFeatureFull (con
       }
     }
 
-    if (use_depth_dependent_smoothing_)
-    {
-      index = border + input_->width * border;
-      unsigned skip = (border << 1);
-
+    // The rectangle size of every point is determined first. Consecutive points of a row which use the
+    // same rectangle size are then passed at once to computePointNormals.
+    const int width = input_->width;
+    const int height = input_->height;
+    const int first = border;
 #ifdef _OPENMP
-      #pragma omp parallel for num_threads(threads_)
+    #pragma omp parallel for num_threads(this->getComputeThreads ())
 #endif
-      for (unsigned ri = border; ri < input_->height - border; ++ri/*, index += skip*/)
+    for (int ri = first; ri < height - first; ++ri)
+    {
+      PointOutT *row = &output [ri * width];
+      int run_begin = first;
+      int run_size = 0;
+      for (int ci = first; ci <= width - first; ++ci)
       {
-        for (unsigned ci = border; ci < input_->width - border; ++ci/*, ++index*/)
+        int size = 0;
+        if (ci < width - first)
         {
-          index = ri * input_->width + ci;
-
+          const int index = ri * width + ci;
           const float depth = input_->points[index].z;
-          if (!pcl_isfinite (depth))
+          if (pcl_isfinite (depth))
           {
-            output[index].getNormalVector3fMap ().setConstant (bad_point);
-            output[index].curvature = bad_point;
-            continue;
+            if (use_depth_dependent_smoothing_)
+            {
+              float smoothing = (std::min)(distanceMap[index], normal_smoothing_size_ + static_cast<float>(depth)/10.0f);  // weired constant, pointcloud unit dependent
+
+              int smoothingint = static_cast<int> (smoothing);
+              int smoothingint_2 = static_cast<int> (smoothing) / 2;
+              if (smoothing > 2.0f && ri >= smoothingint_2 && ci >= smoothingint_2 && (ri - smoothingint_2 + smoothingint - 1 < height) &&  (ci - smoothingint_2 + smoothingint - 1 < width))
+                size = smoothingint;
+            }
+            else
+            {
+              float smoothing = (std::min)(distanceMap[index], normal_smoothing_size_);
+              if (smoothing > 2.0f)
+                size = static_cast<int> (smoothing);
+            }
           }
 
-          float smoothing = (std::min)(distanceMap[index], normal_smoothing_size_ + static_cast<float>(depth)/10.0f);  // weired constant, pointcloud unit dependent
-
-          int smoothingint = static_cast<int> (smoothing);
-          int smoothingint_2 = static_cast<int> (smoothing) / 2;
-          if (smoothing > 2.0f && ri >= smoothingint_2 && ci >= smoothingint_2 && (ri - smoothingint_2 + smoothingint - 1 < (input_->height)) &&  (ci - smoothingint_2 + smoothingint - 1 < (input_->width)))
+          if (size == 0)
           {
-            computePointNormal (ci, ri, index, output [index], smoothingint, smoothingint);
-          }
-          else
-          {
-            output[index].getNormalVector3fMap ().setConstant (bad_point);
-            output[index].curvature = bad_point;
+            row [ci].getNormalVector3fMap ().setConstant (bad_point);
+            row [ci].curvature = bad_point;
           }
         }
-      }
-    }
-    else
-    {
-      const float smoothing_constant = normal_smoothing_size_;
 
-      index = border + input_->width * border;
-      unsigned skip = (border << 1);
-#ifdef _OPENMP
-      #pragma omp parallel for num_threads(threads_)
-#endif
-      for (unsigned ri = border; ri < input_->height - border; ++ri/*, index += skip*/)
-      {
-        for (unsigned ci = border; ci < input_->width - border; ++ci/*, ++index*/)
+        if (size != run_size || ci == width - first)
         {
-          index = ri * input_->width + ci;
-
-          if (!pcl_isfinite (input_->points[index].z))
-          {
-            output [index].getNormalVector3fMap ().setConstant (bad_point);
-            output [index].curvature = bad_point;
-            continue;
-          }
-
-          float smoothing = (std::min)(distanceMap[index], smoothing_constant);
-
-          if (smoothing > 2.0f)
-          {
-            computePointNormal (ci, ri, index, output [index], static_cast<int> (smoothing), static_cast<int> (smoothing));
-          }
-          else
-          {
-            output [index].getNormalVector3fMap ().setConstant (bad_point);
-            output [index].curvature = bad_point;
-          }
+          if (run_size != 0)
+            computePointNormals (run_begin, ri, ci - run_begin, row + run_begin, run_size, run_size);
+          run_begin = ci;
+          run_size = size;
         }
       }
     }
@@ -981,78 +1150,60 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeFeatureFull (con
   {
     output.is_dense = false;
 
-    if (use_depth_dependent_smoothing_)
-    {
-      //index = 0;
-      //unsigned skip = 0;
-      //for (unsigned ri = 0; ri < input_->height; ++ri, index += skip)
+    // Points whose rectangle lies within the image are not affected by the mirroring. For the methods which
+    // evaluate their rectangle sums the same way in both cases, the normals of such points are computed in
+    // runs as above, the remaining points one by one.
+    const bool use_runs = normal_estimation_method_ == COVARIANCE_MATRIX || normal_estimation_method_ == AVERAGE_3D_GRADIENT;
+    const int width = input_->width;
+    const int height = input_->height;
 #ifdef _OPENMP
-      #pragma omp parallel for num_threads(threads_)
+    #pragma omp parallel for num_threads(this->getComputeThreads ())
 #endif
-      for (unsigned ri = 0; ri < input_->height; ++ri)
+    for (int ri = 0; ri < height; ++ri)
+    {
+      PointOutT *row = &output [ri * width];
+      int run_begin = 0;
+      int run_size = 0;
+      for (int ci = 0; ci <= width; ++ci)
       {
-        //for (unsigned ci = 0; ci < input_->width; ++ci, ++index)
-        for (unsigned ci = 0; ci < input_->width; ++ci)
+        int size = 0;
+        if (ci < width)
         {
-          index = ri * input_->width + ci;
-
+          const int index = ri * width + ci;
           const float depth = input_->points[index].z;
-          if (!pcl_isfinite (depth))
+          float smoothing = 0.0f;
+          if (pcl_isfinite (depth))
           {
-            output[index].getNormalVector3fMap ().setConstant (bad_point);
-            output[index].curvature = bad_point;
-            continue;
+            if (use_depth_dependent_smoothing_)
+              smoothing = (std::min)(distanceMap[index], normal_smoothing_size_ + static_cast<float>(depth)/10.0f);
+            else
+              smoothing = (std::min)(distanceMap[index], normal_smoothing_size_);
           }
 
-          float smoothing = (std::min)(distanceMap[index], normal_smoothing_size_ + static_cast<float>(depth)/10.0f);
-
           if (smoothing > 2.0f)
           {
-            computePointNormalMirror (ci, ri, index, output [index], static_cast<int> (smoothing), static_cast<int> (smoothing));
+            size = static_cast<int> (smoothing);
+            const int start_x = ci - size / 2;
+            const int start_y = ri - size / 2;
+            if (!use_runs || start_x < 0 || start_y < 0 || start_x + size >= width || start_y + size >= height)
+            {
+              computePointNormalMirror (ci, ri, index, row [ci], size, size);
+              size = 0;
+            }
           }
           else
           {
-            output[index].getNormalVector3fMap ().setConstant (bad_point);
-            output[index].curvature = bad_point;
+            row [ci].getNormalVector3fMap ().setConstant (bad_point);
+            row [ci].curvature = bad_point;
           }
         }
-      }
-    }
-    else
-    {
-      const float smoothing_constant = normal_smoothing_size_;
 
-      //index = border + input_->width * border;
-      //unsigned skip = (border << 1);
-      //for (unsigned ri = border; ri < input_->height - border; ++ri, index += skip)
-#ifdef _OPENMP
-      #pragma omp parallel for num_threads(threads_)
-#endif
-      for (unsigned ri = 0; ri < input_->height; ++ri)
-      {
-        //for (unsigned ci = border; ci < input_->width - border; ++ci, ++index)
-        for (unsigned ci = 0; ci < input_->width; ++ci)
+        if (size != run_size || ci == width)
         {
-          index = ri * input_->width + ci;
-
-          if (!pcl_isfinite (input_->points[index].z))
-          {
-            output [index].getNormalVector3fMap ().setConstant (bad_point);
-            output [index].curvature = bad_point;
-            continue;
-          }
-
-          float smoothing = (std::min)(distanceMap[index], smoothing_constant);
-
-          if (smoothing > 2.0f)
-          {
-            computePointNormalMirror (ci, ri, index, output [index], static_cast<int> (smoothing), static_cast<int> (smoothing));
-          }
-          else
-          {
-            output [index].getNormalVector3fMap ().setConstant (bad_point);
-            output [index].curvature = bad_point;
-          }
+          if (run_size != 0)
+            computePointNormals (run_begin, ri, ci - run_begin, row + run_begin, run_size, run_size);
+          run_begin = ci;
+          run_size = size;
         }
       }
     }
@@ -1075,9 +1226,9 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeFeaturePart (con
     {
       // Iterating over the entire index vector
 #ifdef _OPENMP
-      #pragma omp parallel for num_threads(threads_)
+      #pragma omp parallel for num_threads(this->getComputeThreads ())
 #endif
-      for (std::size_t idx = 0; idx < indices_->size (); ++idx)
+      for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
       {
         unsigned pt_index = (*indices_)[idx];
         unsigned u = pt_index % input_->width;
@@ -1089,7 +1240,7 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeFeaturePart (con
           continue;
         }
 
-        if (u < border || v > right)
+        if (u < border || u > right)
         {
           output.points[idx].getNormalVector3fMap ().setConstant (bad_point);
           output.points[idx].curvature = bad_point;
@@ -1121,9 +1272,9 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeFeaturePart (con
       const float smoothing_constant = normal_smoothing_size_;
       // Iterating over the entire index vector
 #ifdef _OPENMP
-      #pragma omp parallel for num_threads(threads_)
+      #pragma omp parallel for num_threads(this->getComputeThreads ())
 #endif
-      for (std::size_t idx = 0; idx < indices_->size (); ++idx)
+      for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
       {
         unsigned pt_index = (*indices_)[idx];
         unsigned u = pt_index % input_->width;
@@ -1135,7 +1286,7 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeFeaturePart (con
           continue;
         }
 
-        if (u < border || v > right)
+        if (u < border || u > right)
         {
           output.points[idx].getNormalVector3fMap ().setConstant (bad_point);
           output.points[idx].curvature = bad_point;
@@ -1157,8 +1308,8 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeFeaturePart (con
         }
         else
         {
-          output [pt_index].getNormalVector3fMap ().setConstant (bad_point);
-          output [pt_index].curvature = bad_point;
+          output [idx].getNormalVector3fMap ().setConstant (bad_point);
+          output [idx].curvature = bad_point;
         }
       }
     }
@@ -1169,7 +1320,10 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeFeaturePart (con
 
     if (use_depth_dependent_smoothing_)
     {
-      for (std::size_t idx = 0; idx < indices_->size (); ++idx)
+#ifdef _OPENMP
+      #pragma omp parallel for num_threads(this->getComputeThreads ())
+#endif
+      for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
       {
         unsigned pt_index = (*indices_)[idx];
         unsigned u = pt_index % input_->width;
@@ -1199,7 +1353,10 @@ pcl::IntegralImageNormalEstimation<PointInT, PointOutT>::computeFeaturePart (con
     else
     {
       const float smoothing_constant = normal_smoothing_size_;
-      for (size_t idx = 0; idx < indices_->size (); ++idx)
+#ifdef _OPENMP
+      #pragma omp parallel for num_threads(this->getComputeThreads ())
+#endif
+      for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
       {
         unsigned pt_index = (*indices_)[idx];
         unsigned u = pt_index % input_->width;
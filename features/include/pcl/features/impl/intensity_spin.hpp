@@ -138,13 +138,17 @@ pcl::IntensitySpinEstimation<PointInT, PointOutT>::computeFeature (PointCloudOut
   }
 
   Eigen::MatrixXf intensity_spin_image (nr_intensity_bins_, nr_distance_bins_);
-  // Allocate enough space to hold the radiusSearch results
-  std::vector<int> nn_indices (surface_->points.size ());
-  std::vector<float> nn_dist_sqr (surface_->points.size ());
+  // The radiusSearch results are resized by every search, each thread keeps its own buffers
+  std::vector<int> nn_indices;
+  std::vector<float> nn_dist_sqr;
  
-  output.is_dense = true;
+  bool is_dense = true;
   // Iterating over the entire index vector
-  for (size_t idx = 0; idx < indices_->size (); ++idx)
+#ifdef _OPENMP
+#pragma omp parallel for shared (output) private (nn_indices, nn_dist_sqr) firstprivate (intensity_spin_image) \
+  reduction (&& : is_dense) schedule(dynamic, 64) num_threads(this->getComputeThreads ())
+#endif
+  for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
   {
     // Find neighbors within the search radius
     // TODO: do we want to use searchForNeigbors instead?
@@ -153,7 +157,7 @@ pcl::IntensitySpinEstimation<PointInT, PointOutT>::computeFeature (PointCloudOut
     {
       for (int bin = 0; bin < nr_intensity_bins_ * nr_distance_bins_; ++bin)
         output.points[idx].histogram[bin] = std::numeric_limits<float>::quiet_NaN ();
-      output.is_dense = false;
+      is_dense = false;
       continue;
     }
 
@@ -166,6 +170,7 @@ pcl::IntensitySpinEstimation<PointInT, PointOutT>::computeFeature (PointCloudOut
       for (int bin_i = 0; bin_i < intensity_spin_image.rows (); ++bin_i)
         output.points[idx].histogram[bin++] = intensity_spin_image (bin_i, bin_j);
   }
+  output.is_dense = is_dense;
 }
 
 #define PCL_INSTANTIATE_IntensitySpinEstimation(T,NT) template class PCL_EXPORTS pcl::IntensitySpinEstimation<T,NT>;
@@ -60,6 +60,8 @@ pcl::PFHEstimation<PointInT, PointNT, PointOutT>::computePointPFHSignature (
       const std::vector<int> &indices, int nr_split, Eigen::VectorXf &pfh_histogram)
 {
   int h_index, h_p;
+  Eigen::Vector4f pfh_tuple;
+  int f_index[3];
 
   // Clear the resultant point histogram
   pfh_histogram.setZero ();
@@ -67,7 +69,6 @@ pcl::PFHEstimation<PointInT, PointNT, PointOutT>::computePointPFHSignature (
   // Factorization constant
   float hist_incr = 100.0f / static_cast<float> (indices.size () * (indices.size () - 1) / 2);
 
-  std::pair<int, int> key;
   // Iterate over all the points in the neighborhood
   for (size_t i_idx = 0; i_idx < indices.size (); ++i_idx)
   {
@@ -79,75 +80,42 @@ pcl::PFHEstimation<PointInT, PointNT, PointOutT>::computePointPFHSignature (
 
       if (use_cache_)
       {
-        // In order to create the key, always use the smaller index as the first key pair member
-        int p1, p2;
-  //      if (indices[i_idx] >= indices[j_idx])
-  //      {
-          p1 = indices[i_idx];
-          p2 = indices[j_idx];
-  //      }
-  //      else
-  //      {
-  //        p1 = indices[j_idx];
-  //        p2 = indices[i_idx];
-  //      }
-        key = std::pair<int, int> (p1, p2);
-
-        // Check to see if we already estimated this pair in the global hashmap
-        std::map<std::pair<int, int>, Eigen::Vector4f, std::less<std::pair<int, int> >, Eigen::aligned_allocator<Eigen::Vector4f> >::iterator fm_it = feature_map_.find (key);
-        if (fm_it != feature_map_.end ())
-          pfh_tuple_ = fm_it->second;
-        else
+        // Check to see if we already estimated this pair, otherwise compute the pair NNi to NNj and save it
+        if (!feature_cache_.find (indices[i_idx], indices[j_idx], pfh_tuple.data ()))
         {
-          // Compute the pair NNi to NNj
           if (!computePairFeatures (cloud, normals, indices[i_idx], indices[j_idx],
-                                    pfh_tuple_[0], pfh_tuple_[1], pfh_tuple_[2], pfh_tuple_[3]))
+                                    pfh_tuple[0], pfh_tuple[1], pfh_tuple[2], pfh_tuple[3]))
             continue;
+          feature_cache_.insert (indices[i_idx], indices[j_idx], pfh_tuple.data ());
         }
       }
       else
         if (!computePairFeatures (cloud, normals, indices[i_idx], indices[j_idx],
-                                  pfh_tuple_[0], pfh_tuple_[1], pfh_tuple_[2], pfh_tuple_[3]))
+                                  pfh_tuple[0], pfh_tuple[1], pfh_tuple[2], pfh_tuple[3]))
           continue;
 
       // Normalize the f1, f2, f3 features and push them in the histogram
-      f_index_[0] = static_cast<int> (floor (nr_split * ((pfh_tuple_[0] + M_PI) * d_pi_)));
-      if (f_index_[0] < 0)         f_index_[0] = 0;
-      if (f_index_[0] >= nr_split) f_index_[0] = nr_split - 1;
+      f_index[0] = static_cast<int> (floor (nr_split * ((pfh_tuple[0] + M_PI) * d_pi_)));
+      if (f_index[0] < 0)         f_index[0] = 0;
+      if (f_index[0] >= nr_split) f_index[0] = nr_split - 1;
 
-      f_index_[1] = static_cast<int> (floor (nr_split * ((pfh_tuple_[1] + 1.0) * 0.5)));
-      if (f_index_[1] < 0)         f_index_[1] = 0;
-      if (f_index_[1] >= nr_split) f_index_[1] = nr_split - 1;
+      f_index[1] = static_cast<int> (floor (nr_split * ((pfh_tuple[1] + 1.0) * 0.5)));
+      if (f_index[1] < 0)         f_index[1] = 0;
+      if (f_index[1] >= nr_split) f_index[1] = nr_split - 1;
 
-      f_index_[2] = static_cast<int> (floor (nr_split * ((pfh_tuple_[2] + 1.0) * 0.5)));
-      if (f_index_[2] < 0)         f_index_[2] = 0;
-      if (f_index_[2] >= nr_split) f_index_[2] = nr_split - 1;
+      f_index[2] = static_cast<int> (floor (nr_split * ((pfh_tuple[2] + 1.0) * 0.5)));
+      if (f_index[2] < 0)         f_index[2] = 0;
+      if (f_index[2] >= nr_split) f_index[2] = nr_split - 1;
 
       // Copy into the histogram
       h_index = 0;
       h_p     = 1;
       for (int d = 0; d < 3; ++d)
       {
-        h_index += h_p * f_index_[d];
+        h_index += h_p * f_index[d];
         h_p     *= nr_split;
       }
       pfh_histogram[h_index] += hist_incr;
-
-      if (use_cache_)
-      {
-        // Save the value in the hashmap
-        feature_map_[key] = pfh_tuple_;
-
-        // Use a maximum cache so that we don't go overboard on RAM usage
-        key_list_.push (key);
-        // Check to see if we need to remove an element due to exceeding max_size
-        if (key_list_.size () > max_cache_size_)
-        {
-          // Remove the last element.
-          feature_map_.erase (key_list_.back ());
-          key_list_.pop ();
-        }
-      }
     }
   }
 }
@@ -156,65 +124,44 @@ pcl::PFHEstimation<PointInT, PointNT, PointOutT>::computePointPFHSignature (
 template <typename PointInT, typename PointNT, typename PointOutT> void
 pcl::PFHEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
 {
-  // Clear the feature map
-  feature_map_.clear ();
-  std::queue<std::pair<int, int> > empty;
-  std::swap (key_list_, empty);
+  // Clear the feature cache, releasing its memory if it is not used
+  feature_cache_.reset (use_cache_ ? max_cache_size_ : 0);
 
-  pfh_histogram_.setZero (nr_subdiv_ * nr_subdiv_ * nr_subdiv_);
+  const int nr_bins = nr_subdiv_ * nr_subdiv_ * nr_subdiv_;
 
   // Allocate enough space to hold the results
   // \note This resize is irrelevant for a radiusSearch ().
   std::vector<int> nn_indices (k_);
   std::vector<float> nn_dists (k_);
-
-  output.is_dense = true;
-  // Save a few cycles by not checking every point for NaN/Inf values if the cloud is set to dense
-  if (input_->is_dense)
+  Eigen::VectorXf pfh_histogram (nr_bins);
+
+  bool is_dense = true;
+  // Iterating over the entire index vector
+#ifdef _OPENMP
+#pragma omp parallel for shared (output) private (nn_indices, nn_dists) firstprivate (pfh_histogram) \
+  reduction (&& : is_dense) schedule(dynamic, 16) num_threads(this->getComputeThreads ())
+#endif
+  for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
   {
-    // Iterating over the entire index vector
-    for (size_t idx = 0; idx < indices_->size (); ++idx)
+    // Save a few cycles by not checking every point for NaN/Inf values if the cloud is set to dense
+    if ((!input_->is_dense && !isFinite ((*input_)[(*indices_)[idx]])) ||
+        this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
     {
-      if (this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
-      {
-        for (int d = 0; d < pfh_histogram_.size (); ++d)
-          output.points[idx].histogram[d] = std::numeric_limits<float>::quiet_NaN ();
+      for (int d = 0; d < nr_bins; ++d)
+        output.points[idx].histogram[d] = std::numeric_limits<float>::quiet_NaN ();
 
-        output.is_dense = false;
-        continue;
-      }
-
-      // Estimate the PFH signature at each patch
-      computePointPFHSignature (*surface_, *normals_, nn_indices, nr_subdiv_, pfh_histogram_);
-
-      // Copy into the resultant cloud
-      for (int d = 0; d < pfh_histogram_.size (); ++d)
-        output.points[idx].histogram[d] = pfh_histogram_[d];
+      is_dense = false;
+      continue;
     }
-  }
-  else
-  {
-    // Iterating over the entire index vector
-    for (size_t idx = 0; idx < indices_->size (); ++idx)
-    {
-      if (!isFinite ((*input_)[(*indices_)[idx]]) ||
-          this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
-      {
-        for (int d = 0; d < pfh_histogram_.size (); ++d)
-          output.points[idx].histogram[d] = std::numeric_limits<float>::quiet_NaN ();
 
-        output.is_dense = false;
-        continue;
-      }
+    // Estimate the PFH signature at each patch
+    computePointPFHSignature (*surface_, *normals_, nn_indices, nr_subdiv_, pfh_histogram);
 
-      // Estimate the PFH signature at each patch
-      computePointPFHSignature (*surface_, *normals_, nn_indices, nr_subdiv_, pfh_histogram_);
-
-      // Copy into the resultant cloud
-      for (int d = 0; d < pfh_histogram_.size (); ++d)
-        output.points[idx].histogram[d] = pfh_histogram_[d];
-    }
+    // Copy into the resultant cloud
+    for (int d = 0; d < nr_bins; ++d)
+      output.points[idx].histogram[d] = pfh_histogram[d];
   }
+  output.is_dense = is_dense;
 }
 
 #define PCL_INSTANTIATE_PFHEstimation(T,NT,OutT) template class PCL_EXPORTS pcl::PFHEstimation<T,NT,OutT>;
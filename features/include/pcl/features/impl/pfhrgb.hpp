@@ -66,6 +66,8 @@ pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computePointPFHRGBSignature
     const std::vector<int> &indices, int nr_split, Eigen::VectorXf &pfhrgb_histogram)
 {
   int h_index, h_p;
+  float pfhrgb_tuple[7];
+  int f_index[7];
 
   // Clear the resultant point histogram
   pfhrgb_histogram.setZero ();
@@ -82,37 +84,42 @@ pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computePointPFHRGBSignature
       if (i_idx == j_idx)
         continue;
 
-      // Compute the pair NNi to NNj
-      if (!computeRGBPairFeatures (cloud, normals, indices[i_idx], indices[j_idx],
-                                   pfhrgb_tuple_[0], pfhrgb_tuple_[1], pfhrgb_tuple_[2], pfhrgb_tuple_[3],
-                                   pfhrgb_tuple_[4], pfhrgb_tuple_[5], pfhrgb_tuple_[6]))
-        continue;
+      // Check to see if we already estimated this pair, otherwise compute the pair NNi to NNj
+      if (!use_cache_ || !feature_cache_.find (indices[i_idx], indices[j_idx], pfhrgb_tuple))
+      {
+        if (!computeRGBPairFeatures (cloud, normals, indices[i_idx], indices[j_idx],
+                                     pfhrgb_tuple[0], pfhrgb_tuple[1], pfhrgb_tuple[2], pfhrgb_tuple[3],
+                                     pfhrgb_tuple[4], pfhrgb_tuple[5], pfhrgb_tuple[6]))
+          continue;
+        if (use_cache_)
+          feature_cache_.insert (indices[i_idx], indices[j_idx], pfhrgb_tuple);
+      }
 
       // Normalize the f1, f2, f3, f5, f6, f7 features and push them in the histogram
-      f_index_[0] = static_cast<int> (floor (nr_split * ((pfhrgb_tuple_[0] + M_PI) * d_pi_)));
-      if (f_index_[0] < 0)         f_index_[0] = 0;
-      if (f_index_[0] >= nr_split) f_index_[0] = nr_split - 1;
+      f_index[0] = static_cast<int> (floor (nr_split * ((pfhrgb_tuple[0] + M_PI) * d_pi_)));
+      if (f_index[0] < 0)         f_index[0] = 0;
+      if (f_index[0] >= nr_split) f_index[0] = nr_split - 1;
 
-      f_index_[1] = static_cast<int> (floor (nr_split * ((pfhrgb_tuple_[1] + 1.0) * 0.5)));
-      if (f_index_[1] < 0)         f_index_[1] = 0;
-      if (f_index_[1] >= nr_split) f_index_[1] = nr_split - 1;
+      f_index[1] = static_cast<int> (floor (nr_split * ((pfhrgb_tuple[1] + 1.0) * 0.5)));
+      if (f_index[1] < 0)         f_index[1] = 0;
+      if (f_index[1] >= nr_split) f_index[1] = nr_split - 1;
 
-      f_index_[2] = static_cast<int> (floor (nr_split * ((pfhrgb_tuple_[2] + 1.0) * 0.5)));
-      if (f_index_[2] < 0)         f_index_[2] = 0;
-      if (f_index_[2] >= nr_split) f_index_[2] = nr_split - 1;
+      f_index[2] = static_cast<int> (floor (nr_split * ((pfhrgb_tuple[2] + 1.0) * 0.5)));
+      if (f_index[2] < 0)         f_index[2] = 0;
+      if (f_index[2] >= nr_split) f_index[2] = nr_split - 1;
 
       // color ratios are in [-1, 1]
-      f_index_[4] = static_cast<int> (floor (nr_split * ((pfhrgb_tuple_[4] + 1.0) * 0.5)));
-      if (f_index_[4] < 0)         f_index_[4] = 0;
-      if (f_index_[4] >= nr_split) f_index_[4] = nr_split - 1;
+      f_index[4] = static_cast<int> (floor (nr_split * ((pfhrgb_tuple[4] + 1.0) * 0.5)));
+      if (f_index[4] < 0)         f_index[4] = 0;
+      if (f_index[4] >= nr_split) f_index[4] = nr_split - 1;
 
-      f_index_[5] = static_cast<int> (floor (nr_split * ((pfhrgb_tuple_[5] + 1.0) * 0.5)));
-      if (f_index_[5] < 0)         f_index_[5] = 0;
-      if (f_index_[5] >= nr_split) f_index_[5] = nr_split - 1;
+      f_index[5] = static_cast<int> (floor (nr_split * ((pfhrgb_tuple[5] + 1.0) * 0.5)));
+      if (f_index[5] < 0)         f_index[5] = 0;
+      if (f_index[5] >= nr_split) f_index[5] = nr_split - 1;
 
-      f_index_[6] = static_cast<int> (floor (nr_split * ((pfhrgb_tuple_[6] + 1.0) * 0.5)));
-      if (f_index_[6] < 0)         f_index_[6] = 0;
-      if (f_index_[6] >= nr_split) f_index_[6] = nr_split - 1;
+      f_index[6] = static_cast<int> (floor (nr_split * ((pfhrgb_tuple[6] + 1.0) * 0.5)));
+      if (f_index[6] < 0)         f_index[6] = 0;
+      if (f_index[6] >= nr_split) f_index[6] = nr_split - 1;
 
 
       // Copy into the histogram
@@ -120,7 +127,7 @@ pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computePointPFHRGBSignature
       h_p     = 1;
       for (int d = 0; d < 3; ++d)
       {
-        h_index += h_p * f_index_[d];
+        h_index += h_p * f_index[d];
         h_p     *= nr_split;
       }
       pfhrgb_histogram[h_index] += hist_incr;
@@ -130,7 +137,7 @@ pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computePointPFHRGBSignature
       h_p     = 1;
       for (int d = 4; d < 7; ++d)
       {
-        h_index += h_p * f_index_[d];
+        h_index += h_p * f_index[d];
         h_p     *= nr_split;
       }
       pfhrgb_histogram[h_index] += hist_incr;
@@ -142,9 +149,11 @@ pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computePointPFHRGBSignature
 template <typename PointInT, typename PointNT, typename PointOutT> void
 pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
 {
+  // Clear the feature cache, releasing its memory if it is not used
+  feature_cache_.reset (use_cache_ ? max_cache_size_ : 0);
+
   /// nr_subdiv^3 for RGB and nr_subdiv^3 for the angular features
-  pfhrgb_histogram_.setZero (2 * nr_subdiv_ * nr_subdiv_ * nr_subdiv_);
-  pfhrgb_tuple_.setZero (7);
+  Eigen::VectorXf pfhrgb_histogram (Eigen::VectorXf::Zero (2 * nr_subdiv_ * nr_subdiv_ * nr_subdiv_));
 
   // Allocate enough space to hold the results
   // \note This resize is irrelevant for a radiusSearch ().
@@ -152,19 +161,20 @@ pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudO
   std::vector<float> nn_dists (k_);
 
   // Iterating over the entire index vector
-  for (size_t idx = 0; idx < indices_->size (); ++idx)
+#ifdef _OPENMP
+#pragma omp parallel for shared (output) private (nn_indices, nn_dists) firstprivate (pfhrgb_histogram) \
+  schedule(dynamic, 16) num_threads(this->getComputeThreads ())
+#endif
+  for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
   {
     this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists);
 
     // Estimate the PFH signature at each patch
-    computePointPFHRGBSignature (*surface_, *normals_, nn_indices, nr_subdiv_, pfhrgb_histogram_);
+    computePointPFHRGBSignature (*surface_, *normals_, nn_indices, nr_subdiv_, pfhrgb_histogram);
 
     // Copy into the resultant cloud
-    for (int d = 0; d < pfhrgb_histogram_.size (); ++d) {
-      output.points[idx].histogram[d] = pfhrgb_histogram_[d];
-//      PCL_INFO ("%f ", pfhrgb_histogram_[d]);
-    }
-//    PCL_INFO ("\n");
+    for (int d = 0; d < pfhrgb_histogram.size (); ++d)
+      output.points[idx].histogram[d] = pfhrgb_histogram[d];
   }
 }
 
@@ -47,7 +47,7 @@
 template <typename PointInT, typename PointNT, typename PointOutT> void
 pcl::PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::computePointPrincipalCurvatures (
       const pcl::PointCloud<PointNT> &normals, int p_idx, const std::vector<int> &indices,
-      float &pcx, float &pcy, float &pcz, float &pc1, float &pc2)
+      float &pcx, float &pcy, float &pcz, float &pc1, float &pc2) const
 {
   EIGEN_ALIGN16 Eigen::Matrix3f I = Eigen::Matrix3f::Identity ();
   Eigen::Vector3f n_idx (normals.points[p_idx].normal[0], normals.points[p_idx].normal[1], normals.points[p_idx].normal[2]);
@@ -55,57 +55,58 @@ pcl::PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::computePointPr
 
   // Project normals into the tangent plane
   Eigen::Vector3f normal;
-  projected_normals_.resize (indices.size ());
-  xyz_centroid_.setZero ();
+  std::vector<Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f> > projected_normals (indices.size ());
+  Eigen::Vector3f xyz_centroid = Eigen::Vector3f::Zero ();
   for (size_t idx = 0; idx < indices.size(); ++idx)
   {
     normal[0] = normals.points[indices[idx]].normal[0];
     normal[1] = normals.points[indices[idx]].normal[1];
     normal[2] = normals.points[indices[idx]].normal[2];
 
-    projected_normals_[idx] = M * normal;
-    xyz_centroid_ += projected_normals_[idx];
+    projected_normals[idx] = M * normal;
+    xyz_centroid += projected_normals[idx];
   }
 
   // Estimate the XYZ centroid
-  xyz_centroid_ /= static_cast<float> (indices.size ());
+  xyz_centroid /= static_cast<float> (indices.size ());
 
   // Initialize to 0
-  covariance_matrix_.setZero ();
+  EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix = Eigen::Matrix3f::Zero ();
 
   double demean_xy, demean_xz, demean_yz;
   // For each point in the cloud
   for (size_t idx = 0; idx < indices.size (); ++idx)
   {
-    demean_ = projected_normals_[idx] - xyz_centroid_;
+    const Eigen::Vector3f demean = projected_normals[idx] - xyz_centroid;
 
-    demean_xy = demean_[0] * demean_[1];
-    demean_xz = demean_[0] * demean_[2];
-    demean_yz = demean_[1] * demean_[2];
+    demean_xy = demean[0] * demean[1];
+    demean_xz = demean[0] * demean[2];
+    demean_yz = demean[1] * demean[2];
 
-    covariance_matrix_(0, 0) += demean_[0] * demean_[0];
-    covariance_matrix_(0, 1) += static_cast<float> (demean_xy);
-    covariance_matrix_(0, 2) += static_cast<float> (demean_xz);
+    covariance_matrix(0, 0) += demean[0] * demean[0];
+    covariance_matrix(0, 1) += static_cast<float> (demean_xy);
+    covariance_matrix(0, 2) += static_cast<float> (demean_xz);
 
-    covariance_matrix_(1, 0) += static_cast<float> (demean_xy);
-    covariance_matrix_(1, 1) += demean_[1] * demean_[1];
-    covariance_matrix_(1, 2) += static_cast<float> (demean_yz);
+    covariance_matrix(1, 0) += static_cast<float> (demean_xy);
+    covariance_matrix(1, 1) += demean[1] * demean[1];
+    covariance_matrix(1, 2) += static_cast<float> (demean_yz);
 
-    covariance_matrix_(2, 0) += static_cast<float> (demean_xz);
-    covariance_matrix_(2, 1) += static_cast<float> (demean_yz);
-    covariance_matrix_(2, 2) += demean_[2] * demean_[2];
+    covariance_matrix(2, 0) += static_cast<float> (demean_xz);
+    covariance_matrix(2, 1) += static_cast<float> (demean_yz);
+    covariance_matrix(2, 2) += demean[2] * demean[2];
   }
 
   // Extract the eigenvalues and eigenvectors
-  pcl::eigen33 (covariance_matrix_, eigenvalues_);
-  pcl::computeCorrespondingEigenVector (covariance_matrix_, eigenvalues_ [2], eigenvector_);
+  Eigen::Vector3f eigenvalues, eigenvector;
+  pcl::eigen33 (covariance_matrix, eigenvalues);
+  pcl::computeCorrespondingEigenVector (covariance_matrix, eigenvalues [2], eigenvector);
 
-  pcx = eigenvector_ [0];
-  pcy = eigenvector_ [1];
-  pcz = eigenvector_ [2];
+  pcx = eigenvector [0];
+  pcy = eigenvector [1];
+  pcz = eigenvector [2];
   float indices_size = 1.0f / static_cast<float> (indices.size ());
-  pc1 = eigenvalues_ [2] * indices_size;
-  pc2 = eigenvalues_ [1] * indices_size;
+  pc1 = eigenvalues [2] * indices_size;
+  pc2 = eigenvalues [1] * indices_size;
 }
 
 
@@ -118,18 +119,22 @@ pcl::PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::computeFeature
   std::vector<int> nn_indices (k_);
   std::vector<float> nn_dists (k_);
 
-  output.is_dense = true;
+  bool is_dense = true;
   // Save a few cycles by not checking every point for NaN/Inf values if the cloud is set to dense
   if (input_->is_dense)
   {
+#ifdef _OPENMP
+#pragma omp parallel for shared (output) private (nn_indices, nn_dists) reduction (&& : is_dense) schedule(dynamic, 64) \
+  num_threads(this->getComputeThreads ())
+#endif
     // Iterating over the entire index vector
-    for (size_t idx = 0; idx < indices_->size (); ++idx)
+    for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
     {
       if (this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
       {
         output.points[idx].principal_curvature[0] = output.points[idx].principal_curvature[1] = output.points[idx].principal_curvature[2] =
           output.points[idx].pc1 = output.points[idx].pc2 = std::numeric_limits<float>::quiet_NaN ();
-        output.is_dense = false;
+        is_dense = false;
         continue;
       }
 
@@ -141,15 +146,19 @@ pcl::PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::computeFeature
   }
   else
   {
+#ifdef _OPENMP
+#pragma omp parallel for shared (output) private (nn_indices, nn_dists) reduction (&& : is_dense) schedule(dynamic, 64) \
+  num_threads(this->getComputeThreads ())
+#endif
     // Iterating over the entire index vector
-    for (size_t idx = 0; idx < indices_->size (); ++idx)
+    for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
     {
       if (!isFinite ((*input_)[(*indices_)[idx]]) ||
           this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
       {
         output.points[idx].principal_curvature[0] = output.points[idx].principal_curvature[1] = output.points[idx].principal_curvature[2] =
           output.points[idx].pc1 = output.points[idx].pc2 = std::numeric_limits<float>::quiet_NaN ();
-        output.is_dense = false;
+        is_dense = false;
         continue;
       }
 
@@ -159,6 +168,7 @@ pcl::PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::computeFeature
                                        output.points[idx].pc1, output.points[idx].pc2);
     }
   }
+  output.is_dense = is_dense;
 }
 
 #define PCL_INSTANTIATE_PrincipalCurvaturesEstimation(T,NT,OutT) template class PCL_EXPORTS pcl::PrincipalCurvaturesEstimation<T,NT,OutT>;
@@ -145,7 +145,10 @@ pcl::ROPSEstimation <PointInT, PointOutT>::computeFeature (PointCloudOut &output
   unsigned int number_of_points = static_cast <unsigned int> (indices_->size ());
   output.points.resize (number_of_points, PointOutT ());
 
-  for (unsigned int i_point = 0; i_point < number_of_points; i_point++)
+#ifdef _OPENMP
+#pragma omp parallel for shared (output) schedule(dynamic, 8) num_threads(this->getComputeThreads ())
+#endif
+  for (int i_point = 0; i_point < static_cast <int> (number_of_points); i_point++)
   {
     std::set <unsigned int> local_triangles;
     std::vector <int> local_points;
@@ -323,9 +323,35 @@ pcl::SpinImageEstimation<PointInT, PointNT, PointOutT>::initCompute ()
 template <typename PointInT, typename PointNT, typename PointOutT> void 
 pcl::SpinImageEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
 { 
+  // Exceptions must not leave the parallel region: keep the one raised for the lowest
+  // index and rethrow it once all the points have been processed
+  boost::shared_ptr<PCLException> error;
+  int error_index = static_cast<int> (indices_->size ());
+
+#ifdef _OPENMP
+#pragma omp parallel for shared (output, error, error_index) schedule(dynamic, 16) num_threads(this->getComputeThreads ())
+#endif
   for (int i_input = 0; i_input < static_cast<int> (indices_->size ()); ++i_input)
   {
-    Eigen::ArrayXXd res = computeSiForPoint (indices_->at (i_input));
+    Eigen::ArrayXXd res;
+    try
+    {
+      res = computeSiForPoint (indices_->at (i_input));
+    }
+    catch (const PCLException &e)
+    {
+#ifdef _OPENMP
+#pragma omp critical (spin_image_error)
+#endif
+      {
+        if (i_input < error_index)
+        {
+          error.reset (new PCLException (e));
+          error_index = i_input;
+        }
+      }
+      continue;
+    }
 
     // Copy into the resultant cloud
     for (int iRow = 0; iRow < res.rows () ; iRow++)
@@ -336,6 +362,9 @@ pcl::SpinImageEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointClo
       }
     }   
   } 
+
+  if (error)
+    throw *error;
 }
 
 #define PCL_INSTANTIATE_SpinImageEstimation(T,NT,OutT) template class PCL_EXPORTS pcl::SpinImageEstimation<T,NT,OutT>;
@@ -141,7 +141,7 @@ pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::initCompute ()
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT, typename PointRFT> void
-pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::computePointDescriptor (size_t index, /*float rf[9],*/ std::vector<float> &desc)
+pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::computePointDescriptor (size_t index, /*float rf[9],*/ std::vector<float> &desc) const
 {
   pcl::Vector3fMapConst origin = input_->points[(*indices_)[index]].getVector3fMap ();
 
@@ -248,12 +248,13 @@ pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::computeFeature (PointClo
 {
   assert (descriptor_length_ == 1960);
 
-  output.is_dense = true;
+  bool is_dense = true;
 
-  for (size_t point_index = 0; point_index < indices_->size (); ++point_index)
+#ifdef _OPENMP
+#pragma omp parallel for reduction (&& : is_dense) schedule(dynamic, 16) num_threads(this->getComputeThreads ())
+#endif
+  for (int point_index = 0; point_index < static_cast<int> (indices_->size ()); ++point_index)
   {
-    //output[point_index].descriptor.resize (descriptor_length_);
-
     // If the point is not finite, set the descriptor to NaN and continue
     const PointRFT& current_frame = (*frames_)[point_index];
     if (!isFinite ((*input_)[(*indices_)[point_index]]) ||
@@ -265,7 +266,7 @@ pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::computeFeature (PointClo
         output[point_index].descriptor[i] = std::numeric_limits<float>::quiet_NaN ();
 
       memset (output[point_index].rf, 0, sizeof (output[point_index].rf[0]) * 9);
-      output.is_dense = false;
+      is_dense = false;
       continue;
     }
 
@@ -281,6 +282,7 @@ pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::computeFeature (PointClo
     for (size_t j = 0; j < descriptor_length_; ++j)
       output [point_index].descriptor[j] = descriptor[j];
   }
+  output.is_dense = is_dense;
 }
 
 #define PCL_INSTANTIATE_UniqueShapeContext(T,OutT,RFT) template class PCL_EXPORTS pcl::UniqueShapeContext<T,OutT,RFT>;
@@ -101,6 +101,13 @@ namespace pcl
   };
 
   /** \brief Determines an integral image representation for a given organized data array
+    *
+    * Every channel of the integral images is stored in its own plane of (width + 1) * (height + 1)
+    * values (structure of arrays), so the rectangle sums of consecutive pixels of a row can be
+    * evaluated at once, see \ref getFirstOrderSums. The integral images are computed in two passes,
+    * which can both run in parallel: the rows of the input are prefix summed independently, then the
+    * columns are accumulated in tiles. A single thread merges both passes. The result does not depend
+    * on the number of threads.
     * \author Suat Gedikli
     */
   template <class DataType, unsigned Dimension>
@@ -108,8 +115,9 @@ namespace pcl
   {
     public:
       static const unsigned second_order_size = (Dimension * (Dimension + 1)) >> 1;
-      typedef Eigen::Matrix<typename IntegralImageTypeTraits<DataType>::IntegralType, Dimension, 1> ElementType;
-      typedef Eigen::Matrix<typename IntegralImageTypeTraits<DataType>::IntegralType, second_order_size, 1> SecondOrderType;
+      typedef typename IntegralImageTypeTraits<DataType>::IntegralType IntegralType;
+      typedef Eigen::Matrix<IntegralType, Dimension, 1> ElementType;
+      typedef Eigen::Matrix<IntegralType, second_order_size, 1> SecondOrderType;
 
       /** \brief Constructor for an Integral Image
         * \param[in] compute_second_order_integral_images set to true if we want to compute a second order image
@@ -120,7 +128,9 @@ namespace pcl
         finite_values_integral_image_ (),
         width_ (1), 
         height_ (1), 
-        compute_second_order_integral_images_ (compute_second_order_integral_images)
+        plane_size_ (0),
+        compute_second_order_integral_images_ (compute_second_order_integral_images),
+        threads_ (1)
       {
       }
 
@@ -134,6 +144,16 @@ namespace pcl
       void 
       setSecondOrderComputation (bool compute_second_order_integral_images);
 
+      /** \brief Set the number of threads used to compute the integral images.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+      /** \brief Get the number of threads used to compute the integral images (0 means automatic). */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
       /** \brief Set the input data to compute the integral image for
         * \param[in] data the input data
         * \param[in] width the width of the data
@@ -199,6 +219,45 @@ namespace pcl
       inline unsigned
       getFiniteElementsCountSE (unsigned start_x, unsigned start_y, unsigned end_x, unsigned end_y) const;
 
+      /** \brief Compute the first order sums within count rectangles of the same size, the i-th one starting
+        * at (start_x + i, start_y). Channel d of the i-th sum is written to sums[d * count + i].
+        * \param[in] start_x x position of the first rectangle
+        * \param[in] start_y y position of the rectangles
+        * \param[in] width width of the rectangles
+        * \param[in] height height of the rectangles
+        * \param[in] count the number of rectangles
+        * \param[out] sums the resultant sums, Dimension * count values
+        */
+      void
+      getFirstOrderSums (unsigned start_x, unsigned start_y, unsigned width, unsigned height,
+                         unsigned count, IntegralType *sums) const;
+
+      /** \brief Compute the second order sums within count rectangles of the same size, the i-th one starting
+        * at (start_x + i, start_y). Entry e of the i-th sum is written to sums[e * count + i].
+        * \param[in] start_x x position of the first rectangle
+        * \param[in] start_y y position of the rectangles
+        * \param[in] width width of the rectangles
+        * \param[in] height height of the rectangles
+        * \param[in] count the number of rectangles
+        * \param[out] sums the resultant sums, second_order_size * count values
+        */
+      void
+      getSecondOrderSums (unsigned start_x, unsigned start_y, unsigned width, unsigned height,
+                          unsigned count, IntegralType *sums) const;
+
+      /** \brief Compute the number of finite elements within count rectangles of the same size, the i-th one
+        * starting at (start_x + i, start_y).
+        * \param[in] start_x x position of the first rectangle
+        * \param[in] start_y y position of the rectangles
+        * \param[in] width width of the rectangles
+        * \param[in] height height of the rectangles
+        * \param[in] count the number of rectangles
+        * \param[out] counts the resultant numbers of finite elements, count values
+        */
+      void
+      getFiniteElementsCounts (unsigned start_x, unsigned start_y, unsigned width, unsigned height,
+                               unsigned count, unsigned *counts) const;
+
     private:
       typedef Eigen::Matrix<typename IntegralImageTypeTraits<DataType>::Type, Dimension, 1> InputType;
 
@@ -210,17 +269,25 @@ namespace pcl
       void
       computeIntegralImages (const DataType * data, unsigned row_stride, unsigned element_stride);
 
-      std::vector<ElementType, Eigen::aligned_allocator<ElementType> > first_order_integral_image_;
-      std::vector<SecondOrderType, Eigen::aligned_allocator<SecondOrderType> > second_order_integral_image_;
+      /** \brief The first order integral images, one plane per channel */
+      std::vector<IntegralType> first_order_integral_image_;
+      /** \brief The second order integral images, one plane per entry of the upper triangle of the outer product */
+      std::vector<IntegralType> second_order_integral_image_;
+      /** \brief The integral image of the number of finite elements */
       std::vector<unsigned> finite_values_integral_image_;
 
       /** \brief The width of the 2d input data array */
       unsigned width_;
       /** \brief The height of the 2d input data array */
       unsigned height_;
+      /** \brief The number of values of a plane, i.e. (width_ + 1) * (height_ + 1) */
+      size_t plane_size_;
 
       /** \brief Indicates whether second order integral images are available **/
       bool compute_second_order_integral_images_;
+
+      /** \brief The number of threads used to compute the integral images */
+      unsigned int threads_;
    };
 
    /**
@@ -231,6 +298,7 @@ namespace pcl
   {
     public:
       static const unsigned second_order_size = 1;
+      typedef typename IntegralImageTypeTraits<DataType>::IntegralType IntegralType;
       typedef typename IntegralImageTypeTraits<DataType>::IntegralType ElementType;
       typedef typename IntegralImageTypeTraits<DataType>::IntegralType SecondOrderType;
 
@@ -242,7 +310,8 @@ namespace pcl
         second_order_integral_image_ (),
         finite_values_integral_image_ (),
         width_ (1), height_ (1), 
-        compute_second_order_integral_images_ (compute_second_order_integral_images)
+        compute_second_order_integral_images_ (compute_second_order_integral_images),
+        threads_ (1)
       {
       }
 
@@ -250,6 +319,16 @@ namespace pcl
       virtual
       ~IntegralImage2D () { }
 
+      /** \brief Set the number of threads used to compute the integral images.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+      /** \brief Get the number of threads used to compute the integral images (0 means automatic). */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
       /** \brief Set the input data to compute the integral image for
         * \param[in] data the input data
         * \param[in] width the width of the data
@@ -315,6 +394,45 @@ namespace pcl
       inline unsigned
       getFiniteElementsCountSE (unsigned start_x, unsigned start_y, unsigned end_x, unsigned end_y) const;
 
+      /** \brief Compute the first order sums within count rectangles of the same size, the i-th one starting
+        * at (start_x + i, start_y).
+        * \param[in] start_x x position of the first rectangle
+        * \param[in] start_y y position of the rectangles
+        * \param[in] width width of the rectangles
+        * \param[in] height height of the rectangles
+        * \param[in] count the number of rectangles
+        * \param[out] sums the resultant sums, count values
+        */
+      void
+      getFirstOrderSums (unsigned start_x, unsigned start_y, unsigned width, unsigned height,
+                         unsigned count, ElementType *sums) const;
+
+      /** \brief Compute the second order sums within count rectangles of the same size, the i-th one starting
+        * at (start_x + i, start_y).
+        * \param[in] start_x x position of the first rectangle
+        * \param[in] start_y y position of the rectangles
+        * \param[in] width width of the rectangles
+        * \param[in] height height of the rectangles
+        * \param[in] count the number of rectangles
+        * \param[out] sums the resultant sums, count values
+        */
+      void
+      getSecondOrderSums (unsigned start_x, unsigned start_y, unsigned width, unsigned height,
+                          unsigned count, SecondOrderType *sums) const;
+
+      /** \brief Compute the number of finite elements within count rectangles of the same size, the i-th one
+        * starting at (start_x + i, start_y).
+        * \param[in] start_x x position of the first rectangle
+        * \param[in] start_y y position of the rectangles
+        * \param[in] width width of the rectangles
+        * \param[in] height height of the rectangles
+        * \param[in] count the number of rectangles
+        * \param[out] counts the resultant numbers of finite elements, count values
+        */
+      void
+      getFiniteElementsCounts (unsigned start_x, unsigned start_y, unsigned width, unsigned height,
+                               unsigned count, unsigned *counts) const;
+
   private:
     //  typedef typename IntegralImageTypeTraits<DataType>::Type InputType;
 
@@ -337,6 +455,9 @@ namespace pcl
 
       /** \brief Indicates whether second order integral images are available **/
       bool compute_second_order_integral_images_;
+
+      /** \brief The number of threads used to compute the integral images */
+      unsigned int threads_;
    };
  }
 
@@ -72,6 +72,7 @@ namespace pcl
     using Feature<PointInT, PointOutT>::tree_;
     using Feature<PointInT, PointOutT>::k_;
     using Feature<PointInT, PointOutT>::indices_;
+    using Feature<PointInT, PointOutT>::threads_;
 
     public:
       typedef boost::shared_ptr<IntegralImageNormalEstimation<PointInT, PointOutT> > Ptr;
@@ -148,6 +149,20 @@ namespace pcl
       computePointNormalMirror (const int pos_x, const int pos_y, const unsigned point_index, PointOutT &normal,
         int rect_width, int rect_height);
 
+      /** \brief Computes the normals at consecutive positions of a row, using the same rectangle size for all
+        * of them. The rectangle sums of all positions are evaluated at once from the integral images, which is
+        * considerably faster than calling \ref computePointNormal for every position. No border handling is done.
+        * \param[in] pos_x x position (pixel) of the first point
+        * \param[in] pos_y y position (pixel) of the points
+        * \param[in] count the number of points
+        * \param[out] normals the output estimated normals, one per point
+        * \param[in] rect_width the width of the rectangle within which the normals are estimated
+        * \param[in] rect_height the height of the rectangle within which the normals are estimated
+        */
+      void
+      computePointNormals (const int pos_x, const int pos_y, const unsigned count, PointOutT *normals,
+        int rect_width, int rect_height);
+
       /** \brief The depth change threshold for computing object borders
         * \param[in] max_depth_change_factor the depth change threshold for computing object borders based on
         * depth changes
@@ -287,12 +302,6 @@ namespace pcl
         }
       }
 
-      /** \brief Initialize the scheduler and set the number of threads to use.
-        * \param nr_threads the number of hardware threads to use (0 sets the value back to automatic)
-        */
-      inline void
-      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
-
     protected:
 
       /** \brief Computes the normal for the complete cloud or only \a indices_ if provided.
@@ -355,6 +364,55 @@ namespace pcl
         }
       }
 
+      /** \brief Computes the normal and the curvature of a point from the covariance matrix of its neighborhood.
+        * \param[in] count the number of valid points in the neighborhood
+        * \param[in] sum the sum of the neighborhood points
+        * \param[in] so_sum the sum of the second order products of the neighborhood points
+        * \param[in] point_index the position index of the point
+        * \param[out] normal the output estimated normal
+        */
+      void
+      computeNormalFromMoments (unsigned count, const Eigen::Vector3d &sum,
+                                const typename IntegralImage2D<float, 3>::SecondOrderType &so_sum,
+                                const unsigned point_index, PointOutT &normal);
+
+      /** \brief Computes the normal of a point as the cross product of the vertical and the horizontal gradients.
+        * \param[in] gradient_x the horizontal 3D gradient
+        * \param[in] gradient_y the vertical 3D gradient
+        * \param[in] point_index the position index of the point
+        * \param[out] normal the output estimated normal
+        */
+      void
+      computeNormalFromGradients (const Eigen::Vector3d &gradient_x, const Eigen::Vector3d &gradient_y,
+                                  const unsigned point_index, PointOutT &normal);
+
+      /** \brief Sets a normal computed from the gradients of a point, flipped towards the viewpoint.
+        * \param[in] normal_vector the unit normal vector, with its coordinates stride elements apart
+        * \param[in] stride the distance of the coordinates in normal_vector
+        * \param[in] point_index the position index of the point
+        * \param[out] normal the output estimated normal
+        */
+      void
+      setGradientNormal (const double *normal_vector, unsigned stride, const unsigned point_index, PointOutT &normal);
+
+      /** \brief Computes the normal of a point from the mean depths left, right, above and below of it.
+        * \param[in] mean_L_z the mean depth left of the point
+        * \param[in] mean_R_z the mean depth right of the point
+        * \param[in] mean_U_z the mean depth above the point
+        * \param[in] mean_D_z the mean depth below the point
+        * \param[in] pointL the point left of the point
+        * \param[in] pointR the point right of the point
+        * \param[in] pointU the point above the point
+        * \param[in] pointD the point below the point
+        * \param[in] point_index the position index of the point
+        * \param[out] normal the output estimated normal
+        */
+      void
+      computeNormalFromDepthChange (float mean_L_z, float mean_R_z, float mean_U_z, float mean_D_z,
+                                    const PointInT &pointL, const PointInT &pointR,
+                                    const PointInT &pointU, const PointInT &pointD,
+                                    const unsigned point_index, PointOutT &normal);
+
       /** \brief The normal estimation method to use. Currently, 3 implementations are provided:
         *
         * - COVARIANCE_MATRIX
@@ -417,13 +475,14 @@ namespace pcl
       /** whether the sensor origin of the input cloud or a user given viewpoint should be used.*/
       bool use_sensor_origin_;
 
-      /** \brief The number of threads the scheduler should use. */
-      int threads_;
-      
       /** \brief This method should get called before starting the actual computation. */
       bool
       initCompute ();
 
+      /** \brief The normals of the whole image are written at the positions of their pixels. */
+      bool
+      supportsSpatialOrder () const { return (false); }
+
       /** \brief Internal initialization method for COVARIANCE_MATRIX estimation. */
       void
       initCovarianceMatrixMethod ();
@@ -74,20 +74,14 @@ namespace pcl
       /** \brief Initialize the scheduler and set the number of threads to use.
         * \param nr_threads the number of hardware threads to use (0 sets the value back to automatic)
         */
-      NormalEstimationOMP (unsigned int nr_threads = 0) : threads_ (nr_threads)
+      NormalEstimationOMP (unsigned int nr_threads = 0)
       {
         feature_name_ = "NormalEstimationOMP";
+        threads_ = nr_threads;
       }
 
-      /** \brief Initialize the scheduler and set the number of threads to use.
-        * \param nr_threads the number of hardware threads to use (0 sets the value back to automatic)
-        */
-      inline void 
-      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
-
     protected:
-      /** \brief The number of threads the scheduler should use. */
-      unsigned int threads_;
+      using Feature<PointInT, PointOutT>::threads_;
 
     private:
       /** \brief Estimate normals for all points given in <setInputCloud (), setIndices ()> using the surface in
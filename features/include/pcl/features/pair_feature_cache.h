@@ -0,0 +1,388 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_FEATURES_PAIR_FEATURE_CACHE_H_
+#define PCL_FEATURES_PAIR_FEATURE_CACHE_H_
+
+#include <pcl/pcl_macros.h>
+#include <algorithm>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace pcl
+{
+  /** \brief PairFeatureCache stores the \a Dim dimensional features computed for ordered pairs of point indices
+    * (e.g. the PFH 4-tuples), so that the pairs shared by overlapping neighborhoods are only estimated once.
+    *
+    * The cache is an open-addressing hash table split into independently locked shards, so \ref find and
+    * \ref insert can be called concurrently from OpenMP threads. Every key hashes to a bucket of \ref WAYS
+    * slots; the shards start small and double their number of buckets until the maximum size is reached,
+    * after which the CLOCK (second chance) policy of the bucket chooses the entry to evict.
+    *
+    * \note \ref reset, \ref clear and \ref size must not be called while other threads use the cache.
+    * \ingroup features
+    */
+  template <int Dim>
+  class PairFeatureCache
+  {
+    public:
+      /** \brief Number of independently locked shards. */
+      static const int NR_SHARDS = 64;
+      /** \brief Number of slots in a bucket. */
+      static const int WAYS = 8;
+
+      /** \brief Constructor.
+        * \param[in] max_size the maximum number of cached pairs (0 disables the cache)
+        */
+      PairFeatureCache (size_t max_size = 0) : max_size_ (0)
+      {
+        initLocks ();
+        reset (max_size);
+      }
+
+      /** \brief Copy constructor. The copy has the same maximum size, but starts empty. */
+      PairFeatureCache (const PairFeatureCache &other) : max_size_ (0)
+      {
+        initLocks ();
+        reset (other.max_size_);
+      }
+
+      /** \brief Assignment operator. The cache takes the maximum size of \a other, but is emptied. */
+      PairFeatureCache&
+      operator = (const PairFeatureCache &other)
+      {
+        if (this != &other)
+          reset (other.max_size_);
+        return (*this);
+      }
+
+      /** \brief Destructor. */
+      ~PairFeatureCache ()
+      {
+#ifdef _OPENMP
+        for (int s = 0; s < NR_SHARDS; ++s)
+          omp_destroy_lock (&shards_[s].lock);
+#endif
+      }
+
+      /** \brief Remove all the cached pairs and set the maximum number of pairs to keep.
+        * \param[in] max_size the maximum number of cached pairs (0 disables the cache)
+        */
+      void
+      reset (size_t max_size)
+      {
+        max_size_ = max_size;
+        for (int s = 0; s < NR_SHARDS; ++s)
+        {
+          // The pairs are spread over the shards, and every shard gets the largest power of two number of
+          // buckets that fits in its share. A share smaller than a bucket is enforced by Shard::max_size.
+          const size_t shard_size = max_size / NR_SHARDS + (static_cast<size_t> (s) < max_size % NR_SHARDS ? 1 : 0);
+          size_t max_buckets = 0;
+          if (shard_size > 0)
+            for (max_buckets = 1; 2 * max_buckets * WAYS <= shard_size; max_buckets *= 2) ;
+          shards_[s].max_buckets = max_buckets;
+          shards_[s].max_size = shard_size;
+          allocate (shards_[s], (std::min) (max_buckets, static_cast<size_t> (INITIAL_BUCKETS)));
+        }
+      }
+
+      /** \brief Remove all the cached pairs. */
+      inline void
+      clear ()
+      {
+        reset (max_size_);
+      }
+
+      /** \brief Get the maximum number of cached pairs. */
+      inline size_t
+      getMaximumSize () const
+      {
+        return (max_size_);
+      }
+
+      /** \brief Get the number of cached pairs. */
+      size_t
+      size () const
+      {
+        size_t result = 0;
+        for (int s = 0; s < NR_SHARDS; ++s)
+          result += shards_[s].size;
+        return (result);
+      }
+
+      /** \brief Look up the feature of a pair of points.
+        * \param[in] p_idx the index of the first point of the pair
+        * \param[in] q_idx the index of the second point of the pair
+        * \param[out] value the cached feature, if found
+        * \return true if the pair was found in the cache
+        */
+      bool
+      find (int p_idx, int q_idx, float *value)
+      {
+        const uint64_t key = makeKey (p_idx, q_idx);
+        const uint64_t hash = mix (key);
+        Shard &shard = shards_[hash >> SHARD_SHIFT];
+        lock (shard);
+        if (shard.nr_buckets == 0)
+        {
+          unlock (shard);
+          return (false);
+        }
+
+        const size_t base = (hash & (shard.nr_buckets - 1)) * WAYS;
+        bool found = false;
+        for (size_t slot = base; slot < base + WAYS; ++slot)
+        {
+          if (shard.keys[slot] == key)
+          {
+            std::copy (&shard.values[slot * Dim], &shard.values[slot * Dim] + Dim, value);
+            shard.referenced[slot] = 1;
+            found = true;
+            break;
+          }
+        }
+        unlock (shard);
+        return (found);
+      }
+
+      /** \brief Store the feature of a pair of points, evicting an older pair if the cache is full.
+        * \param[in] p_idx the index of the first point of the pair
+        * \param[in] q_idx the index of the second point of the pair
+        * \param[in] value the feature to store
+        */
+      void
+      insert (int p_idx, int q_idx, const float *value)
+      {
+        const uint64_t key = makeKey (p_idx, q_idx);
+        const uint64_t hash = mix (key);
+        Shard &shard = shards_[hash >> SHARD_SHIFT];
+        lock (shard);
+        if (shard.nr_buckets == 0)
+        {
+          unlock (shard);
+          return;
+        }
+
+        size_t slot = findSlot (shard, hash, key);
+        if (slot == NO_SLOT && shard.nr_buckets < shard.max_buckets)
+        {
+          // The bucket is full: split every bucket of the shard in two and try again
+          grow (shard);
+          slot = findSlot (shard, hash, key);
+        }
+        // A shard holding fewer pairs than a bucket is full before its bucket is
+        if (slot != NO_SLOT && shard.keys[slot] == EMPTY_KEY && shard.size >= shard.max_size)
+          slot = NO_SLOT;
+        if (slot == NO_SLOT)
+        {
+          slot = evict (shard, (hash & (shard.nr_buckets - 1)));
+          if (slot == NO_SLOT)
+          {
+            unlock (shard);
+            return;
+          }
+        }
+        else if (shard.keys[slot] == EMPTY_KEY)
+          ++shard.size;
+        shard.keys[slot] = key;
+        shard.referenced[slot] = 0;
+        std::copy (value, value + Dim, &shard.values[slot * Dim]);
+        unlock (shard);
+      }
+
+    private:
+      static const int INITIAL_BUCKETS = 64;
+      static const int SHARD_SHIFT = 58;   // 64 - log2 (NR_SHARDS)
+      static const size_t NO_SLOT = static_cast<size_t> (-1);
+      static const uint64_t EMPTY_KEY = ~static_cast<uint64_t> (0);
+
+      struct Shard
+      {
+        Shard () : nr_buckets (0), max_buckets (0), max_size (0), size (0) {}
+
+        /** \brief Pair keys, WAYS consecutive slots per bucket (EMPTY_KEY marks a free slot). */
+        std::vector<uint64_t> keys;
+        /** \brief Features, Dim consecutive values per slot. */
+        std::vector<float> values;
+        /** \brief CLOCK reference bits, set on every hit. */
+        std::vector<unsigned char> referenced;
+        /** \brief CLOCK hand of every bucket. */
+        std::vector<unsigned char> hands;
+        size_t nr_buckets;
+        size_t max_buckets;
+        /** \brief Maximum number of pairs in the shard, its share of the maximum size of the cache. */
+        size_t max_size;
+        size_t size;
+#ifdef _OPENMP
+        omp_lock_t lock;
+#endif
+      };
+
+      /** \brief Combine the two point indices into a single key. */
+      static inline uint64_t
+      makeKey (int p_idx, int q_idx)
+      {
+        return ((static_cast<uint64_t> (static_cast<uint32_t> (p_idx)) << 32) | static_cast<uint32_t> (q_idx));
+      }
+
+      /** \brief 64 bit finalizer of MurmurHash3: the high bits select the shard, the low bits the bucket. */
+      static inline uint64_t
+      mix (uint64_t key)
+      {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        return (key);
+      }
+
+      /** \brief Return the slot holding \a key, or else a free slot of its bucket, or else NO_SLOT. */
+      static inline size_t
+      findSlot (const Shard &shard, uint64_t hash, uint64_t key)
+      {
+        const size_t base = (hash & (shard.nr_buckets - 1)) * WAYS;
+        size_t free_slot = NO_SLOT;
+        for (size_t slot = base; slot < base + WAYS; ++slot)
+        {
+          if (shard.keys[slot] == key)
+            return (slot);
+          if (free_slot == NO_SLOT && shard.keys[slot] == EMPTY_KEY)
+            free_slot = slot;
+        }
+        return (free_slot);
+      }
+
+      /** \brief Advance the CLOCK hand of a bucket to the first used slot not referenced since the last pass.
+        * \return the slot to evict, or NO_SLOT if the bucket is empty
+        */
+      static inline size_t
+      evict (Shard &shard, size_t bucket)
+      {
+        unsigned char &hand = shard.hands[bucket];
+        // Two passes at most: the first one clears the reference bits
+        for (int step = 0; step < 2 * WAYS; ++step)
+        {
+          const size_t slot = bucket * WAYS + hand;
+          hand = static_cast<unsigned char> ((hand + 1) % WAYS);
+          if (shard.keys[slot] == EMPTY_KEY)
+            continue;
+          if (!shard.referenced[slot])
+            return (slot);
+          shard.referenced[slot] = 0;
+        }
+        return (NO_SLOT);
+      }
+
+      /** \brief Allocate \a nr_buckets empty buckets for a shard. */
+      static void
+      allocate (Shard &shard, size_t nr_buckets)
+      {
+        std::vector<uint64_t> (nr_buckets * WAYS, static_cast<uint64_t> (EMPTY_KEY)).swap (shard.keys);
+        std::vector<float> (nr_buckets * WAYS * Dim).swap (shard.values);
+        std::vector<unsigned char> (nr_buckets * WAYS, 0).swap (shard.referenced);
+        std::vector<unsigned char> (nr_buckets, 0).swap (shard.hands);
+        shard.nr_buckets = nr_buckets;
+        shard.size = 0;
+      }
+
+      /** \brief Double the number of buckets of a shard. Bucket b is split into buckets b and b + nr_buckets,
+        * so the entries of a bucket always fit in their new one.
+        */
+      static void
+      grow (Shard &shard)
+      {
+        Shard old;
+        old.keys.swap (shard.keys);
+        old.values.swap (shard.values);
+        old.referenced.swap (shard.referenced);
+        allocate (shard, 2 * shard.nr_buckets);
+        for (size_t old_slot = 0; old_slot < old.keys.size (); ++old_slot)
+        {
+          if (old.keys[old_slot] == EMPTY_KEY)
+            continue;
+          const size_t slot = findSlot (shard, mix (old.keys[old_slot]), old.keys[old_slot]);
+          shard.keys[slot] = old.keys[old_slot];
+          shard.referenced[slot] = old.referenced[old_slot];
+          std::copy (&old.values[old_slot * Dim], &old.values[old_slot * Dim] + Dim, &shard.values[slot * Dim]);
+          ++shard.size;
+        }
+      }
+
+      inline void
+      initLocks ()
+      {
+#ifdef _OPENMP
+        for (int s = 0; s < NR_SHARDS; ++s)
+          omp_init_lock (&shards_[s].lock);
+#endif
+      }
+
+      static inline void
+      lock (Shard &shard)
+      {
+#ifdef _OPENMP
+        omp_set_lock (&shard.lock);
+#else
+        (void) shard;
+#endif
+      }
+
+      static inline void
+      unlock (Shard &shard)
+      {
+#ifdef _OPENMP
+        omp_unset_lock (&shard.lock);
+#else
+        (void) shard;
+#endif
+      }
+
+      /** \brief The maximum number of cached pairs. */
+      size_t max_size_;
+
+      /** \brief The shards of the table. */
+      Shard shards_[NR_SHARDS];
+  };
+}
+
+#endif    // PCL_FEATURES_PAIR_FEATURE_CACHE_H_
@@ -44,7 +44,7 @@
 #include <pcl/point_types.h>
 #include <pcl/features/feature.h>
 #include <pcl/features/pfh_tools.h>
-#include <map>
+#include <pcl/features/pair_feature_cache.h>
 
 namespace pcl
 {
@@ -72,8 +72,8 @@ namespace pcl
     *     doesn't have finite 3D coordinates. Therefore, any point that contains
     *     NaN data on x, y, or z, will have its PFH feature property set to NaN.
     *
-    * \note The code is stateful as we do not expect this class to be multicore parallelized. Please look at
-    * \ref FPFHEstimationOMP for examples on parallel implementations of the FPFH (Fast Point Feature Histogram).
+    * \note The features of the query points are estimated in parallel with \ref setNumberOfThreads. The
+    * internal cache (see \ref setUseInternalCache) is shared by all the threads.
     *
     * \author Radu B. Rusu
     * \ingroup features
@@ -101,11 +101,8 @@ namespace pcl
         */
       PFHEstimation () : 
         nr_subdiv_ (5), 
-        pfh_histogram_ (),
-        pfh_tuple_ (),
         d_pi_ (1.0f / (2.0f * static_cast<float> (M_PI))), 
-        feature_map_ (),
-        key_list_ (),
+        feature_cache_ (),
         // Default 1GB memory size. Need to set it to something more conservative.
         max_cache_size_ ((1ul*1024ul*1024ul*1024ul) / sizeof (std::pair<std::pair<int, int>, Eigen::Vector4f>)),
         use_cache_ (false)
@@ -134,7 +131,8 @@ namespace pcl
         * \note Depending on how the point cloud is ordered and how the nearest
         * neighbors are estimated, using a cache could have a positive or a
         * negative influence. Please test with and without a cache on your
-        * data, and choose whatever works best!
+        * data, and choose whatever works best! The cached pair features are
+        * identical to the computed ones, so the result does not change.
         *
         * See \ref setMaximumCacheSize for setting the maximum cache size
         *
@@ -195,25 +193,13 @@ namespace pcl
       /** \brief The number of subdivisions for each angular feature interval. */
       int nr_subdiv_;
 
-      /** \brief Placeholder for a point's PFH signature. */
-      Eigen::VectorXf pfh_histogram_;
-
-      /** \brief Placeholder for a PFH 4-tuple. */
-      Eigen::Vector4f pfh_tuple_;
-
-      /** \brief Placeholder for a histogram index. */
-      int f_index_[3];
-
       /** \brief Float constant = 1.0 / (2.0 * M_PI) */
       float d_pi_; 
 
-      /** \brief Internal hashmap, used to optimize efficiency of redundant computations. */
-      std::map<std::pair<int, int>, Eigen::Vector4f, std::less<std::pair<int, int> >, Eigen::aligned_allocator<Eigen::Vector4f> > feature_map_;
-
-      /** \brief Queue of pairs saved, used to constrain memory usage. */
-      std::queue<std::pair<int, int> > key_list_;
+      /** \brief Internal pair feature cache, used to optimize efficiency of redundant computations. */
+      PairFeatureCache<4> feature_cache_;
 
-      /** \brief Maximum size of internal cache memory. */
+      /** \brief Maximum number of pairs kept in the internal cache. */
       unsigned int max_cache_size_;
 
       /** \brief Set to true to use the internal cache for removing redundant computations. */
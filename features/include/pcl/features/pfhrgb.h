@@ -42,9 +42,17 @@
 
 #include <pcl/features/feature.h>
 #include <pcl/features/pfh_tools.h>
+#include <pcl/features/pair_feature_cache.h>
 
 namespace pcl
 {
+  /** \brief PFHRGBEstimation estimates the PFH descriptor extended with the color ratios of every pair of points.
+    *
+    * \note The features of the query points are estimated in parallel with \ref setNumberOfThreads. The
+    * internal cache (see \ref setUseInternalCache) is shared by all the threads.
+    *
+    * \ingroup features
+    */
   template <typename PointInT, typename PointNT, typename PointOutT = pcl::PFHRGBSignature250>
   class PFHRGBEstimation : public FeatureFromNormals<PointInT, PointNT, PointOutT>
   {
@@ -61,11 +69,48 @@ namespace pcl
 
 
       PFHRGBEstimation ()
-        : nr_subdiv_ (5), pfhrgb_histogram_ (), pfhrgb_tuple_ (), d_pi_ (1.0f / (2.0f * static_cast<float> (M_PI)))
+        : nr_subdiv_ (5), d_pi_ (1.0f / (2.0f * static_cast<float> (M_PI))),
+          feature_cache_ (),
+          // Default 1GB memory size, as for PFHEstimation
+          max_cache_size_ ((1ul*1024ul*1024ul*1024ul) / (sizeof (std::pair<int, int>) + 7 * sizeof (float))),
+          use_cache_ (false)
       {
         feature_name_ = "PFHRGBEstimation";
       }
 
+      /** \brief Set the maximum number of pairs kept in the internal cache.
+        * \param[in] cache_size maximum cache size
+        */
+      inline void
+      setMaximumCacheSize (unsigned int cache_size)
+      {
+        max_cache_size_ = cache_size;
+      }
+
+      /** \brief Get the maximum number of pairs kept in the internal cache. */
+      inline unsigned int
+      getMaximumCacheSize ()
+      {
+        return (max_cache_size_);
+      }
+
+      /** \brief Set whether to use an internal cache for the pair features shared by several neighborhoods.
+        * See \ref PFHEstimation::setUseInternalCache.
+        * \param[in] use_cache set to true to use the internal cache, false otherwise
+        */
+      inline void
+      setUseInternalCache (bool use_cache)
+      {
+        use_cache_ = use_cache;
+      }
+
+      /** \brief Get whether the internal cache is used or not for computing the PFHRGB features. */
+      inline bool
+      getUseInternalCache ()
+      {
+        return (use_cache_);
+      }
+
       bool
       computeRGBPairFeatures (const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals,
                               int p_idx, int q_idx,
@@ -83,17 +128,17 @@ namespace pcl
       /** \brief The number of subdivisions for each angular feature interval. */
       int nr_subdiv_;
 
-      /** \brief Placeholder for a point's PFHRGB signature. */
-      Eigen::VectorXf pfhrgb_histogram_;
+      /** \brief Float constant = 1.0 / (2.0 * M_PI) */
+      float d_pi_;
 
-      /** \brief Placeholder for a PFHRGB 7-tuple. */
-      Eigen::VectorXf pfhrgb_tuple_;
+      /** \brief Internal pair feature cache, used to optimize efficiency of redundant computations. */
+      PairFeatureCache<7> feature_cache_;
 
-      /** \brief Placeholder for a histogram index. */
-      int f_index_[7];
+      /** \brief Maximum number of pairs kept in the internal cache. */
+      unsigned int max_cache_size_;
 
-      /** \brief Float constant = 1.0 / (2.0 * M_PI) */
-      float d_pi_;
+      /** \brief Set to true to use the internal cache for removing redundant computations. */
+      bool use_cache_;
   };
 }
 
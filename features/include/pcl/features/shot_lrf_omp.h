@@ -70,20 +70,15 @@ namespace pcl
       typedef boost::shared_ptr<SHOTLocalReferenceFrameEstimationOMP<PointInT, PointOutT> > Ptr;
       typedef boost::shared_ptr<const SHOTLocalReferenceFrameEstimationOMP<PointInT, PointOutT> > ConstPtr;
       /** \brief Constructor */
-    SHOTLocalReferenceFrameEstimationOMP () : threads_ (0)
+    SHOTLocalReferenceFrameEstimationOMP ()
       {
         feature_name_ = "SHOTLocalReferenceFrameEstimationOMP";
+        threads_ = 0;
       }
       
     /** \brief Empty destructor */
     virtual ~SHOTLocalReferenceFrameEstimationOMP () {}
 
-    /** \brief Initialize the scheduler and set the number of threads to use.
-     * \param nr_threads the number of hardware threads to use (0 sets the value back to automatic)
-     */
-     inline void
-     setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
-
     protected:
       using Feature<PointInT, PointOutT>::feature_name_;
       using Feature<PointInT, PointOutT>::getClassName;
@@ -103,8 +98,7 @@ namespace pcl
       virtual void
       computeFeature (PointCloudOut &output);
 
-      /** \brief The number of threads the scheduler should use. */
-      unsigned int threads_;
+      using Feature<PointInT, PointOutT>::threads_;
 
   };
 }
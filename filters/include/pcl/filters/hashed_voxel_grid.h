@@ -0,0 +1,172 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_FILTERS_HASHED_VOXEL_GRID_H_
+#define PCL_FILTERS_HASHED_VOXEL_GRID_H_
+
+#include <pcl/filters/boost.h>
+#include <pcl/filters/filter.h>
+#include <pcl/common/voxel_hash_table.h>
+
+namespace pcl
+{
+  /** \brief HashedVoxelGrid assembles a local 3D grid over a given PointCloud, and downsamples + filters the data.
+    *
+    * Like \ref VoxelGrid, all the points present in a voxel are approximated with their centroid.
+    * Instead of sorting the voxel index of every point, the points are accumulated in a single pass
+    * into an exact open-addressing hash table (\ref VoxelHashTable) keyed by the voxel coordinates,
+    * so the filter runs in O(N). The memory used depends on the number of occupied voxels only,
+    * which means that, unlike \ref VoxelGrid, leaf sizes that are tiny compared to the extent of
+    * the data are supported.
+    *
+    * The output points are stored in the order in which their voxels are first encountered in the
+    * input, not in the order of \ref VoxelGrid.
+    *
+    * \ingroup filters
+    */
+  template <typename PointT>
+  class HashedVoxelGrid: public Filter<PointT>
+  {
+    protected:
+      using Filter<PointT>::filter_name_;
+      using Filter<PointT>::getClassName;
+      using Filter<PointT>::input_;
+      using Filter<PointT>::indices_;
+
+      typedef typename Filter<PointT>::PointCloud PointCloud;
+      typedef typename PointCloud::Ptr PointCloudPtr;
+      typedef typename PointCloud::ConstPtr PointCloudConstPtr;
+      typedef typename pcl::traits::fieldList<PointT>::type FieldList;
+
+    public:
+      typedef boost::shared_ptr< HashedVoxelGrid<PointT> > Ptr;
+      typedef boost::shared_ptr< const HashedVoxelGrid<PointT> > ConstPtr;
+
+      /** \brief Empty constructor. */
+      HashedVoxelGrid () :
+        leaf_size_ (Eigen::Vector3f::Zero ()),
+        inverse_leaf_size_ (Eigen::Array3f::Zero ()),
+        downsample_all_data_ (true),
+        min_points_per_voxel_ (0),
+        voxels_ ()
+      {
+        filter_name_ = "HashedVoxelGrid";
+      }
+
+      /** \brief Destructor. */
+      virtual ~HashedVoxelGrid ()
+      {
+      }
+
+      /** \brief Set the voxel grid leaf size.
+        * \param[in] leaf_size the voxel grid leaf size
+        */
+      inline void
+      setLeafSize (const Eigen::Vector3f &leaf_size)
+      {
+        leaf_size_ = leaf_size;
+        inverse_leaf_size_ = Eigen::Array3f::Ones () / leaf_size_.array ();
+      }
+
+      /** \brief Set the voxel grid leaf size.
+        * \param[in] lx the leaf size for X
+        * \param[in] ly the leaf size for Y
+        * \param[in] lz the leaf size for Z
+        */
+      inline void
+      setLeafSize (float lx, float ly, float lz)
+      {
+        setLeafSize (Eigen::Vector3f (lx, ly, lz));
+      }
+
+      /** \brief Get the voxel grid leaf size. */
+      inline Eigen::Vector3f
+      getLeafSize () const { return (leaf_size_); }
+
+      /** \brief Set to true if all fields need to be downsampled, or false if just XYZ.
+        * \param[in] downsample the new value (true/false)
+        */
+      inline void
+      setDownsampleAllData (bool downsample) { downsample_all_data_ = downsample; }
+
+      /** \brief Get the state of the internal downsampling parameter (true if
+        * all fields need to be downsampled, false if just XYZ).
+        */
+      inline bool
+      getDownsampleAllData () const { return (downsample_all_data_); }
+
+      /** \brief Set the minimum number of points required for a voxel to be used.
+        * \param[in] min_points_per_voxel the minimum number of points for required for a voxel to be used
+        */
+      inline void
+      setMinimumPointsNumberPerVoxel (unsigned int min_points_per_voxel) { min_points_per_voxel_ = min_points_per_voxel; }
+
+      /** \brief Return the minimum number of points required for a voxel to be used. */
+      inline unsigned int
+      getMinimumPointsNumberPerVoxel () const { return (min_points_per_voxel_); }
+
+    protected:
+      /** \brief The size of a leaf. */
+      Eigen::Vector3f leaf_size_;
+
+      /** \brief Internal leaf sizes stored as 1/leaf_size_ for efficiency reasons. */
+      Eigen::Array3f inverse_leaf_size_;
+
+      /** \brief Set to true if all fields need to be downsampled, or false if just XYZ. */
+      bool downsample_all_data_;
+
+      /** \brief Minimum number of points per voxel for the centroid to be computed */
+      unsigned int min_points_per_voxel_;
+
+      /** \brief The hash table of the occupied voxels, kept between calls to reuse its memory. */
+      VoxelHashTable voxels_;
+
+      /** \brief Downsample a Point Cloud using a hashed voxel grid approach
+        * \param[out] output the resultant point cloud message
+        */
+      void
+      applyFilter (PointCloud &output);
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/filters/impl/hashed_voxel_grid.hpp>
+#endif
+
+#endif  //#ifndef PCL_FILTERS_HASHED_VOXEL_GRID_H_
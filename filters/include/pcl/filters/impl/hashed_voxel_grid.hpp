@@ -0,0 +1,178 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_FILTERS_IMPL_HASHED_VOXEL_GRID_H_
+#define PCL_FILTERS_IMPL_HASHED_VOXEL_GRID_H_
+
+#include <pcl/common/common.h>
+#include <pcl/common/io.h>
+#include <pcl/filters/hashed_voxel_grid.h>
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::HashedVoxelGrid<PointT>::applyFilter (PointCloud &output)
+{
+  // Has the input dataset been set already?
+  if (!input_)
+  {
+    PCL_WARN ("[pcl::%s::applyFilter] No input dataset given!\n", getClassName ().c_str ());
+    output.width = output.height = 0;
+    output.points.clear ();
+    return;
+  }
+
+  output.height       = 1;                    // downsampling breaks the organized structure
+  output.is_dense     = true;                 // we filter out invalid points
+
+  int centroid_size = 3;
+  if (downsample_all_data_)
+    centroid_size = boost::mpl::size<FieldList>::value;
+
+  // ---[ RGB special case
+  std::vector<pcl::PCLPointField> fields;
+  int rgba_index = -1;
+  if (downsample_all_data_)
+  {
+    rgba_index = pcl::getFieldIndex (*input_, "rgb", fields);
+    if (rgba_index == -1)
+      rgba_index = pcl::getFieldIndex (*input_, "rgba", fields);
+    if (rgba_index >= 0)
+    {
+      rgba_index = fields[rgba_index].offset;
+      centroid_size += 3;
+    }
+  }
+
+  // Single pass: accumulate every point into the sums of its voxel. Voxels are created in the
+  // order in which they are first encountered, which is also the order of the output
+  voxels_.clear ();
+  std::vector<float> sums;
+  std::vector<unsigned int> counts;
+  Eigen::VectorXf scratch = Eigen::VectorXf::Zero (centroid_size);
+
+  for (std::vector<int>::const_iterator it = indices_->begin (); it != indices_->end (); ++it)
+  {
+    const PointT &point = input_->points[*it];
+    if (!input_->is_dense)
+      // Check if the point is invalid
+      if (!pcl_isfinite (point.x) || !pcl_isfinite (point.y) || !pcl_isfinite (point.z))
+        continue;
+
+    int ijk0, ijk1, ijk2;
+    if (!VoxelHashTable::getVoxelCoordinate (point.x, inverse_leaf_size_[0], ijk0) ||
+        !VoxelHashTable::getVoxelCoordinate (point.y, inverse_leaf_size_[1], ijk1) ||
+        !VoxelHashTable::getVoxelCoordinate (point.z, inverse_leaf_size_[2], ijk2))
+    {
+      PCL_WARN ("[pcl::%s::applyFilter] Leaf size is too small for the input dataset. Integer voxel coordinates would overflow.\n", getClassName ().c_str ());
+      output = *input_;
+      return;
+    }
+
+    const int voxel = voxels_.insert (ijk0, ijk1, ijk2);
+    if (voxel == static_cast<int> (counts.size ()))
+    {
+      counts.push_back (0);
+      sums.resize (sums.size () + centroid_size, 0.0f);
+    }
+    ++counts[voxel];
+
+    float *sum = &sums[static_cast<size_t> (voxel) * centroid_size];
+    if (!downsample_all_data_)
+    {
+      sum[0] += point.x;
+      sum[1] += point.y;
+      sum[2] += point.z;
+    }
+    else
+    {
+      // ---[ RGB special case
+      if (rgba_index >= 0)
+      {
+        // Fill r/g/b data, assuming that the order is BGRA
+        pcl::RGB rgb;
+        memcpy (&rgb, reinterpret_cast<const char*> (&point) + rgba_index, sizeof (RGB));
+        scratch[centroid_size-3] = rgb.r;
+        scratch[centroid_size-2] = rgb.g;
+        scratch[centroid_size-1] = rgb.b;
+      }
+      pcl::for_each_type <FieldList> (NdCopyPointEigenFunctor <PointT> (point, scratch));
+      Eigen::Map<Eigen::VectorXf> (sum, centroid_size) += scratch;
+    }
+  }
+
+  // Compute the centroids of the voxels that have enough points
+  output.points.resize (counts.size ());
+  size_t index = 0;
+  for (size_t voxel = 0; voxel < counts.size (); ++voxel)
+  {
+    if (counts[voxel] < min_points_per_voxel_)
+      continue;
+
+    Eigen::Map<Eigen::VectorXf> centroid (&sums[voxel * centroid_size], centroid_size);
+    centroid /= static_cast<float> (counts[voxel]);
+
+    // Do we need to process all the fields?
+    if (!downsample_all_data_)
+    {
+      output.points[index].x = centroid[0];
+      output.points[index].y = centroid[1];
+      output.points[index].z = centroid[2];
+    }
+    else
+    {
+      scratch = centroid;
+      pcl::for_each_type<FieldList> (pcl::NdCopyEigenPointFunctor <PointT> (scratch, output.points[index]));
+      // ---[ RGB special case
+      if (rgba_index >= 0)
+      {
+        // pack r/g/b into rgb
+        float r = centroid[centroid_size-3], g = centroid[centroid_size-2], b = centroid[centroid_size-1];
+        int rgb = (static_cast<int> (r) << 16) | (static_cast<int> (g) << 8) | static_cast<int> (b);
+        memcpy (reinterpret_cast<char*> (&output.points[index]) + rgba_index, &rgb, sizeof (float));
+      }
+    }
+    ++index;
+  }
+  output.points.resize (index);
+  output.width = static_cast<uint32_t> (output.points.size ());
+}
+
+#define PCL_INSTANTIATE_HashedVoxelGrid(T) template class PCL_EXPORTS pcl::HashedVoxelGrid<T>;
+
+#endif    // PCL_FILTERS_IMPL_HASHED_VOXEL_GRID_H_
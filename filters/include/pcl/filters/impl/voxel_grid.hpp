@@ -205,7 +205,12 @@ struct cloud_point_index_idx
   unsigned int cloud_point_index;
 
   cloud_point_index_idx (unsigned int idx_, unsigned int cloud_point_index_) : idx (idx_), cloud_point_index (cloud_point_index_) {}
-  bool operator < (const cloud_point_index_idx &p) const { return (idx < p.idx); }
+  // Points falling into the same voxel are kept in input order, so that the centroids are
+  // accumulated in a deterministic order (see VoxelGridOMP)
+  bool operator < (const cloud_point_index_idx &p) const
+  {
+    return (idx < p.idx || (idx == p.idx && cloud_point_index < p.cloud_point_index));
+  }
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,464 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_FILTERS_IMPL_VOXEL_GRID_OMP_H_
+#define PCL_FILTERS_IMPL_VOXEL_GRID_OMP_H_
+
+#include <pcl/common/common.h>
+#include <pcl/common/io.h>
+#include <pcl/filters/voxel_grid_omp.h>
+#include <pcl/filters/impl/voxel_grid.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Stable LSD radix sort of (voxel index, point index) pairs, in parallel.
+      * The result is ordered by voxel index first and by point index second, which is
+      * exactly the order produced by sorting with cloud_point_index_idx::operator<.
+      * \param[in,out] data the pairs to sort
+      * \param[in] nr_threads the maximum number of threads to use
+      */
+    inline void
+    radixSortVoxelIndices (std::vector<cloud_point_index_idx> &data, int nr_threads)
+    {
+      const int radix_bits = 11;
+      const unsigned int radix_size = 1u << radix_bits;
+      const unsigned int radix_mask = radix_size - 1;
+      const int n = static_cast<int> (data.size ());
+      if (n < 2)
+        return;
+
+      // Find how many digits are needed for both keys, and whether the point indices are
+      // already ascending (the usual case), in which case they do not need to be sorted at all
+      unsigned int max_idx = 0, max_point = 0;
+      bool points_ascending = true;
+      for (int i = 0; i < n; ++i)
+      {
+        max_idx = std::max (max_idx, data[i].idx);
+        max_point = std::max (max_point, data[i].cloud_point_index);
+        if (i > 0 && data[i].cloud_point_index < data[i - 1].cloud_point_index)
+          points_ascending = false;
+      }
+
+      // A pass is described by the key it sorts on (false: point index, true: voxel index) and a shift
+      std::vector<std::pair<bool, int> > passes;
+      if (!points_ascending)
+        for (int shift = 0; shift == 0 || (shift < 32 && (max_point >> shift) != 0); shift += radix_bits)
+          passes.push_back (std::pair<bool, int> (false, shift));
+      for (int shift = 0; shift < 32 && (max_idx >> shift) != 0; shift += radix_bits)
+        passes.push_back (std::pair<bool, int> (true, shift));
+      if (passes.empty ())
+        return;
+
+      std::vector<cloud_point_index_idx> buffer (data.size (), cloud_point_index_idx (0, 0));
+      std::vector<cloud_point_index_idx> *src = &data, *dst = &buffer;
+      // offsets[t * radix_size + d]: histogram of digit d in the chunk of thread t, then its write position
+      std::vector<size_t> offsets (static_cast<size_t> (nr_threads) * radix_size);
+
+      for (size_t p = 0; p < passes.size (); ++p)
+      {
+        const bool on_voxel = passes[p].first;
+        const int shift = passes[p].second;
+        std::fill (offsets.begin (), offsets.end (), 0);
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+        {
+#ifdef _OPENMP
+          const int tid = omp_get_thread_num ();
+          const int nt = omp_get_num_threads ();
+#else
+          const int tid = 0;
+          const int nt = 1;
+#endif
+          // Every thread handles a contiguous chunk, which keeps the sort stable
+          const int begin = static_cast<int> (static_cast<int64_t> (n) * tid / nt);
+          const int end = static_cast<int> (static_cast<int64_t> (n) * (tid + 1) / nt);
+          size_t *histogram = &offsets[static_cast<size_t> (tid) * radix_size];
+          const std::vector<cloud_point_index_idx> &in = *src;
+          std::vector<cloud_point_index_idx> &out = *dst;
+
+          for (int i = begin; i < end; ++i)
+            ++histogram[((on_voxel ? in[i].idx : in[i].cloud_point_index) >> shift) & radix_mask];
+
+#ifdef _OPENMP
+#pragma omp barrier
+#pragma omp single
+#endif
+          {
+            // Exclusive prefix sum in (digit, thread) order
+            size_t sum = 0;
+            for (unsigned int d = 0; d < radix_size; ++d)
+              for (int t = 0; t < nt; ++t)
+              {
+                size_t count = offsets[static_cast<size_t> (t) * radix_size + d];
+                offsets[static_cast<size_t> (t) * radix_size + d] = sum;
+                sum += count;
+              }
+          }
+
+          for (int i = begin; i < end; ++i)
+            out[histogram[((on_voxel ? in[i].idx : in[i].cloud_point_index) >> shift) & radix_mask]++] = in[i];
+        }
+        std::swap (src, dst);
+      }
+
+      if (src != &data)
+        data.swap (buffer);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::VoxelGridOMP<PointT>::applyFilter (PointCloud &output)
+{
+  // Has the input dataset been set already?
+  if (!input_)
+  {
+    PCL_WARN ("[pcl::%s::applyFilter] No input dataset given!\n", getClassName ().c_str ());
+    output.width = output.height = 0;
+    output.points.clear ();
+    return;
+  }
+
+#ifdef _OPENMP
+  const int nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+#else
+  const int nr_threads = 1;
+#endif
+
+  // Copy the header (and thus the frame_id) + allocate enough space for points
+  output.height       = 1;                    // downsampling breaks the organized structure
+  output.is_dense     = true;                 // we filter out invalid points
+
+  Eigen::Vector4f min_p, max_p;
+  // Get the minimum and maximum dimensions
+  if (!filter_field_name_.empty ()) // If we don't want to process the entire cloud...
+    getMinMax3D<PointT> (input_, *indices_, filter_field_name_, static_cast<float> (filter_limit_min_), static_cast<float> (filter_limit_max_), min_p, max_p, filter_limit_negative_);
+  else
+    getMinMax3D<PointT> (*input_, *indices_, min_p, max_p);
+
+  // Check that the leaf size is not too small, given the size of the data
+  int64_t dx = static_cast<int64_t>((max_p[0] - min_p[0]) * inverse_leaf_size_[0])+1;
+  int64_t dy = static_cast<int64_t>((max_p[1] - min_p[1]) * inverse_leaf_size_[1])+1;
+  int64_t dz = static_cast<int64_t>((max_p[2] - min_p[2]) * inverse_leaf_size_[2])+1;
+
+  if ((dx*dy*dz) > static_cast<int64_t>(std::numeric_limits<int32_t>::max()))
+  {
+    PCL_WARN("[pcl::%s::applyFilter] Leaf size is too small for the input dataset. Integer indices would overflow.", getClassName().c_str());
+    output = *input_;
+    return;
+  }
+
+  // Compute the minimum and maximum bounding box values
+  min_b_[0] = static_cast<int> (floor (min_p[0] * inverse_leaf_size_[0]));
+  max_b_[0] = static_cast<int> (floor (max_p[0] * inverse_leaf_size_[0]));
+  min_b_[1] = static_cast<int> (floor (min_p[1] * inverse_leaf_size_[1]));
+  max_b_[1] = static_cast<int> (floor (max_p[1] * inverse_leaf_size_[1]));
+  min_b_[2] = static_cast<int> (floor (min_p[2] * inverse_leaf_size_[2]));
+  max_b_[2] = static_cast<int> (floor (max_p[2] * inverse_leaf_size_[2]));
+
+  // Compute the number of divisions needed along all axis
+  div_b_ = max_b_ - min_b_ + Eigen::Vector4i::Ones ();
+  div_b_[3] = 0;
+
+  // Set up the division multiplier
+  divb_mul_ = Eigen::Vector4i (1, div_b_[0], div_b_[0] * div_b_[1], 0);
+
+  int centroid_size = 4;
+  if (downsample_all_data_)
+    centroid_size = boost::mpl::size<FieldList>::value;
+
+  // ---[ RGB special case
+  std::vector<pcl::PCLPointField> fields;
+  int rgba_index = -1;
+  rgba_index = pcl::getFieldIndex (*input_, "rgb", fields);
+  if (rgba_index == -1)
+    rgba_index = pcl::getFieldIndex (*input_, "rgba", fields);
+  if (rgba_index >= 0)
+  {
+    rgba_index = fields[rgba_index].offset;
+    centroid_size += 3;
+  }
+
+  // If we don't want to process the entire cloud, but rather filter points far away from the viewpoint first...
+  int distance_offset = -1;
+  if (!filter_field_name_.empty ())
+  {
+    // Get the distance field index
+    std::vector<pcl::PCLPointField> distance_fields;
+    int distance_idx = pcl::getFieldIndex (*input_, filter_field_name_, distance_fields);
+    if (distance_idx == -1)
+      PCL_WARN ("[pcl::%s::applyFilter] Invalid filter field name. Index is %d.\n", getClassName ().c_str (), distance_idx);
+    else
+      distance_offset = distance_fields[distance_idx].offset;
+  }
+  const bool filter_distance = !filter_field_name_.empty ();
+
+  // First pass: go over all points and compute their voxel index. Every thread handles a
+  // contiguous chunk of indices_, so that concatenating the per-thread results preserves the
+  // order of the serial implementation
+  const int nr_indices = static_cast<int> (indices_->size ());
+  std::vector<std::vector<cloud_point_index_idx> > thread_index_vectors (nr_threads);
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+  {
+#ifdef _OPENMP
+    const int tid = omp_get_thread_num ();
+    const int nt = omp_get_num_threads ();
+#else
+    const int tid = 0;
+    const int nt = 1;
+#endif
+    const int begin = static_cast<int> (static_cast<int64_t> (nr_indices) * tid / nt);
+    const int end = static_cast<int> (static_cast<int64_t> (nr_indices) * (tid + 1) / nt);
+    std::vector<cloud_point_index_idx> &local_index_vector = thread_index_vectors[tid];
+    local_index_vector.reserve (end - begin);
+
+    for (int i = begin; i < end; ++i)
+    {
+      const int point_index = (*indices_)[i];
+      const PointT &point = input_->points[point_index];
+
+      if (!input_->is_dense)
+        // Check if the point is invalid
+        if (!pcl_isfinite (point.x) || !pcl_isfinite (point.y) || !pcl_isfinite (point.z))
+          continue;
+
+      if (filter_distance)
+      {
+        // Get the distance value
+        float distance_value = 0;
+        if (distance_offset >= 0)
+          memcpy (&distance_value, reinterpret_cast<const uint8_t*> (&point) + distance_offset, sizeof (float));
+
+        if (filter_limit_negative_)
+        {
+          // Use a threshold for cutting out points which inside the interval
+          if ((distance_value < filter_limit_max_) && (distance_value > filter_limit_min_))
+            continue;
+        }
+        else
+        {
+          // Use a threshold for cutting out points which are too close/far away
+          if ((distance_value > filter_limit_max_) || (distance_value < filter_limit_min_))
+            continue;
+        }
+      }
+
+      int ijk0 = static_cast<int> (floor (point.x * inverse_leaf_size_[0]) - static_cast<float> (min_b_[0]));
+      int ijk1 = static_cast<int> (floor (point.y * inverse_leaf_size_[1]) - static_cast<float> (min_b_[1]));
+      int ijk2 = static_cast<int> (floor (point.z * inverse_leaf_size_[2]) - static_cast<float> (min_b_[2]));
+
+      // Compute the centroid leaf index
+      int idx = ijk0 * divb_mul_[0] + ijk1 * divb_mul_[1] + ijk2 * divb_mul_[2];
+      local_index_vector.push_back (cloud_point_index_idx (static_cast<unsigned int> (idx), point_index));
+    }
+  }
+
+  std::vector<cloud_point_index_idx> index_vector;
+  {
+    size_t total_size = 0;
+    for (int t = 0; t < nr_threads; ++t)
+      total_size += thread_index_vectors[t].size ();
+    index_vector.reserve (total_size);
+    for (int t = 0; t < nr_threads; ++t)
+    {
+      index_vector.insert (index_vector.end (), thread_index_vectors[t].begin (), thread_index_vectors[t].end ());
+      std::vector<cloud_point_index_idx> ().swap (thread_index_vectors[t]);
+    }
+  }
+
+  // Second pass: sort the index_vector vector using value representing target cell as index
+  // in effect all points belonging to the same output cell will be next to each other
+  pcl::detail::radixSortVoxelIndices (index_vector, nr_threads);
+
+  // Third pass: count output cells
+  // we need to skip all the same, adjacenent idx values
+  // first_and_last_indices_vector[i] represents the index in index_vector of the first point in
+  // index_vector belonging to the voxel which corresponds to the i-th output point,
+  // and of the first point not belonging to.
+  std::vector<std::pair<unsigned int, unsigned int> > first_and_last_indices_vector;
+  // Worst case size
+  first_and_last_indices_vector.reserve (index_vector.size ());
+  unsigned int index = 0;
+  while (index < index_vector.size ()) 
+  {
+    unsigned int i = index + 1;
+    while (i < index_vector.size () && index_vector[i].idx == index_vector[index].idx) 
+      ++i;
+    if (i - index >= min_points_per_voxel_)
+      first_and_last_indices_vector.push_back (std::pair<unsigned int, unsigned int> (index, i));
+    index = i;
+  }
+
+  // Fourth pass: compute centroids, insert them into their final position
+  output.points.resize (first_and_last_indices_vector.size ());
+  if (save_leaf_layout_)
+  {
+    try
+    { 
+      // Resizing won't reset old elements to -1.  If leaf_layout_ has been used previously, it needs to be re-initialized to -1
+      uint32_t new_layout_size = div_b_[0]*div_b_[1]*div_b_[2];
+      //This is the number of elements that need to be re-initialized to -1
+      uint32_t reinit_size = std::min (static_cast<unsigned int> (new_layout_size), static_cast<unsigned int> (leaf_layout_.size()));
+      for (uint32_t i = 0; i < reinit_size; i++)
+      {
+        leaf_layout_[i] = -1;
+      }        
+      leaf_layout_.resize (new_layout_size, -1);           
+    }
+    catch (std::bad_alloc&)
+    {
+      throw PCLException("VoxelGrid bin size is too low; impossible to allocate memory for layout", 
+        "voxel_grid_omp.hpp", "applyFilter");	
+    }
+    catch (std::length_error&)
+    {
+      throw PCLException("VoxelGrid bin size is too low; impossible to allocate memory for layout", 
+        "voxel_grid_omp.hpp", "applyFilter");	
+    }
+  }
+
+  // Every voxel is reduced by exactly one thread, in the same order as in VoxelGrid
+  const int nr_voxels = static_cast<int> (first_and_last_indices_vector.size ());
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+  {
+    Eigen::VectorXf centroid = Eigen::VectorXf::Zero (centroid_size);
+    Eigen::VectorXf temporary = Eigen::VectorXf::Zero (centroid_size);
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (int cp = 0; cp < nr_voxels; ++cp)
+    {
+      // calculate centroid - sum values from all input points, that have the same idx value in index_vector array
+      unsigned int first_index = first_and_last_indices_vector[cp].first;
+      unsigned int last_index = first_and_last_indices_vector[cp].second;
+      if (!downsample_all_data_) 
+      {
+        centroid[0] = input_->points[index_vector[first_index].cloud_point_index].x;
+        centroid[1] = input_->points[index_vector[first_index].cloud_point_index].y;
+        centroid[2] = input_->points[index_vector[first_index].cloud_point_index].z;
+      }
+      else 
+      {
+        // ---[ RGB special case
+        if (rgba_index >= 0)
+        {
+          // Fill r/g/b data, assuming that the order is BGRA
+          pcl::RGB rgb;
+          memcpy (&rgb, reinterpret_cast<const char*> (&input_->points[index_vector[first_index].cloud_point_index]) + rgba_index, sizeof (RGB));
+          centroid[centroid_size-3] = rgb.r;
+          centroid[centroid_size-2] = rgb.g;
+          centroid[centroid_size-1] = rgb.b;
+        }
+        pcl::for_each_type <FieldList> (NdCopyPointEigenFunctor <PointT> (input_->points[index_vector[first_index].cloud_point_index], centroid));
+      }
+
+      for (unsigned int i = first_index + 1; i < last_index; ++i) 
+      {
+        if (!downsample_all_data_) 
+        {
+          centroid[0] += input_->points[index_vector[i].cloud_point_index].x;
+          centroid[1] += input_->points[index_vector[i].cloud_point_index].y;
+          centroid[2] += input_->points[index_vector[i].cloud_point_index].z;
+        }
+        else 
+        {
+          // ---[ RGB special case
+          if (rgba_index >= 0)
+          {
+            // Fill r/g/b data, assuming that the order is BGRA
+            pcl::RGB rgb;
+            memcpy (&rgb, reinterpret_cast<const char*> (&input_->points[index_vector[i].cloud_point_index]) + rgba_index, sizeof (RGB));
+            temporary[centroid_size-3] = rgb.r;
+            temporary[centroid_size-2] = rgb.g;
+            temporary[centroid_size-1] = rgb.b;
+          }
+          pcl::for_each_type <FieldList> (NdCopyPointEigenFunctor <PointT> (input_->points[index_vector[i].cloud_point_index], temporary));
+          centroid += temporary;
+        }
+      }
+
+      // cp is centroid final position in resulting PointCloud
+      if (save_leaf_layout_)
+        leaf_layout_[index_vector[first_index].idx] = cp;
+
+      centroid /= static_cast<float> (last_index - first_index);
+
+      // store centroid
+      // Do we need to process all the fields?
+      if (!downsample_all_data_) 
+      {
+        output.points[cp].x = centroid[0];
+        output.points[cp].y = centroid[1];
+        output.points[cp].z = centroid[2];
+      }
+      else 
+      {
+        pcl::for_each_type<FieldList> (pcl::NdCopyEigenPointFunctor <PointT> (centroid, output.points[cp]));
+        // ---[ RGB special case
+        if (rgba_index >= 0) 
+        {
+          // pack r/g/b into rgb
+          float r = centroid[centroid_size-3], g = centroid[centroid_size-2], b = centroid[centroid_size-1];
+          int rgb = (static_cast<int> (r) << 16) | (static_cast<int> (g) << 8) | static_cast<int> (b);
+          memcpy (reinterpret_cast<char*> (&output.points[cp]) + rgba_index, &rgb, sizeof (float));
+        }
+      }
+    }
+  }
+  output.width = static_cast<uint32_t> (output.points.size ());
+}
+
+#define PCL_INSTANTIATE_VoxelGridOMP(T) template class PCL_EXPORTS pcl::VoxelGridOMP<T>;
+
+#endif    // PCL_FILTERS_IMPL_VOXEL_GRID_OMP_H_
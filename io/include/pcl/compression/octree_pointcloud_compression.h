@@ -177,6 +177,16 @@ namespace pcl
           OctreePointCloud<PointT, LeafT, BranchT, OctreeT>::addPointIdx(pointIdx_arg);
         }
 
+        /** \brief Prepare the bulk insertion of point at index from input pointcloud dataset
+         * \param[in] pointIdx_arg the index representing the point in the dataset given by \a setInputCloud to be added
+         */
+        virtual void
+        preparePointIdx (const int pointIdx_arg)
+        {
+          ++object_count_;
+          OctreePointCloud<PointT, LeafT, BranchT, OctreeT>::preparePointIdx(pointIdx_arg);
+        }
+
         /** \brief Provide a pointer to the output data set.
           * \param cloud_arg: the boost shared pointer to a PointCloud message
           */
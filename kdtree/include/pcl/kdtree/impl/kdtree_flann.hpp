@@ -40,9 +40,15 @@
 #define PCL_KDTREE_KDTREE_IMPL_FLANN_H_
 
 #include <cstdio>
+#include <algorithm>
 #include <pcl/kdtree/kdtree_flann.h>
 #include <pcl/kdtree/flann.h>
 #include <pcl/console/print.h>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename Dist>
@@ -53,6 +59,7 @@ pcl::KdTreeFLANN<PointT, Dist>::KdTreeFLANN (bool sorted)
   , dim_ (0), total_nr_points_ (0)
   , param_k_ (::flann::SearchParams (-1 , epsilon_))
   , param_radius_ (::flann::SearchParams (-1, epsilon_, sorted))
+  , spatial_order_ (NO_SPATIAL_ORDER)
 {
 }
 
@@ -65,6 +72,7 @@ pcl::KdTreeFLANN<PointT, Dist>::KdTreeFLANN (const KdTreeFLANN<PointT> &k)
   , dim_ (0), total_nr_points_ (0)
   , param_k_ (::flann::SearchParams (-1 , epsilon_))
   , param_radius_ (::flann::SearchParams (-1, epsilon_, false))
+  , spatial_order_ (NO_SPATIAL_ORDER)
 {
   *this = k;
 }
@@ -120,10 +128,15 @@ pcl::KdTreeFLANN<PointT, Dist>::setInputCloud (const PointCloudConstPtr &cloud,
     return;
   }
 
+  // Points stored along a space-filling curve do not need to be reordered by FLANN
+  const bool spatially_ordered = spatial_order_ != NO_SPATIAL_ORDER && dim_ >= 3;
+  if (spatially_ordered)
+    applySpatialOrder ();
+
   flann_index_.reset (new FLANNIndex (::flann::Matrix<float> (cloud_.get (), 
                                                               index_mapping_.size (), 
                                                               dim_),
-                                      ::flann::KDTreeSingleIndexParams (15))); // max 15 points/leaf
+                                      ::flann::KDTreeSingleIndexParams (15, !spatially_ordered))); // max 15 points/leaf
   flann_index_->buildIndex ();
 }
 
@@ -132,6 +145,17 @@ template <typename PointT, typename Dist> int
 pcl::KdTreeFLANN<PointT, Dist>::nearestKSearch (const PointT &point, int k, 
                                                 std::vector<int> &k_indices, 
                                                 std::vector<float> &k_distances) const
+{
+  NeighborSearchContext context;
+  return (nearestKSearch (point, k, k_indices, k_distances, context));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Dist> int 
+pcl::KdTreeFLANN<PointT, Dist>::nearestKSearch (const PointT &point, int k, 
+                                                std::vector<int> &k_indices, 
+                                                std::vector<float> &k_distances,
+                                                NeighborSearchContext &context) const
 {
   assert (point_representation_->isValid (point) && "Invalid (NaN, Inf) point coordinates given to nearestKSearch!");
 
@@ -141,7 +165,8 @@ pcl::KdTreeFLANN<PointT, Dist>::nearestKSearch (const PointT &point, int k,
   k_indices.resize (k);
   k_distances.resize (k);
 
-  std::vector<float> query (dim_);
+  std::vector<float> &query = context.query;
+  query.resize (dim_);
   point_representation_->vectorize (static_cast<PointT> (point), query);
 
   ::flann::Matrix<int> k_indices_mat (&k_indices[0], 1, k);
@@ -168,18 +193,32 @@ pcl::KdTreeFLANN<PointT, Dist>::nearestKSearch (const PointT &point, int k,
 template <typename PointT, typename Dist> int 
 pcl::KdTreeFLANN<PointT, Dist>::radiusSearch (const PointT &point, double radius, std::vector<int> &k_indices,
                                               std::vector<float> &k_sqr_dists, unsigned int max_nn) const
+{
+  NeighborSearchContext context;
+  return (radiusSearch (point, radius, k_indices, k_sqr_dists, context, max_nn));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Dist> int 
+pcl::KdTreeFLANN<PointT, Dist>::radiusSearch (const PointT &point, double radius, std::vector<int> &k_indices,
+                                              std::vector<float> &k_sqr_dists, NeighborSearchContext &context,
+                                              unsigned int max_nn) const
 {
   assert (point_representation_->isValid (point) && "Invalid (NaN, Inf) point coordinates given to radiusSearch!");
 
-  std::vector<float> query (dim_);
+  std::vector<float> &query = context.query;
+  query.resize (dim_);
   point_representation_->vectorize (static_cast<PointT> (point), query);
 
   // Has max_nn been set properly?
   if (max_nn == 0 || max_nn > static_cast<unsigned int> (total_nr_points_))
     max_nn = total_nr_points_;
 
-  std::vector<std::vector<int> > indices(1);
-  std::vector<std::vector<float> > dists(1);
+  // FLANN resizes the inner vectors, which keep their capacity from one query to the next
+  std::vector<std::vector<int> > &indices = context.indices;
+  std::vector<std::vector<float> > &dists = context.distances;
+  indices.resize (1);
+  dists.resize (1);
 
   ::flann::SearchParams params (param_radius_);
   if (max_nn == static_cast<unsigned int>(total_nr_points_))
@@ -193,8 +232,8 @@ pcl::KdTreeFLANN<PointT, Dist>::radiusSearch (const PointT &point, double radius
       static_cast<float> (radius * radius), 
       params);
 
-  k_indices = indices[0];
-  k_sqr_dists = dists[0];
+  k_indices.assign (indices[0].begin (), indices[0].end ());
+  k_sqr_dists.assign (dists[0].begin (), dists[0].end ());
 
   // Do mapping to original point cloud
   if (!identity_mapping_) 
@@ -209,6 +248,82 @@ pcl::KdTreeFLANN<PointT, Dist>::radiusSearch (const PointT &point, double radius
   return (neighbors_in_radius);
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Dist> void
+pcl::KdTreeFLANN<PointT, Dist>::batchNearestKSearch (const PointCloud &cloud, const std::vector<int> &indices, int k,
+                                                     std::vector<int> &k_indices, std::vector<float> &k_sqr_distances,
+                                                     unsigned int nr_threads) const
+{
+  const int nr_queries = static_cast<int> (indices.empty () ? cloud.points.size () : indices.size ());
+  if (k < 0)
+    k = 0;
+  k_indices.resize (static_cast<size_t> (nr_queries) * k);
+  k_sqr_distances.resize (static_cast<size_t> (nr_queries) * k);
+  if (k == 0)
+    return;
+
+  // The tree may hold less than k points, the rest of every row is padded
+  const int nr_found = flann_index_ ? std::min (k, total_nr_points_) : 0;
+
+  // Number of query points handed to FLANN at once
+  const int block_size = 64;
+  const int nr_blocks = (nr_queries + block_size - 1) / block_size;
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads == 0 ? omp_get_max_threads () : static_cast<int> (nr_threads))
+#endif
+  {
+    std::vector<float> queries (block_size * dim_);
+    std::vector<int> query_rows (block_size);
+    std::vector<int> block_indices (block_size * std::max (nr_found, 1));
+    std::vector<float> block_dists (block_size * std::max (nr_found, 1));
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+    for (int block = 0; block < nr_blocks; ++block)
+    {
+      const int begin = block * block_size;
+      const int end = std::min (begin + block_size, nr_queries);
+
+      int nr_valid = 0;
+      for (int i = begin; i < end; ++i)
+      {
+        std::fill (k_indices.begin () + static_cast<size_t> (i) * k, k_indices.begin () + static_cast<size_t> (i + 1) * k, -1);
+        std::fill (k_sqr_distances.begin () + static_cast<size_t> (i) * k, k_sqr_distances.begin () + static_cast<size_t> (i + 1) * k,
+                   std::numeric_limits<float>::max ());
+
+        const PointT &point = cloud.points[indices.empty () ? i : indices[i]];
+        if (!point_representation_->isValid (point))
+          continue;
+        float *query = &queries[nr_valid * dim_];
+        point_representation_->vectorize (point, query);
+        query_rows[nr_valid++] = i;
+      }
+      if (nr_valid == 0 || nr_found == 0)
+        continue;
+
+      ::flann::Matrix<int> k_indices_mat (&block_indices[0], nr_valid, nr_found);
+      ::flann::Matrix<float> k_distances_mat (&block_dists[0], nr_valid, nr_found);
+      flann_index_->knnSearch (::flann::Matrix<float> (&queries[0], nr_valid, dim_),
+                               k_indices_mat, k_distances_mat,
+                               nr_found, param_k_);
+
+      // Copy the rows to their place, mapping the results to the original point cloud
+      for (int row = 0; row < nr_valid; ++row)
+      {
+        const size_t offset = static_cast<size_t> (query_rows[row]) * k;
+        for (int j = 0; j < nr_found; ++j)
+        {
+          const int neighbor_index = block_indices[row * nr_found + j];
+          k_indices[offset + j] = identity_mapping_ ? neighbor_index : index_mapping_[neighbor_index];
+          k_sqr_distances[offset + j] = block_dists[row * nr_found + j];
+        }
+      }
+    }
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename Dist> void 
 pcl::KdTreeFLANN<PointT, Dist>::cleanup ()
@@ -220,6 +335,26 @@ pcl::KdTreeFLANN<PointT, Dist>::cleanup ()
     indices_.reset ();
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Dist> void 
+pcl::KdTreeFLANN<PointT, Dist>::applySpatialOrder ()
+{
+  const size_t nr_points = index_mapping_.size ();
+  std::vector<int> order;
+  computeSpatialOrder (cloud_.get (), nr_points, dim_, spatial_order_, order);
+
+  boost::shared_array<float> ordered_cloud (new float[nr_points * dim_]);
+  std::vector<int> ordered_mapping (nr_points);
+  for (size_t i = 0; i < nr_points; ++i)
+  {
+    std::copy (&cloud_[order[i] * dim_], &cloud_[order[i] * dim_] + dim_, &ordered_cloud[i * dim_]);
+    ordered_mapping[i] = index_mapping_[order[i]];
+  }
+  cloud_ = ordered_cloud;
+  index_mapping_.swap (ordered_mapping);
+  identity_mapping_ = false;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename Dist> void 
 pcl::KdTreeFLANN<PointT, Dist>::convertCloudToArray (const PointCloud &cloud)
@@ -48,6 +48,26 @@
 
 namespace pcl
 {
+  /** \brief Scratch buffers owned by the caller of a neighbor query, and reused from one query to the next.
+    *
+    * The search structures use it for their temporaries (the vectorized query point, the per-query result
+    * vectors handed to FLANN), so that once the buffers have grown to their steady state size a query does not
+    * allocate. A context can be reused with any tree, but must not be shared between concurrent queries: use one
+    * context per thread.
+    * \ingroup kdtree
+    */
+  struct NeighborSearchContext
+  {
+    /** \brief The query point, in the representation of the tree. */
+    std::vector<float> query;
+
+    /** \brief The indices of the neighbors found by a radius search. */
+    std::vector<std::vector<int> > indices;
+
+    /** \brief The squared distances of the neighbors found by a radius search. */
+    std::vector<std::vector<float> > distances;
+  };
+
   /** \brief KdTree represents the base spatial locator class for kd-tree implementations.
     * \author Radu B Rusu, Bastian Steder, Michael Dixon
     * \ingroup kdtree
@@ -43,6 +43,7 @@
 
 #include <pcl/kdtree/kdtree.h>
 #include <pcl/kdtree/flann.h>
+#include <pcl/common/spatial_order.h>
 
 #include <boost/shared_array.hpp>
 
@@ -116,6 +117,7 @@ namespace pcl
         total_nr_points_ = k.total_nr_points_;
         param_k_ = k.param_k_;
         param_radius_ = k.param_radius_;
+        spatial_order_ = k.spatial_order_;
         return (*this);
       }
 
@@ -127,6 +129,22 @@ namespace pcl
 
       void 
       setSortedResults (bool sorted);
+
+      /** \brief Set the order in which the points are stored in the tree. Takes effect at the next
+        * \ref setInputCloud.
+        *
+        * With a space-filling curve order, the points of a leaf are (nearly) contiguous in memory, so FLANN
+        * searches the data in place instead of keeping a reordered copy of it. The order is computed on the
+        * first three dimensions of the point representation. The returned indices always refer to the
+        * input cloud.
+        * \param[in] order the space-filling curve to store the points along (NO_SPATIAL_ORDER by default)
+        */
+      inline void
+      setSpatialOrder (SpatialOrder order) { spatial_order_ = order; }
+
+      /** \brief Get the order in which the points are stored in the tree. */
+      inline SpatialOrder
+      getSpatialOrder () const { return (spatial_order_); }
       
       inline Ptr makeShared () { return Ptr (new KdTreeFLANN<PointT> (*this)); } 
 
@@ -163,6 +181,21 @@ namespace pcl
       nearestKSearch (const PointT &point, int k, 
                       std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const;
 
+      /** \brief Search for k-nearest neighbors for the given query point, using the scratch buffers of \a context.
+        * Once the buffers of \a context and the output vectors have reached their steady state size, the query does
+        * not allocate.
+        * \param[in] point a given \a valid (i.e., finite) query point
+        * \param[in] k the number of neighbors to search for
+        * \param[out] k_indices the resultant indices of the neighboring points
+        * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+        * \param[in,out] context the scratch buffers to use (one per thread)
+        * \return number of neighbors found
+        */
+      int 
+      nearestKSearch (const PointT &point, int k, 
+                      std::vector<int> &k_indices, std::vector<float> &k_sqr_distances,
+                      NeighborSearchContext &context) const;
+
       /** \brief Search for all the nearest neighbors of the query point in a given radius.
         * 
         * \attention This method does not do any bounds checking for the input index
@@ -183,6 +216,45 @@ namespace pcl
       radiusSearch (const PointT &point, double radius, std::vector<int> &k_indices,
                     std::vector<float> &k_sqr_distances, unsigned int max_nn = 0) const;
 
+      /** \brief Search for all the nearest neighbors of the query point in a given radius, using the scratch
+        * buffers of \a context.
+        * Once the buffers of \a context and the output vectors have reached their steady state size, the query does
+        * not allocate.
+        * \param[in] point a given \a valid (i.e., finite) query point
+        * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+        * \param[out] k_indices the resultant indices of the neighboring points
+        * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+        * \param[in,out] context the scratch buffers to use (one per thread)
+        * \param[in] max_nn if given, bounds the maximum returned neighbors to this value. If \a max_nn is set to
+        * 0 or to a number higher than the number of points in the input cloud, all neighbors in \a radius will be
+        * returned.
+        * \return number of neighbors found in radius
+        */
+      int 
+      radiusSearch (const PointT &point, double radius, std::vector<int> &k_indices,
+                    std::vector<float> &k_sqr_distances, NeighborSearchContext &context,
+                    unsigned int max_nn = 0) const;
+
+      /** \brief Search for the k-nearest neighbors of a batch of query points, in parallel.
+        *
+        * The query points are vectorized and handed to FLANN in blocks, so that a single FLANN call answers many
+        * queries and no memory is allocated per query.
+        *
+        * \param[in] cloud the point cloud containing the query points
+        * \param[in] indices the indices in \a cloud of the query points. If empty, all the points are queried.
+        * \param[in] k the number of neighbors to search for
+        * \param[out] k_indices the resultant indices of the neighboring points, as a row-major matrix with one row of
+        * \a k entries per query point. Missing neighbors (invalid query point, or less than \a k points in the tree)
+        * are set to -1.
+        * \param[out] k_sqr_distances the resultant squared distances to the neighboring points, in the same layout.
+        * Missing neighbors are set to std::numeric_limits<float>::max ().
+        * \param[in] nr_threads the number of threads to use (0 means automatic)
+        */
+      void
+      batchNearestKSearch (const PointCloud &cloud, const std::vector<int> &indices, int k,
+                           std::vector<int> &k_indices, std::vector<float> &k_sqr_distances,
+                           unsigned int nr_threads = 0) const;
+
     private:
       /** \brief Internal cleanup method. */
       void 
@@ -203,6 +275,12 @@ namespace pcl
       void 
       convertCloudToArray (const PointCloud &cloud, const std::vector<int> &indices);
 
+      /** \brief Sort the internal FLANN point array and the index mapping along the space-filling curve
+        * given by \ref setSpatialOrder.
+        */
+      void
+      applySpatialOrder ();
+
     private:
       /** \brief Class getName method. */
       virtual std::string 
@@ -231,6 +309,9 @@ namespace pcl
 
       /** \brief The KdTree search parameters for radius search. */
       ::flann::SearchParams param_radius_;
+
+      /** \brief The order in which the points are stored in the tree. */
+      SpatialOrder spatial_order_;
   };
 }
 
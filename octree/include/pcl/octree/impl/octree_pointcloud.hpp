@@ -40,17 +40,24 @@
 #define PCL_OCTREE_POINTCLOUD_HPP_
 
 #include <vector>
+#include <algorithm>
 #include <assert.h>
 
+#include <boost/type_traits/is_same.hpp>
+
 #include <pcl/common/common.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename LeafContainerT, typename BranchContainerT, typename OctreeT>
 pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::OctreePointCloud (const double resolution) :
     OctreeT (), input_ (PointCloudConstPtr ()), indices_ (IndicesConstPtr ()),
     epsilon_ (0), resolution_ (resolution), min_x_ (0.0f), max_x_ (resolution), min_y_ (0.0f),
-    max_y_ (resolution), min_z_ (0.0f), max_z_ (resolution), bounding_box_defined_ (false), max_objs_per_leaf_(0)
+    max_y_ (resolution), min_z_ (0.0f), max_z_ (resolution), bounding_box_defined_ (false), max_objs_per_leaf_(0), threads_ (0)
 {
   assert (resolution > 0.0f);
 }
@@ -67,6 +74,33 @@ pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>
 {
   size_t i;
 
+  // the bulk build neither expands leaf nodes nor reuses the nodes of a previous buffer
+  if (!this->dynamic_depth_enabled_ && boost::is_same<OctreeT, OctreeBase<LeafContainerT, BranchContainerT> >::value)
+  {
+    std::vector<int> point_indices;
+    if (indices_)
+    {
+      point_indices.reserve (indices_->size ());
+      for (std::vector<int>::const_iterator current = indices_->begin (); current != indices_->end (); ++current)
+      {
+        assert( (*current>=0) && (*current < static_cast<int> (input_->points.size ())));
+
+        if (isFinite (input_->points[*current]))
+          point_indices.push_back (*current);
+      }
+    }
+    else
+    {
+      point_indices.reserve (input_->points.size ());
+      for (i = 0; i < input_->points.size (); i++)
+        if (isFinite (input_->points[i]))
+          point_indices.push_back (static_cast<int> (i));
+    }
+
+    addPointsBulk (point_indices);
+    return;
+  }
+
   if (indices_)
   {
     for (std::vector<int>::const_iterator current = indices_->begin (); current != indices_->end (); ++current)
@@ -596,6 +630,165 @@ pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>
   (*leaf_node)->addPointIndex (point_idx_arg);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafContainerT, typename BranchContainerT, typename OctreeT> bool
+pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::compareMortonOrder (const BulkPoint &a,
+                                                                                                     const BulkPoint &b)
+{
+  // the axis with the most significant differing bit decides, x before y before z on the same bit
+  const unsigned int diff[3] = {a.key.x ^ b.key.x, a.key.y ^ b.key.y, a.key.z ^ b.key.z};
+  int axis = 0;
+  for (int i = 1; i < 3; ++i)
+    if (diff[axis] < diff[i] && diff[axis] < (diff[axis] ^ diff[i]))
+      axis = i;
+
+  return (a.key.key_[axis] < b.key.key_[axis]);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafContainerT, typename BranchContainerT, typename OctreeT> void
+pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::addPointsBulk (const std::vector<int> &point_indices_arg)
+{
+  const int nr_points = static_cast<int> (point_indices_arg.size ());
+  if (nr_points == 0)
+    return;
+
+#ifdef _OPENMP
+  const int nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+#else
+  const int nr_threads = 1;
+#endif
+
+  // grow the bounding box sequentially, so the octree depth and root match the point by point insertion
+  for (int i = 0; i < nr_points; ++i)
+    preparePointIdx (point_indices_arg[i]);
+
+  std::vector<BulkPoint> points (nr_points);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nr_threads)
+#endif
+  for (int i = 0; i < nr_points; ++i)
+  {
+    points[i].idx = point_indices_arg[i];
+    genOctreeKeyForPointIdx (point_indices_arg[i], points[i].key);
+  }
+
+  // stable merge sort in Morton order: every leaf receives its points in input order
+  const int nr_chunks = std::min (nr_threads, nr_points);
+  std::vector<std::size_t> chunk_begin (nr_chunks + 1);
+  for (int c = 0; c <= nr_chunks; ++c)
+    chunk_begin[c] = static_cast<std::size_t> (nr_points) * c / nr_chunks;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nr_threads)
+#endif
+  for (int c = 0; c < nr_chunks; ++c)
+    std::stable_sort (points.begin () + chunk_begin[c], points.begin () + chunk_begin[c + 1], compareMortonOrder);
+
+  for (int width = 1; width < nr_chunks; width *= 2)
+  {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nr_threads)
+#endif
+    for (int c = 0; c < nr_chunks - width; c += 2 * width)
+      std::inplace_merge (points.begin () + chunk_begin[c], points.begin () + chunk_begin[c + width],
+                          points.begin () + chunk_begin[std::min (c + 2 * width, nr_chunks)], compareMortonOrder);
+  }
+
+  // split the upper levels sequentially until there are enough subtrees to build in parallel
+  std::vector<BulkSubtree> subtrees (1);
+  subtrees[0].branch = this->root_node_;
+  subtrees[0].begin = 0;
+  subtrees[0].end = points.size ();
+
+  unsigned int depth_mask = this->depth_mask_;
+  while (depth_mask > 1 && subtrees.size () < 4 * static_cast<std::size_t> (nr_threads))
+  {
+    std::vector<BulkSubtree> children;
+    for (std::size_t s = 0; s < subtrees.size (); ++s)
+    {
+      std::size_t run_begin = subtrees[s].begin;
+      while (run_begin < subtrees[s].end)
+      {
+        const unsigned char child_idx = points[run_begin].key.getChildIdxWithDepthMask (depth_mask);
+        std::size_t run_end = run_begin + 1;
+        while (run_end < subtrees[s].end && points[run_end].key.getChildIdxWithDepthMask (depth_mask) == child_idx)
+          ++run_end;
+
+        BulkSubtree child;
+        child.branch = static_cast<BranchNode*> (this->getBranchChildPtr (*subtrees[s].branch, child_idx));
+        if (!child.branch)
+        {
+          child.branch = this->createBranchChild (*subtrees[s].branch, child_idx);
+          this->branch_count_++;
+        }
+        child.begin = run_begin;
+        child.end = run_end;
+        children.push_back (child);
+
+        run_begin = run_end;
+      }
+    }
+    subtrees.swap (children);
+    depth_mask >>= 1;
+  }
+
+  std::size_t leaf_count = 0;
+  std::size_t branch_count = 0;
+  const int nr_subtrees = static_cast<int> (subtrees.size ());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nr_threads) reduction(+: leaf_count, branch_count)
+#endif
+  for (int s = 0; s < nr_subtrees; ++s)
+    addPointsBulkRecursive (*subtrees[s].branch, depth_mask, points, subtrees[s].begin, subtrees[s].end,
+                            leaf_count, branch_count);
+
+  this->leaf_count_ += leaf_count;
+  this->branch_count_ += branch_count;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafContainerT, typename BranchContainerT, typename OctreeT> void
+pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::addPointsBulkRecursive (
+    BranchNode &branch_arg, unsigned int depth_mask_arg, const std::vector<BulkPoint> &points_arg,
+    std::size_t begin_arg, std::size_t end_arg, std::size_t &leaf_count_arg, std::size_t &branch_count_arg)
+{
+  std::size_t run_begin = begin_arg;
+  while (run_begin < end_arg)
+  {
+    // points falling into the same child are contiguous in Morton order
+    const unsigned char child_idx = points_arg[run_begin].key.getChildIdxWithDepthMask (depth_mask_arg);
+    std::size_t run_end = run_begin + 1;
+    while (run_end < end_arg && points_arg[run_end].key.getChildIdxWithDepthMask (depth_mask_arg) == child_idx)
+      ++run_end;
+
+    if (depth_mask_arg > 1)
+    {
+      BranchNode* child_branch = static_cast<BranchNode*> (this->getBranchChildPtr (branch_arg, child_idx));
+      if (!child_branch)
+      {
+        child_branch = this->createBranchChild (branch_arg, child_idx);
+        branch_count_arg++;
+      }
+      addPointsBulkRecursive (*child_branch, depth_mask_arg / 2, points_arg, run_begin, run_end,
+                              leaf_count_arg, branch_count_arg);
+    }
+    else
+    {
+      LeafNode* child_leaf = static_cast<LeafNode*> (this->getBranchChildPtr (branch_arg, child_idx));
+      if (!child_leaf)
+      {
+        child_leaf = this->createLeafChild (branch_arg, child_idx);
+        leaf_count_arg++;
+      }
+      for (std::size_t i = run_begin; i < run_end; ++i)
+        addPointToLeaf (points_arg[i].idx, child_leaf->getContainer ());
+    }
+
+    run_begin = run_end;
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename LeafContainerT, typename BranchContainerT, typename OctreeT> const PointT&
 pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::getPointByIndex (const unsigned int index_arg) const
@@ -0,0 +1,903 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_OCTREE_POINTCLOUD_LINEAR_HPP_
+#define PCL_OCTREE_POINTCLOUD_LINEAR_HPP_
+
+#include <pcl/octree/octree_pointcloud_linear.h>
+#include <pcl/common/spatial_order.h>
+#include <pcl/console/print.h>
+
+#include <algorithm>
+#include <limits>
+#include <cstring>
+
+namespace pcl
+{
+  namespace octree
+  {
+    /** \brief Compare two (Morton code, point index) pairs by their Morton code only. */
+    inline bool
+    compareLinearOctreeCodes (const std::pair<uint64_t, int> &a, const std::pair<uint64_t, int> &b)
+    {
+      return (a.first < b.first);
+    }
+
+    /** \brief Order a Morton code before a leaf node with a larger Morton code. */
+    inline bool
+    compareLinearOctreeNodeCode (const OctreeLinearNode &node, uint64_t code)
+    {
+      return (node.code < code);
+    }
+
+    /** \brief Squared distance of a point to an axis aligned voxel. */
+    inline double
+    sqrDistanceToLinearOctreeVoxel (const Eigen::Vector3f &point, const Eigen::Vector3d &min_pt, double side)
+    {
+      double sqr_distance = 0;
+      for (int d = 0; d < 3; ++d)
+      {
+        double delta = 0;
+        if (point[d] < min_pt[d])
+          delta = min_pt[d] - point[d];
+        else if (point[d] > min_pt[d] + side)
+          delta = point[d] - (min_pt[d] + side);
+        sqr_distance += delta * delta;
+      }
+      return (sqr_distance);
+    }
+
+    /** \brief Intersect a ray (origin + t * direction, t >= 0) with an axis aligned voxel.
+      * \param[out] t_entry the ray parameter at which the ray enters the voxel, 0 if the origin is inside
+      * \return "true" if the ray intersects the voxel
+      */
+    inline bool
+    intersectRayWithLinearOctreeVoxel (const Eigen::Vector3f &origin, const Eigen::Vector3f &direction,
+                                       const Eigen::Vector3d &min_pt, double side, double &t_entry)
+    {
+      double t_min = 0;
+      double t_max = std::numeric_limits<double>::max ();
+      for (int d = 0; d < 3; ++d)
+      {
+        if (direction[d] == 0.0f)
+        {
+          // parallel to the slab
+          if (origin[d] < min_pt[d] || origin[d] > min_pt[d] + side)
+            return (false);
+          continue;
+        }
+        double t0 = (min_pt[d] - origin[d]) / direction[d];
+        double t1 = (min_pt[d] + side - origin[d]) / direction[d];
+        if (t0 > t1)
+          std::swap (t0, t1);
+        t_min = std::max (t_min, t0);
+        t_max = std::min (t_max, t1);
+        if (t_min > t_max)
+          return (false);
+      }
+      t_entry = t_min;
+      return (true);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT>
+pcl::octree::OctreePointCloudLinear<PointT>::OctreePointCloudLinear (const double resolution) :
+  input_ (), indices_ (), resolution_ (resolution), min_x_ (0), min_y_ (0), min_z_ (0), octree_depth_ (0),
+  nodes_ (), level_begin_ (), point_indices_ ()
+{
+  assert (resolution > 0.0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::octree::OctreePointCloudLinear<PointT>::deleteTree ()
+{
+  octree_depth_ = 0;
+  nodes_.clear ();
+  level_begin_.clear ();
+  point_indices_.clear ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::octree::OctreePointCloudLinear<PointT>::addPointsFromInputCloud ()
+{
+  deleteTree ();
+
+  // collect the finite points
+  std::vector<int> valid_indices;
+  if (indices_)
+  {
+    valid_indices.reserve (indices_->size ());
+    for (std::vector<int>::const_iterator it = indices_->begin (); it != indices_->end (); ++it)
+      if (isFinite (input_->points[*it]))
+        valid_indices.push_back (*it);
+  }
+  else
+  {
+    valid_indices.reserve (input_->points.size ());
+    for (size_t i = 0; i < input_->points.size (); ++i)
+      if (isFinite (input_->points[i]))
+        valid_indices.push_back (static_cast<int> (i));
+  }
+  if (valid_indices.empty ())
+    return;
+
+  // cubic bounding box with a power of two number of voxels along each axis
+  Eigen::Vector3f min_pt = input_->points[valid_indices[0]].getVector3fMap ();
+  Eigen::Vector3f max_pt = min_pt;
+  for (size_t i = 1; i < valid_indices.size (); ++i)
+  {
+    min_pt = min_pt.cwiseMin (input_->points[valid_indices[i]].getVector3fMap ());
+    max_pt = max_pt.cwiseMax (input_->points[valid_indices[i]].getVector3fMap ());
+  }
+  const double extent = (max_pt - min_pt).maxCoeff ();
+
+  unsigned int depth = 1;
+  while (depth < 21 && static_cast<double> (1u << depth) * resolution_ <= extent)
+    ++depth;
+  if (static_cast<double> (1u << depth) * resolution_ <= extent)
+  {
+    PCL_ERROR ("[pcl::octree::OctreePointCloudLinear::addPointsFromInputCloud] The resolution %g is too small for an extent of %g!\n",
+               resolution_, extent);
+    return;
+  }
+
+  min_x_ = min_pt[0];
+  min_y_ = min_pt[1];
+  min_z_ = min_pt[2];
+  octree_depth_ = depth;
+
+  // sort the points by the Morton codes of their leaf voxels, keeping the input order within a voxel
+  std::vector<std::pair<uint64_t, int> > codes (valid_indices.size ());
+  for (size_t i = 0; i < valid_indices.size (); ++i)
+  {
+    OctreeKey key;
+    genOctreeKeyforPoint (input_->points[valid_indices[i]], key);
+    codes[i] = std::make_pair (pcl::computeMortonCode (key.x, key.y, key.z), valid_indices[i]);
+  }
+  std::stable_sort (codes.begin (), codes.end (), compareLinearOctreeCodes);
+
+  // leaf level
+  std::vector<std::vector<OctreeLinearNode> > levels (octree_depth_ + 1);
+  point_indices_.resize (codes.size ());
+  for (size_t i = 0; i < codes.size (); ++i)
+  {
+    point_indices_[i] = codes[i].second;
+    if (i == 0 || codes[i].first != codes[i - 1].first)
+    {
+      OctreeLinearNode leaf;
+      leaf.code = codes[i].first;
+      leaf.first = static_cast<uint32_t> (i);
+      leaf.child_mask = 0;
+      leaf.depth = static_cast<uint8_t> (octree_depth_);
+      levels[octree_depth_].push_back (leaf);
+    }
+  }
+
+  // branch levels, bottom-up: the parent code drops the 3 lowest bits of the child code
+  for (unsigned int depth_idx = octree_depth_; depth_idx > 0; --depth_idx)
+  {
+    const std::vector<OctreeLinearNode> &children = levels[depth_idx];
+    std::vector<OctreeLinearNode> &parents = levels[depth_idx - 1];
+    for (size_t i = 0; i < children.size (); ++i)
+    {
+      const uint64_t parent_code = children[i].code >> 3;
+      if (parents.empty () || parents.back ().code != parent_code)
+      {
+        OctreeLinearNode branch;
+        branch.code = parent_code;
+        branch.first = static_cast<uint32_t> (i);
+        branch.child_mask = 0;
+        branch.depth = static_cast<uint8_t> (depth_idx - 1);
+        parents.push_back (branch);
+      }
+      parents.back ().child_mask = static_cast<uint8_t> (parents.back ().child_mask | (1 << (children[i].code & 7)));
+    }
+  }
+
+  // concatenate the levels, turning the child offsets into array indices
+  level_begin_.resize (octree_depth_ + 2);
+  level_begin_[0] = 0;
+  for (unsigned int depth_idx = 0; depth_idx <= octree_depth_; ++depth_idx)
+    level_begin_[depth_idx + 1] = level_begin_[depth_idx] + levels[depth_idx].size ();
+
+  nodes_.reserve (level_begin_.back ());
+  for (unsigned int depth_idx = 0; depth_idx <= octree_depth_; ++depth_idx)
+  {
+    if (depth_idx < octree_depth_)
+      for (size_t i = 0; i < levels[depth_idx].size (); ++i)
+        levels[depth_idx][i].first += static_cast<uint32_t> (level_begin_[depth_idx + 1]);
+    nodes_.insert (nodes_.end (), levels[depth_idx].begin (), levels[depth_idx].end ());
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::octree::OctreePointCloudLinear<PointT>::getBoundingBox (double &min_x_arg, double &min_y_arg, double &min_z_arg,
+                                                             double &max_x_arg, double &max_y_arg, double &max_z_arg) const
+{
+  const double side = resolution_ * static_cast<double> (1u << octree_depth_);
+  min_x_arg = min_x_;
+  min_y_arg = min_y_;
+  min_z_arg = min_z_;
+  max_x_arg = min_x_ + side;
+  max_y_arg = min_y_ + side;
+  max_z_arg = min_z_ + side;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::octree::OctreePointCloudLinear<PointT>::genOctreeKeyforPoint (const PointT& point_arg, OctreeKey &key_arg) const
+{
+  // points outside of the bounding box are clamped to the closest voxel
+  const double max_key = static_cast<double> ((1u << octree_depth_) - 1);
+  key_arg.x = static_cast<unsigned int> (std::min (std::max ((point_arg.x - min_x_) / resolution_, 0.0), max_key));
+  key_arg.y = static_cast<unsigned int> (std::min (std::max ((point_arg.y - min_y_) / resolution_, 0.0), max_key));
+  key_arg.z = static_cast<unsigned int> (std::min (std::max ((point_arg.z - min_z_) / resolution_, 0.0), max_key));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> pcl::octree::OctreeKey
+pcl::octree::OctreePointCloudLinear<PointT>::getNodeKey (std::size_t node_idx_arg) const
+{
+  const uint64_t code = nodes_[node_idx_arg].code;
+  OctreeKey key;
+  for (unsigned int bit = 0; bit < nodes_[node_idx_arg].depth; ++bit)
+  {
+    key.x |= static_cast<unsigned int> ((code >> (3 * bit + 2)) & 1) << bit;
+    key.y |= static_cast<unsigned int> ((code >> (3 * bit + 1)) & 1) << bit;
+    key.z |= static_cast<unsigned int> ((code >> (3 * bit)) & 1) << bit;
+  }
+  return (key);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> pcl::octree::OctreeLinearLeafContainer
+pcl::octree::OctreePointCloudLinear<PointT>::getLeafContainer (std::size_t node_idx_arg) const
+{
+  const std::size_t end = node_idx_arg + 1 < nodes_.size () ? nodes_[node_idx_arg + 1].first : point_indices_.size ();
+  return (OctreeLinearLeafContainer (&point_indices_[0] + nodes_[node_idx_arg].first, &point_indices_[0] + end));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> std::size_t
+pcl::octree::OctreePointCloudLinear<PointT>::findLeaf (uint64_t code_arg) const
+{
+  if (nodes_.empty ())
+    return (0);
+
+  // the leaf level is sorted by Morton code
+  std::vector<OctreeLinearNode>::const_iterator leaf =
+      std::lower_bound (nodes_.begin () + level_begin_[octree_depth_], nodes_.end (), code_arg, compareLinearOctreeNodeCode);
+  if (leaf == nodes_.end () || leaf->code != code_arg)
+    return (nodes_.size ());
+  return (leaf - nodes_.begin ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> double
+pcl::octree::OctreePointCloudLinear<PointT>::getVoxelBounds (const OctreeKey &key_arg, unsigned int depth_arg,
+                                                             Eigen::Vector3d &min_pt) const
+{
+  const double side = resolution_ * static_cast<double> (1u << (octree_depth_ - depth_arg));
+  min_pt[0] = min_x_ + key_arg.x * side;
+  min_pt[1] = min_y_ + key_arg.y * side;
+  min_pt[2] = min_z_ + key_arg.z * side;
+  return (side);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> bool
+pcl::octree::OctreePointCloudLinear<PointT>::isVoxelOccupiedAtPoint (const PointT& point_arg) const
+{
+  double min_x, min_y, min_z, max_x, max_y, max_z;
+  getBoundingBox (min_x, min_y, min_z, max_x, max_y, max_z);
+  if (nodes_.empty () || point_arg.x < min_x || point_arg.y < min_y || point_arg.z < min_z ||
+      point_arg.x >= max_x || point_arg.y >= max_y || point_arg.z >= max_z)
+    return (false);
+
+  OctreeKey key;
+  genOctreeKeyforPoint (point_arg, key);
+  return (findLeaf (pcl::computeMortonCode (key.x, key.y, key.z)) < nodes_.size ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> int
+pcl::octree::OctreePointCloudLinear<PointT>::getOccupiedVoxelCenters (AlignedPointTVector &voxel_center_list_arg) const
+{
+  voxel_center_list_arg.clear ();
+  if (nodes_.empty ())
+    return (0);
+
+  voxel_center_list_arg.reserve (getLeafCount ());
+  for (std::size_t i = level_begin_[octree_depth_]; i < nodes_.size (); ++i)
+  {
+    Eigen::Vector3d min_pt;
+    const double side = getVoxelBounds (getNodeKey (i), octree_depth_, min_pt);
+
+    PointT center;
+    center.x = static_cast<float> (min_pt[0] + side / 2.0);
+    center.y = static_cast<float> (min_pt[1] + side / 2.0);
+    center.z = static_cast<float> (min_pt[2] + side / 2.0);
+    voxel_center_list_arg.push_back (center);
+  }
+  return (static_cast<int> (voxel_center_list_arg.size ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> bool
+pcl::octree::OctreePointCloudLinear<PointT>::voxelSearch (const PointT& point, std::vector<int>& point_idx_data) const
+{
+  assert (isFinite (point) && "Invalid (NaN, Inf) point coordinates given to voxelSearch!");
+  if (!isVoxelOccupiedAtPoint (point))
+    return (false);
+
+  OctreeKey key;
+  genOctreeKeyforPoint (point, key);
+  getLeafContainer (findLeaf (pcl::computeMortonCode (key.x, key.y, key.z))).getPointIndices (point_idx_data);
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> int
+pcl::octree::OctreePointCloudLinear<PointT>::nearestKSearch (const PointT &p_q, int k, std::vector<int> &k_indices,
+                                                             std::vector<float> &k_sqr_distances) const
+{
+  assert (isFinite (p_q) && "Invalid (NaN, Inf) point coordinates given to nearestKSearch!");
+
+  k_indices.clear ();
+  k_sqr_distances.clear ();
+  if (k < 1 || nodes_.empty ())
+    return (0);
+
+  std::vector<std::pair<float, int> > candidates;
+  candidates.reserve (k);
+  getKNearestNeighborRecursive (p_q, k, 0, OctreeKey (), candidates);
+
+  std::sort_heap (candidates.begin (), candidates.end ());
+  k_indices.resize (candidates.size ());
+  k_sqr_distances.resize (candidates.size ());
+  for (size_t i = 0; i < candidates.size (); ++i)
+  {
+    k_indices[i] = candidates[i].second;
+    k_sqr_distances[i] = candidates[i].first;
+  }
+  return (static_cast<int> (k_indices.size ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::octree::OctreePointCloudLinear<PointT>::getKNearestNeighborRecursive (
+    const PointT &point, std::size_t k, std::size_t node_idx, const OctreeKey &key,
+    std::vector<std::pair<float, int> > &candidates) const
+{
+  const OctreeLinearNode &node = nodes_[node_idx];
+  const Eigen::Vector3f query = point.getVector3fMap ();
+
+  // insertion sort the existing children by their distance to the query point
+  double child_distances[8];
+  std::size_t child_nodes[8];
+  OctreeKey child_keys[8];
+  int nr_children = 0;
+  std::size_t child_idx = node.first;
+  for (unsigned char child = 0; child < 8; ++child)
+  {
+    if (!(node.child_mask & (1 << child)))
+      continue;
+
+    const OctreeKey child_key ((key.x << 1) | ((child >> 2) & 1), (key.y << 1) | ((child >> 1) & 1), (key.z << 1) | (child & 1));
+    Eigen::Vector3d min_pt;
+    const double side = getVoxelBounds (child_key, node.depth + 1, min_pt);
+    const double distance = sqrDistanceToLinearOctreeVoxel (query, min_pt, side);
+
+    int pos = nr_children++;
+    for (; pos > 0 && child_distances[pos - 1] > distance; --pos)
+    {
+      child_distances[pos] = child_distances[pos - 1];
+      child_nodes[pos] = child_nodes[pos - 1];
+      child_keys[pos] = child_keys[pos - 1];
+    }
+    child_distances[pos] = distance;
+    child_nodes[pos] = child_idx++;
+    child_keys[pos] = child_key;
+  }
+
+  for (int i = 0; i < nr_children; ++i)
+  {
+    // no point of this or any further child can improve the result
+    if (candidates.size () == k && child_distances[i] >= candidates.front ().first)
+      break;
+
+    const std::size_t child_node = child_nodes[i];
+    if (node.depth + 1u < octree_depth_)
+    {
+      getKNearestNeighborRecursive (point, k, child_node, child_keys[i], candidates);
+      continue;
+    }
+
+    const OctreeLinearLeafContainer leaf = getLeafContainer (child_node);
+    const int* leaf_indices = &point_indices_[0] + nodes_[child_node].first;
+    for (std::size_t j = 0; j < leaf.getSize (); ++j)
+    {
+      const float sqr_distance = (input_->points[leaf_indices[j]].getVector3fMap () - query).squaredNorm ();
+      if (candidates.size () < k)
+      {
+        candidates.push_back (std::make_pair (sqr_distance, leaf_indices[j]));
+        std::push_heap (candidates.begin (), candidates.end ());
+      }
+      else if (sqr_distance < candidates.front ().first)
+      {
+        std::pop_heap (candidates.begin (), candidates.end ());
+        candidates.back () = std::make_pair (sqr_distance, leaf_indices[j]);
+        std::push_heap (candidates.begin (), candidates.end ());
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::octree::OctreePointCloudLinear<PointT>::approxNearestSearch (const PointT &p_q, int &result_index,
+                                                                  float &sqr_distance) const
+{
+  assert (isFinite (p_q) && "Invalid (NaN, Inf) point coordinates given to approxNearestSearch!");
+
+  result_index = -1;
+  sqr_distance = std::numeric_limits<float>::max ();
+  if (nodes_.empty ())
+    return;
+
+  // descend into the child with the closest voxel center
+  const Eigen::Vector3f query = p_q.getVector3fMap ();
+  std::size_t node_idx = 0;
+  OctreeKey key;
+  while (nodes_[node_idx].depth < octree_depth_)
+  {
+    const OctreeLinearNode &node = nodes_[node_idx];
+    double min_distance = std::numeric_limits<double>::max ();
+    std::size_t child_idx = node.first;
+    std::size_t min_child_idx = node.first;
+    OctreeKey min_child_key;
+    for (unsigned char child = 0; child < 8; ++child)
+    {
+      if (!(node.child_mask & (1 << child)))
+        continue;
+
+      const OctreeKey child_key ((key.x << 1) | ((child >> 2) & 1), (key.y << 1) | ((child >> 1) & 1), (key.z << 1) | (child & 1));
+      Eigen::Vector3d min_pt;
+      const double side = getVoxelBounds (child_key, node.depth + 1, min_pt);
+      const double distance = (min_pt + Eigen::Vector3d::Constant (side / 2.0) - query.cast<double> ()).squaredNorm ();
+      if (distance < min_distance)
+      {
+        min_distance = distance;
+        min_child_idx = child_idx;
+        min_child_key = child_key;
+      }
+      ++child_idx;
+    }
+    node_idx = min_child_idx;
+    key = min_child_key;
+  }
+
+  const OctreeLinearLeafContainer leaf = getLeafContainer (node_idx);
+  const int* leaf_indices = &point_indices_[0] + nodes_[node_idx].first;
+  for (std::size_t j = 0; j < leaf.getSize (); ++j)
+  {
+    const float distance = (input_->points[leaf_indices[j]].getVector3fMap () - query).squaredNorm ();
+    if (distance < sqr_distance)
+    {
+      result_index = leaf_indices[j];
+      sqr_distance = distance;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> int
+pcl::octree::OctreePointCloudLinear<PointT>::radiusSearch (const PointT &p_q, const double radius,
+                                                           std::vector<int> &k_indices,
+                                                           std::vector<float> &k_sqr_distances,
+                                                           unsigned int max_nn) const
+{
+  assert (isFinite (p_q) && "Invalid (NaN, Inf) point coordinates given to radiusSearch!");
+
+  k_indices.clear ();
+  k_sqr_distances.clear ();
+  if (!nodes_.empty ())
+    getNeighborsWithinRadiusRecursive (p_q, radius * radius, 0, OctreeKey (), k_indices, k_sqr_distances, max_nn);
+
+  return (static_cast<int> (k_indices.size ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::octree::OctreePointCloudLinear<PointT>::getNeighborsWithinRadiusRecursive (
+    const PointT &point, double radius_squared, std::size_t node_idx, const OctreeKey &key,
+    std::vector<int> &k_indices, std::vector<float> &k_sqr_distances, unsigned int max_nn) const
+{
+  const OctreeLinearNode &node = nodes_[node_idx];
+  const Eigen::Vector3f query = point.getVector3fMap ();
+
+  std::size_t child_idx = node.first;
+  for (unsigned char child = 0; child < 8; ++child)
+  {
+    if (!(node.child_mask & (1 << child)))
+      continue;
+
+    const std::size_t child_node = child_idx++;
+    const OctreeKey child_key ((key.x << 1) | ((child >> 2) & 1), (key.y << 1) | ((child >> 1) & 1), (key.z << 1) | (child & 1));
+    Eigen::Vector3d min_pt;
+    const double side = getVoxelBounds (child_key, node.depth + 1, min_pt);
+    if (sqrDistanceToLinearOctreeVoxel (query, min_pt, side) > radius_squared)
+      continue;
+
+    if (node.depth + 1u < octree_depth_)
+    {
+      getNeighborsWithinRadiusRecursive (point, radius_squared, child_node, child_key, k_indices, k_sqr_distances, max_nn);
+    }
+    else
+    {
+      const OctreeLinearLeafContainer leaf = getLeafContainer (child_node);
+      const int* leaf_indices = &point_indices_[0] + nodes_[child_node].first;
+      for (std::size_t j = 0; j < leaf.getSize (); ++j)
+      {
+        const float sqr_distance = (input_->points[leaf_indices[j]].getVector3fMap () - query).squaredNorm ();
+        if (sqr_distance > radius_squared)
+          continue;
+
+        k_indices.push_back (leaf_indices[j]);
+        k_sqr_distances.push_back (sqr_distance);
+        if (max_nn != 0 && k_indices.size () == max_nn)
+          return;
+      }
+    }
+
+    if (max_nn != 0 && k_indices.size () == max_nn)
+      return;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> int
+pcl::octree::OctreePointCloudLinear<PointT>::boxSearch (const Eigen::Vector3f &min_pt, const Eigen::Vector3f &max_pt,
+                                                        std::vector<int> &k_indices) const
+{
+  k_indices.clear ();
+  if (!nodes_.empty ())
+    boxSearchRecursive (min_pt, max_pt, 0, OctreeKey (), k_indices);
+
+  return (static_cast<int> (k_indices.size ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::octree::OctreePointCloudLinear<PointT>::boxSearchRecursive (const Eigen::Vector3f &min_pt,
+                                                                 const Eigen::Vector3f &max_pt, std::size_t node_idx,
+                                                                 const OctreeKey &key, std::vector<int> &k_indices) const
+{
+  const OctreeLinearNode &node = nodes_[node_idx];
+
+  std::size_t child_idx = node.first;
+  for (unsigned char child = 0; child < 8; ++child)
+  {
+    if (!(node.child_mask & (1 << child)))
+      continue;
+
+    const std::size_t child_node = child_idx++;
+    const OctreeKey child_key ((key.x << 1) | ((child >> 2) & 1), (key.y << 1) | ((child >> 1) & 1), (key.z << 1) | (child & 1));
+    Eigen::Vector3d voxel_min;
+    const double side = getVoxelBounds (child_key, node.depth + 1, voxel_min);
+
+    // test if search region overlaps with voxel space
+    if (voxel_min[0] > max_pt[0] || min_pt[0] > voxel_min[0] + side ||
+        voxel_min[1] > max_pt[1] || min_pt[1] > voxel_min[1] + side ||
+        voxel_min[2] > max_pt[2] || min_pt[2] > voxel_min[2] + side)
+      continue;
+
+    if (node.depth + 1u < octree_depth_)
+    {
+      boxSearchRecursive (min_pt, max_pt, child_node, child_key, k_indices);
+      continue;
+    }
+
+    const OctreeLinearLeafContainer leaf = getLeafContainer (child_node);
+    const int* leaf_indices = &point_indices_[0] + nodes_[child_node].first;
+    for (std::size_t j = 0; j < leaf.getSize (); ++j)
+    {
+      const PointT &candidate_point = input_->points[leaf_indices[j]];
+      if (candidate_point.x >= min_pt[0] && candidate_point.x <= max_pt[0] &&
+          candidate_point.y >= min_pt[1] && candidate_point.y <= max_pt[1] &&
+          candidate_point.z >= min_pt[2] && candidate_point.z <= max_pt[2])
+        k_indices.push_back (leaf_indices[j]);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> int
+pcl::octree::OctreePointCloudLinear<PointT>::getIntersectedVoxelCenters (Eigen::Vector3f origin,
+                                                                         Eigen::Vector3f direction,
+                                                                         AlignedPointTVector &voxel_center_list,
+                                                                         int max_voxel_count) const
+{
+  std::vector<std::size_t> leaves;
+  getIntersectedLeaves (origin, direction, std::max (max_voxel_count, 0), leaves);
+
+  voxel_center_list.clear ();
+  voxel_center_list.reserve (leaves.size ());
+  for (std::size_t i = 0; i < leaves.size (); ++i)
+  {
+    Eigen::Vector3d min_pt;
+    const double side = getVoxelBounds (getNodeKey (leaves[i]), octree_depth_, min_pt);
+
+    PointT center;
+    center.x = static_cast<float> (min_pt[0] + side / 2.0);
+    center.y = static_cast<float> (min_pt[1] + side / 2.0);
+    center.z = static_cast<float> (min_pt[2] + side / 2.0);
+    voxel_center_list.push_back (center);
+  }
+  return (static_cast<int> (leaves.size ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> int
+pcl::octree::OctreePointCloudLinear<PointT>::getIntersectedVoxelIndices (Eigen::Vector3f origin,
+                                                                         Eigen::Vector3f direction,
+                                                                         std::vector<int> &k_indices,
+                                                                         int max_voxel_count) const
+{
+  std::vector<std::size_t> leaves;
+  getIntersectedLeaves (origin, direction, std::max (max_voxel_count, 0), leaves);
+
+  k_indices.clear ();
+  for (std::size_t i = 0; i < leaves.size (); ++i)
+    getLeafContainer (leaves[i]).getPointIndices (k_indices);
+  return (static_cast<int> (leaves.size ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::octree::OctreePointCloudLinear<PointT>::getIntersectedLeaves (const Eigen::Vector3f &origin,
+                                                                   const Eigen::Vector3f &direction,
+                                                                   std::size_t max_voxel_count,
+                                                                   std::vector<std::size_t> &leaves) const
+{
+  leaves.clear ();
+  if (nodes_.empty ())
+    return;
+
+  Eigen::Vector3d root_min;
+  const double side = getVoxelBounds (OctreeKey (), 0, root_min);
+  double t_entry;
+  if (intersectRayWithLinearOctreeVoxel (origin, direction, root_min, side, t_entry))
+    getIntersectedLeavesRecursive (origin, direction, 0, OctreeKey (), max_voxel_count, leaves);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::octree::OctreePointCloudLinear<PointT>::getIntersectedLeavesRecursive (const Eigen::Vector3f &origin,
+                                                                            const Eigen::Vector3f &direction,
+                                                                            std::size_t node_idx,
+                                                                            const OctreeKey &key,
+                                                                            std::size_t max_voxel_count,
+                                                                            std::vector<std::size_t> &leaves) const
+{
+  const OctreeLinearNode &node = nodes_[node_idx];
+
+  // the intersected children, sorted by the ray parameter at which the ray enters them
+  std::pair<double, unsigned char> hits[8];
+  std::size_t child_nodes[8];
+  OctreeKey child_keys[8];
+  int hit_count = 0;
+
+  std::size_t child_idx = node.first;
+  for (unsigned char child = 0; child < 8; ++child)
+  {
+    if (!(node.child_mask & (1 << child)))
+      continue;
+
+    child_nodes[child] = child_idx++;
+    child_keys[child] = OctreeKey ((key.x << 1) | ((child >> 2) & 1), (key.y << 1) | ((child >> 1) & 1), (key.z << 1) | (child & 1));
+    Eigen::Vector3d voxel_min;
+    const double side = getVoxelBounds (child_keys[child], node.depth + 1, voxel_min);
+
+    double t_entry;
+    if (intersectRayWithLinearOctreeVoxel (origin, direction, voxel_min, side, t_entry))
+      hits[hit_count++] = std::make_pair (t_entry, child);
+  }
+  std::sort (hits, hits + hit_count);
+
+  for (int i = 0; i < hit_count; ++i)
+  {
+    const unsigned char child = hits[i].second;
+    if (node.depth + 1u < octree_depth_)
+      getIntersectedLeavesRecursive (origin, direction, child_nodes[child], child_keys[child], max_voxel_count, leaves);
+    else
+      leaves.push_back (child_nodes[child]);
+
+    if (max_voxel_count != 0 && leaves.size () >= max_voxel_count)
+      return;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::octree::OctreePointCloudLinear<PointT>::serializeTree (std::vector<char> &buffer_arg) const
+{
+  const uint64_t nr_nodes = nodes_.size ();
+  const uint64_t nr_points = point_indices_.size ();
+  const uint32_t depth = octree_depth_;
+  const double parameters[4] = {resolution_, min_x_, min_y_, min_z_};
+
+  // the nodes are written field by field, without the padding of OctreeLinearNode
+  const std::size_t node_size = sizeof (uint64_t) + sizeof (uint32_t) + 2 * sizeof (uint8_t);
+  const std::size_t header_size = sizeof (parameters) + sizeof (depth) + sizeof (nr_nodes) + sizeof (nr_points);
+  buffer_arg.resize (header_size + nr_nodes * node_size + nr_points * sizeof (int));
+
+  char* data = &buffer_arg[0];
+  memcpy (data, parameters, sizeof (parameters));
+  data += sizeof (parameters);
+  memcpy (data, &depth, sizeof (depth));
+  data += sizeof (depth);
+  memcpy (data, &nr_nodes, sizeof (nr_nodes));
+  data += sizeof (nr_nodes);
+  memcpy (data, &nr_points, sizeof (nr_points));
+  data += sizeof (nr_points);
+  for (std::size_t i = 0; i < nodes_.size (); ++i)
+  {
+    memcpy (data, &nodes_[i].code, sizeof (nodes_[i].code));
+    data += sizeof (nodes_[i].code);
+    memcpy (data, &nodes_[i].first, sizeof (nodes_[i].first));
+    data += sizeof (nodes_[i].first);
+    *data++ = static_cast<char> (nodes_[i].child_mask);
+    *data++ = static_cast<char> (nodes_[i].depth);
+  }
+  if (nr_points > 0)
+    memcpy (data, &point_indices_[0], nr_points * sizeof (int));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> bool
+pcl::octree::OctreePointCloudLinear<PointT>::deserializeTree (const std::vector<char> &buffer_arg)
+{
+  deleteTree ();
+
+  uint64_t nr_nodes, nr_points;
+  uint32_t depth;
+  double parameters[4];
+
+  const std::size_t node_size = sizeof (uint64_t) + sizeof (uint32_t) + 2 * sizeof (uint8_t);
+  const std::size_t header_size = sizeof (parameters) + sizeof (depth) + sizeof (nr_nodes) + sizeof (nr_points);
+  if (buffer_arg.size () < header_size)
+    return (false);
+
+  const char* data = &buffer_arg[0];
+  memcpy (parameters, data, sizeof (parameters));
+  data += sizeof (parameters);
+  memcpy (&depth, data, sizeof (depth));
+  data += sizeof (depth);
+  memcpy (&nr_nodes, data, sizeof (nr_nodes));
+  data += sizeof (nr_nodes);
+  memcpy (&nr_points, data, sizeof (nr_points));
+  data += sizeof (nr_points);
+
+  // the sizes are checked one at a time, so that their products cannot overflow
+  const std::size_t payload_size = buffer_arg.size () - header_size;
+  if (depth > 21 || !(parameters[0] > 0) || nr_nodes > payload_size / node_size ||
+      nr_points != (payload_size - nr_nodes * node_size) / sizeof (int) ||
+      (payload_size - nr_nodes * node_size) % sizeof (int) != 0 ||
+      nr_points > static_cast<uint64_t> (std::numeric_limits<uint32_t>::max ()) ||
+      (nr_nodes == 0) != (nr_points == 0) || (nr_nodes > 0 && depth == 0))
+    return (false);
+
+  nodes_.resize (nr_nodes);
+  for (std::size_t i = 0; i < nodes_.size (); ++i)
+  {
+    memcpy (&nodes_[i].code, data, sizeof (nodes_[i].code));
+    data += sizeof (nodes_[i].code);
+    memcpy (&nodes_[i].first, data, sizeof (nodes_[i].first));
+    data += sizeof (nodes_[i].first);
+    nodes_[i].child_mask = static_cast<uint8_t> (*data++);
+    nodes_[i].depth = static_cast<uint8_t> (*data++);
+  }
+  point_indices_.resize (nr_points);
+  if (nr_points > 0)
+    memcpy (&point_indices_[0], data, nr_points * sizeof (int));
+
+  // check the structure the searches rely on: the root first, the children of each branch right after the children
+  // of the previous branches with the Morton codes of their child indices, and the leaves at the tree depth, each
+  // addressing a non-empty range of valid point indices
+  bool valid = nr_nodes == 0 || (nodes_[0].depth == 0 && nodes_[0].code == 0);
+  std::size_t next_child = 1;
+  for (std::size_t i = 0; valid && i < nodes_.size (); ++i)
+  {
+    const OctreeLinearNode &node = nodes_[i];
+    // every node but the root is the child of a previous branch
+    if (i > 0 && i >= next_child)
+      valid = false;
+    else if (node.depth < depth)
+    {
+      valid = node.child_mask != 0 && node.first == next_child && node.first + getChildCount (node.child_mask) <= nr_nodes;
+      std::size_t child_idx = node.first;
+      for (unsigned char child = 0; valid && child < 8; ++child)
+      {
+        if (!(node.child_mask & (1 << child)))
+          continue;
+        const OctreeLinearNode &child_node = nodes_[child_idx++];
+        valid = child_node.depth == node.depth + 1 && child_node.code == ((node.code << 3) | child);
+      }
+      next_child = child_idx;
+    }
+    else
+    {
+      const bool first_leaf = i == 0 || nodes_[i - 1].depth < depth;
+      valid = node.depth == depth && node.child_mask == 0 && node.first < nr_points &&
+              (first_leaf ? node.first == 0 : node.first > nodes_[i - 1].first);
+    }
+  }
+  valid = valid && (nr_nodes == 0 || next_child == nr_nodes);
+  for (std::size_t i = 0; valid && i < point_indices_.size (); ++i)
+    valid = point_indices_[i] >= 0 && (!input_ || point_indices_[i] < static_cast<int> (input_->points.size ()));
+  if (!valid)
+  {
+    deleteTree ();
+    return (false);
+  }
+
+  resolution_ = parameters[0];
+  min_x_ = parameters[1];
+  min_y_ = parameters[2];
+  min_z_ = parameters[3];
+  if (nr_nodes == 0)
+    return (true);
+
+  // recover the first node of each depth
+  octree_depth_ = depth;
+  level_begin_.assign (octree_depth_ + 2, nodes_.size ());
+  for (std::size_t i = nodes_.size (); i > 0; --i)
+    level_begin_[nodes_[i - 1].depth] = i - 1;
+  return (true);
+}
+
+#define PCL_INSTANTIATE_OctreePointCloudLinear(T) template class PCL_EXPORTS pcl::octree::OctreePointCloudLinear<T>;
+
+#endif    // PCL_OCTREE_POINTCLOUD_LINEAR_HPP_
@@ -45,11 +45,15 @@
 #include <pcl/common/common.h>
 #include <assert.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename LeafContainerT, typename BranchContainerT> bool
 pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::voxelSearch (const PointT& point,
-                                                                          std::vector<int>& point_idx_data)
+                                                                          std::vector<int>& point_idx_data) const
 {
   assert (isFinite (point) && "Invalid (NaN, Inf) point coordinates given to nearestKSearch!");
   OctreeKey key;
@@ -72,7 +76,7 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::v
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename LeafContainerT, typename BranchContainerT> bool
 pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::voxelSearch (const int index,
-                                                                          std::vector<int>& point_idx_data)
+                                                                          std::vector<int>& point_idx_data) const
 {
   const PointT search_point = this->getPointByIndex (index);
   return (this->voxelSearch (search_point, point_idx_data));
@@ -82,7 +86,7 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::v
 template<typename PointT, typename LeafContainerT, typename BranchContainerT> int
 pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::nearestKSearch (const PointT &p_q, int k,
                                                                              std::vector<int> &k_indices,
-                                                                             std::vector<float> &k_sqr_distances)
+                                                                             std::vector<float> &k_sqr_distances) const
 {
   assert(this->leaf_count_>0);
   assert (isFinite (p_q) && "Invalid (NaN, Inf) point coordinates given to nearestKSearch!");
@@ -125,7 +129,7 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::n
 template<typename PointT, typename LeafContainerT, typename BranchContainerT> int
 pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::nearestKSearch (int index, int k,
                                                                              std::vector<int> &k_indices,
-                                                                             std::vector<float> &k_sqr_distances)
+                                                                             std::vector<float> &k_sqr_distances) const
 {
   const PointT search_point = this->getPointByIndex (index);
   return (nearestKSearch (search_point, k, k_indices, k_sqr_distances));
@@ -135,7 +139,7 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::n
 template<typename PointT, typename LeafContainerT, typename BranchContainerT> void
 pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::approxNearestSearch (const PointT &p_q,
                                                                                   int &result_index,
-                                                                                  float &sqr_distance)
+                                                                                  float &sqr_distance) const
 {
   assert(this->leaf_count_>0);
   assert (isFinite (p_q) && "Invalid (NaN, Inf) point coordinates given to nearestKSearch!");
@@ -151,7 +155,7 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::a
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename LeafContainerT, typename BranchContainerT> void
 pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::approxNearestSearch (int query_index, int &result_index,
-                                                                                  float &sqr_distance)
+                                                                                  float &sqr_distance) const
 {
   const PointT search_point = this->getPointByIndex (query_index);
 
@@ -214,8 +218,9 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::g
     const PointT & point, unsigned int K, const BranchNode* node, const OctreeKey& key, unsigned int tree_depth,
     const double squared_search_radius, std::vector<prioPointQueueEntry>& point_candidates) const
 {
-  std::vector<prioBranchQueueEntry> search_heap;
-  search_heap.resize (8);
+  // branch queue on the stack: a query does not allocate per visited branch
+  prioBranchQueueEntry search_heap[8];
+  int heap_size = 8;
 
   unsigned char child_idx;
 
@@ -250,18 +255,18 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::g
     }
   }
 
-  std::sort (search_heap.begin (), search_heap.end ());
+  std::sort (search_heap, search_heap + heap_size);
 
   // iterate over all children in priority queue
   // check if the distance to search candidate is smaller than the best point distance (smallest_squared_dist)
-  while ((!search_heap.empty ()) && (search_heap.back ().point_distance <
+  while ((heap_size > 0) && (search_heap[heap_size - 1].point_distance <
          smallest_squared_dist + voxelSquaredDiameter / 4.0 + sqrt (smallest_squared_dist * voxelSquaredDiameter) - this->epsilon_))
   {
     const OctreeNode* child_node;
 
     // read from priority queue element
-    child_node = search_heap.back ().node;
-    new_key = search_heap.back ().key;
+    child_node = search_heap[heap_size - 1].node;
+    new_key = search_heap[heap_size - 1].key;
 
     if (tree_depth < this->octree_depth_)
     {
@@ -311,7 +316,7 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::g
         smallest_squared_dist = point_candidates.back ().point_distance_;
     }
     // pop element from priority queue
-    search_heap.pop_back ();
+    --heap_size;
   }
 
   return (smallest_squared_dist);
@@ -409,7 +414,7 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::a
                                                                                            const OctreeKey& key,
                                                                                            unsigned int tree_depth,
                                                                                            int& result_index,
-                                                                                           float& sqr_distance)
+                                                                                           float& sqr_distance) const
 {
   unsigned char child_idx;
   unsigned char min_child_idx;
@@ -631,6 +636,31 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::g
   return (0);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafContainerT, typename BranchContainerT> int
+pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::getIntersectedVoxelIndices (
+    const std::vector<Eigen::Vector3f> &origins, const std::vector<Eigen::Vector3f> &directions,
+    std::vector<std::vector<int> > &k_indices, int max_voxel_count) const
+{
+  assert (origins.size () == directions.size ());
+
+#ifdef _OPENMP
+  const int nr_threads = this->threads_ == 0 ? omp_get_max_threads () : static_cast<int> (this->threads_);
+#endif
+
+  const int nr_rays = static_cast<int> (origins.size ());
+  k_indices.resize (nr_rays);
+
+  int voxel_count = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 256) num_threads(nr_threads) reduction(+: voxel_count)
+#endif
+  for (int i = 0; i < nr_rays; ++i)
+    voxel_count += getIntersectedVoxelIndices (origins[i], directions[i], k_indices[i], max_voxel_count);
+
+  return (voxel_count);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename LeafContainerT, typename BranchContainerT> int
 pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::getIntersectedVoxelCentersRecursive (
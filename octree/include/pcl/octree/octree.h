@@ -53,5 +53,6 @@
 #include <pcl/octree/octree_pointcloud_voxelcentroid.h>
 
 #include <pcl/octree/octree_search.h>
+#include <pcl/octree/octree_pointcloud_linear.h>
 
 #endif
@@ -203,7 +203,11 @@ namespace pcl
           return this->octree_depth_;
         }
 
-        /** \brief Add points from input point cloud to octree. */
+        /** \brief Add points from input point cloud to octree.
+         * \note For fixed depth, single buffered octrees the points are inserted in bulk: their octree keys are
+         * computed in parallel, sorted in Morton order and the subtrees below the root are built in parallel.
+         * The resulting octree is identical to the one obtained by adding the points one by one.
+         */
         void
         addPointsFromInputCloud ();
 
@@ -405,6 +409,23 @@ namespace pcl
           this->dynamic_depth_enabled_ = static_cast<bool> (max_objs_per_leaf_>0);
         }
 
+        /** \brief Set the number of threads used by \a addPointsFromInputCloud to build the octree, and by the
+         * batch queries of derived classes.
+         * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+         */
+        inline void
+        setNumberOfThreads (unsigned int nr_threads = 0)
+        {
+          threads_ = nr_threads;
+        }
+
+        /** \brief Get the number of threads used to build and query the octree (0 means automatic). */
+        inline unsigned int
+        getNumberOfThreads () const
+        {
+          return (threads_);
+        }
+
 
       protected:
 
@@ -414,6 +435,80 @@ namespace pcl
         virtual void
         addPointIdx (const int point_idx_arg);
 
+        /** \brief Prepare the insertion of a point by the bulk build of \a addPointsFromInputCloud. This method is
+         * called sequentially, in input order, for every point before any octree key is generated. The default
+         * implementation grows the bounding box until the point fits.
+         * \note Classes overriding \a addPointIdx have to override the bulk build methods accordingly.
+         * \param[in] point_idx_arg the index representing the point in the dataset given by \a setInputCloud
+         */
+        virtual void
+        preparePointIdx (const int point_idx_arg)
+        {
+          adoptBoundingBoxToPoint (input_->points[point_idx_arg]);
+        }
+
+        /** \brief Generate the octree key of a point for the bulk build. This method is called in parallel.
+         * \param[in] point_idx_arg the index representing the point in the dataset given by \a setInputCloud
+         * \param[out] key_arg write octree key to this reference
+         */
+        virtual void
+        genOctreeKeyForPointIdx (const int point_idx_arg, OctreeKey &key_arg) const
+        {
+          genOctreeKeyforPoint (input_->points[point_idx_arg], key_arg);
+        }
+
+        /** \brief Add a point to its leaf container during the bulk build. This method is called in parallel, but
+         * never concurrently for the same leaf.
+         * \param[in] point_idx_arg the index representing the point in the dataset given by \a setInputCloud
+         * \param[in] leaf_arg the leaf container the point falls into
+         */
+        virtual void
+        addPointToLeaf (const int point_idx_arg, LeafContainerT &leaf_arg)
+        {
+          leaf_arg.addPointIndex (point_idx_arg);
+        }
+
+        /** \brief Octree key and point index pair used by the bulk build. */
+        struct BulkPoint
+        {
+          OctreeKey key;
+          int idx;
+        };
+
+        /** \brief Branch node and range of the Morton sorted bulk points falling into it. */
+        struct BulkSubtree
+        {
+          BranchNode* branch;
+          std::size_t begin;
+          std::size_t end;
+        };
+
+        /** \brief Compare two bulk points by the Morton order of their octree keys.
+         * \note The order matches the child indices of the branch nodes, so every subtree covers a contiguous range.
+         */
+        static bool
+        compareMortonOrder (const BulkPoint &a, const BulkPoint &b);
+
+        /** \brief Insert the finite points given by \a point_indices_arg in bulk.
+         * \param[in] point_indices_arg the indices of the points to be added, in input order
+         */
+        void
+        addPointsBulk (const std::vector<int> &point_indices_arg);
+
+        /** \brief Recursively create the children of a branch from a range of Morton sorted bulk points.
+         * \param[in] branch_arg the branch the points fall into
+         * \param[in] depth_mask_arg depth mask used to get the child indices of the points
+         * \param[in] points_arg the Morton sorted bulk points
+         * \param[in] begin_arg first point of the range
+         * \param[in] end_arg past-the-end point of the range
+         * \param[out] leaf_count_arg incremented by the number of created leaf nodes
+         * \param[out] branch_count_arg incremented by the number of created branch nodes
+         */
+        void
+        addPointsBulkRecursive (BranchNode &branch_arg, unsigned int depth_mask_arg,
+                                const std::vector<BulkPoint> &points_arg, std::size_t begin_arg, std::size_t end_arg,
+                                std::size_t &leaf_count_arg, std::size_t &branch_count_arg);
+
         /** \brief Add point at index from input pointcloud dataset to octree
          * \param[in] leaf_node to be expanded
          * \param[in] parent_branch parent of leaf node to be expanded
@@ -568,6 +663,9 @@ namespace pcl
          *  \note zero indicates a fixed/maximum depth octree structure
          * **/
         std::size_t max_objs_per_leaf_;
+
+        /** \brief The number of threads used to build the octree in bulk and by batch queries. */
+        unsigned int threads_;
     };
 
   }
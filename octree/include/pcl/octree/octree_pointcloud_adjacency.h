@@ -201,6 +201,34 @@ namespace pcl
          virtual void
          addPointIdx (const int point_idx_arg);
 
+        /** \brief Bulk build counterpart of \a addPointIdx; the bounding box is already defined on the transformed cloud.
+          *
+          * \param[in] point_idx_arg The index representing the point in the dataset given by setInputCloud() */
+        virtual void
+        preparePointIdx (const int)
+        {
+        }
+
+        /** \brief Generates the octree key of a point for the bulk build (uses transform if provided).
+          *
+          * \param[in] point_idx_arg The index representing the point in the dataset given by setInputCloud()
+          * \param[out] key_arg Resulting octree key */
+        virtual void
+        genOctreeKeyForPointIdx (const int point_idx_arg, OctreeKey &key_arg) const
+        {
+          genOctreeKeyforPoint (this->input_->points[point_idx_arg], key_arg);
+        }
+
+        /** \brief Adds a point to a leaf container during the bulk build.
+          *
+          * \param[in] point_idx_arg The index representing the point in the dataset given by setInputCloud()
+          * \param[in] leaf_arg Leaf container the point falls into */
+        virtual void
+        addPointToLeaf (const int point_idx_arg, LeafContainerT &leaf_arg)
+        {
+          leaf_arg.addPoint (this->input_->points[point_idx_arg]);
+        }
+
         /** \brief Fills in the neighbors fields for new voxels.
           *
           * \param[in] key_arg Key of the voxel to check neighbors for
@@ -0,0 +1,797 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_OCTREE_POINTCLOUD_LINEAR_H_
+#define PCL_OCTREE_POINTCLOUD_LINEAR_H_
+
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+
+#include "octree_key.h"
+
+#include <vector>
+#include <assert.h>
+
+namespace pcl
+{
+  namespace octree
+  {
+    /** \brief @b Node of a linear octree.
+      * \note Nodes are stored in a contiguous array, level by level and in Morton order within a level. Instead of
+      * child pointers, a branch stores a child mask and the array index of its first child; the children of a
+      * branch are contiguous. A leaf stores the offset of its first point index.
+      * \ingroup octree
+      */
+    struct OctreeLinearNode
+    {
+      /** \brief Morton code of the node, i.e. the interleaved bits of its octree key at its depth. */
+      uint64_t code;
+      /** \brief Index of the first child node (branch) or of the first point index (leaf). */
+      uint32_t first;
+      /** \brief Bit pattern of the existing children, bit i is set if child i exists. */
+      uint8_t child_mask;
+      /** \brief Depth of the node, the root has depth 0. */
+      uint8_t depth;
+    };
+
+    /** \brief @b Leaf container view of a linear octree leaf, providing the point index interface of
+      * \ref OctreeContainerPointIndices.
+      * \ingroup octree
+      */
+    class OctreeLinearLeafContainer
+    {
+      public:
+        /** \brief Constructor.
+          * \param[in] begin pointer to the first point index of the leaf
+          * \param[in] end past-the-end pointer of the point indices of the leaf
+          */
+        OctreeLinearLeafContainer (const int* begin, const int* end) : begin_ (begin), end_ (end)
+        {
+        }
+
+        /** \brief Append the point indices of the leaf to a vector.
+          * \param[out] data_vector_arg vector the point indices are appended to
+          */
+        void
+        getPointIndices (std::vector<int>& data_vector_arg) const
+        {
+          data_vector_arg.insert (data_vector_arg.end (), begin_, end_);
+        }
+
+        /** \brief Get the last point index of the leaf. */
+        int
+        getPointIndex () const
+        {
+          return (*(end_ - 1));
+        }
+
+        /** \brief Get the number of points in the leaf. */
+        std::size_t
+        getSize () const
+        {
+          return (end_ - begin_);
+        }
+
+      protected:
+        const int* begin_;
+        const int* end_;
+    };
+
+    /** \brief @b Abstract iterator over the nodes of a linear octree.
+      * \note It offers the interface of \ref OctreeIteratorBase, without pointers to nodes.
+      * \ingroup octree
+      */
+    template<typename OctreeT>
+    class OctreeLinearIteratorBase
+    {
+      public:
+        /** \brief Constructor.
+          * \param[in] octree_arg the octree to iterate over
+          * \param[in] node_idx_arg the index of the current node (the node count for an end iterator)
+          */
+        OctreeLinearIteratorBase (const OctreeT* octree_arg = 0, std::size_t node_idx_arg = 0) :
+          octree_ (octree_arg), node_idx_ (node_idx_arg)
+        {
+        }
+
+        /** \brief Equal comparison operator. */
+        bool
+        operator== (const OctreeLinearIteratorBase& other) const
+        {
+          return (octree_ == other.octree_ && node_idx_ == other.node_idx_);
+        }
+
+        /** \brief Inequal comparison operator. */
+        bool
+        operator!= (const OctreeLinearIteratorBase& other) const
+        {
+          return (!operator== (other));
+        }
+
+        /** \brief Get the octree key of the current node, with one bit per level down to its depth. */
+        OctreeKey
+        getCurrentOctreeKey () const
+        {
+          return (octree_->getNodeKey (node_idx_));
+        }
+
+        /** \brief Get the depth of the current node, the root has depth 0. */
+        unsigned int
+        getCurrentOctreeDepth () const
+        {
+          return (octree_->nodes_[node_idx_].depth);
+        }
+
+        /** \brief Get the array index of the current node. */
+        std::size_t
+        getCurrentNodeIndex () const
+        {
+          return (node_idx_);
+        }
+
+        /** \brief Check if the current node is a branch node. */
+        bool
+        isBranchNode () const
+        {
+          return (octree_->nodes_[node_idx_].depth < octree_->getTreeDepth ());
+        }
+
+        /** \brief Check if the current node is a leaf node. */
+        bool
+        isLeafNode () const
+        {
+          return (octree_->nodes_[node_idx_].depth == octree_->getTreeDepth ());
+        }
+
+        /** \brief Get the bit pattern of the existing children of the current node. */
+        char
+        getNodeConfiguration () const
+        {
+          return (static_cast<char> (octree_->nodes_[node_idx_].child_mask));
+        }
+
+        /** \brief Get the point indices of the current leaf node. */
+        OctreeLinearLeafContainer
+        getLeafContainer () const
+        {
+          assert (isLeafNode ());
+          return (octree_->getLeafContainer (node_idx_));
+        }
+
+      protected:
+        /** \brief The octree being iterated over. */
+        const OctreeT* octree_;
+
+        /** \brief Array index of the current node. */
+        std::size_t node_idx_;
+    };
+
+    /** \brief @b Breadth-first iterator over a linear octree, which is the order the nodes are stored in.
+      * \ingroup octree
+      */
+    template<typename OctreeT>
+    class OctreeLinearBreadthFirstIterator : public OctreeLinearIteratorBase<OctreeT>
+    {
+      public:
+        OctreeLinearBreadthFirstIterator (const OctreeT* octree_arg = 0, std::size_t node_idx_arg = 0) :
+          OctreeLinearIteratorBase<OctreeT> (octree_arg, node_idx_arg)
+        {
+        }
+
+        /** \brief Preincrement operator. */
+        OctreeLinearBreadthFirstIterator&
+        operator++ ()
+        {
+          ++this->node_idx_;
+          return (*this);
+        }
+    };
+
+    /** \brief @b Iterator over the leaf nodes of a linear octree, in Morton order.
+      * \ingroup octree
+      */
+    template<typename OctreeT>
+    class OctreeLinearLeafNodeIterator : public OctreeLinearBreadthFirstIterator<OctreeT>
+    {
+      public:
+        OctreeLinearLeafNodeIterator (const OctreeT* octree_arg = 0, std::size_t node_idx_arg = 0) :
+          OctreeLinearBreadthFirstIterator<OctreeT> (octree_arg, node_idx_arg)
+        {
+        }
+    };
+
+    /** \brief @b Depth-first iterator over a linear octree, visiting the children of a branch in child index order.
+      * \ingroup octree
+      */
+    template<typename OctreeT>
+    class OctreeLinearDepthFirstIterator : public OctreeLinearIteratorBase<OctreeT>
+    {
+      public:
+        OctreeLinearDepthFirstIterator (const OctreeT* octree_arg = 0, std::size_t node_idx_arg = 0) :
+          OctreeLinearIteratorBase<OctreeT> (octree_arg, node_idx_arg), stack_ ()
+        {
+        }
+
+        /** \brief Preincrement operator. */
+        OctreeLinearDepthFirstIterator&
+        operator++ ()
+        {
+          const OctreeLinearNode& node = this->octree_->nodes_[this->node_idx_];
+          if (node.depth < this->octree_->getTreeDepth ())
+          {
+            // push the children in reverse order, so the first child is visited next
+            for (std::size_t child = node.first + OctreeT::getChildCount (node.child_mask); child > node.first; --child)
+              stack_.push_back (child - 1);
+          }
+
+          if (stack_.empty ())
+          {
+            this->node_idx_ = this->octree_->nodes_.size ();
+          }
+          else
+          {
+            this->node_idx_ = stack_.back ();
+            stack_.pop_back ();
+          }
+          return (*this);
+        }
+
+        /** \brief Skip the children of the current branch node. */
+        void
+        skipChildVoxels ()
+        {
+          if (stack_.empty ())
+          {
+            this->node_idx_ = this->octree_->nodes_.size ();
+          }
+          else
+          {
+            this->node_idx_ = stack_.back ();
+            stack_.pop_back ();
+          }
+        }
+
+      protected:
+        /** \brief Nodes left to visit. */
+        std::vector<std::size_t> stack_;
+    };
+
+    /** \brief @b Pointer-free linear octree for point clouds.
+      * \note The nodes are stored in a single contiguous array, ordered by depth and by Morton code within each depth.
+      * Branches address their children through a child mask and the array index of their first child, leaves
+      * address a contiguous range of a single point index array. The tree is built in one pass from the Morton sorted
+      * points, supports the search interface of \ref OctreePointCloudSearch and is serialized with a single write.
+      * \note The maximum tree depth is 21, i.e. 2^21 voxels along each axis.
+      * \note typename: PointT: type of point used in pointcloud
+      * \ingroup octree
+      */
+    template<typename PointT>
+    class OctreePointCloudLinear
+    {
+      friend class OctreeLinearIteratorBase<OctreePointCloudLinear>;
+      friend class OctreeLinearDepthFirstIterator<OctreePointCloudLinear>;
+
+      public:
+        typedef boost::shared_ptr<std::vector<int> > IndicesPtr;
+        typedef boost::shared_ptr<const std::vector<int> > IndicesConstPtr;
+
+        typedef pcl::PointCloud<PointT> PointCloud;
+        typedef boost::shared_ptr<PointCloud> PointCloudPtr;
+        typedef boost::shared_ptr<const PointCloud> PointCloudConstPtr;
+
+        typedef boost::shared_ptr<OctreePointCloudLinear<PointT> > Ptr;
+        typedef boost::shared_ptr<const OctreePointCloudLinear<PointT> > ConstPtr;
+
+        typedef std::vector<PointT, Eigen::aligned_allocator<PointT> > AlignedPointTVector;
+
+        // iterators
+        typedef OctreeLinearDepthFirstIterator<OctreePointCloudLinear> Iterator;
+        typedef OctreeLinearDepthFirstIterator<OctreePointCloudLinear> DepthFirstIterator;
+        typedef OctreeLinearBreadthFirstIterator<OctreePointCloudLinear> BreadthFirstIterator;
+        typedef OctreeLinearLeafNodeIterator<OctreePointCloudLinear> LeafNodeIterator;
+
+        /** \brief Constructor.
+          * \param[in] resolution octree resolution at lowest octree level
+          */
+        OctreePointCloudLinear (const double resolution);
+
+        /** \brief Empty class destructor. */
+        virtual
+        ~OctreePointCloudLinear ()
+        {
+        }
+
+        /** \brief Provide a pointer to the input data set.
+          * \param[in] cloud_arg the const boost shared pointer to a PointCloud message
+          * \param[in] indices_arg the point indices subset that is to be used from \a cloud - if 0 the whole point cloud is used
+          */
+        inline void
+        setInputCloud (const PointCloudConstPtr &cloud_arg, const IndicesConstPtr &indices_arg = IndicesConstPtr ())
+        {
+          input_ = cloud_arg;
+          indices_ = indices_arg;
+        }
+
+        /** \brief Get a pointer to the input point cloud dataset. */
+        inline PointCloudConstPtr
+        getInputCloud () const
+        {
+          return (input_);
+        }
+
+        /** \brief Get a pointer to the vector of indices used. */
+        inline IndicesConstPtr
+        getIndices () const
+        {
+          return (indices_);
+        }
+
+        /** \brief Build the octree from the finite points of the input cloud, replacing its previous content. */
+        void
+        addPointsFromInputCloud ();
+
+        /** \brief Delete the octree structure. */
+        void
+        deleteTree ();
+
+        /** \brief Get the octree voxel resolution. */
+        inline double
+        getResolution () const
+        {
+          return (resolution_);
+        }
+
+        /** \brief Get the depth of the leaf nodes. */
+        inline unsigned int
+        getTreeDepth () const
+        {
+          return (octree_depth_);
+        }
+
+        /** \brief Get the number of leaf nodes. */
+        inline std::size_t
+        getLeafCount () const
+        {
+          return (nodes_.empty () ? 0 : nodes_.size () - level_begin_[octree_depth_]);
+        }
+
+        /** \brief Get the number of branch nodes. */
+        inline std::size_t
+        getBranchCount () const
+        {
+          return (nodes_.empty () ? 0 : level_begin_[octree_depth_]);
+        }
+
+        /** \brief Get the bounding box of the octree.
+          * \param[out] min_x_arg X coordinate of lower bounding box corner
+          * \param[out] min_y_arg Y coordinate of lower bounding box corner
+          * \param[out] min_z_arg Z coordinate of lower bounding box corner
+          * \param[out] max_x_arg X coordinate of upper bounding box corner
+          * \param[out] max_y_arg Y coordinate of upper bounding box corner
+          * \param[out] max_z_arg Z coordinate of upper bounding box corner
+          */
+        void
+        getBoundingBox (double &min_x_arg, double &min_y_arg, double &min_z_arg,
+                        double &max_x_arg, double &max_y_arg, double &max_z_arg) const;
+
+        /** \brief Check if a voxel at a given point exists.
+          * \param[in] point_arg point to be checked
+          * \return "true" if voxel exist; "false" otherwise
+          */
+        bool
+        isVoxelOccupiedAtPoint (const PointT& point_arg) const;
+
+        /** \brief Get a PointT vector of centers of all occupied voxels, in Morton order.
+          * \param[out] voxel_center_list_arg results are written to this vector of PointT elements
+          * \return number of occupied voxels
+          */
+        int
+        getOccupiedVoxelCenters (AlignedPointTVector &voxel_center_list_arg) const;
+
+        /** \brief Search for neighbors within a voxel at given point
+          * \param[in] point point addressing a leaf node voxel
+          * \param[out] point_idx_data the resultant indices of the neighboring voxel points
+          * \return "true" if leaf node exist; "false" otherwise
+          */
+        bool
+        voxelSearch (const PointT& point, std::vector<int>& point_idx_data) const;
+
+        /** \brief Search for neighbors within a voxel at given point referenced by a point index
+          * \param[in] index the index in input cloud defining the query point
+          * \param[out] point_idx_data the resultant indices of the neighboring voxel points
+          * \return "true" if leaf node exist; "false" otherwise
+          */
+        bool
+        voxelSearch (const int index, std::vector<int>& point_idx_data) const
+        {
+          return (voxelSearch (input_->points[index], point_idx_data));
+        }
+
+        /** \brief Search for k-nearest neighbors at the query point.
+          * \param[in] cloud the point cloud data
+          * \param[in] index the index in \a cloud representing the query point
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \return number of neighbors found
+          */
+        inline int
+        nearestKSearch (const PointCloud &cloud, int index, int k, std::vector<int> &k_indices,
+                        std::vector<float> &k_sqr_distances) const
+        {
+          return (nearestKSearch (cloud[index], k, k_indices, k_sqr_distances));
+        }
+
+        /** \brief Search for k-nearest neighbors at given query point.
+          * \param[in] p_q the given query point
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points, sorted by distance
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \return number of neighbors found
+          */
+        int
+        nearestKSearch (const PointT &p_q, int k, std::vector<int> &k_indices,
+                        std::vector<float> &k_sqr_distances) const;
+
+        /** \brief Search for k-nearest neighbors at query point
+          * \param[in] index index representing the query point in the dataset given by \a setInputCloud.
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \return number of neighbors found
+          */
+        inline int
+        nearestKSearch (int index, int k, std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
+        {
+          return (nearestKSearch (input_->points[index], k, k_indices, k_sqr_distances));
+        }
+
+        /** \brief Search for approx. nearest neighbor at the query point.
+          * \param[in] cloud the point cloud data
+          * \param[in] query_index the index in \a cloud representing the query point
+          * \param[out] result_index the resultant index of the neighbor point
+          * \param[out] sqr_distance the resultant squared distance to the neighboring point
+          */
+        inline void
+        approxNearestSearch (const PointCloud &cloud, int query_index, int &result_index, float &sqr_distance) const
+        {
+          return (approxNearestSearch (cloud.points[query_index], result_index, sqr_distance));
+        }
+
+        /** \brief Search for approx. nearest neighbor at the query point, by descending into the child with the
+          * closest voxel center down to the leaf level.
+          * \param[in] p_q the given query point
+          * \param[out] result_index the resultant index of the neighbor point (-1 for an empty octree)
+          * \param[out] sqr_distance the resultant squared distance to the neighboring point
+          */
+        void
+        approxNearestSearch (const PointT &p_q, int &result_index, float &sqr_distance) const;
+
+        /** \brief Search for approx. nearest neighbor at the query point.
+          * \param[in] query_index index representing the query point in the dataset given by \a setInputCloud.
+          * \param[out] result_index the resultant index of the neighbor point
+          * \param[out] sqr_distance the resultant squared distance to the neighboring point
+          */
+        inline void
+        approxNearestSearch (int query_index, int &result_index, float &sqr_distance) const
+        {
+          return (approxNearestSearch (input_->points[query_index], result_index, sqr_distance));
+        }
+
+        /** \brief Search for all neighbors of query point that are within a given radius.
+          * \param[in] cloud the point cloud data
+          * \param[in] index the index in \a cloud representing the query point
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value
+          * \return number of neighbors found in radius
+          */
+        inline int
+        radiusSearch (const PointCloud &cloud, int index, double radius, std::vector<int> &k_indices,
+                      std::vector<float> &k_sqr_distances, unsigned int max_nn = 0) const
+        {
+          return (radiusSearch (cloud.points[index], radius, k_indices, k_sqr_distances, max_nn));
+        }
+
+        /** \brief Search for all neighbors of query point that are within a given radius.
+          * \param[in] p_q the given query point
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[out] k_indices the resultant indices of the neighboring points, in Morton order of their voxels
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value
+          * \return number of neighbors found in radius
+          */
+        int
+        radiusSearch (const PointT &p_q, const double radius, std::vector<int> &k_indices,
+                      std::vector<float> &k_sqr_distances, unsigned int max_nn = 0) const;
+
+        /** \brief Search for all neighbors of query point that are within a given radius.
+          * \param[in] index index representing the query point in the dataset given by \a setInputCloud.
+          * \param[in] radius radius of the sphere bounding all of p_q's neighbors
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value
+          * \return number of neighbors found in radius
+          */
+        inline int
+        radiusSearch (int index, const double radius, std::vector<int> &k_indices,
+                      std::vector<float> &k_sqr_distances, unsigned int max_nn = 0) const
+        {
+          return (radiusSearch (input_->points[index], radius, k_indices, k_sqr_distances, max_nn));
+        }
+
+        /** \brief Search for points within rectangular search area
+          * \param[in] min_pt lower corner of search area
+          * \param[in] max_pt upper corner of search area
+          * \param[out] k_indices the resultant point indices
+          * \return number of points found within search area
+          */
+        int
+        boxSearch (const Eigen::Vector3f &min_pt, const Eigen::Vector3f &max_pt, std::vector<int> &k_indices) const;
+
+        /** \brief Get a PointT vector of centers of all voxels that intersected by a ray (origin, direction).
+          * \note The voxels are sorted by the distance at which the ray enters them.
+          * \param[in] origin ray origin
+          * \param[in] direction ray direction vector
+          * \param[out] voxel_center_list results are written to this vector of PointT elements
+          * \param[in] max_voxel_count stop raycasting when this many voxels intersected (0: disable)
+          * \return number of intersected voxels
+          */
+        int
+        getIntersectedVoxelCenters (Eigen::Vector3f origin, Eigen::Vector3f direction,
+                                    AlignedPointTVector &voxel_center_list, int max_voxel_count = 0) const;
+
+        /** \brief Get indices of all voxels that are intersected by a ray (origin, direction).
+          * \note The voxels are sorted by the distance at which the ray enters them.
+          * \param[in] origin ray origin
+          * \param[in] direction ray direction vector
+          * \param[out] k_indices resulting point indices from intersected voxels
+          * \param[in] max_voxel_count stop raycasting when this many voxels intersected (0: disable)
+          * \return number of intersected voxels
+          */
+        int
+        getIntersectedVoxelIndices (Eigen::Vector3f origin, Eigen::Vector3f direction,
+                                    std::vector<int> &k_indices, int max_voxel_count = 0) const;
+
+        /** \brief Serialize the octree into a single contiguous buffer, which can be written at once.
+          * \note The buffer holds the octree parameters, the node array and the point index array in host byte order.
+          * The input cloud is not serialized.
+          * \param[out] buffer_arg the buffer the octree is written to
+          */
+        void
+        serializeTree (std::vector<char> &buffer_arg) const;
+
+        /** \brief Deserialize an octree written by \a serializeTree.
+          * \note The point indices refer to the cloud the octree was built from, which has to be provided with
+          * \a setInputCloud before searching.
+          * \note The tree structure is validated, and so are the point indices against the input cloud if it is
+          * already set.
+          * \param[in] buffer_arg the buffer the octree is read from
+          * \return "true" on success, "false" if the buffer does not hold a valid octree
+          */
+        bool
+        deserializeTree (const std::vector<char> &buffer_arg);
+
+        /** \brief Get an iterator to the root node, for a depth-first traversal. */
+        Iterator
+        begin () const
+        {
+          return (Iterator (this, 0));
+        }
+
+        /** \brief Get the end iterator of a depth-first traversal. */
+        Iterator
+        end () const
+        {
+          return (Iterator (this, nodes_.size ()));
+        }
+
+        /** \brief Get an iterator to the root node, for a depth-first traversal. */
+        DepthFirstIterator
+        depth_begin () const
+        {
+          return (DepthFirstIterator (this, 0));
+        }
+
+        /** \brief Get the end iterator of a depth-first traversal. */
+        DepthFirstIterator
+        depth_end () const
+        {
+          return (DepthFirstIterator (this, nodes_.size ()));
+        }
+
+        /** \brief Get an iterator to the root node, for a breadth-first traversal. */
+        BreadthFirstIterator
+        breadth_begin () const
+        {
+          return (BreadthFirstIterator (this, 0));
+        }
+
+        /** \brief Get the end iterator of a breadth-first traversal. */
+        BreadthFirstIterator
+        breadth_end () const
+        {
+          return (BreadthFirstIterator (this, nodes_.size ()));
+        }
+
+        /** \brief Get an iterator to the first leaf node. */
+        LeafNodeIterator
+        leaf_begin () const
+        {
+          return (LeafNodeIterator (this, nodes_.empty () ? 0 : level_begin_[octree_depth_]));
+        }
+
+        /** \brief Get the end iterator of the leaf nodes. */
+        LeafNodeIterator
+        leaf_end () const
+        {
+          return (LeafNodeIterator (this, nodes_.size ()));
+        }
+
+        /** \brief Get the number of children given by a child mask. */
+        static inline unsigned int
+        getChildCount (uint8_t child_mask)
+        {
+          unsigned int count = child_mask - ((child_mask >> 1) & 0x55);
+          count = (count & 0x33) + ((count >> 2) & 0x33);
+          return ((count + (count >> 4)) & 0x0F);
+        }
+
+      protected:
+        /** \brief Generate the octree key of the leaf voxel at a given point. */
+        void
+        genOctreeKeyforPoint (const PointT& point_arg, OctreeKey &key_arg) const;
+
+        /** \brief Get the octree key of a node from its Morton code. */
+        OctreeKey
+        getNodeKey (std::size_t node_idx_arg) const;
+
+        /** \brief Get the point indices of a leaf node. */
+        OctreeLinearLeafContainer
+        getLeafContainer (std::size_t node_idx_arg) const;
+
+        /** \brief Find the leaf node with a given Morton code.
+          * \return the array index of the leaf node, or the node count if it does not exist
+          */
+        std::size_t
+        findLeaf (uint64_t code_arg) const;
+
+        /** \brief Get the lower corner of the voxel of a node.
+          * \param[in] key_arg octree key of the node at its depth
+          * \param[in] depth_arg depth of the node
+          * \param[out] min_pt lower corner of the voxel
+          * \return side length of the voxel
+          */
+        double
+        getVoxelBounds (const OctreeKey &key_arg, unsigned int depth_arg, Eigen::Vector3d &min_pt) const;
+
+        /** \brief Recursive k-nearest neighbor search, visiting the children closest to the query point first.
+          * \param[in] point the query point
+          * \param[in] k the number of neighbors to search for
+          * \param[in] node_idx array index of the current branch node
+          * \param[in] key octree key of the current branch node
+          * \param[in,out] candidates max-heap of (squared distance, point index) pairs
+          */
+        void
+        getKNearestNeighborRecursive (const PointT &point, std::size_t k, std::size_t node_idx, const OctreeKey &key,
+                                      std::vector<std::pair<float, int> > &candidates) const;
+
+        /** \brief Recursive radius search.
+          * \param[in] point the query point
+          * \param[in] radius_squared the squared search radius
+          * \param[in] node_idx array index of the current branch node
+          * \param[in] key octree key of the current branch node
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in] max_nn if not 0, bounds the maximum returned neighbors to this value
+          */
+        void
+        getNeighborsWithinRadiusRecursive (const PointT &point, double radius_squared, std::size_t node_idx,
+                                           const OctreeKey &key, std::vector<int> &k_indices,
+                                           std::vector<float> &k_sqr_distances, unsigned int max_nn) const;
+
+        /** \brief Recursive box search.
+          * \param[in] min_pt lower corner of search area
+          * \param[in] max_pt upper corner of search area
+          * \param[in] node_idx array index of the current branch node
+          * \param[in] key octree key of the current branch node
+          * \param[out] k_indices the resultant point indices
+          */
+        void
+        boxSearchRecursive (const Eigen::Vector3f &min_pt, const Eigen::Vector3f &max_pt, std::size_t node_idx,
+                            const OctreeKey &key, std::vector<int> &k_indices) const;
+
+        /** \brief Get the leaf nodes intersected by a ray, in the order the ray enters them.
+          * \param[in] origin ray origin
+          * \param[in] direction ray direction vector
+          * \param[in] max_voxel_count stop raycasting when this many voxels intersected (0: disable)
+          * \param[out] leaves array indices of the intersected leaf nodes
+          */
+        void
+        getIntersectedLeaves (const Eigen::Vector3f &origin, const Eigen::Vector3f &direction,
+                              std::size_t max_voxel_count, std::vector<std::size_t> &leaves) const;
+
+        /** \brief Recursive ray traversal, visiting the children in the order the ray enters them.
+          * \param[in] origin ray origin
+          * \param[in] direction ray direction vector
+          * \param[in] node_idx array index of the current branch node
+          * \param[in] key octree key of the current branch node
+          * \param[in] max_voxel_count stop raycasting when this many voxels intersected (0: disable)
+          * \param[out] leaves array indices of the intersected leaf nodes
+          */
+        void
+        getIntersectedLeavesRecursive (const Eigen::Vector3f &origin, const Eigen::Vector3f &direction,
+                                       std::size_t node_idx, const OctreeKey &key, std::size_t max_voxel_count,
+                                       std::vector<std::size_t> &leaves) const;
+
+        /** \brief Pointer to input point cloud dataset. */
+        PointCloudConstPtr input_;
+
+        /** \brief A pointer to the vector of point indices to use. */
+        IndicesConstPtr indices_;
+
+        /** \brief Octree resolution. */
+        double resolution_;
+
+        /** \brief Lower corner of the octree bounding box. */
+        double min_x_;
+        double min_y_;
+        double min_z_;
+
+        /** \brief Depth of the leaf nodes. */
+        unsigned int octree_depth_;
+
+        /** \brief Nodes, ordered by depth and by Morton code within each depth. */
+        std::vector<OctreeLinearNode> nodes_;
+
+        /** \brief Array index of the first node of each depth, followed by the node count. */
+        std::vector<std::size_t> level_begin_;
+
+        /** \brief Point indices, grouped by leaf node. */
+        std::vector<int> point_indices_;
+    };
+  }
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/octree/impl/octree_pointcloud_linear.hpp>
+#endif
+
+#endif    // PCL_OCTREE_POINTCLOUD_LINEAR_H_
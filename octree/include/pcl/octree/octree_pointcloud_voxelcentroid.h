@@ -191,6 +191,16 @@ namespace pcl
 
         }
 
+        /** \brief Add point to the centroid of a leaf node during the bulk build.
+          * \param[in] pointIdx_arg index of the point in the input cloud
+          * \param[in] leaf_arg leaf container the point falls into
+          */
+        virtual void
+        addPointToLeaf (const int pointIdx_arg, LeafContainerT &leaf_arg)
+        {
+          leaf_arg.addPoint (this->input_->points[pointIdx_arg]);
+        }
+
         /** \brief Get centroid for a single voxel addressed by a PointT point.
           * \param[in] point_arg point addressing a voxel in octree
           * \param[out] voxel_centroid_arg centroid is written to this PointT reference
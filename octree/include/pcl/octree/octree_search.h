@@ -50,6 +50,8 @@ namespace pcl
   {
     /** \brief @b Octree pointcloud search class
       * \note This class provides several methods for spatial neighbor search based on octree structure
+      * \note All search methods are const and keep their state on the stack or in the output arguments, so they may
+      * be called concurrently from several threads, as long as neither the octree nor the input cloud are modified.
       * \note typename: PointT: type of point used in pointcloud
       * \ingroup octree
       * \author Julius Kammerl (julius@kammerl.de)
@@ -97,7 +99,7 @@ namespace pcl
           * \return "true" if leaf node exist; "false" otherwise
           */
         bool
-        voxelSearch (const PointT& point, std::vector<int>& point_idx_data);
+        voxelSearch (const PointT& point, std::vector<int>& point_idx_data) const;
 
         /** \brief Search for neighbors within a voxel at given point referenced by a point index
           * \param[in] index the index in input cloud defining the query point
@@ -105,7 +107,7 @@ namespace pcl
           * \return "true" if leaf node exist; "false" otherwise
           */
         bool
-        voxelSearch (const int index, std::vector<int>& point_idx_data);
+        voxelSearch (const int index, std::vector<int>& point_idx_data) const;
 
         /** \brief Search for k-nearest neighbors at the query point.
           * \param[in] cloud the point cloud data
@@ -118,7 +120,7 @@ namespace pcl
           */
         inline int
         nearestKSearch (const PointCloud &cloud, int index, int k, std::vector<int> &k_indices,
-                        std::vector<float> &k_sqr_distances)
+                        std::vector<float> &k_sqr_distances) const
         {
           return (nearestKSearch (cloud[index], k, k_indices, k_sqr_distances));
         }
@@ -132,7 +134,7 @@ namespace pcl
           */
         int
         nearestKSearch (const PointT &p_q, int k, std::vector<int> &k_indices,
-                        std::vector<float> &k_sqr_distances);
+                        std::vector<float> &k_sqr_distances) const;
 
         /** \brief Search for k-nearest neighbors at query point
           * \param[in] index index representing the query point in the dataset given by \a setInputCloud.
@@ -144,7 +146,7 @@ namespace pcl
          * \return number of neighbors found
          */
         int
-        nearestKSearch (int index, int k, std::vector<int> &k_indices, std::vector<float> &k_sqr_distances);
+        nearestKSearch (int index, int k, std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const;
 
         /** \brief Search for approx. nearest neighbor at the query point.
           * \param[in] cloud the point cloud data
@@ -154,7 +156,7 @@ namespace pcl
           * \return number of neighbors found
           */
         inline void
-        approxNearestSearch (const PointCloud &cloud, int query_index, int &result_index, float &sqr_distance)
+        approxNearestSearch (const PointCloud &cloud, int query_index, int &result_index, float &sqr_distance) const
         {
           return (approxNearestSearch (cloud.points[query_index], result_index, sqr_distance));
         }
@@ -165,7 +167,7 @@ namespace pcl
           * \param[out] sqr_distance the resultant squared distance to the neighboring point
           */
         void
-        approxNearestSearch (const PointT &p_q, int &result_index, float &sqr_distance);
+        approxNearestSearch (const PointT &p_q, int &result_index, float &sqr_distance) const;
 
         /** \brief Search for approx. nearest neighbor at the query point.
           * \param[in] query_index index representing the query point in the dataset given by \a setInputCloud.
@@ -175,7 +177,7 @@ namespace pcl
           * \return number of neighbors found
           */
         void
-        approxNearestSearch (int query_index, int &result_index, float &sqr_distance);
+        approxNearestSearch (int query_index, int &result_index, float &sqr_distance) const;
 
         /** \brief Search for all neighbors of query point that are within a given radius.
           * \param[in] cloud the point cloud data
@@ -241,6 +243,20 @@ namespace pcl
                                     std::vector<int> &k_indices,
                                     int max_voxel_count = 0) const;
 
+        /** \brief Get indices of all voxels that are intersected by each ray of a batch, casting the rays in parallel.
+          * \note The number of threads is set with \a setNumberOfThreads.
+          * \param[in] origins ray origins
+          * \param[in] directions ray direction vectors, one per origin
+          * \param[out] k_indices resulting point indices from the voxels intersected by each ray
+          * \param[in] max_voxel_count stop raycasting when this many voxels intersected (0: disable)
+          * \return total number of intersected voxels
+          */
+        int
+        getIntersectedVoxelIndices (const std::vector<Eigen::Vector3f> &origins,
+                                    const std::vector<Eigen::Vector3f> &directions,
+                                    std::vector<std::vector<int> > &k_indices,
+                                    int max_voxel_count = 0) const;
+
 
         /** \brief Search for points within rectangular search area
          * \param[in] min_pt lower corner of search area
@@ -391,7 +407,7 @@ namespace pcl
           */
         void
         approxNearestSearchRecursive (const PointT& point, const BranchNode* node, const OctreeKey& key,
-                                      unsigned int tree_depth, int& result_index, float& sqr_distance);
+                                      unsigned int tree_depth, int& result_index, float& sqr_distance) const;
 
         /** \brief Recursively search the tree for all intersected leaf nodes and return a vector of voxel centers.
           * This algorithm is based off the paper An Efficient Parametric Algorithm for Octree Traversal:
@@ -75,6 +75,9 @@ namespace pcl
         typedef pcl::search::KdTree<PointTarget> KdTree;
         typedef typename KdTree::Ptr KdTreePtr;
 
+        typedef pcl::search::Search<PointTarget> SearchTarget;
+        typedef typename SearchTarget::Ptr SearchTargetPtr;
+
         typedef pcl::search::KdTree<PointSource> KdTreeReciprocal;
         typedef typename KdTree::Ptr KdTreeReciprocalPtr;
 
@@ -207,14 +210,15 @@ namespace pcl
         getIndicesTarget () { return (target_indices_); }
 
         /** \brief Provide a pointer to the search object used to find correspondences in
-          * the target cloud.
+          * the target cloud. Any search method can be used, e.g. a \ref pcl::search::VoxelHash
+          * trades exactness for speed on large, uniformly sampled targets.
           * \param[in] tree a pointer to the spatial search object.
           * \param[in] force_no_recompute If set to true, this tree will NEVER be 
           * recomputed, regardless of calls to setInputTarget. Only use if you are 
           * confident that the tree will be set correctly.
           */
         inline void
-        setSearchMethodTarget (const KdTreePtr &tree, 
+        setSearchMethodTarget (const SearchTargetPtr &tree, 
                                bool force_no_recompute = false) 
         { 
           tree_ = tree; 
@@ -228,7 +232,7 @@ namespace pcl
 
         /** \brief Get a pointer to the search method used to find correspondences in the
           * target cloud. */
-        inline KdTreePtr
+        inline SearchTargetPtr
         getSearchMethodTarget () const
         {
           return (tree_);
@@ -301,7 +305,7 @@ namespace pcl
         std::string corr_name_;
 
         /** \brief A pointer to the spatial search object used for the target dataset. */
-        KdTreePtr tree_;
+        SearchTargetPtr tree_;
 
         /** \brief A pointer to the spatial search object used for the source dataset. */
         KdTreeReciprocalPtr tree_reciprocal_;
@@ -0,0 +1,161 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_REGISTRATION_CORRESPONDENCE_ESTIMATION_OMP_H_
+#define PCL_REGISTRATION_CORRESPONDENCE_ESTIMATION_OMP_H_
+
+#include <pcl/registration/correspondence_types.h>
+#include <pcl/registration/correspondence_estimation.h>
+
+namespace pcl
+{
+  namespace registration
+  {
+    /** \brief @b CorrespondenceEstimationOMP determines the same nearest neighbor correspondences
+      * as \ref CorrespondenceEstimation, but queries the search trees in parallel, using the OpenMP
+      * standard.
+      *
+      * The source indices are split in contiguous chunks, one per thread. Every thread collects its
+      * correspondences in its own buffer and the buffers are concatenated in chunk order, so the
+      * result is identical to (and in the same order as) the one of \ref CorrespondenceEstimation,
+      * whatever the number of threads. The class can be passed to
+      * Registration::setCorrespondenceEstimation as is.
+      *
+      * \ingroup registration
+      */
+    template <typename PointSource, typename PointTarget, typename Scalar = float>
+    class CorrespondenceEstimationOMP : public CorrespondenceEstimation<PointSource, PointTarget, Scalar>
+    {
+      public:
+        typedef boost::shared_ptr<CorrespondenceEstimationOMP<PointSource, PointTarget, Scalar> > Ptr;
+        typedef boost::shared_ptr<const CorrespondenceEstimationOMP<PointSource, PointTarget, Scalar> > ConstPtr;
+
+        using CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::tree_;
+        using CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::tree_reciprocal_;
+        using CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::target_;
+        using CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::corr_name_;
+        using CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::getClassName;
+        using CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::initCompute;
+        using CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::initComputeReciprocal;
+        using CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::input_;
+        using CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::indices_;
+        using PCLBase<PointSource>::deinitCompute;
+
+        typedef pcl::PointCloud<PointSource> PointCloudSource;
+        typedef typename PointCloudSource::Ptr PointCloudSourcePtr;
+        typedef typename PointCloudSource::ConstPtr PointCloudSourceConstPtr;
+
+        typedef pcl::PointCloud<PointTarget> PointCloudTarget;
+        typedef typename PointCloudTarget::Ptr PointCloudTargetPtr;
+        typedef typename PointCloudTarget::ConstPtr PointCloudTargetConstPtr;
+
+        /** \brief Initialize the scheduler and set the number of threads to use.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        CorrespondenceEstimationOMP (unsigned int nr_threads = 0) : threads_ (nr_threads)
+        {
+          corr_name_  = "CorrespondenceEstimationOMP";
+        }
+      
+        /** \brief Empty destructor */
+        virtual ~CorrespondenceEstimationOMP () {}
+
+        /** \brief Initialize the scheduler and set the number of threads to use.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        inline void 
+        setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+        /** \brief Get the number of threads the scheduler is set to use (0 means automatic). */
+        inline unsigned int
+        getNumberOfThreads () const { return (threads_); }
+
+        /** \brief Determine the correspondences between input and target cloud.
+          * \param[out] correspondences the found correspondences (index of query point, index of target point, distance)
+          * \param[in] max_distance maximum allowed distance between correspondences
+          */
+        virtual void 
+        determineCorrespondences (pcl::Correspondences &correspondences,
+                                  double max_distance = std::numeric_limits<double>::max ());
+
+        /** \brief Determine the reciprocal correspondences between input and target cloud.
+          * A correspondence is considered reciprocal if both Src_i has Tgt_i as a 
+          * correspondence, and Tgt_i has Src_i as one.
+          *
+          * \param[out] correspondences the found correspondences (index of query and target point, distance)
+          * \param[in] max_distance maximum allowed distance between correspondences
+          */
+        virtual void 
+        determineReciprocalCorrespondences (pcl::Correspondences &correspondences,
+                                            double max_distance = std::numeric_limits<double>::max ());
+
+        /** \brief Clone and cast to CorrespondenceEstimationBase */
+        virtual boost::shared_ptr< CorrespondenceEstimationBase<PointSource, PointTarget, Scalar> > 
+        clone () const
+        {
+          Ptr copy (new CorrespondenceEstimationOMP<PointSource, PointTarget, Scalar> (*this));
+          return (copy);
+        }
+
+      protected:
+        /** \brief The number of threads the scheduler should use. */
+        unsigned int threads_;
+
+      private:
+        /** \brief Search the correspondences of the source indices in [begin, end).
+          * \param[in] begin the first position in indices_ to process
+          * \param[in] end one past the last position in indices_ to process
+          * \param[in] max_dist_sqr the squared maximum distance between correspondences
+          * \param[in] reciprocal true if only reciprocal correspondences should be kept
+          * \param[out] correspondences the correspondences found, appended in indices_ order
+          */
+        void
+        determineCorrespondencesInRange (int begin, int end, double max_dist_sqr, bool reciprocal,
+                                         pcl::Correspondences &correspondences) const;
+
+        /** \brief Split indices_ among the threads and merge their correspondences in order. */
+        void
+        determineCorrespondencesParallel (pcl::Correspondences &correspondences, double max_distance, bool reciprocal);
+     };
+  }
+}
+
+#include <pcl/registration/impl/correspondence_estimation_omp.hpp>
+
+#endif /* PCL_REGISTRATION_CORRESPONDENCE_ESTIMATION_OMP_H_ */
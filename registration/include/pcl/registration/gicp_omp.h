@@ -0,0 +1,225 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_GICP_OMP_H_
+#define PCL_GICP_OMP_H_
+
+#include <pcl/registration/gicp.h>
+
+namespace pcl
+{
+  /** \brief GeneralizedIterativeClosestPointOMP is a parallel version of \ref GeneralizedIterativeClosestPoint,
+    * using the OpenMP standard.
+    *
+    * The per point covariances are computed in parallel and regularized with a closed form 3x3 eigen
+    * decomposition instead of an SVD, the closest point assignment (and the Mahalanobis matrices) of
+    * every outer iteration is computed in parallel, and the cost function and gradient evaluated by
+    * the BFGS optimizer are reduced in parallel. The partial sums are accumulated in contiguous chunks
+    * and combined in a fixed order, so for a given number of threads the result is deterministic.
+    *
+    * When the same target is registered against many sources (e.g. scan to map alignment), \ref
+    * setReuseTargetCovariances can be enabled so that the target covariances (and search tree) are
+    * kept when \ref setInputTarget is called again with the same cloud.
+    *
+    * \ingroup registration
+    */
+  template <typename PointSource, typename PointTarget>
+  class GeneralizedIterativeClosestPointOMP : public GeneralizedIterativeClosestPoint<PointSource, PointTarget>
+  {
+    public:
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::reg_name_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::getClassName;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::indices_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::target_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::input_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::tree_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::tree_reciprocal_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::nr_iterations_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::max_iterations_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::previous_transformation_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::final_transformation_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::transformation_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::transformation_epsilon_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::converged_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::corr_dist_threshold_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::k_correspondences_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::gicp_epsilon_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::rotation_epsilon_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::base_transformation_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::tmp_src_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::tmp_tgt_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::tmp_idx_src_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::tmp_idx_tgt_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::input_covariances_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::target_covariances_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::mahalanobis_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::max_inner_iterations_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::rigid_transformation_estimation_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::applyState;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::computeRDerivative;
+
+      typedef typename GeneralizedIterativeClosestPoint<PointSource, PointTarget>::PointCloudSource PointCloudSource;
+      typedef typename GeneralizedIterativeClosestPoint<PointSource, PointTarget>::PointCloudTarget PointCloudTarget;
+      typedef typename GeneralizedIterativeClosestPoint<PointSource, PointTarget>::PointCloudTargetConstPtr PointCloudTargetConstPtr;
+      typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+      typedef boost::shared_ptr< GeneralizedIterativeClosestPointOMP<PointSource, PointTarget> > Ptr;
+      typedef boost::shared_ptr< const GeneralizedIterativeClosestPointOMP<PointSource, PointTarget> > ConstPtr;
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      GeneralizedIterativeClosestPointOMP (unsigned int nr_threads = 0)
+        : threads_ (nr_threads)
+        , reuse_target_covariances_ (false)
+      {
+        reg_name_ = "GeneralizedIterativeClosestPointOMP";
+        rigid_transformation_estimation_ = 
+          boost::bind (&GeneralizedIterativeClosestPointOMP<PointSource, PointTarget>::estimateRigidTransformationBFGS, 
+                       this, _1, _2, _3, _4, _5); 
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void 
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+      /** \brief Get the number of threads the scheduler is set to use (0 means automatic). */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
+      /** \brief Keep the target covariances (and the target search tree) when \ref setInputTarget is
+        * called again with the same cloud. The cloud must not have been modified in between.
+        * \param[in] reuse true to reuse the target covariances, false (default) to recompute them
+        */
+      inline void
+      setReuseTargetCovariances (bool reuse) { reuse_target_covariances_ = reuse; }
+
+      /** \brief Get whether the target covariances are reused for an unchanged target. */
+      inline bool
+      getReuseTargetCovariances () const { return (reuse_target_covariances_); }
+
+      /** \brief Get the covariances of the source points, empty until they are computed by \ref align. */
+      inline const std::vector<Eigen::Matrix3d, Eigen::aligned_allocator<Eigen::Matrix3d> >&
+      getSourceCovariances () const { return (input_covariances_); }
+
+      /** \brief Get the covariances of the target points, empty until they are computed by \ref align. */
+      inline const std::vector<Eigen::Matrix3d, Eigen::aligned_allocator<Eigen::Matrix3d> >&
+      getTargetCovariances () const { return (target_covariances_); }
+
+      /** \brief Provide a pointer to the input target (e.g., the point cloud that we want to align the input source to)
+        * \param[in] target the input point cloud target
+        */
+      inline void 
+      setInputTarget (const PointCloudTargetConstPtr &target)
+      {
+        if (reuse_target_covariances_ && target_ && target == target_ && 
+            target_covariances_.size () == target->size ())
+          return;
+        GeneralizedIterativeClosestPoint<PointSource, PointTarget>::setInputTarget (target);
+      }
+
+      /** \brief Estimate a rigid rotation transformation between a source and a target point cloud using an iterative
+        * non-linear BFGS approach, evaluating the cost function and its gradient in parallel.
+        * \param[in] cloud_src the source point cloud dataset
+        * \param[in] indices_src the vector of indices describing the points of interest in \a cloud_src
+        * \param[in] cloud_tgt the target point cloud dataset
+        * \param[in] indices_tgt the vector of indices describing the correspondences of the interst points from \a indices_src
+        * \param[out] transformation_matrix the resultant transformation matrix
+        */
+      void
+      estimateRigidTransformationBFGS (const PointCloudSource &cloud_src,
+                                       const std::vector<int> &indices_src,
+                                       const PointCloudTarget &cloud_tgt,
+                                       const std::vector<int> &indices_tgt,
+                                       Eigen::Matrix4f &transformation_matrix);
+
+    protected:
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
+      /** \brief Whether the target covariances are kept for an unchanged target. */
+      bool reuse_target_covariances_;
+
+      /** \brief Compute points covariances matrices according to the K nearest neighbors, in parallel.
+        * K is set via setCorrespondenceRandomness() methode.
+        * \param cloud pointer to point cloud
+        * \param tree KD tree performer for nearest neighbors search
+        * \param[out] cloud_covariances covariances matrices for each point in the cloud
+        */
+      template<typename PointT> void
+      computeCovariances (typename pcl::PointCloud<PointT>::ConstPtr cloud, 
+                          const typename pcl::search::KdTree<PointT>::Ptr tree,
+                          std::vector<Eigen::Matrix3d, Eigen::aligned_allocator<Eigen::Matrix3d> >& cloud_covariances);
+
+      /** \brief Rigid transformation computation method  with initial guess.
+        * \param output the transformed input point cloud dataset using the rigid transformation found
+        * \param guess the initial guess of the transformation to compute
+        */
+      void 
+      computeTransformation (PointCloudSource &output, const Eigen::Matrix4f &guess);
+
+      /** \brief Evaluate the mean Mahalanobis cost of the current correspondences and, optionally, its
+        * gradient, for the state \a x.
+        * \param[in] x the state (translation and Z Y X euler angles) relative to base_transformation_
+        * \param[out] f the cost function value
+        * \param[out] g the gradient of the cost function
+        * \param[in] compute_gradient false to only evaluate \a f
+        */
+      void
+      computeCostAndGradient (const Vector6d &x, double &f, Vector6d &g, bool compute_gradient) const;
+
+      /// \brief optimization functor structure
+      struct OptimizationFunctorWithIndicesOMP : public BFGSDummyFunctor<double,6>
+      {
+        OptimizationFunctorWithIndicesOMP (const GeneralizedIterativeClosestPointOMP* gicp)
+          : BFGSDummyFunctor<double,6> (), gicp_(gicp) {}
+        double operator() (const Vector6d& x);
+        void  df(const Vector6d &x, Vector6d &df);
+        void fdf(const Vector6d &x, double &f, Vector6d &df);
+
+        const GeneralizedIterativeClosestPointOMP *gicp_;
+      };
+  };
+}
+
+#include <pcl/registration/impl/gicp_omp.hpp>
+
+#endif  //#ifndef PCL_GICP_OMP_H_
@@ -71,7 +71,12 @@ pcl::registration::CorrespondenceEstimationBase<PointSource, PointTarget, Scalar
 
   // Set the internal point representation of choice
   if (point_representation_)
-    tree_->setPointRepresentation (point_representation_);
+  {
+    // Only the kd-tree search methods use a point representation
+    KdTreePtr kdtree = boost::dynamic_pointer_cast<KdTree> (tree_);
+    if (kdtree)
+      kdtree->setPointRepresentation (point_representation_);
+  }
 
   target_cloud_updated_ = true;
 }
@@ -146,8 +151,7 @@ pcl::registration::CorrespondenceEstimation<PointSource, PointTarget, Scalar>::d
     // Iterate over the input set of source indices
     for (std::vector<int>::const_iterator idx = indices_->begin (); idx != indices_->end (); ++idx)
     {
-      tree_->nearestKSearch (input_->points[*idx], 1, index, distance);
-      if (distance[0] > max_dist_sqr)
+      if (tree_->nearestKSearch (input_->points[*idx], 1, index, distance) == 0 || distance[0] > max_dist_sqr)
         continue;
 
       corr.index_query = *idx;
@@ -166,8 +170,7 @@ pcl::registration::CorrespondenceEstimation<PointSource, PointTarget, Scalar>::d
       // Copy the source data to a target PointTarget format so we can search in the tree
       copyPoint (input_->points[*idx], pt);
 
-      tree_->nearestKSearch (pt, 1, index, distance);
-      if (distance[0] > max_dist_sqr)
+      if (tree_->nearestKSearch (pt, 1, index, distance) == 0 || distance[0] > max_dist_sqr)
         continue;
 
       corr.index_query = *idx;
@@ -210,8 +213,7 @@ pcl::registration::CorrespondenceEstimation<PointSource, PointTarget, Scalar>::d
     // Iterate over the input set of source indices
     for (std::vector<int>::const_iterator idx = indices_->begin (); idx != indices_->end (); ++idx)
     {
-      tree_->nearestKSearch (input_->points[*idx], 1, index, distance);
-      if (distance[0] > max_dist_sqr)
+      if (tree_->nearestKSearch (input_->points[*idx], 1, index, distance) == 0 || distance[0] > max_dist_sqr)
         continue;
 
       target_idx = index[0];
@@ -237,8 +239,7 @@ pcl::registration::CorrespondenceEstimation<PointSource, PointTarget, Scalar>::d
       // Copy the source data to a target PointTarget format so we can search in the tree
       copyPoint (input_->points[*idx], pt_src);
 
-      tree_->nearestKSearch (pt_src, 1, index, distance);
-      if (distance[0] > max_dist_sqr)
+      if (tree_->nearestKSearch (pt_src, 1, index, distance) == 0 || distance[0] > max_dist_sqr)
         continue;
 
       target_idx = index[0];
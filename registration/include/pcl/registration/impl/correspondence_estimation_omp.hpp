@@ -0,0 +1,175 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_REGISTRATION_IMPL_CORRESPONDENCE_ESTIMATION_OMP_H_
+#define PCL_REGISTRATION_IMPL_CORRESPONDENCE_ESTIMATION_OMP_H_
+
+#include <pcl/common/io.h>
+#include <pcl/common/copy_point.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget, typename Scalar> void
+pcl::registration::CorrespondenceEstimationOMP<PointSource, PointTarget, Scalar>::determineCorrespondencesInRange (
+    int begin, int end, double max_dist_sqr, bool reciprocal, pcl::Correspondences &correspondences) const
+{
+  std::vector<int> index (1);
+  std::vector<float> distance (1);
+  std::vector<int> index_reciprocal (1);
+  std::vector<float> distance_reciprocal (1);
+  PointTarget pt_src;
+  PointSource pt_tgt;
+
+  // Check if the template types are the same. If true, avoid a copy.
+  // Both point types MUST be registered using the POINT_CLOUD_REGISTER_POINT_STRUCT macro!
+  const bool same_point_type = isSamePointType<PointSource, PointTarget> ();
+
+  for (int i = begin; i < end; ++i)
+  {
+    const int idx = (*indices_)[i];
+    int nr_found;
+    if (same_point_type)
+      nr_found = tree_->nearestKSearch (input_->points[idx], 1, index, distance);
+    else
+    {
+      // Copy the source data to a target PointTarget format so we can search in the tree
+      copyPoint (input_->points[idx], pt_src);
+      nr_found = tree_->nearestKSearch (pt_src, 1, index, distance);
+    }
+    if (nr_found == 0 || distance[0] > max_dist_sqr)
+      continue;
+
+    if (reciprocal)
+    {
+      const int target_idx = index[0];
+      if (same_point_type)
+        tree_reciprocal_->nearestKSearch (target_->points[target_idx], 1, index_reciprocal, distance_reciprocal);
+      else
+      {
+        // Copy the target data to a target PointSource format so we can search in the tree_reciprocal
+        copyPoint (target_->points[target_idx], pt_tgt);
+        tree_reciprocal_->nearestKSearch (pt_tgt, 1, index_reciprocal, distance_reciprocal);
+      }
+      if (distance_reciprocal[0] > max_dist_sqr || idx != index_reciprocal[0])
+        continue;
+    }
+
+    correspondences.push_back (pcl::Correspondence (idx, index[0], distance[0]));
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget, typename Scalar> void
+pcl::registration::CorrespondenceEstimationOMP<PointSource, PointTarget, Scalar>::determineCorrespondencesParallel (
+    pcl::Correspondences &correspondences, double max_distance, bool reciprocal)
+{
+  const double max_dist_sqr = max_distance * max_distance;
+  const int nr_indices = static_cast<int> (indices_->size ());
+
+#ifdef _OPENMP
+  const int nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+#else
+  const int nr_threads = 1;
+#endif
+
+  // One buffer per contiguous chunk of indices_, merged in chunk order afterwards
+  std::vector<pcl::Correspondences> thread_correspondences (nr_threads);
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+  {
+#ifdef _OPENMP
+    const int tid = omp_get_thread_num ();
+    const int nt = omp_get_num_threads ();
+#else
+    const int tid = 0;
+    const int nt = 1;
+#endif
+    const int begin = static_cast<int> (static_cast<int64_t> (nr_indices) * tid / nt);
+    const int end = static_cast<int> (static_cast<int64_t> (nr_indices) * (tid + 1) / nt);
+    thread_correspondences[tid].reserve (end - begin);
+    determineCorrespondencesInRange (begin, end, max_dist_sqr, reciprocal, thread_correspondences[tid]);
+  }
+
+  size_t nr_valid_correspondences = 0;
+  for (int t = 0; t < nr_threads; ++t)
+    nr_valid_correspondences += thread_correspondences[t].size ();
+
+  correspondences.resize (nr_valid_correspondences);
+  size_t offset = 0;
+  for (int t = 0; t < nr_threads; ++t)
+  {
+    std::copy (thread_correspondences[t].begin (), thread_correspondences[t].end (), correspondences.begin () + offset);
+    offset += thread_correspondences[t].size ();
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget, typename Scalar> void
+pcl::registration::CorrespondenceEstimationOMP<PointSource, PointTarget, Scalar>::determineCorrespondences (
+    pcl::Correspondences &correspondences, double max_distance)
+{
+  if (!initCompute ())
+    return;
+
+  determineCorrespondencesParallel (correspondences, max_distance, false);
+  deinitCompute ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget, typename Scalar> void
+pcl::registration::CorrespondenceEstimationOMP<PointSource, PointTarget, Scalar>::determineReciprocalCorrespondences (
+    pcl::Correspondences &correspondences, double max_distance)
+{
+  if (!initCompute ())
+    return;
+
+  // setup tree for reciprocal search
+  if (!initComputeReciprocal ())
+    return;
+
+  determineCorrespondencesParallel (correspondences, max_distance, true);
+  deinitCompute ();
+}
+
+#endif /* PCL_REGISTRATION_IMPL_CORRESPONDENCE_ESTIMATION_OMP_H_ */
@@ -0,0 +1,438 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+#ifndef PCL_REGISTRATION_IMPL_GICP_OMP_HPP_
+#define PCL_REGISTRATION_IMPL_GICP_OMP_HPP_
+
+#include <pcl/registration/boost.h>
+#include <pcl/registration/exceptions.h>
+#include <pcl/common/eigen.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget> 
+template<typename PointT> void
+pcl::GeneralizedIterativeClosestPointOMP<PointSource, PointTarget>::computeCovariances (typename pcl::PointCloud<PointT>::ConstPtr cloud, 
+                                                                                        const typename pcl::search::KdTree<PointT>::Ptr kdtree,
+                                                                                        std::vector<Eigen::Matrix3d, Eigen::aligned_allocator<Eigen::Matrix3d> >& cloud_covariances)
+{
+  if (k_correspondences_ > int (cloud->size ()))
+  {
+    PCL_ERROR ("[pcl::GeneralizedIterativeClosestPointOMP::computeCovariances] Number or points in cloud (%lu) is less than k_correspondences_ (%lu)!\n", cloud->size (), k_correspondences_);
+    return;
+  }
+
+  if (cloud_covariances.size () < cloud->size ())
+    cloud_covariances.resize (cloud->size ());
+
+#ifdef _OPENMP
+  const int nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+#endif
+  const int nr_points = static_cast<int> (cloud->size ());
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+  {
+    std::vector<int> nn_indices (k_correspondences_);
+    std::vector<float> nn_dist_sq (k_correspondences_);
+    Eigen::Vector3d mean;
+    Eigen::Vector3d normal;
+    double smallest_eigenvalue;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 256)
+#endif
+    for (int i = 0; i < nr_points; ++i)
+    {
+      Eigen::Matrix3d &cov = cloud_covariances[i];
+      cov.setZero ();
+      mean.setZero ();
+
+      // Search for the K nearest neighbours
+      kdtree->nearestKSearch (cloud->points[i], k_correspondences_, nn_indices, nn_dist_sq);
+
+      for (int j = 0; j < k_correspondences_; j++)
+      {
+        const PointT &pt = cloud->points[nn_indices[j]];
+
+        mean[0] += pt.x;
+        mean[1] += pt.y;
+        mean[2] += pt.z;
+
+        cov (0,0) += pt.x*pt.x;
+
+        cov (1,0) += pt.y*pt.x;
+        cov (1,1) += pt.y*pt.y;
+
+        cov (2,0) += pt.z*pt.x;
+        cov (2,1) += pt.z*pt.y;
+        cov (2,2) += pt.z*pt.z;
+      }
+
+      mean /= static_cast<double> (k_correspondences_);
+      for (int k = 0; k < 3; k++)
+        for (int l = 0; l <= k; l++)
+        {
+          cov (k,l) /= static_cast<double> (k_correspondences_);
+          cov (k,l) -= mean[k]*mean[l];
+          cov (l,k) = cov (k,l);
+        }
+
+      // The two largest eigenvalues are replaced by 1 and the smallest one by gicp_epsilon_. As the
+      // eigenvectors are orthonormal, U diag (1, 1, eps) U' = I + (eps - 1) n n', so only the eigenvector
+      // of the smallest eigenvalue is needed, which is obtained in closed form.
+      pcl::eigen33 (cov, smallest_eigenvalue, normal);
+      cov = Eigen::Matrix3d::Identity () + (gicp_epsilon_ - 1.0) * normal * normal.transpose ();
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget> void
+pcl::GeneralizedIterativeClosestPointOMP<PointSource, PointTarget>::computeCostAndGradient (
+    const Vector6d &x, double &f, Vector6d &g, bool compute_gradient) const
+{
+  Eigen::Matrix4f transformation_matrix = base_transformation_;
+  applyState (transformation_matrix, x);
+
+  const int m = static_cast<int> (tmp_idx_src_->size ());
+
+#ifdef _OPENMP
+  const int nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+#else
+  const int nr_threads = 1;
+#endif
+
+  // One partial sum per contiguous chunk of correspondences, combined in chunk order afterwards
+  std::vector<double> thread_f (nr_threads, 0.0);
+  std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d> > thread_g (nr_threads, Eigen::Vector3d::Zero ());
+  std::vector<Eigen::Matrix3d, Eigen::aligned_allocator<Eigen::Matrix3d> > thread_R (nr_threads, Eigen::Matrix3d::Zero ());
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+  {
+#ifdef _OPENMP
+    const int tid = omp_get_thread_num ();
+    const int nt = omp_get_num_threads ();
+#else
+    const int tid = 0;
+    const int nt = 1;
+#endif
+    const int begin = static_cast<int> (static_cast<int64_t> (m) * tid / nt);
+    const int end = static_cast<int> (static_cast<int64_t> (m) * (tid + 1) / nt);
+
+    double f_local = 0.0;
+    Eigen::Vector3d g_local = Eigen::Vector3d::Zero ();
+    Eigen::Matrix3d R_local = Eigen::Matrix3d::Zero ();
+    for (int i = begin; i < end; ++i)
+    {
+      const int src_idx = (*tmp_idx_src_)[i];
+      // The last coordinate, p_src[3] is guaranteed to be set to 1.0 in registration.hpp
+      Vector4fMapConst p_src = tmp_src_->points[src_idx].getVector4fMap ();
+      // The last coordinate, p_tgt[3] is guaranteed to be set to 1.0 in registration.hpp
+      Vector4fMapConst p_tgt = tmp_tgt_->points[(*tmp_idx_tgt_)[i]].getVector4fMap ();
+      Eigen::Vector4f pp (transformation_matrix * p_src);
+      Eigen::Vector3d res (pp[0] - p_tgt[0], pp[1] - p_tgt[1], pp[2] - p_tgt[2]);
+      // temp = M*res
+      Eigen::Vector3d temp (mahalanobis_[src_idx] * res);
+      f_local += double (res.transpose () * temp);
+      if (compute_gradient)
+      {
+        g_local += temp;
+        pp = base_transformation_ * p_src;
+        Eigen::Vector3d p_src3 (pp[0], pp[1], pp[2]);
+        R_local += p_src3 * temp.transpose ();
+      }
+    }
+    thread_f[tid] = f_local;
+    thread_g[tid] = g_local;
+    thread_R[tid] = R_local;
+  }
+
+  f = 0.0;
+  g.setZero ();
+  Eigen::Matrix3d R = Eigen::Matrix3d::Zero ();
+  for (int t = 0; t < nr_threads; ++t)
+  {
+    f += thread_f[t];
+    g.head<3> () += thread_g[t];
+    R += thread_R[t];
+  }
+  f /= double (m);
+  if (!compute_gradient)
+    return;
+  g.head<3> () *= 2.0 / m;
+  R *= 2.0 / m;
+  computeRDerivative (x, R, g);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget> void
+pcl::GeneralizedIterativeClosestPointOMP<PointSource, PointTarget>::estimateRigidTransformationBFGS (const PointCloudSource &cloud_src, 
+                                                                                                     const std::vector<int> &indices_src, 
+                                                                                                     const PointCloudTarget &cloud_tgt, 
+                                                                                                     const std::vector<int> &indices_tgt, 
+                                                                                                     Eigen::Matrix4f &transformation_matrix)
+{
+  if (indices_src.size () < 4)     // need at least 4 samples
+  {
+    PCL_THROW_EXCEPTION (NotEnoughPointsException, 
+                         "[pcl::GeneralizedIterativeClosestPointOMP::estimateRigidTransformationBFGS] Need at least 4 points to estimate a transform! Source and target have " << indices_src.size () << " points!");
+    return;
+  }
+  // Set the initial solution
+  Vector6d x = Vector6d::Zero ();
+  x[0] = transformation_matrix (0,3);
+  x[1] = transformation_matrix (1,3);
+  x[2] = transformation_matrix (2,3);
+  x[3] = atan2 (transformation_matrix (2,1), transformation_matrix (2,2));
+  x[4] = asin (-transformation_matrix (2,0));
+  x[5] = atan2 (transformation_matrix (1,0), transformation_matrix (0,0));
+
+  // Set temporary pointers
+  tmp_src_ = &cloud_src;
+  tmp_tgt_ = &cloud_tgt;
+  tmp_idx_src_ = &indices_src;
+  tmp_idx_tgt_ = &indices_tgt;
+
+  const double gradient_tol = 1e-2;
+  OptimizationFunctorWithIndicesOMP functor (this);
+  BFGS<OptimizationFunctorWithIndicesOMP> bfgs (functor);
+  bfgs.parameters.sigma = 0.01;
+  bfgs.parameters.rho = 0.01;
+  bfgs.parameters.tau1 = 9;
+  bfgs.parameters.tau2 = 0.05;
+  bfgs.parameters.tau3 = 0.5;
+  bfgs.parameters.order = 3;
+
+  int inner_iterations_ = 0;
+  int result = bfgs.minimizeInit (x);
+  result = BFGSSpace::Running;
+  do
+  {
+    inner_iterations_++;
+    result = bfgs.minimizeOneStep (x);
+    if (result)
+      break;
+    result = bfgs.testGradient (gradient_tol);
+  } while (result == BFGSSpace::Running && inner_iterations_ < max_inner_iterations_);
+  if (result == BFGSSpace::NoProgress || result == BFGSSpace::Success || inner_iterations_ == max_inner_iterations_)
+  {
+    PCL_DEBUG ("[pcl::registration::TransformationEstimationBFGS::estimateRigidTransformation]");
+    PCL_DEBUG ("BFGS solver finished with exit code %i \n", result);
+    transformation_matrix.setIdentity ();
+    applyState (transformation_matrix, x);
+  }
+  else
+    PCL_THROW_EXCEPTION (SolverDidntConvergeException, 
+                         "[pcl::" << getClassName () << "::TransformationEstimationBFGS::estimateRigidTransformation] BFGS solver didn't converge!");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget> inline double
+pcl::GeneralizedIterativeClosestPointOMP<PointSource, PointTarget>::OptimizationFunctorWithIndicesOMP::operator() (const Vector6d& x)
+{
+  double f;
+  Vector6d g;
+  gicp_->computeCostAndGradient (x, f, g, false);
+  return (f);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget> inline void
+pcl::GeneralizedIterativeClosestPointOMP<PointSource, PointTarget>::OptimizationFunctorWithIndicesOMP::df (const Vector6d& x, Vector6d& g)
+{
+  double f;
+  gicp_->computeCostAndGradient (x, f, g, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget> inline void
+pcl::GeneralizedIterativeClosestPointOMP<PointSource, PointTarget>::OptimizationFunctorWithIndicesOMP::fdf (const Vector6d& x, double& f, Vector6d& g)
+{
+  gicp_->computeCostAndGradient (x, f, g, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget> inline void
+pcl::GeneralizedIterativeClosestPointOMP<PointSource, PointTarget>::computeTransformation (PointCloudSource &output, const Eigen::Matrix4f& guess)
+{
+  pcl::IterativeClosestPoint<PointSource, PointTarget>::initComputeReciprocal ();
+  // Difference between consecutive transforms
+  double delta = 0;
+  const int N = static_cast<int> (indices_->size ());
+  // Set the mahalanobis matrices to identity
+  mahalanobis_.resize (N, Eigen::Matrix3d::Identity ());
+  // Compute target cloud covariance matrices
+  if (target_covariances_.empty ())
+    computeCovariances<PointTarget> (target_, tree_, target_covariances_);
+  // Compute input cloud covariance matrices
+  if (input_covariances_.empty ())
+    computeCovariances<PointSource> (input_, tree_reciprocal_, input_covariances_);
+
+  base_transformation_ = guess;
+  nr_iterations_ = 0;
+  converged_ = false;
+  const double dist_threshold = corr_dist_threshold_ * corr_dist_threshold_;
+
+#ifdef _OPENMP
+  const int nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+#endif
+
+  // Nearest target index of every source point, -1 if it is farther than the threshold and -2 if
+  // the search failed
+  std::vector<int> nn_target (N);
+
+  while (!converged_)
+  {
+    // guess corresponds to base_t and transformation_ to t
+    Eigen::Matrix4d transform_R = Eigen::Matrix4d::Zero ();
+    for (size_t i = 0; i < 4; i++)
+      for (size_t j = 0; j < 4; j++)
+        for (size_t k = 0; k < 4; k++)
+          transform_R (i,j) += double (transformation_ (i,k)) * double (guess (k,j));
+
+    const Eigen::Matrix3d R = transform_R.topLeftCorner<3,3> ();
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+    {
+      std::vector<int> nn_indices (1);
+      std::vector<float> nn_dists (1);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 256)
+#endif
+      for (int i = 0; i < N; i++)
+      {
+        PointSource query = output[i];
+        query.getVector4fMap () = guess * query.getVector4fMap ();
+        query.getVector4fMap () = transformation_ * query.getVector4fMap ();
+
+        nn_target[i] = -1;
+        if (tree_->nearestKSearch (query, 1, nn_indices, nn_dists) == 0)
+        {
+          nn_target[i] = -2;
+          continue;
+        }
+
+        // Check if the distance to the nearest neighbor is smaller than the user imposed threshold
+        if (nn_dists[0] < dist_threshold)
+        {
+          const Eigen::Matrix3d &C1 = input_covariances_[i];
+          const Eigen::Matrix3d &C2 = target_covariances_[nn_indices[0]];
+          // M = (R*C1*R' + C2)^-1
+          Eigen::Matrix3d temp = R * C1 * R.transpose ();
+          temp += C2;
+          mahalanobis_[i] = temp.inverse ();
+          nn_target[i] = nn_indices[0];
+        }
+      }
+    }
+
+    // Compact the valid correspondences, in source order
+    std::vector<int> source_indices;
+    std::vector<int> target_indices;
+    source_indices.reserve (N);
+    target_indices.reserve (N);
+    for (int i = 0; i < N; ++i)
+    {
+      if (nn_target[i] == -2)
+      {
+        PCL_ERROR ("[pcl::%s::computeTransformation] Unable to find a nearest neighbor in the target dataset for point %d in the source!\n", getClassName ().c_str (), (*indices_)[i]);
+        return;
+      }
+      if (nn_target[i] == -1)
+        continue;
+      source_indices.push_back (i);
+      target_indices.push_back (nn_target[i]);
+    }
+
+    previous_transformation_ = transformation_;
+    try
+    {
+      rigid_transformation_estimation_ (output, source_indices, *target_, target_indices, transformation_);
+      /* compute the delta from this iteration */
+      delta = 0.;
+      for (int k = 0; k < 4; k++)
+      {
+        for (int l = 0; l < 4; l++)
+        {
+          double ratio = 1;
+          if (k < 3 && l < 3) // rotation part of the transform
+            ratio = 1./rotation_epsilon_;
+          else
+            ratio = 1./transformation_epsilon_;
+          double c_delta = ratio*fabs (previous_transformation_ (k,l) - transformation_ (k,l));
+          if (c_delta > delta)
+            delta = c_delta;
+        }
+      }
+    } 
+    catch (PCLException &e)
+    {
+      PCL_DEBUG ("[pcl::%s::computeTransformation] Optimization issue %s\n", getClassName ().c_str (), e.what ());
+      break;
+    }
+    nr_iterations_++;
+    // Check for convergence
+    if (nr_iterations_ >= max_iterations_ || delta < 1)
+    {
+      converged_ = true;
+      previous_transformation_ = transformation_;
+      PCL_DEBUG ("[pcl::%s::computeTransformation] Convergence reached. Number of iterations: %d out of %d. Transformation difference: %f\n",
+                 getClassName ().c_str (), nr_iterations_, max_iterations_, (transformation_ - previous_transformation_).array ().abs ().sum ());
+    } 
+    else
+      PCL_DEBUG ("[pcl::%s::computeTransformation] Convergence failed\n", getClassName ().c_str ());
+  }
+  final_transformation_.topLeftCorner (3,3) = previous_transformation_.topLeftCorner (3,3) * guess.topLeftCorner (3,3);
+  final_transformation_(0,3) = previous_transformation_(0,3) + guess(0,3);
+  final_transformation_(1,3) = previous_transformation_(1,3) + guess(1,3);
+  final_transformation_(2,3) = previous_transformation_(2,3) + guess(2,3);
+
+  // Transform the point cloud
+  pcl::transformPointCloud (*input_, output, final_transformation_);
+}
+
+#endif //PCL_REGISTRATION_IMPL_GICP_OMP_HPP_
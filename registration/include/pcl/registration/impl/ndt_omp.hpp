@@ -0,0 +1,260 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+#ifndef PCL_REGISTRATION_NDT_OMP_IMPL_H_
+#define PCL_REGISTRATION_NDT_OMP_IMPL_H_
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointSource, typename PointTarget> void
+pcl::NormalDistributionsTransformOMP<PointSource, PointTarget>::getRelativeCoordinates (Eigen::MatrixXi &relative_coordinates) const
+{
+  switch (search_method_)
+  {
+    case DIRECT26:
+    {
+      // The voxel containing the point first, then its 26 neighbors
+      relative_coordinates.resize (3, 27);
+      relative_coordinates.col (0).setZero ();
+      relative_coordinates.rightCols (26) = pcl::getAllNeighborCellIndices ();
+      break;
+    }
+    case DIRECT7:
+    {
+      relative_coordinates.setZero (3, 7);
+      relative_coordinates (0, 1) = 1;
+      relative_coordinates (0, 2) = -1;
+      relative_coordinates (1, 3) = 1;
+      relative_coordinates (1, 4) = -1;
+      relative_coordinates (2, 5) = 1;
+      relative_coordinates (2, 6) = -1;
+      break;
+    }
+    case DIRECT1:
+    {
+      relative_coordinates.setZero (3, 1);
+      break;
+    }
+    default:
+    {
+      relative_coordinates.resize (3, 0);
+      break;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointSource, typename PointTarget> int
+pcl::NormalDistributionsTransformOMP<PointSource, PointTarget>::getNeighborhood (const Eigen::MatrixXi &relative_coordinates,
+                                                                                 const PointSource &x_trans_pt,
+                                                                                 std::vector<TargetGridLeafConstPtr> &neighborhood,
+                                                                                 std::vector<float> &distances) const
+{
+  if (search_method_ == KDTREE)
+    return (target_cells_.radiusSearch (x_trans_pt, resolution_, neighborhood, distances));
+  return (target_cells_.getNeighborhoodAtPoint (relative_coordinates, x_trans_pt, neighborhood));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointSource, typename PointTarget> double
+pcl::NormalDistributionsTransformOMP<PointSource, PointTarget>::computeDerivatives (Eigen::Matrix<double, 6, 1> &score_gradient,
+                                                                                    Eigen::Matrix<double, 6, 6> &hessian,
+                                                                                    PointCloudSource &trans_cloud,
+                                                                                    Eigen::Matrix<double, 6, 1> &p,
+                                                                                    bool compute_hessian)
+{
+  // Precompute Angular Derivatives (eq. 6.19 and 6.21)[Magnusson 2009]
+  computeAngleDerivatives (p);
+
+  Eigen::MatrixXi relative_coordinates;
+  getRelativeCoordinates (relative_coordinates);
+
+  const int nr_points = static_cast<int> (input_->points.size ());
+
+#ifdef _OPENMP
+  const int nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+#else
+  const int nr_threads = 1;
+#endif
+
+  // One set of accumulators per contiguous chunk of the source cloud, combined in chunk order afterwards
+  std::vector<double> thread_score (nr_threads, 0.0);
+  std::vector<Eigen::Matrix<double, 6, 1>, Eigen::aligned_allocator<Eigen::Matrix<double, 6, 1> > > thread_gradient (nr_threads, Eigen::Matrix<double, 6, 1>::Zero ());
+  std::vector<Eigen::Matrix<double, 6, 6>, Eigen::aligned_allocator<Eigen::Matrix<double, 6, 6> > > thread_hessian (nr_threads, Eigen::Matrix<double, 6, 6>::Zero ());
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+  {
+#ifdef _OPENMP
+    const int tid = omp_get_thread_num ();
+    const int nt = omp_get_num_threads ();
+#else
+    const int tid = 0;
+    const int nt = 1;
+#endif
+    const int begin = static_cast<int> (static_cast<int64_t> (nr_points) * tid / nt);
+    const int end = static_cast<int> (static_cast<int64_t> (nr_points) * (tid + 1) / nt);
+
+    // Thread local copies of the point derivatives, initialized with the constant blocks
+    Eigen::Matrix<double, 3, 6> point_gradient = point_gradient_;
+    Eigen::Matrix<double, 18, 6> point_hessian = point_hessian_;
+    Eigen::Matrix<double, 6, 1> score_gradient_local = Eigen::Matrix<double, 6, 1>::Zero ();
+    Eigen::Matrix<double, 6, 6> hessian_local = Eigen::Matrix<double, 6, 6>::Zero ();
+    double score_local = 0;
+
+    std::vector<TargetGridLeafConstPtr> neighborhood;
+    std::vector<float> distances;
+    Eigen::Vector3d x, x_trans;
+
+    // Update gradient and hessian for each point, line 17 in Algorithm 2 [Magnusson 2009]
+    for (int idx = begin; idx < end; idx++)
+    {
+      const PointSource &x_trans_pt = trans_cloud.points[idx];
+      getNeighborhood (relative_coordinates, x_trans_pt, neighborhood, distances);
+      if (neighborhood.empty ())
+        continue;
+
+      const PointSource &x_pt = input_->points[idx];
+      x = Eigen::Vector3d (x_pt.x, x_pt.y, x_pt.z);
+      // Compute derivative of transform function w.r.t. transform vector, J_E and H_E in Equations 6.18 and 6.20 [Magnusson 2009]
+      computePointDerivatives (x, point_gradient, point_hessian, compute_hessian);
+
+      for (size_t ni = 0; ni < neighborhood.size (); ++ni)
+      {
+        const TargetGridLeafConstPtr cell = neighborhood[ni];
+        // Denorm point, x_k' in Equations 6.12 and 6.13 [Magnusson 2009]
+        x_trans = Eigen::Vector3d (x_trans_pt.x, x_trans_pt.y, x_trans_pt.z) - cell->mean_;
+        // Update score, gradient and hessian, lines 19-21 in Algorithm 2, according to Equations 6.10, 6.12 and 6.13, respectively [Magnusson 2009]
+        score_local += updateDerivatives (score_gradient_local, hessian_local, point_gradient, point_hessian,
+                                          x_trans, cell->icov_, compute_hessian);
+      }
+    }
+
+    thread_score[tid] = score_local;
+    thread_gradient[tid] = score_gradient_local;
+    thread_hessian[tid] = hessian_local;
+  }
+
+  double score = 0;
+  score_gradient.setZero ();
+  hessian.setZero ();
+  for (int t = 0; t < nr_threads; ++t)
+  {
+    score += thread_score[t];
+    score_gradient += thread_gradient[t];
+    hessian += thread_hessian[t];
+  }
+  return (score);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointSource, typename PointTarget> void
+pcl::NormalDistributionsTransformOMP<PointSource, PointTarget>::computeHessian (Eigen::Matrix<double, 6, 6> &hessian,
+                                                                                PointCloudSource &trans_cloud,
+                                                                                Eigen::Matrix<double, 6, 1> &)
+{
+  Eigen::MatrixXi relative_coordinates;
+  getRelativeCoordinates (relative_coordinates);
+
+  const int nr_points = static_cast<int> (input_->points.size ());
+
+#ifdef _OPENMP
+  const int nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+#else
+  const int nr_threads = 1;
+#endif
+
+  std::vector<Eigen::Matrix<double, 6, 6>, Eigen::aligned_allocator<Eigen::Matrix<double, 6, 6> > > thread_hessian (nr_threads, Eigen::Matrix<double, 6, 6>::Zero ());
+
+  // Precompute Angular Derivatives unessisary because only used after regular derivative calculation
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+  {
+#ifdef _OPENMP
+    const int tid = omp_get_thread_num ();
+    const int nt = omp_get_num_threads ();
+#else
+    const int tid = 0;
+    const int nt = 1;
+#endif
+    const int begin = static_cast<int> (static_cast<int64_t> (nr_points) * tid / nt);
+    const int end = static_cast<int> (static_cast<int64_t> (nr_points) * (tid + 1) / nt);
+
+    Eigen::Matrix<double, 3, 6> point_gradient = point_gradient_;
+    Eigen::Matrix<double, 18, 6> point_hessian = point_hessian_;
+    Eigen::Matrix<double, 6, 6> hessian_local = Eigen::Matrix<double, 6, 6>::Zero ();
+
+    std::vector<TargetGridLeafConstPtr> neighborhood;
+    std::vector<float> distances;
+    Eigen::Vector3d x, x_trans;
+
+    // Update hessian for each point, line 17 in Algorithm 2 [Magnusson 2009]
+    for (int idx = begin; idx < end; idx++)
+    {
+      const PointSource &x_trans_pt = trans_cloud.points[idx];
+      getNeighborhood (relative_coordinates, x_trans_pt, neighborhood, distances);
+      if (neighborhood.empty ())
+        continue;
+
+      const PointSource &x_pt = input_->points[idx];
+      x = Eigen::Vector3d (x_pt.x, x_pt.y, x_pt.z);
+      computePointDerivatives (x, point_gradient, point_hessian);
+
+      for (size_t ni = 0; ni < neighborhood.size (); ++ni)
+      {
+        const TargetGridLeafConstPtr cell = neighborhood[ni];
+        x_trans = Eigen::Vector3d (x_trans_pt.x, x_trans_pt.y, x_trans_pt.z) - cell->mean_;
+        // Update hessian, lines 21 in Algorithm 2, according to Equations 6.10, 6.12 and 6.13, respectively [Magnusson 2009]
+        updateHessian (hessian_local, point_gradient, point_hessian, x_trans, cell->icov_);
+      }
+    }
+
+    thread_hessian[tid] = hessian_local;
+  }
+
+  hessian.setZero ();
+  for (int t = 0; t < nr_threads; ++t)
+    hessian += thread_hessian[t];
+}
+
+#endif // PCL_REGISTRATION_NDT_OMP_IMPL_H_
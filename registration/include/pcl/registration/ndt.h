@@ -265,7 +265,7 @@ namespace pcl
         * \param[in] p the current transform vector
         * \param[in] compute_hessian flag to calculate hessian, unnessissary for step calculation.
         */
-      double
+      virtual double
       computeDerivatives (Eigen::Matrix<double, 6, 1> &score_gradient,
                           Eigen::Matrix<double, 6, 6> &hessian,
                           PointCloudSource &trans_cloud,
@@ -286,6 +286,25 @@ namespace pcl
                          Eigen::Vector3d &x_trans, Eigen::Matrix3d &c_inv,
                          bool compute_hessian = true);
 
+      /** \brief Compute individual point contirbutions to derivatives of probability function w.r.t. the transformation vector,
+        * using the given point derivatives instead of \ref point_gradient_ and \ref point_hessian_.
+        * \note Equation 6.10, 6.12 and 6.13 [Magnusson 2009].
+        * \param[in,out] score_gradient the gradient vector of the probability function w.r.t. the transformation vector
+        * \param[in,out] hessian the hessian matrix of the probability function w.r.t. the transformation vector
+        * \param[in] point_gradient the first order derivative of the transformation of the point, \f$ J_E \f$
+        * \param[in] point_hessian the second order derivative of the transformation of the point, \f$ H_E \f$
+        * \param[in] x_trans transformed point minus mean of occupied covariance voxel
+        * \param[in] c_inv covariance of occupied covariance voxel
+        * \param[in] compute_hessian flag to calculate hessian, unnessissary for step calculation.
+        */
+      double
+      updateDerivatives (Eigen::Matrix<double, 6, 1> &score_gradient,
+                         Eigen::Matrix<double, 6, 6> &hessian,
+                         const Eigen::Matrix<double, 3, 6> &point_gradient,
+                         const Eigen::Matrix<double, 18, 6> &point_hessian,
+                         const Eigen::Vector3d &x_trans, const Eigen::Matrix3d &c_inv,
+                         bool compute_hessian = true) const;
+
       /** \brief Precompute anglular components of derivatives.
         * \note Equation 6.19 and 6.21 [Magnusson 2009].
         * \param[in] p the current transform vector
@@ -302,13 +321,26 @@ namespace pcl
       void
       computePointDerivatives (Eigen::Vector3d &x, bool compute_hessian = true);
 
+      /** \brief Compute point derivatives into the given matrices instead of \ref point_gradient_ and \ref point_hessian_.
+        * \note Equation 6.18-21 [Magnusson 2009].
+        * \param[in] x point from the input cloud
+        * \param[in,out] point_gradient the first order derivative of the transformation of the point, \f$ J_E \f$
+        * \param[in,out] point_hessian the second order derivative of the transformation of the point, \f$ H_E \f$
+        * \param[in] compute_hessian flag to calculate hessian, unnessissary for step calculation.
+        */
+      void
+      computePointDerivatives (const Eigen::Vector3d &x,
+                               Eigen::Matrix<double, 3, 6> &point_gradient,
+                               Eigen::Matrix<double, 18, 6> &point_hessian,
+                               bool compute_hessian = true) const;
+
       /** \brief Compute hessian of probability function w.r.t. the transformation vector.
         * \note Equation 6.13 [Magnusson 2009].
         * \param[out] hessian the hessian matrix of the probability function w.r.t. the transformation vector
         * \param[in] trans_cloud transformed point cloud
         * \param[in] p the current transform vector
         */
-      void
+      virtual void
       computeHessian (Eigen::Matrix<double, 6, 6> &hessian,
                       PointCloudSource &trans_cloud,
                       Eigen::Matrix<double, 6, 1> &p);
@@ -323,6 +355,21 @@ namespace pcl
       updateHessian (Eigen::Matrix<double, 6, 6> &hessian,
                      Eigen::Vector3d &x_trans, Eigen::Matrix3d &c_inv);
 
+      /** \brief Compute individual point contirbutions to hessian of probability function w.r.t. the transformation vector,
+        * using the given point derivatives instead of \ref point_gradient_ and \ref point_hessian_.
+        * \note Equation 6.13 [Magnusson 2009].
+        * \param[in,out] hessian the hessian matrix of the probability function w.r.t. the transformation vector
+        * \param[in] point_gradient the first order derivative of the transformation of the point, \f$ J_E \f$
+        * \param[in] point_hessian the second order derivative of the transformation of the point, \f$ H_E \f$
+        * \param[in] x_trans transformed point minus mean of occupied covariance voxel
+        * \param[in] c_inv covariance of occupied covariance voxel
+        */
+      void
+      updateHessian (Eigen::Matrix<double, 6, 6> &hessian,
+                     const Eigen::Matrix<double, 3, 6> &point_gradient,
+                     const Eigen::Matrix<double, 18, 6> &point_hessian,
+                     const Eigen::Vector3d &x_trans, const Eigen::Matrix3d &c_inv) const;
+
       /** \brief Compute line search step length and update transform and probability derivatives using More-Thuente method.
         * \note Search Algorithm [More, Thuente 1994]
         * \param[in] x initial transformation vector, \f$ x \f$ in Equation 1.3 (Moore, Thuente 1994) and \f$ \vec{p} \f$ in Algorithm 2 [Magnusson 2009]
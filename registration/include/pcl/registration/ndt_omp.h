@@ -0,0 +1,187 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_REGISTRATION_NDT_OMP_H_
+#define PCL_REGISTRATION_NDT_OMP_H_
+
+#include <pcl/registration/ndt.h>
+
+namespace pcl
+{
+  /** \brief NormalDistributionsTransformOMP is a parallel version of \ref NormalDistributionsTransform,
+    * using the OpenMP standard.
+    *
+    * The score, gradient and hessian of every source point are accumulated in per thread buffers over
+    * contiguous chunks of the source cloud, and the partial sums are combined in a fixed order, so for a
+    * given number of threads the result is deterministic.
+    *
+    * In addition to the kd-tree radius search over the voxel centroids used by \ref NormalDistributionsTransform,
+    * the target voxels contributing to a source point can be looked up directly in the voxel grid, using
+    * either the voxel containing the point (DIRECT1), that voxel and its 6 face neighbors (DIRECT7), or that
+    * voxel and all its 26 neighbors (DIRECT26). DIRECT7 is usually the best compromise between speed and
+    * accuracy for localization against large maps.
+    *
+    * \ingroup registration
+    */
+  template<typename PointSource, typename PointTarget>
+  class NormalDistributionsTransformOMP : public NormalDistributionsTransform<PointSource, PointTarget>
+  {
+    protected:
+      typedef typename NormalDistributionsTransform<PointSource, PointTarget>::PointCloudSource PointCloudSource;
+      typedef typename NormalDistributionsTransform<PointSource, PointTarget>::TargetGridLeafConstPtr TargetGridLeafConstPtr;
+
+    public:
+      typedef boost::shared_ptr< NormalDistributionsTransformOMP<PointSource, PointTarget> > Ptr;
+      typedef boost::shared_ptr< const NormalDistributionsTransformOMP<PointSource, PointTarget> > ConstPtr;
+
+      /** \brief Method used to find the target voxels contributing to a source point. */
+      enum NeighborSearchMethod
+      {
+        /** \brief Radius search over the voxel centroids, as in \ref NormalDistributionsTransform. */
+        KDTREE,
+        /** \brief The voxel containing the point and its 26 neighbors. */
+        DIRECT26,
+        /** \brief The voxel containing the point and its 6 face neighbors. */
+        DIRECT7,
+        /** \brief The voxel containing the point only. */
+        DIRECT1
+      };
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      NormalDistributionsTransformOMP (unsigned int nr_threads = 0)
+        : threads_ (nr_threads)
+        , search_method_ (KDTREE)
+      {
+        reg_name_ = "NormalDistributionsTransformOMP";
+      }
+
+      /** \brief Empty destructor */
+      virtual ~NormalDistributionsTransformOMP () {}
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void 
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+      /** \brief Get the number of threads the scheduler is set to use (0 means automatic). */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
+      /** \brief Set the method used to find the target voxels contributing to a source point.
+        * \param[in] method the neighbor search method (default: KDTREE)
+        */
+      inline void
+      setNeighborhoodSearchMethod (NeighborSearchMethod method) { search_method_ = method; }
+
+      /** \brief Get the method used to find the target voxels contributing to a source point. */
+      inline NeighborSearchMethod
+      getNeighborhoodSearchMethod () const { return (search_method_); }
+
+    protected:
+      using NormalDistributionsTransform<PointSource, PointTarget>::reg_name_;
+      using NormalDistributionsTransform<PointSource, PointTarget>::input_;
+      using NormalDistributionsTransform<PointSource, PointTarget>::target_cells_;
+      using NormalDistributionsTransform<PointSource, PointTarget>::resolution_;
+      using NormalDistributionsTransform<PointSource, PointTarget>::point_gradient_;
+      using NormalDistributionsTransform<PointSource, PointTarget>::point_hessian_;
+      using NormalDistributionsTransform<PointSource, PointTarget>::computeAngleDerivatives;
+      using NormalDistributionsTransform<PointSource, PointTarget>::computePointDerivatives;
+      using NormalDistributionsTransform<PointSource, PointTarget>::updateDerivatives;
+      using NormalDistributionsTransform<PointSource, PointTarget>::updateHessian;
+
+      /** \brief Compute derivatives of probability function w.r.t. the transformation vector, in parallel.
+        * \note Equation 6.10, 6.12 and 6.13 [Magnusson 2009].
+        * \param[out] score_gradient the gradient vector of the probability function w.r.t. the transformation vector
+        * \param[out] hessian the hessian matrix of the probability function w.r.t. the transformation vector
+        * \param[in] trans_cloud transformed point cloud
+        * \param[in] p the current transform vector
+        * \param[in] compute_hessian flag to calculate hessian, unnessissary for step calculation.
+        */
+      virtual double
+      computeDerivatives (Eigen::Matrix<double, 6, 1> &score_gradient,
+                          Eigen::Matrix<double, 6, 6> &hessian,
+                          PointCloudSource &trans_cloud,
+                          Eigen::Matrix<double, 6, 1> &p,
+                          bool compute_hessian = true);
+
+      /** \brief Compute hessian of probability function w.r.t. the transformation vector, in parallel.
+        * \note Equation 6.13 [Magnusson 2009].
+        * \param[out] hessian the hessian matrix of the probability function w.r.t. the transformation vector
+        * \param[in] trans_cloud transformed point cloud
+        * \param[in] p the current transform vector
+        */
+      virtual void
+      computeHessian (Eigen::Matrix<double, 6, 6> &hessian,
+                      PointCloudSource &trans_cloud,
+                      Eigen::Matrix<double, 6, 1> &p);
+
+      /** \brief Find the target voxels contributing to a transformed source point with the selected method.
+        * \param[in] relative_coordinates the cell displacements used by the direct methods
+        * \param[in] x_trans_pt the transformed source point
+        * \param[out] neighborhood the contributing voxels
+        * \param[out] distances scratch buffer used by the kd-tree search
+        * \return number of voxels found
+        */
+      int
+      getNeighborhood (const Eigen::MatrixXi &relative_coordinates, const PointSource &x_trans_pt,
+                       std::vector<TargetGridLeafConstPtr> &neighborhood, std::vector<float> &distances) const;
+
+      /** \brief Get the cell displacements searched by the selected direct method.
+        * \param[out] relative_coordinates 3xN matrix of cell displacements
+        */
+      void
+      getRelativeCoordinates (Eigen::MatrixXi &relative_coordinates) const;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
+      /** \brief The method used to find the target voxels contributing to a source point. */
+      NeighborSearchMethod search_method_;
+
+    public:
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+}
+
+#include <pcl/registration/impl/ndt_omp.hpp>
+
+#endif // PCL_REGISTRATION_NDT_OMP_H_
@@ -0,0 +1,215 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_SAMPLE_CONSENSUS_IMPL_LMEDS_OMP_H_
+#define PCL_SAMPLE_CONSENSUS_IMPL_LMEDS_OMP_H_
+
+#include <pcl/sample_consensus/lmeds_omp.h>
+#include <pcl/sample_consensus/impl/lmeds.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::LeastMedianSquaresOMP<PointT>::computeModel (int debug_verbosity_level)
+{
+  // Warn and exit if no threshold was set
+  if (threshold_ == std::numeric_limits<double>::max())
+  {
+    PCL_ERROR ("[pcl::LeastMedianSquaresOMP::computeModel] No threshold set!\n");
+    return (false);
+  }
+
+  if (sac_model_->getIndices ()->size () < sac_model_->getSampleSize ())
+  {
+    PCL_ERROR ("[pcl::LeastMedianSquaresOMP::computeModel] Can not select %u unique points out of %lu!\n",
+               sac_model_->getSampleSize (), sac_model_->getIndices ()->size ());
+    return (false);
+  }
+
+#ifdef _OPENMP
+  const int nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+#else
+  const int nr_threads = 1;
+#endif
+  const int batch_size = 2 * nr_threads;
+
+  // Every hypothesis gets its own generator, seeded from the base seed and its global index
+  const unsigned int seed = static_cast<unsigned int> (rnd () * static_cast<double> (std::numeric_limits<unsigned int>::max ()));
+  unsigned int nr_hypotheses = 0;
+
+  iterations_ = 0;
+  double d_best_penalty = std::numeric_limits<double>::max();
+
+  std::vector<std::vector<int> > selections (batch_size);
+  std::vector<Eigen::VectorXf> coefficients (batch_size);
+  std::vector<char> valid (batch_size);
+  std::vector<double> penalties (batch_size);
+  std::vector<double> distances;
+
+  const size_t nr_indices = sac_model_->getIndices ()->size ();
+  // d_cur_penalty = median (distances)
+  const size_t mid = nr_indices / 2;
+
+  int n_inliers_count = 0;
+  unsigned skipped_count = 0;
+  // supress infinite loops by just allowing 10 x maximum allowed iterations for invalid model parameters!
+  const unsigned max_skip = max_iterations_ * 10;
+
+  bool done = false;
+  while (!done && iterations_ < max_iterations_ && skipped_count < max_skip)
+  {
+    // Generate and score a batch of hypotheses in parallel
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+    {
+      std::vector<double> hypothesis_distances;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+      for (int b = 0; b < batch_size; ++b)
+      {
+        boost::mt19937 rng (seed ^ ((nr_hypotheses + static_cast<unsigned int> (b)) * 2654435761u));
+        sac_model_->drawSamples (rng, selections[b]);
+        valid[b] = false;
+        if (selections[b].empty ())
+          continue;
+        if (!sac_model_->computeModelCoefficients (selections[b], coefficients[b]))
+          continue;
+
+        // Iterate through the 3d points and calculate the distances from them to the model
+        sac_model_->getDistancesToModel (coefficients[b], hypothesis_distances);
+
+        // No distances? The model must not respect the user given constraints
+        if (hypothesis_distances.empty () || mid >= hypothesis_distances.size ())
+          continue;
+
+        // Only the middle element(s) are needed, a partial selection is enough
+        std::nth_element (hypothesis_distances.begin (), hypothesis_distances.begin () + mid, hypothesis_distances.end ());
+
+        // Do we have a "middle" point or should we "estimate" one ?
+        if (nr_indices % 2 == 0)
+        {
+          double lower = *std::max_element (hypothesis_distances.begin (), hypothesis_distances.begin () + mid);
+          penalties[b] = (sqrt (lower) + sqrt (hypothesis_distances[mid])) / 2;
+        }
+        else
+          penalties[b] = sqrt (hypothesis_distances[mid]);
+        valid[b] = true;
+      }
+    }
+    nr_hypotheses += static_cast<unsigned int> (batch_size);
+
+    // Consume the batch in hypothesis order, exactly as the serial loop would
+    for (int b = 0; b < batch_size; ++b)
+    {
+      if (!(iterations_ < max_iterations_ && skipped_count < max_skip) || selections[b].empty ())
+      {
+        done = true;
+        break;
+      }
+
+      if (!valid[b])
+      {
+        ++skipped_count;
+        continue;
+      }
+
+      // Better match ?
+      if (penalties[b] < d_best_penalty)
+      {
+        d_best_penalty = penalties[b];
+
+        // Save the current model/coefficients selection as being the best so far
+        model_              = selections[b];
+        model_coefficients_ = coefficients[b];
+      }
+
+      ++iterations_;
+      if (debug_verbosity_level > 1)
+        PCL_DEBUG ("[pcl::LeastMedianSquaresOMP::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_, max_iterations_, d_best_penalty);
+    }
+  }
+
+  if (model_.empty ())
+  {
+    if (debug_verbosity_level > 0)
+      PCL_DEBUG ("[pcl::LeastMedianSquaresOMP::computeModel] Unable to find a solution!\n");
+    return (false);
+  }
+
+  // Iterate through the 3d points and calculate the distances from them to the model again
+  sac_model_->getDistancesToModel (model_coefficients_, distances);
+  // No distances? The model must not respect the user given constraints
+  if (distances.empty ())
+  {
+    PCL_ERROR ("[pcl::LeastMedianSquaresOMP::computeModel] The model found failed to verify against the given constraints!\n");
+    return (false);
+  }
+
+  std::vector<int> &indices = *sac_model_->getIndices ();
+
+  if (distances.size () != indices.size ())
+  {
+    PCL_ERROR ("[pcl::LeastMedianSquaresOMP::computeModel] Estimated distances (%lu) differs than the normal of indices (%lu).\n", distances.size (), indices.size ());
+    return (false);
+  }
+
+  inliers_.resize (distances.size ());
+  // Get the inliers for the best model found
+  n_inliers_count = 0;
+  for (size_t i = 0; i < distances.size (); ++i)
+    if (distances[i] <= threshold_)
+      inliers_[n_inliers_count++] = indices[i];
+
+  // Resize the inliers vector
+  inliers_.resize (n_inliers_count);
+
+  if (debug_verbosity_level > 0)
+    PCL_DEBUG ("[pcl::LeastMedianSquaresOMP::computeModel] Model: %lu size, %d inliers.\n", model_.size (), n_inliers_count);
+
+  return (true);
+}
+
+#define PCL_INSTANTIATE_LeastMedianSquaresOMP(T) template class PCL_EXPORTS pcl::LeastMedianSquaresOMP<T>;
+
+#endif    // PCL_SAMPLE_CONSENSUS_IMPL_LMEDS_OMP_H_
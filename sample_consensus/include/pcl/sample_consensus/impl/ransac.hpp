@@ -64,6 +64,14 @@ pcl::RandomSampleConsensus<PointT>::computeModel (int)
   double log_probability  = log (1.0 - probability_);
   double one_over_indices = 1.0 / static_cast<double> (sac_model_->getIndices ()->size ());
 
+  // Sequential probability ratio test state: epsilon is the inlier ratio of the best model so far,
+  // delta the (estimated) inlier ratio of bad models, and sprt_threshold the decision threshold A
+  const size_t nr_indices = sac_model_->getIndices ()->size ();
+  double sprt_epsilon = 0.0;
+  double sprt_delta = 0.01;
+  double sprt_threshold = std::numeric_limits<double>::max ();
+  double rejected_inliers = 0.0, rejected_tested = 0.0;
+
   int n_inliers_count = 0;
   unsigned skipped_count = 0;
   // supress infinite loops by just allowing 10 x maximum allowed iterations for invalid model parameters!
@@ -94,7 +102,27 @@ pcl::RandomSampleConsensus<PointT>::computeModel (int)
     //if (inliers.empty () && k > 1.0)
     //  continue;
 
-    n_inliers_count = sac_model_->countWithinDistance (model_coefficients, threshold_);
+    if (use_sprt_ && sprt_threshold < std::numeric_limits<double>::max ())
+    {
+      size_t nr_tested = 0;
+      n_inliers_count = sac_model_->countWithinDistanceSPRT (model_coefficients, threshold_,
+                                                             sprt_epsilon, sprt_delta, sprt_threshold, nr_tested);
+      if (nr_tested < nr_indices)
+      {
+        // The model was rejected: update the estimate of delta from the support of the bad models
+        rejected_inliers += n_inliers_count;
+        rejected_tested += static_cast<double> (nr_tested);
+        double delta = (std::max) (rejected_inliers / rejected_tested, 1e-4);
+        if (fabs (delta - sprt_delta) > 0.05 * sprt_delta)
+        {
+          sprt_delta = delta;
+          sprt_threshold = SampleConsensusModel<PointT>::computeSPRTDecisionThreshold (sprt_epsilon, sprt_delta);
+        }
+        n_inliers_count = -1;
+      }
+    }
+    else
+      n_inliers_count = sac_model_->countWithinDistance (model_coefficients, threshold_);
 
     // Better match ?
     if (n_inliers_count > n_best_inliers_count)
@@ -108,6 +136,14 @@ pcl::RandomSampleConsensus<PointT>::computeModel (int)
       // Compute the k parameter (k=log(z)/log(1-w^n))
       double w = static_cast<double> (n_best_inliers_count) * one_over_indices;
       double p_no_outliers = 1.0 - pow (w, static_cast<double> (selection.size ()));
+      if (use_sprt_)
+      {
+        sprt_epsilon = w;
+        sprt_threshold = SampleConsensusModel<PointT>::computeSPRTDecisionThreshold (sprt_epsilon, sprt_delta);
+        // A good model is rejected by the test with a probability of about 1/A
+        if (sprt_threshold < std::numeric_limits<double>::max ())
+          p_no_outliers = 1.0 - pow (w, static_cast<double> (selection.size ())) * (1.0 - 1.0 / sprt_threshold);
+      }
       p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
       p_no_outliers = (std::min) (1.0 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
       k = log_probability / log (p_no_outliers);
@@ -0,0 +1,182 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_SAMPLE_CONSENSUS_IMPL_RANSAC_OMP_H_
+#define PCL_SAMPLE_CONSENSUS_IMPL_RANSAC_OMP_H_
+
+#include <pcl/sample_consensus/ransac_omp.h>
+#include <pcl/sample_consensus/impl/ransac.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::RandomSampleConsensusOMP<PointT>::computeModel (int)
+{
+  // Warn and exit if no threshold was set
+  if (threshold_ == std::numeric_limits<double>::max())
+  {
+    PCL_ERROR ("[pcl::RandomSampleConsensusOMP::computeModel] No threshold set!\n");
+    return (false);
+  }
+
+  if (sac_model_->getIndices ()->size () < sac_model_->getSampleSize ())
+  {
+    PCL_ERROR ("[pcl::RandomSampleConsensusOMP::computeModel] Can not select %u unique points out of %lu!\n",
+               sac_model_->getSampleSize (), sac_model_->getIndices ()->size ());
+    inliers_.clear ();
+    return (false);
+  }
+
+#ifdef _OPENMP
+  const int nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+#else
+  const int nr_threads = 1;
+#endif
+  const int batch_size = 2 * nr_threads;
+
+  // Every hypothesis gets its own generator, seeded from the base seed and its global index
+  const unsigned int seed = static_cast<unsigned int> (rnd () * static_cast<double> (std::numeric_limits<unsigned int>::max ()));
+  unsigned int nr_hypotheses = 0;
+
+  iterations_ = 0;
+  int n_best_inliers_count = -INT_MAX;
+  double k = 1.0;
+
+  std::vector<std::vector<int> > selections (batch_size);
+  std::vector<Eigen::VectorXf> coefficients (batch_size);
+  std::vector<char> valid (batch_size);
+  std::vector<int> inliers_counts (batch_size);
+
+  double log_probability  = log (1.0 - probability_);
+  double one_over_indices = 1.0 / static_cast<double> (sac_model_->getIndices ()->size ());
+
+  unsigned skipped_count = 0;
+  // supress infinite loops by just allowing 10 x maximum allowed iterations for invalid model parameters!
+  const unsigned max_skip = max_iterations_ * 10;
+
+  bool done = false;
+  while (!done && iterations_ < k && skipped_count < max_skip)
+  {
+    // Generate and score a batch of hypotheses in parallel
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nr_threads) schedule(dynamic, 1)
+#endif
+    for (int b = 0; b < batch_size; ++b)
+    {
+      boost::mt19937 rng (seed ^ ((nr_hypotheses + static_cast<unsigned int> (b)) * 2654435761u));
+      sac_model_->drawSamples (rng, selections[b]);
+      valid[b] = false;
+      if (selections[b].empty ())
+        continue;
+      if (!sac_model_->computeModelCoefficients (selections[b], coefficients[b]))
+        continue;
+      valid[b] = true;
+      inliers_counts[b] = sac_model_->countWithinDistance (coefficients[b], threshold_);
+    }
+    nr_hypotheses += static_cast<unsigned int> (batch_size);
+
+    // Consume the batch in hypothesis order, exactly as the serial loop would
+    for (int b = 0; b < batch_size; ++b)
+    {
+      if (!(iterations_ < k && skipped_count < max_skip))
+      {
+        done = true;
+        break;
+      }
+
+      if (selections[b].empty ())
+      {
+        PCL_ERROR ("[pcl::RandomSampleConsensusOMP::computeModel] No samples could be selected!\n");
+        done = true;
+        break;
+      }
+
+      if (!valid[b])
+      {
+        ++skipped_count;
+        continue;
+      }
+
+      // Better match ?
+      if (inliers_counts[b] > n_best_inliers_count)
+      {
+        n_best_inliers_count = inliers_counts[b];
+
+        // Save the current model/inlier/coefficients selection as being the best so far
+        model_              = selections[b];
+        model_coefficients_ = coefficients[b];
+
+        // Compute the k parameter (k=log(z)/log(1-w^n))
+        double w = static_cast<double> (n_best_inliers_count) * one_over_indices;
+        double p_no_outliers = 1.0 - pow (w, static_cast<double> (selections[b].size ()));
+        p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
+        p_no_outliers = (std::min) (1.0 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
+        k = log_probability / log (p_no_outliers);
+      }
+
+      ++iterations_;
+      PCL_DEBUG ("[pcl::RandomSampleConsensusOMP::computeModel] Trial %d out of %f: %d inliers (best is: %d so far).\n", iterations_, k, inliers_counts[b], n_best_inliers_count);
+      if (iterations_ > max_iterations_)
+      {
+        PCL_DEBUG ("[pcl::RandomSampleConsensusOMP::computeModel] RANSAC reached the maximum number of trials.\n");
+        done = true;
+        break;
+      }
+    }
+  }
+
+  PCL_DEBUG ("[pcl::RandomSampleConsensusOMP::computeModel] Model: %lu size, %d inliers.\n", model_.size (), n_best_inliers_count);
+
+  if (model_.empty ())
+  {
+    inliers_.clear ();
+    return (false);
+  }
+
+  // Get the set of inliers that correspond to the best model found so far
+  sac_model_->selectWithinDistance (model_coefficients_, threshold_, inliers_);
+  return (true);
+}
+
+#define PCL_INSTANTIATE_RandomSampleConsensusOMP(T) template class PCL_EXPORTS pcl::RandomSampleConsensusOMP<T>;
+
+#endif    // PCL_SAMPLE_CONSENSUS_IMPL_RANSAC_OMP_H_
@@ -127,35 +127,154 @@ pcl::SampleConsensusModelLine<PointT>::selectWithinDistance (
   if (!isModelValid (model_coefficients))
     return;
 
-  double sqr_threshold = threshold * threshold;
-
-  int nr_p = 0;
   inliers.resize (indices_->size ());
   error_sqr_dists_.resize (indices_->size ());
 
-  // Obtain the line point and direction
-  Eigen::Vector4f line_pt  (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0);
+#if defined (__AVX__)
+  const int nr_p = selectWithinDistanceAVX (model_coefficients, threshold, 0, indices_->size (), inliers, 0);
+#elif defined (__SSE2__)
+  const int nr_p = selectWithinDistanceSSE (model_coefficients, threshold, 0, indices_->size (), inliers, 0);
+#else
+  const int nr_p = selectWithinDistanceStandard (model_coefficients, threshold, 0, indices_->size (), inliers, 0);
+#endif
+  inliers.resize (nr_p);
+  error_sqr_dists_.resize (nr_p);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelLine<PointT>::selectWithinDistanceStandard (
+      const Eigen::VectorXf &model_coefficients, const double threshold, size_t i, size_t end,
+      std::vector<int> &inliers, int nr_p)
+{
+  // Same single precision distance and threshold as the vectorized kernels, so that a point is an inlier
+  // whichever kernel tests it
+  const float sqr_threshold = static_cast<float> (threshold * threshold);
+
+  // Obtain the line direction
   Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0);
   line_dir.normalize ();
 
   // Iterate through the 3d points and calculate the distances from them to the line
-  for (size_t i = 0; i < indices_->size (); ++i)
+  for (; i < end; ++i)
   {
     // Calculate the distance from the point to the line
-    // D = ||(P2-P1) x (P1-P0)|| / ||P2-P1|| = norm (cross (p2-p1, p2-p0)) / norm(p2-p1)
-    double sqr_distance = (line_pt - input_->points[(*indices_)[i]].getVector4fMap ()).cross3 (line_dir).squaredNorm ();
+    // D^2 = ||(P1-P0) x dir||^2
+    const float dx = model_coefficients[0] - input_->points[(*indices_)[i]].x;
+    const float dy = model_coefficients[1] - input_->points[(*indices_)[i]].y;
+    const float dz = model_coefficients[2] - input_->points[(*indices_)[i]].z;
+    const float cross_x = dy * line_dir[2] - dz * line_dir[1];
+    const float cross_y = dz * line_dir[0] - dx * line_dir[2];
+    const float cross_z = dx * line_dir[1] - dy * line_dir[0];
+    const float sqr_distance = cross_x * cross_x + cross_y * cross_y + cross_z * cross_z;
 
     if (sqr_distance < sqr_threshold)
     {
       // Returns the indices of the points whose squared distances are smaller than the threshold
       inliers[nr_p] = (*indices_)[i];
-      error_sqr_dists_[nr_p] = sqr_distance;
+      error_sqr_dists_[nr_p] = static_cast<double> (sqr_distance);
       ++nr_p;
     }
   }
-  inliers.resize (nr_p);
-  error_sqr_dists_.resize (nr_p);
+  return (nr_p);
+}
+
+#if defined (__SSE2__)
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelLine<PointT>::selectWithinDistanceSSE (
+      const Eigen::VectorXf &model_coefficients, const double threshold, size_t i, size_t end,
+      std::vector<int> &inliers, int nr_p)
+{
+  // Obtain the line direction
+  Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0);
+  line_dir.normalize ();
+
+  const __m128 px = _mm_set1_ps (model_coefficients[0]);
+  const __m128 py = _mm_set1_ps (model_coefficients[1]);
+  const __m128 pz = _mm_set1_ps (model_coefficients[2]);
+  const __m128 dir_x = _mm_set1_ps (line_dir[0]);
+  const __m128 dir_y = _mm_set1_ps (line_dir[1]);
+  const __m128 dir_z = _mm_set1_ps (line_dir[2]);
+  const __m128 sqr_thresh = _mm_set1_ps (static_cast<float> (threshold * threshold));
+
+  // Same squared distances as countWithinDistanceSSE, the inliers of a block are picked from the comparison mask
+  EIGEN_ALIGN16 float sqr_distances[4];
+  for (; i + 4 <= end; i += 4)
+  {
+    __m128 x, y, z;
+    this->loadPoints4 (i, x, y, z);
+    const __m128 dx = _mm_sub_ps (px, x);
+    const __m128 dy = _mm_sub_ps (py, y);
+    const __m128 dz = _mm_sub_ps (pz, z);
+    const __m128 cross_x = _mm_sub_ps (_mm_mul_ps (dy, dir_z), _mm_mul_ps (dz, dir_y));
+    const __m128 cross_y = _mm_sub_ps (_mm_mul_ps (dz, dir_x), _mm_mul_ps (dx, dir_z));
+    const __m128 cross_z = _mm_sub_ps (_mm_mul_ps (dx, dir_y), _mm_mul_ps (dy, dir_x));
+    const __m128 sqr_dist = _mm_add_ps (_mm_add_ps (_mm_mul_ps (cross_x, cross_x), _mm_mul_ps (cross_y, cross_y)), _mm_mul_ps (cross_z, cross_z));
+    const int mask = _mm_movemask_ps (_mm_cmplt_ps (sqr_dist, sqr_thresh));
+    if (mask == 0)
+      continue;
+    _mm_store_ps (sqr_distances, sqr_dist);
+    for (int k = 0; k < 4; ++k)
+    {
+      if (!((mask >> k) & 1))
+        continue;
+      inliers[nr_p] = (*indices_)[i + k];
+      error_sqr_dists_[nr_p] = static_cast<double> (sqr_distances[k]);
+      ++nr_p;
+    }
+  }
+  return (selectWithinDistanceStandard (model_coefficients, threshold, i, end, inliers, nr_p));
+}
+#endif
+
+#if defined (__AVX__)
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelLine<PointT>::selectWithinDistanceAVX (
+      const Eigen::VectorXf &model_coefficients, const double threshold, size_t i, size_t end,
+      std::vector<int> &inliers, int nr_p)
+{
+  // Obtain the line direction
+  Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0);
+  line_dir.normalize ();
+
+  const __m256 px = _mm256_set1_ps (model_coefficients[0]);
+  const __m256 py = _mm256_set1_ps (model_coefficients[1]);
+  const __m256 pz = _mm256_set1_ps (model_coefficients[2]);
+  const __m256 dir_x = _mm256_set1_ps (line_dir[0]);
+  const __m256 dir_y = _mm256_set1_ps (line_dir[1]);
+  const __m256 dir_z = _mm256_set1_ps (line_dir[2]);
+  const __m256 sqr_thresh = _mm256_set1_ps (static_cast<float> (threshold * threshold));
+
+  float sqr_distances[8];
+  for (; i + 8 <= end; i += 8)
+  {
+    __m256 x, y, z;
+    this->loadPoints8 (i, x, y, z);
+    const __m256 dx = _mm256_sub_ps (px, x);
+    const __m256 dy = _mm256_sub_ps (py, y);
+    const __m256 dz = _mm256_sub_ps (pz, z);
+    const __m256 cross_x = _mm256_sub_ps (_mm256_mul_ps (dy, dir_z), _mm256_mul_ps (dz, dir_y));
+    const __m256 cross_y = _mm256_sub_ps (_mm256_mul_ps (dz, dir_x), _mm256_mul_ps (dx, dir_z));
+    const __m256 cross_z = _mm256_sub_ps (_mm256_mul_ps (dx, dir_y), _mm256_mul_ps (dy, dir_x));
+    const __m256 sqr_dist = _mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (cross_x, cross_x), _mm256_mul_ps (cross_y, cross_y)), _mm256_mul_ps (cross_z, cross_z));
+    const int mask = _mm256_movemask_ps (_mm256_cmp_ps (sqr_dist, sqr_thresh, _CMP_LT_OQ));
+    if (mask == 0)
+      continue;
+    _mm256_storeu_ps (sqr_distances, sqr_dist);
+    for (int k = 0; k < 8; ++k)
+    {
+      if (!((mask >> k) & 1))
+        continue;
+      inliers[nr_p] = (*indices_)[i + k];
+      error_sqr_dists_[nr_p] = static_cast<double> (sqr_distances[k]);
+      ++nr_p;
+    }
+  }
+  return (selectWithinDistanceSSE (model_coefficients, threshold, i, end, inliers, nr_p));
 }
+#endif
 
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> int
@@ -166,28 +285,148 @@ pcl::SampleConsensusModelLine<PointT>::countWithinDistance (
   if (!isModelValid (model_coefficients))
     return (0);
 
-  double sqr_threshold = threshold * threshold;
+#if defined (__AVX__)
+  return (countWithinDistanceAVX (model_coefficients, threshold, 0, indices_->size ()));
+#elif defined (__SSE2__)
+  return (countWithinDistanceSSE (model_coefficients, threshold, 0, indices_->size ()));
+#else
+  return (countWithinDistanceStandard (model_coefficients, threshold, 0, indices_->size ()));
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelLine<PointT>::countWithinDistanceRange (
+      const Eigen::VectorXf &model_coefficients, const double threshold, size_t begin, size_t end)
+{
+  // The model was checked with isModelValid by the caller (see countWithinDistanceSPRT)
+  end = (std::min) (end, indices_->size ());
+#if defined (__AVX__)
+  return (countWithinDistanceAVX (model_coefficients, threshold, begin, end));
+#elif defined (__SSE2__)
+  return (countWithinDistanceSSE (model_coefficients, threshold, begin, end));
+#else
+  return (countWithinDistanceStandard (model_coefficients, threshold, begin, end));
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelLine<PointT>::countWithinDistanceStandard (
+      const Eigen::VectorXf &model_coefficients, const double threshold, size_t i, size_t end) const
+{
+  // Same single precision distance and threshold as the vectorized kernels
+  const float sqr_threshold = static_cast<float> (threshold * threshold);
 
   int nr_p = 0;
 
-  // Obtain the line point and direction
-  Eigen::Vector4f line_pt  (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0);
+  // Obtain the line direction
   Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0);
   line_dir.normalize ();
 
   // Iterate through the 3d points and calculate the distances from them to the line
-  for (size_t i = 0; i < indices_->size (); ++i)
+  for (; i < end; ++i)
   {
     // Calculate the distance from the point to the line
-    // D = ||(P2-P1) x (P1-P0)|| / ||P2-P1|| = norm (cross (p2-p1, p2-p0)) / norm(p2-p1)
-    double sqr_distance = (line_pt - input_->points[(*indices_)[i]].getVector4fMap ()).cross3 (line_dir).squaredNorm ();
-
-    if (sqr_distance < sqr_threshold)
+    // D^2 = ||(P1-P0) x dir||^2
+    const float dx = model_coefficients[0] - input_->points[(*indices_)[i]].x;
+    const float dy = model_coefficients[1] - input_->points[(*indices_)[i]].y;
+    const float dz = model_coefficients[2] - input_->points[(*indices_)[i]].z;
+    const float cross_x = dy * line_dir[2] - dz * line_dir[1];
+    const float cross_y = dz * line_dir[0] - dx * line_dir[2];
+    const float cross_z = dx * line_dir[1] - dy * line_dir[0];
+    if (cross_x * cross_x + cross_y * cross_y + cross_z * cross_z < sqr_threshold)
       nr_p++;
   }
   return (nr_p);
 }
 
+#if defined (__SSE2__)
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelLine<PointT>::countWithinDistanceSSE (
+      const Eigen::VectorXf &model_coefficients, const double threshold, size_t i, size_t end) const
+{
+  // Obtain the line point and direction
+  Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0);
+  line_dir.normalize ();
+
+  const __m128 px = _mm_set1_ps (model_coefficients[0]);
+  const __m128 py = _mm_set1_ps (model_coefficients[1]);
+  const __m128 pz = _mm_set1_ps (model_coefficients[2]);
+  const __m128 dir_x = _mm_set1_ps (line_dir[0]);
+  const __m128 dir_y = _mm_set1_ps (line_dir[1]);
+  const __m128 dir_z = _mm_set1_ps (line_dir[2]);
+  const __m128 sqr_thresh = _mm_set1_ps (static_cast<float> (threshold * threshold));
+
+  // Every lane of the comparison mask is either 0 or -1, so subtracting it counts the inliers per lane
+  __m128i counts = _mm_setzero_si128 ();
+  for (; i + 4 <= end; i += 4)
+  {
+    __m128 x, y, z;
+    this->loadPoints4 (i, x, y, z);
+    // D^2 = ||(P1-P0) x dir||^2
+    const __m128 dx = _mm_sub_ps (px, x);
+    const __m128 dy = _mm_sub_ps (py, y);
+    const __m128 dz = _mm_sub_ps (pz, z);
+    const __m128 cross_x = _mm_sub_ps (_mm_mul_ps (dy, dir_z), _mm_mul_ps (dz, dir_y));
+    const __m128 cross_y = _mm_sub_ps (_mm_mul_ps (dz, dir_x), _mm_mul_ps (dx, dir_z));
+    const __m128 cross_z = _mm_sub_ps (_mm_mul_ps (dx, dir_y), _mm_mul_ps (dy, dir_x));
+    const __m128 sqr_dist = _mm_add_ps (_mm_add_ps (_mm_mul_ps (cross_x, cross_x), _mm_mul_ps (cross_y, cross_y)), _mm_mul_ps (cross_z, cross_z));
+    counts = _mm_sub_epi32 (counts, _mm_castps_si128 (_mm_cmplt_ps (sqr_dist, sqr_thresh)));
+  }
+
+  EIGEN_ALIGN16 int lane_counts[4];
+  _mm_store_si128 (reinterpret_cast<__m128i*> (lane_counts), counts);
+  return (lane_counts[0] + lane_counts[1] + lane_counts[2] + lane_counts[3] +
+          countWithinDistanceStandard (model_coefficients, threshold, i, end));
+}
+#endif
+
+#if defined (__AVX__)
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelLine<PointT>::countWithinDistanceAVX (
+      const Eigen::VectorXf &model_coefficients, const double threshold, size_t i, size_t end) const
+{
+  // Obtain the line point and direction
+  Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0);
+  line_dir.normalize ();
+
+  const __m256 px = _mm256_set1_ps (model_coefficients[0]);
+  const __m256 py = _mm256_set1_ps (model_coefficients[1]);
+  const __m256 pz = _mm256_set1_ps (model_coefficients[2]);
+  const __m256 dir_x = _mm256_set1_ps (line_dir[0]);
+  const __m256 dir_y = _mm256_set1_ps (line_dir[1]);
+  const __m256 dir_z = _mm256_set1_ps (line_dir[2]);
+  const __m256 sqr_thresh = _mm256_set1_ps (static_cast<float> (threshold * threshold));
+
+  // AVX has no 256 bit integer arithmetic, so the two halves of the mask are accumulated separately
+  __m128i counts = _mm_setzero_si128 ();
+  for (; i + 8 <= end; i += 8)
+  {
+    __m256 x, y, z;
+    this->loadPoints8 (i, x, y, z);
+    // D^2 = ||(P1-P0) x dir||^2
+    const __m256 dx = _mm256_sub_ps (px, x);
+    const __m256 dy = _mm256_sub_ps (py, y);
+    const __m256 dz = _mm256_sub_ps (pz, z);
+    const __m256 cross_x = _mm256_sub_ps (_mm256_mul_ps (dy, dir_z), _mm256_mul_ps (dz, dir_y));
+    const __m256 cross_y = _mm256_sub_ps (_mm256_mul_ps (dz, dir_x), _mm256_mul_ps (dx, dir_z));
+    const __m256 cross_z = _mm256_sub_ps (_mm256_mul_ps (dx, dir_y), _mm256_mul_ps (dy, dir_x));
+    const __m256 sqr_dist = _mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (cross_x, cross_x), _mm256_mul_ps (cross_y, cross_y)), _mm256_mul_ps (cross_z, cross_z));
+    const __m256 mask = _mm256_cmp_ps (sqr_dist, sqr_thresh, _CMP_LT_OQ);
+    counts = _mm_sub_epi32 (counts, _mm_castps_si128 (_mm256_castps256_ps128 (mask)));
+    counts = _mm_sub_epi32 (counts, _mm_castps_si128 (_mm256_extractf128_ps (mask, 1)));
+  }
+
+  EIGEN_ALIGN16 int lane_counts[4];
+  _mm_store_si128 (reinterpret_cast<__m128i*> (lane_counts), counts);
+  return (lane_counts[0] + lane_counts[1] + lane_counts[2] + lane_counts[3] +
+          countWithinDistanceSSE (model_coefficients, threshold, i, end));
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SampleConsensusModelLine<PointT>::optimizeModelCoefficients (
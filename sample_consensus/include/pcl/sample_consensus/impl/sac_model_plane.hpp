@@ -150,23 +150,41 @@ pcl::SampleConsensusModelPlane<PointT>::selectWithinDistance (
     return;
   }
 
-  int nr_p = 0;
   inliers.resize (indices_->size ());
   error_sqr_dists_.resize (indices_->size ());
 
+#if defined (__AVX__)
+  const int nr_p = selectWithinDistanceAVX (model_coefficients, threshold, 0, indices_->size (), inliers, 0);
+#elif defined (__SSE2__)
+  const int nr_p = selectWithinDistanceSSE (model_coefficients, threshold, 0, indices_->size (), inliers, 0);
+#else
+  const int nr_p = selectWithinDistanceStandard (model_coefficients, threshold, 0, indices_->size (), inliers, 0);
+#endif
+  inliers.resize (nr_p);
+  error_sqr_dists_.resize (nr_p);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelPlane<PointT>::selectWithinDistanceStandard (
+      const Eigen::VectorXf &model_coefficients, const double threshold, size_t i, size_t end,
+      std::vector<int> &inliers, int nr_p)
+{
+  // Same single precision distance and threshold as the vectorized kernels, so that a point is an inlier
+  // whichever kernel tests it
+  const float thresh = static_cast<float> (threshold);
+
   // Iterate through the 3d points and calculate the distances from them to the plane
-  for (size_t i = 0; i < indices_->size (); ++i)
+  for (; i < end; ++i)
   {
     // Calculate the distance from the point to the plane normal as the dot product
     // D = (P-A).N/|N|
-    Eigen::Vector4f pt (input_->points[(*indices_)[i]].x,
-                        input_->points[(*indices_)[i]].y,
-                        input_->points[(*indices_)[i]].z,
-                        1);
-    
-    float distance = fabsf (model_coefficients.dot (pt));
-    
-    if (distance < threshold)
+    const float distance = fabsf (model_coefficients[0] * input_->points[(*indices_)[i]].x +
+                                  model_coefficients[1] * input_->points[(*indices_)[i]].y +
+                                  model_coefficients[2] * input_->points[(*indices_)[i]].z +
+                                  model_coefficients[3]);
+
+    if (distance < thresh)
     {
       // Returns the indices of the points whose distances are smaller than the threshold
       inliers[nr_p] = (*indices_)[i];
@@ -174,10 +192,86 @@ pcl::SampleConsensusModelPlane<PointT>::selectWithinDistance (
       ++nr_p;
     }
   }
-  inliers.resize (nr_p);
-  error_sqr_dists_.resize (nr_p);
+  return (nr_p);
 }
 
+#if defined (__SSE2__)
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelPlane<PointT>::selectWithinDistanceSSE (
+      const Eigen::VectorXf &model_coefficients, const double threshold, size_t i, size_t end,
+      std::vector<int> &inliers, int nr_p)
+{
+  const __m128 a = _mm_set1_ps (model_coefficients[0]);
+  const __m128 b = _mm_set1_ps (model_coefficients[1]);
+  const __m128 c = _mm_set1_ps (model_coefficients[2]);
+  const __m128 d = _mm_set1_ps (model_coefficients[3]);
+  const __m128 thresh = _mm_set1_ps (static_cast<float> (threshold));
+  const __m128 sign_mask = _mm_set1_ps (-0.0f);
+
+  // Same distances as countWithinDistanceSSE, the inliers of a block are picked from the comparison mask
+  EIGEN_ALIGN16 float distances[4];
+  for (; i + 4 <= end; i += 4)
+  {
+    __m128 x, y, z;
+    this->loadPoints4 (i, x, y, z);
+    __m128 dist = _mm_add_ps (_mm_add_ps (_mm_add_ps (_mm_mul_ps (a, x), _mm_mul_ps (b, y)), _mm_mul_ps (c, z)), d);
+    dist = _mm_andnot_ps (sign_mask, dist);
+    const int mask = _mm_movemask_ps (_mm_cmplt_ps (dist, thresh));
+    if (mask == 0)
+      continue;
+    _mm_store_ps (distances, dist);
+    for (int k = 0; k < 4; ++k)
+    {
+      if (!((mask >> k) & 1))
+        continue;
+      inliers[nr_p] = (*indices_)[i + k];
+      error_sqr_dists_[nr_p] = static_cast<double> (distances[k]);
+      ++nr_p;
+    }
+  }
+  return (selectWithinDistanceStandard (model_coefficients, threshold, i, end, inliers, nr_p));
+}
+#endif
+
+#if defined (__AVX__)
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelPlane<PointT>::selectWithinDistanceAVX (
+      const Eigen::VectorXf &model_coefficients, const double threshold, size_t i, size_t end,
+      std::vector<int> &inliers, int nr_p)
+{
+  const __m256 a = _mm256_set1_ps (model_coefficients[0]);
+  const __m256 b = _mm256_set1_ps (model_coefficients[1]);
+  const __m256 c = _mm256_set1_ps (model_coefficients[2]);
+  const __m256 d = _mm256_set1_ps (model_coefficients[3]);
+  const __m256 thresh = _mm256_set1_ps (static_cast<float> (threshold));
+  const __m256 sign_mask = _mm256_set1_ps (-0.0f);
+
+  float distances[8];
+  for (; i + 8 <= end; i += 8)
+  {
+    __m256 x, y, z;
+    this->loadPoints8 (i, x, y, z);
+    __m256 dist = _mm256_add_ps (_mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (a, x), _mm256_mul_ps (b, y)), _mm256_mul_ps (c, z)), d);
+    dist = _mm256_andnot_ps (sign_mask, dist);
+    const int mask = _mm256_movemask_ps (_mm256_cmp_ps (dist, thresh, _CMP_LT_OQ));
+    if (mask == 0)
+      continue;
+    _mm256_storeu_ps (distances, dist);
+    for (int k = 0; k < 8; ++k)
+    {
+      if (!((mask >> k) & 1))
+        continue;
+      inliers[nr_p] = (*indices_)[i + k];
+      error_sqr_dists_[nr_p] = static_cast<double> (distances[k]);
+      ++nr_p;
+    }
+  }
+  return (selectWithinDistanceSSE (model_coefficients, threshold, i, end, inliers, nr_p));
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> int
 pcl::SampleConsensusModelPlane<PointT>::countWithinDistance (
@@ -190,23 +284,118 @@ pcl::SampleConsensusModelPlane<PointT>::countWithinDistance (
     return (0);
   }
 
+#if defined (__AVX__)
+  return (countWithinDistanceAVX (model_coefficients, threshold, 0, indices_->size ()));
+#elif defined (__SSE2__)
+  return (countWithinDistanceSSE (model_coefficients, threshold, 0, indices_->size ()));
+#else
+  return (countWithinDistanceStandard (model_coefficients, threshold, 0, indices_->size ()));
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelPlane<PointT>::countWithinDistanceRange (
+      const Eigen::VectorXf &model_coefficients, const double threshold, size_t begin, size_t end)
+{
+  // The model was checked with isModelValid by the caller (see countWithinDistanceSPRT)
+  end = (std::min) (end, indices_->size ());
+#if defined (__AVX__)
+  return (countWithinDistanceAVX (model_coefficients, threshold, begin, end));
+#elif defined (__SSE2__)
+  return (countWithinDistanceSSE (model_coefficients, threshold, begin, end));
+#else
+  return (countWithinDistanceStandard (model_coefficients, threshold, begin, end));
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelPlane<PointT>::countWithinDistanceStandard (
+      const Eigen::VectorXf &model_coefficients, const double threshold, size_t i, size_t end) const
+{
+  // Same single precision distance and threshold as the vectorized kernels
+  const float thresh = static_cast<float> (threshold);
   int nr_p = 0;
 
   // Iterate through the 3d points and calculate the distances from them to the plane
-  for (size_t i = 0; i < indices_->size (); ++i)
+  for (; i < end; ++i)
   {
     // Calculate the distance from the point to the plane normal as the dot product
     // D = (P-A).N/|N|
-    Eigen::Vector4f pt (input_->points[(*indices_)[i]].x,
-                        input_->points[(*indices_)[i]].y,
-                        input_->points[(*indices_)[i]].z,
-                        1);
-    if (fabs (model_coefficients.dot (pt)) < threshold)
+    if (fabsf (model_coefficients[0] * input_->points[(*indices_)[i]].x +
+               model_coefficients[1] * input_->points[(*indices_)[i]].y +
+               model_coefficients[2] * input_->points[(*indices_)[i]].z +
+               model_coefficients[3]) < thresh)
       nr_p++;
   }
   return (nr_p);
 }
 
+#if defined (__SSE2__)
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelPlane<PointT>::countWithinDistanceSSE (
+      const Eigen::VectorXf &model_coefficients, const double threshold, size_t i, size_t end) const
+{
+  const __m128 a = _mm_set1_ps (model_coefficients[0]);
+  const __m128 b = _mm_set1_ps (model_coefficients[1]);
+  const __m128 c = _mm_set1_ps (model_coefficients[2]);
+  const __m128 d = _mm_set1_ps (model_coefficients[3]);
+  const __m128 thresh = _mm_set1_ps (static_cast<float> (threshold));
+  const __m128 sign_mask = _mm_set1_ps (-0.0f);
+
+  // Every lane of the comparison mask is either 0 or -1, so subtracting it counts the inliers per lane
+  __m128i counts = _mm_setzero_si128 ();
+  for (; i + 4 <= end; i += 4)
+  {
+    __m128 x, y, z;
+    this->loadPoints4 (i, x, y, z);
+    __m128 dist = _mm_add_ps (_mm_add_ps (_mm_add_ps (_mm_mul_ps (a, x), _mm_mul_ps (b, y)), _mm_mul_ps (c, z)), d);
+    dist = _mm_andnot_ps (sign_mask, dist);
+    counts = _mm_sub_epi32 (counts, _mm_castps_si128 (_mm_cmplt_ps (dist, thresh)));
+  }
+
+  EIGEN_ALIGN16 int lane_counts[4];
+  _mm_store_si128 (reinterpret_cast<__m128i*> (lane_counts), counts);
+  return (lane_counts[0] + lane_counts[1] + lane_counts[2] + lane_counts[3] +
+          countWithinDistanceStandard (model_coefficients, threshold, i, end));
+}
+#endif
+
+#if defined (__AVX__)
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::SampleConsensusModelPlane<PointT>::countWithinDistanceAVX (
+      const Eigen::VectorXf &model_coefficients, const double threshold, size_t i, size_t end) const
+{
+  const __m256 a = _mm256_set1_ps (model_coefficients[0]);
+  const __m256 b = _mm256_set1_ps (model_coefficients[1]);
+  const __m256 c = _mm256_set1_ps (model_coefficients[2]);
+  const __m256 d = _mm256_set1_ps (model_coefficients[3]);
+  const __m256 thresh = _mm256_set1_ps (static_cast<float> (threshold));
+  const __m256 sign_mask = _mm256_set1_ps (-0.0f);
+
+  // AVX has no 256 bit integer arithmetic, so the two halves of the mask are accumulated separately
+  __m128i counts = _mm_setzero_si128 ();
+  for (; i + 8 <= end; i += 8)
+  {
+    __m256 x, y, z;
+    this->loadPoints8 (i, x, y, z);
+    __m256 dist = _mm256_add_ps (_mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (a, x), _mm256_mul_ps (b, y)), _mm256_mul_ps (c, z)), d);
+    dist = _mm256_andnot_ps (sign_mask, dist);
+    const __m256 mask = _mm256_cmp_ps (dist, thresh, _CMP_LT_OQ);
+    counts = _mm_sub_epi32 (counts, _mm_castps_si128 (_mm256_castps256_ps128 (mask)));
+    counts = _mm_sub_epi32 (counts, _mm_castps_si128 (_mm256_extractf128_ps (mask, 1)));
+  }
+
+  EIGEN_ALIGN16 int lane_counts[4];
+  _mm_store_si128 (reinterpret_cast<__m128i*> (lane_counts), counts);
+  return (lane_counts[0] + lane_counts[1] + lane_counts[2] + lane_counts[3] +
+          countWithinDistanceSSE (model_coefficients, threshold, i, end));
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SampleConsensusModelPlane<PointT>::optimizeModelCoefficients (
@@ -0,0 +1,125 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_SAMPLE_CONSENSUS_LMEDS_OMP_H_
+#define PCL_SAMPLE_CONSENSUS_LMEDS_OMP_H_
+
+#include <pcl/sample_consensus/lmeds.h>
+
+namespace pcl
+{
+  /** \brief @b LeastMedianSquaresOMP is a parallel version of \ref LeastMedianSquares, using the OpenMP
+    * standard.
+    *
+    * The median residual of every hypothesis is computed in parallel, in batches of twice the number of
+    * threads, with per-hypothesis random number generators (see \ref RandomSampleConsensusOMP), and the
+    * median is found by partial selection instead of a full sort. Since LMedS always runs \a max_iterations_
+    * trials, the batch merge only has to keep the serial order of the skip counting and best model updates.
+    *
+    * \note The samples are drawn with \ref SampleConsensusModel::drawSamples, so the sequence of hypotheses
+    * differs from the one of the serial \ref LeastMedianSquares.
+    * \ingroup sample_consensus
+    */
+  template <typename PointT>
+  class LeastMedianSquaresOMP : public LeastMedianSquares<PointT>
+  {
+    typedef typename SampleConsensusModel<PointT>::Ptr SampleConsensusModelPtr;
+
+    public:
+      typedef boost::shared_ptr<LeastMedianSquaresOMP> Ptr;
+      typedef boost::shared_ptr<const LeastMedianSquaresOMP> ConstPtr;
+
+      using SampleConsensus<PointT>::max_iterations_;
+      using SampleConsensus<PointT>::threshold_;
+      using SampleConsensus<PointT>::iterations_;
+      using SampleConsensus<PointT>::sac_model_;
+      using SampleConsensus<PointT>::model_;
+      using SampleConsensus<PointT>::model_coefficients_;
+      using SampleConsensus<PointT>::inliers_;
+
+      /** \brief LMedS (Least Median of Squares) main constructor
+        * \param[in] model a Sample Consensus model
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      LeastMedianSquaresOMP (const SampleConsensusModelPtr &model, unsigned int nr_threads = 0)
+        : LeastMedianSquares<PointT> (model)
+        , threads_ (nr_threads)
+      {
+      }
+
+      /** \brief LMedS (Least Median of Squares) main constructor
+        * \param[in] model a Sample Consensus model
+        * \param[in] threshold distance to model threshold
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      LeastMedianSquaresOMP (const SampleConsensusModelPtr &model, double threshold, unsigned int nr_threads = 0)
+        : LeastMedianSquares<PointT> (model, threshold)
+        , threads_ (nr_threads)
+      {
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+      /** \brief Get the number of threads the scheduler is set to use (0 means automatic). */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
+      /** \brief Compute the actual model and find the inliers
+        * \param[in] debug_verbosity_level enable/disable on-screen debug information and set the verbosity level
+        */
+      bool
+      computeModel (int debug_verbosity_level = 0);
+
+    protected:
+      using SampleConsensus<PointT>::rnd;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/sample_consensus/impl/lmeds_omp.hpp>
+#endif
+
+#endif  //#ifndef PCL_SAMPLE_CONSENSUS_LMEDS_OMP_H_
@@ -0,0 +1,127 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_SAMPLE_CONSENSUS_MSAC_OMP_H_
+#define PCL_SAMPLE_CONSENSUS_MSAC_OMP_H_
+
+#include <pcl/sample_consensus/msac.h>
+
+namespace pcl
+{
+  /** \brief @b MEstimatorSampleConsensusOMP is a parallel version of \ref MEstimatorSampleConsensus, using the OpenMP
+    * standard.
+    *
+    * The truncated penalty of every hypothesis is computed in parallel, in batches of twice the number of
+    * threads, with per-hypothesis random number generators (see \ref RandomSampleConsensusOMP). The batch is
+    * merged in hypothesis order with the serial update of the best penalty and of the adaptive number of
+    * trials, so the result does not depend on the number of threads. Contrary to the serial version, a
+    * model that yields no distances is counted as skipped.
+    *
+    * \note The samples are drawn with \ref SampleConsensusModel::drawSamples, so the sequence of hypotheses
+    * differs from the one of the serial \ref MEstimatorSampleConsensus.
+    * \ingroup sample_consensus
+    */
+  template <typename PointT>
+  class MEstimatorSampleConsensusOMP : public MEstimatorSampleConsensus<PointT>
+  {
+    typedef typename SampleConsensusModel<PointT>::Ptr SampleConsensusModelPtr;
+
+    public:
+      typedef boost::shared_ptr<MEstimatorSampleConsensusOMP> Ptr;
+      typedef boost::shared_ptr<const MEstimatorSampleConsensusOMP> ConstPtr;
+
+      using SampleConsensus<PointT>::max_iterations_;
+      using SampleConsensus<PointT>::threshold_;
+      using SampleConsensus<PointT>::iterations_;
+      using SampleConsensus<PointT>::sac_model_;
+      using SampleConsensus<PointT>::model_;
+      using SampleConsensus<PointT>::model_coefficients_;
+      using SampleConsensus<PointT>::inliers_;
+      using SampleConsensus<PointT>::probability_;
+
+      /** \brief MSAC (M-estimator SAmple Consensus) main constructor
+        * \param[in] model a Sample Consensus model
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      MEstimatorSampleConsensusOMP (const SampleConsensusModelPtr &model, unsigned int nr_threads = 0)
+        : MEstimatorSampleConsensus<PointT> (model)
+        , threads_ (nr_threads)
+      {
+      }
+
+      /** \brief MSAC (M-estimator SAmple Consensus) main constructor
+        * \param[in] model a Sample Consensus model
+        * \param[in] threshold distance to model threshold
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      MEstimatorSampleConsensusOMP (const SampleConsensusModelPtr &model, double threshold, unsigned int nr_threads = 0)
+        : MEstimatorSampleConsensus<PointT> (model, threshold)
+        , threads_ (nr_threads)
+      {
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+      /** \brief Get the number of threads the scheduler is set to use (0 means automatic). */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
+      /** \brief Compute the actual model and find the inliers
+        * \param[in] debug_verbosity_level enable/disable on-screen debug information and set the verbosity level
+        */
+      bool
+      computeModel (int debug_verbosity_level = 0);
+
+    protected:
+      using SampleConsensus<PointT>::rnd;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/sample_consensus/impl/msac_omp.hpp>
+#endif
+
+#endif  //#ifndef PCL_SAMPLE_CONSENSUS_MSAC_OMP_H_
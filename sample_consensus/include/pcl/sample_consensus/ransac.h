@@ -75,6 +75,7 @@ namespace pcl
         */
       RandomSampleConsensus (const SampleConsensusModelPtr &model) 
         : SampleConsensus<PointT> (model)
+        , use_sprt_ (false)
       {
         // Maximum number of trials before we give up.
         max_iterations_ = 10000;
@@ -86,6 +87,7 @@ namespace pcl
         */
       RandomSampleConsensus (const SampleConsensusModelPtr &model, double threshold) 
         : SampleConsensus<PointT> (model, threshold)
+        , use_sprt_ (false)
       {
         // Maximum number of trials before we give up.
         max_iterations_ = 10000;
@@ -96,6 +98,24 @@ namespace pcl
         */
       bool 
       computeModel (int debug_verbosity_level = 0);
+
+      /** \brief Set whether the hypotheses should be verified with a sequential probability ratio test
+        * (see \ref SampleConsensusModel::countWithinDistanceSPRT), which stops the verification of a model
+        * as soon as it is found to be bad. The probability of an inlier for a good model is taken from the
+        * best model found so far, the one for a bad model is estimated from the rejected models, and the
+        * number of iterations is increased to account for the good models which get rejected.
+        * \param[in] use_sprt true to enable the early termination of the verification (default: false)
+        */
+      inline void
+      setUseSPRT (bool use_sprt) { use_sprt_ = use_sprt; }
+
+      /** \brief Get whether the hypotheses are verified with a sequential probability ratio test. */
+      inline bool
+      getUseSPRT () const { return (use_sprt_); }
+
+    protected:
+      /** \brief True if the hypotheses are verified with a sequential probability ratio test. */
+      bool use_sprt_;
   };
 }
 
@@ -0,0 +1,129 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_SAMPLE_CONSENSUS_RANSAC_OMP_H_
+#define PCL_SAMPLE_CONSENSUS_RANSAC_OMP_H_
+
+#include <pcl/sample_consensus/ransac.h>
+
+namespace pcl
+{
+  /** \brief @b RandomSampleConsensusOMP is a parallel version of \ref RandomSampleConsensus, using the OpenMP
+    * standard.
+    *
+    * Hypotheses are generated and scored in batches of twice the number of threads. Every hypothesis draws
+    * its samples with its own random number generator, seeded from a base seed (taken once per call from the
+    * generator of \ref SampleConsensus) and the global index of the hypothesis. The batch is then merged in
+    * hypothesis order using exactly the serial acceptance logic (skipped models, best model update, adaptive
+    * number of trials k, maximum number of iterations), and the speculative hypotheses beyond the stopping
+    * point are discarded. The result therefore only depends on the seed, and not on the number of threads.
+    *
+    * \note The samples are drawn with \ref SampleConsensusModel::drawSamples, so the sequence of hypotheses
+    * differs from the one of the serial \ref RandomSampleConsensus. The sequential probability ratio test
+    * (\ref setUseSPRT) is not used, as its decisions depend on the order in which the hypotheses are verified.
+    * \ingroup sample_consensus
+    */
+  template <typename PointT>
+  class RandomSampleConsensusOMP : public RandomSampleConsensus<PointT>
+  {
+    typedef typename SampleConsensusModel<PointT>::Ptr SampleConsensusModelPtr;
+
+    public:
+      typedef boost::shared_ptr<RandomSampleConsensusOMP> Ptr;
+      typedef boost::shared_ptr<const RandomSampleConsensusOMP> ConstPtr;
+
+      using SampleConsensus<PointT>::max_iterations_;
+      using SampleConsensus<PointT>::threshold_;
+      using SampleConsensus<PointT>::iterations_;
+      using SampleConsensus<PointT>::sac_model_;
+      using SampleConsensus<PointT>::model_;
+      using SampleConsensus<PointT>::model_coefficients_;
+      using SampleConsensus<PointT>::inliers_;
+      using SampleConsensus<PointT>::probability_;
+
+      /** \brief RANSAC (RAndom SAmple Consensus) main constructor
+        * \param[in] model a Sample Consensus model
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      RandomSampleConsensusOMP (const SampleConsensusModelPtr &model, unsigned int nr_threads = 0)
+        : RandomSampleConsensus<PointT> (model)
+        , threads_ (nr_threads)
+      {
+      }
+
+      /** \brief RANSAC (RAndom SAmple Consensus) main constructor
+        * \param[in] model a Sample Consensus model
+        * \param[in] threshold distance to model threshold
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      RandomSampleConsensusOMP (const SampleConsensusModelPtr &model, double threshold, unsigned int nr_threads = 0)
+        : RandomSampleConsensus<PointT> (model, threshold)
+        , threads_ (nr_threads)
+      {
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+      /** \brief Get the number of threads the scheduler is set to use (0 means automatic). */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
+      /** \brief Compute the actual model and find the inliers
+        * \param[in] debug_verbosity_level enable/disable on-screen debug information and set the verbosity level
+        */
+      bool
+      computeModel (int debug_verbosity_level = 0);
+
+    protected:
+      using SampleConsensus<PointT>::rnd;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/sample_consensus/impl/ransac_omp.hpp>
+#endif
+
+#endif  //#ifndef PCL_SAMPLE_CONSENSUS_RANSAC_OMP_H_
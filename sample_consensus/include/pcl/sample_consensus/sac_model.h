@@ -53,6 +53,12 @@
 
 #include <pcl/search/search.h>
 
+#if defined (__AVX__)
+#include <immintrin.h>
+#elif defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace pcl
 {
   template<class T> class ProgressiveSampleConsensus;
@@ -209,6 +215,71 @@ namespace pcl
         samples.clear ();
       }
 
+      /** \brief Get a set of random data samples using an external random number generator, and
+        * return them as point indices. Contrary to \ref getSamples, the state of the model is not
+        * modified, so several threads can draw samples concurrently, each one with its own generator.
+        * \param[in,out] rng the random number generator to draw the samples with
+        * \param[out] samples the resultant model samples (empty if no good sample could be selected)
+        */
+      void
+      drawSamples (boost::mt19937 &rng, std::vector<int> &samples) const
+      {
+        const size_t sample_size = getSampleSize ();
+        samples.clear ();
+        if (indices_->size () < sample_size || sample_size == 0)
+          return;
+
+        boost::uniform_int<> index_dist (0, static_cast<int> (indices_->size ()) - 1);
+        std::vector<int> positions (sample_size);
+        std::vector<int> nn_indices;
+        std::vector<float> nn_dists;
+        samples.resize (sample_size);
+        for (unsigned int iter = 0; iter < max_sample_checks_; ++iter)
+        {
+          if (samples_radius_ < std::numeric_limits<double>::epsilon ())
+          {
+            // Draw sample_size distinct positions in indices_ (sample sizes are tiny, so rejection is cheap)
+            for (size_t i = 0; i < sample_size; ++i)
+            {
+              bool unique = false;
+              while (!unique)
+              {
+                positions[i] = index_dist (rng);
+                unique = true;
+                for (size_t j = 0; j < i; ++j)
+                  if (positions[j] == positions[i])
+                    unique = false;
+              }
+              samples[i] = (*indices_)[positions[i]];
+            }
+          }
+          else
+          {
+            samples[0] = (*indices_)[index_dist (rng)];
+            samples_radius_search_->radiusSearch (input_->at (samples[0]), samples_radius_, nn_indices, nn_dists);
+            if (nn_indices.size () < sample_size - 1)
+            {
+              // radius search failed, make an invalid model
+              for (size_t i = 1; i < sample_size; ++i)
+                samples[i] = samples[0];
+            }
+            else
+            {
+              for (size_t i = 0; i < sample_size - 1; ++i)
+              {
+                boost::uniform_int<> nn_dist (static_cast<int> (i), static_cast<int> (nn_indices.size ()) - 1);
+                std::swap (nn_indices[i], nn_indices[nn_dist (rng)]);
+                samples[i + 1] = nn_indices[i];
+              }
+            }
+          }
+
+          if (isSampleGood (samples))
+            return;
+        }
+        samples.clear ();
+      }
+
       /** \brief Check whether the given index samples can form a valid model,
         * compute the model coefficients from these samples and store them
         * in model_coefficients. Pure virtual.
@@ -270,6 +341,129 @@ namespace pcl
       countWithinDistance (const Eigen::VectorXf &model_coefficients, 
                            const double threshold) = 0;
 
+      /** \brief Count the points of indices_, between positions \a begin (included) and \a end
+        * (excluded), which respect the given model coefficients as inliers. This is the building block
+        * of \ref countWithinDistanceSPRT; models which cannot evaluate a part of their points keep the
+        * default implementation, which returns -1. The model coefficients are not checked with
+        * \ref isModelValid, so that the blocks of \ref countWithinDistanceSPRT do not pay for it every
+        * time: they must be valid.
+        * \param[in] model_coefficients the coefficients of a model that we need to compute distances to
+        * \param[in] threshold a maximum admissible distance threshold for determining the inliers from the outliers
+        * \param[in] begin the position in indices_ of the first point to test
+        * \param[in] end the position in indices_ after the last point to test
+        * \return the resultant number of inliers, or -1 if not supported by the model
+        */
+      virtual int
+      countWithinDistanceRange (const Eigen::VectorXf &,
+                                const double,
+                                size_t,
+                                size_t)
+      {
+        return (-1);
+      }
+
+      /** \brief Count all the points which respect the given model coefficients as inliers, but stop as
+        * soon as a sequential probability ratio test decides that the model is bad, as described in:
+        * "Optimal Randomized RANSAC", O. Chum and J. Matas, PAMI 30(8): 1472-1482, 2008.
+        *
+        * The points are tested in blocks, visited in a scattered order so that spatially coherent
+        * parts of the cloud do not bias the test. The likelihood ratio of the model being bad is
+        * updated after every block, and the model is rejected when it exceeds \a decision_threshold.
+        * If the model does not implement \ref countWithinDistanceRange, all the points are counted
+        * with \ref countWithinDistance.
+        * \param[in] model_coefficients the coefficients of a model that we need to compute distances to
+        * \param[in] threshold a maximum admissible distance threshold for determining the inliers from the outliers
+        * \param[in] epsilon the probability that a point is an inlier of a good model
+        * \param[in] delta the probability that a point is an inlier of a bad model (must be smaller than \a epsilon)
+        * \param[in] decision_threshold the SPRT decision threshold A (see \ref computeSPRTDecisionThreshold)
+        * \param[out] nr_tested the number of points tested; the model was rejected if it is smaller than
+        * the number of indices
+        * \return the number of inliers among the tested points
+        */
+      int
+      countWithinDistanceSPRT (const Eigen::VectorXf &model_coefficients,
+                               const double threshold,
+                               const double epsilon,
+                               const double delta,
+                               const double decision_threshold,
+                               size_t &nr_tested)
+      {
+        const size_t nr_indices = indices_->size ();
+
+        // Check the model constraints once, countWithinDistanceRange does not check them for every block
+        if (!isModelValid (model_coefficients))
+        {
+          nr_tested = nr_indices;
+          return (0);
+        }
+
+        const size_t block_size = 16;
+        const size_t nr_blocks = (nr_indices + block_size - 1) / block_size;
+
+        // Visit the blocks with a stride coprime with their number, which is a full permutation
+        size_t stride = std::max<size_t> (1, static_cast<size_t> (0.618034 * static_cast<double> (nr_blocks)));
+        while (nr_blocks > 1 && gcd (stride, nr_blocks) != 1)
+          ++stride;
+
+        const double log_inlier = log (delta / epsilon);
+        const double log_outlier = log ((1.0 - delta) / (1.0 - epsilon));
+        const double log_decision_threshold = log (decision_threshold);
+        double log_lambda = 0.0;
+
+        int nr_p = 0;
+        nr_tested = 0;
+        for (size_t j = 0, block = 0; j < nr_blocks; ++j, block = (block + stride) % nr_blocks)
+        {
+          const size_t begin = block * block_size;
+          const size_t end = (std::min) (begin + block_size, nr_indices);
+          const int block_inliers = countWithinDistanceRange (model_coefficients, threshold, begin, end);
+          if (block_inliers < 0)
+          {
+            nr_tested = nr_indices;
+            return (countWithinDistance (model_coefficients, threshold));
+          }
+
+          nr_p += block_inliers;
+          nr_tested += end - begin;
+          log_lambda += static_cast<double> (block_inliers) * log_inlier +
+                        static_cast<double> (end - begin - block_inliers) * log_outlier;
+          if (log_lambda > log_decision_threshold && nr_tested < nr_indices)
+            break;
+        }
+        return (nr_p);
+      }
+
+      /** \brief Compute the SPRT decision threshold A which minimizes the average time to solution, by
+        * iterating A = K + 1 + log (A), with K = t_M * C / m_S (see "Optimal Randomized RANSAC").
+        * \param[in] epsilon the probability that a point is an inlier of a good model
+        * \param[in] delta the probability that a point is an inlier of a bad model
+        * \param[in] model_time the time needed to compute a model from a sample, in units of the time
+        * needed to verify one point (t_M)
+        * \param[in] models_per_sample the average number of models computed from a sample (m_S)
+        */
+      static double
+      computeSPRTDecisionThreshold (const double epsilon,
+                                    const double delta,
+                                    const double model_time = 200.0,
+                                    const double models_per_sample = 1.0)
+      {
+        // The test is meaningless if bad models are as likely to be supported as good ones
+        if (!(epsilon > delta) || delta <= 0.0 || epsilon >= 1.0)
+          return (std::numeric_limits<double>::max ());
+
+        const double c = (1.0 - delta) * log ((1.0 - delta) / (1.0 - epsilon)) + delta * log (delta / epsilon);
+        const double k = model_time * c / models_per_sample;
+        double a = k + 1.0;
+        for (int i = 0; i < 10; ++i)
+        {
+          const double a_next = k + 1.0 + log (a);
+          if (fabs (a_next - a) < 1e-5)
+            return (a_next);
+          a = a_next;
+        }
+        return (a);
+      }
+
       /** \brief Create a new point cloud with inliers projected onto the model. Pure virtual.
         * \param[in] inliers the data inliers that we want to project on the model
         * \param[in] model_coefficients the coefficients of a model
@@ -512,6 +706,46 @@ namespace pcl
       virtual bool
       isSampleGood (const std::vector<int> &samples) const = 0;
 
+#if defined (__SSE2__)
+      /** \brief Load the coordinates of 4 consecutive points of indices_ as a SoA (structure of arrays) block.
+        * \param[in] i the position in indices_ of the first point
+        * \param[out] x the x coordinates of the points
+        * \param[out] y the y coordinates of the points
+        * \param[out] z the z coordinates of the points
+        */
+      inline void
+      loadPoints4 (size_t i, __m128 &x, __m128 &y, __m128 &z) const
+      {
+        __m128 p0 = _mm_loadu_ps (input_->points[(*indices_)[i    ]].data);
+        __m128 p1 = _mm_loadu_ps (input_->points[(*indices_)[i + 1]].data);
+        __m128 p2 = _mm_loadu_ps (input_->points[(*indices_)[i + 2]].data);
+        __m128 p3 = _mm_loadu_ps (input_->points[(*indices_)[i + 3]].data);
+        _MM_TRANSPOSE4_PS (p0, p1, p2, p3);
+        x = p0;
+        y = p1;
+        z = p2;
+      }
+#endif
+
+#if defined (__AVX__)
+      /** \brief Load the coordinates of 8 consecutive points of indices_ as a SoA (structure of arrays) block.
+        * \param[in] i the position in indices_ of the first point
+        * \param[out] x the x coordinates of the points
+        * \param[out] y the y coordinates of the points
+        * \param[out] z the z coordinates of the points
+        */
+      inline void
+      loadPoints8 (size_t i, __m256 &x, __m256 &y, __m256 &z) const
+      {
+        __m128 x0, y0, z0, x1, y1, z1;
+        loadPoints4 (i, x0, y0, z0);
+        loadPoints4 (i + 4, x1, y1, z1);
+        x = _mm256_insertf128_ps (_mm256_castps128_ps256 (x0), x1, 1);
+        y = _mm256_insertf128_ps (_mm256_castps128_ps256 (y0), y1, 1);
+        z = _mm256_insertf128_ps (_mm256_castps128_ps256 (z0), z1, 1);
+      }
+#endif
+
       /** \brief The model name. */
       std::string model_name_;
 
@@ -556,6 +790,19 @@ namespace pcl
       {
         return ((*rng_gen_) ());
       }
+
+      /** \brief Greatest common divisor of \a a and \a b. */
+      static inline size_t
+      gcd (size_t a, size_t b)
+      {
+        while (b != 0)
+        {
+          const size_t r = a % b;
+          a = b;
+          b = r;
+        }
+        return (a);
+      }
     public:
       EIGEN_MAKE_ALIGNED_OPERATOR_NEW
  };
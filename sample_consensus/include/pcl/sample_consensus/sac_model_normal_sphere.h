@@ -135,6 +135,18 @@ namespace pcl
       countWithinDistance (const Eigen::VectorXf &model_coefficients, 
                            const double threshold);
 
+      /** \brief Partial counting is not supported, since the inliers also depend on the normals.
+        * \return -1
+        */
+      virtual int
+      countWithinDistanceRange (const Eigen::VectorXf &,
+                                const double,
+                                size_t,
+                                size_t)
+      {
+        return (-1);
+      }
+
       /** \brief Compute all distances from the cloud data to a given sphere model.
         * \param[in] model_coefficients the coefficients of a sphere model that we need to compute distances to
         * \param[out] distances the resultant estimated distances
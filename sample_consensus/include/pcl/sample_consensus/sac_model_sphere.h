@@ -159,6 +159,21 @@ namespace pcl
       countWithinDistance (const Eigen::VectorXf &model_coefficients, 
                            const double threshold);
 
+      /** \brief Count the points of indices_, between positions \a begin (included) and \a end (excluded),
+        * which respect the given model coefficients as inliers. The model coefficients
+        * must have been checked with \ref isModelValid.
+        * \param[in] model_coefficients the coefficients of a sphere model that we need to compute distances to
+        * \param[in] threshold maximum admissible distance threshold for determining the inliers from the outliers
+        * \param[in] begin the position in indices_ of the first point to test
+        * \param[in] end the position in indices_ after the last point to test
+        * \return the resultant number of inliers
+        */
+      virtual int
+      countWithinDistanceRange (const Eigen::VectorXf &model_coefficients,
+                                const double threshold,
+                                size_t begin,
+                                size_t end);
+
       /** \brief Recompute the sphere coefficients using the given inlier set and return them to the user.
         * @note: these are the coefficients of the sphere model after refinement (e.g. after SVD)
         * \param[in] inliers the data inliers found as supporting the model
@@ -225,6 +240,86 @@ namespace pcl
       bool
       isSampleGood(const std::vector<int> &samples) const;
 
+      /** \brief Count the points of indices_, between positions \a i (included) and \a end (excluded),
+        * which are inliers of the given sphere model, one point at a time.
+        * \param[in] model_coefficients the coefficients of the sphere model
+        * \param[in] threshold maximum admissible distance threshold for determining the inliers from the outliers
+        * \param[in] i the position in indices_ of the first point to test
+        * \param[in] end the position in indices_ after the last point to test
+        */
+      int
+      countWithinDistanceStandard (const Eigen::VectorXf &model_coefficients,
+                                   const double threshold,
+                                   size_t i,
+                                   size_t end) const;
+
+#if defined (__SSE2__)
+      /** \brief Same as \ref countWithinDistanceStandard, testing 4 points at a time with SSE2 (the last
+        * points are handled by \ref countWithinDistanceStandard).
+        */
+      int
+      countWithinDistanceSSE (const Eigen::VectorXf &model_coefficients,
+                              const double threshold,
+                              size_t i,
+                              size_t end) const;
+#endif
+
+#if defined (__AVX__)
+      /** \brief Same as \ref countWithinDistanceStandard, testing 8 points at a time with AVX (the last
+        * points are handled by \ref countWithinDistanceSSE).
+        */
+      int
+      countWithinDistanceAVX (const Eigen::VectorXf &model_coefficients,
+                              const double threshold,
+                              size_t i,
+                              size_t end) const;
+#endif
+
+      /** \brief Select the points of indices_, between positions \a i (included) and \a end (excluded), which
+        * are inliers of the given sphere model, one point at a time. Their indices and distances are stored in
+        * \a inliers and \a error_sqr_dists_ from position \a nr_p on.
+        * \param[in] model_coefficients the coefficients of the sphere model
+        * \param[in] threshold maximum admissible distance threshold for determining the inliers from the outliers
+        * \param[in] i the position in indices_ of the first point to test
+        * \param[in] end the position in indices_ after the last point to test
+        * \param[out] inliers the resultant model inliers, large enough for all the points
+        * \param[in] nr_p the number of inliers already stored
+        * \return the number of inliers stored
+        */
+      int
+      selectWithinDistanceStandard (const Eigen::VectorXf &model_coefficients,
+                                    const double threshold,
+                                    size_t i,
+                                    size_t end,
+                                    std::vector<int> &inliers,
+                                    int nr_p);
+
+#if defined (__SSE2__)
+      /** \brief Same as \ref selectWithinDistanceStandard, testing 4 points at a time with SSE2 (the last
+        * points are handled by \ref selectWithinDistanceStandard).
+        */
+      int
+      selectWithinDistanceSSE (const Eigen::VectorXf &model_coefficients,
+                               const double threshold,
+                               size_t i,
+                               size_t end,
+                               std::vector<int> &inliers,
+                               int nr_p);
+#endif
+
+#if defined (__AVX__)
+      /** \brief Same as \ref selectWithinDistanceStandard, testing 8 points at a time with AVX (the last
+        * points are handled by \ref selectWithinDistanceSSE).
+        */
+      int
+      selectWithinDistanceAVX (const Eigen::VectorXf &model_coefficients,
+                               const double threshold,
+                               size_t i,
+                               size_t end,
+                               std::vector<int> &inliers,
+                               int nr_p);
+#endif
+
     private:
       /** \brief Temporary pointer to a list of given indices for optimizeModelCoefficients () */
       const std::vector<int> *tmp_inliers_;
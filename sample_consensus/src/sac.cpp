@@ -36,12 +36,15 @@
  */
 
 #include <pcl/sample_consensus/impl/ransac.hpp>
+#include <pcl/sample_consensus/impl/ransac_omp.hpp>
 #include <pcl/sample_consensus/impl/rransac.hpp>
 #include <pcl/sample_consensus/impl/msac.hpp>
+#include <pcl/sample_consensus/impl/msac_omp.hpp>
 #include <pcl/sample_consensus/impl/rmsac.hpp>
 #include <pcl/sample_consensus/impl/prosac.hpp>
 #include <pcl/sample_consensus/impl/mlesac.hpp>
 #include <pcl/sample_consensus/impl/lmeds.hpp>
+#include <pcl/sample_consensus/impl/lmeds_omp.hpp>
 
 #ifndef PCL_NO_PRECOMPILE
 #include <pcl/impl/instantiate.hpp>
@@ -55,6 +58,9 @@
   PCL_INSTANTIATE(ProgressiveSampleConsensus, (pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGBA)(pcl::PointXYZRGB)(pcl::PointXYZRGBNormal))
   PCL_INSTANTIATE(MaximumLikelihoodSampleConsensus, (pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGBA)(pcl::PointXYZRGB)(pcl::PointXYZRGBNormal))
   PCL_INSTANTIATE(LeastMedianSquares, (pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGBA)(pcl::PointXYZRGB)(pcl::PointXYZRGBNormal))
+  PCL_INSTANTIATE(RandomSampleConsensusOMP, (pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGBA)(pcl::PointXYZRGB)(pcl::PointNormal)(pcl::PointXYZRGBNormal))
+  PCL_INSTANTIATE(MEstimatorSampleConsensusOMP, (pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGBA)(pcl::PointXYZRGB)(pcl::PointXYZRGBNormal))
+  PCL_INSTANTIATE(LeastMedianSquaresOMP, (pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGBA)(pcl::PointXYZRGB)(pcl::PointXYZRGBNormal))
 #else
   PCL_INSTANTIATE(RandomSampleConsensus, PCL_XYZ_POINT_TYPES)
   PCL_INSTANTIATE(MEstimatorSampleConsensus, PCL_XYZ_POINT_TYPES)
@@ -63,6 +69,9 @@
   PCL_INSTANTIATE(ProgressiveSampleConsensus, PCL_XYZ_POINT_TYPES)
   PCL_INSTANTIATE(MaximumLikelihoodSampleConsensus, PCL_XYZ_POINT_TYPES)
   PCL_INSTANTIATE(LeastMedianSquares, PCL_XYZ_POINT_TYPES)
+  PCL_INSTANTIATE(RandomSampleConsensusOMP, PCL_XYZ_POINT_TYPES)
+  PCL_INSTANTIATE(MEstimatorSampleConsensusOMP, PCL_XYZ_POINT_TYPES)
+  PCL_INSTANTIATE(LeastMedianSquaresOMP, PCL_XYZ_POINT_TYPES)
 #endif
 #endif    // PCL_NO_PRECOMPILE
 
@@ -0,0 +1,280 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_SEARCH_DYNAMIC_KDTREE_H_
+#define PCL_SEARCH_DYNAMIC_KDTREE_H_
+
+#include <pcl/search/search.h>
+#include <pcl/search/kdtree_3d.h>
+
+namespace pcl
+{
+  namespace search
+  {
+    /** \brief DynamicKdTree is a search structure supporting the insertion and deletion of points, without
+      * rebuilding the index over the whole cloud.
+      *
+      * The points are spread over a logarithmic forest of static \ref KdTree3D trees of decreasing sizes. Inserted
+      * points form a new tree, which absorbs the smaller trees first (as in a binary counter), so a point is
+      * rebuilt O(log n) times over its life. Deleted points are invalidated in place in their tree and skipped at
+      * no cost by the queries; a tree is rebuilt from its remaining points once more than half of them have been
+      * deleted. A query visits all the trees, sharing its current bound between them.
+      *
+      * The points live in an internal cloud, returned by \ref getInputCloud, and the search results are indices in
+      * this cloud. The index of a point stays valid until the point is deleted, after which it may be reused by a
+      * later insertion.
+      *
+      * \ingroup search
+      */
+    template<typename PointT>
+    class DynamicKdTree: public Search<PointT>
+    {
+      public:
+        typedef typename Search<PointT>::PointCloud PointCloud;
+        typedef typename Search<PointT>::PointCloudPtr PointCloudPtr;
+        typedef typename Search<PointT>::PointCloudConstPtr PointCloudConstPtr;
+
+        typedef boost::shared_ptr<std::vector<int> > IndicesPtr;
+        typedef boost::shared_ptr<const std::vector<int> > IndicesConstPtr;
+
+        using pcl::search::Search<PointT>::input_;
+        using pcl::search::Search<PointT>::indices_;
+        using pcl::search::Search<PointT>::sorted_results_;
+        using pcl::search::Search<PointT>::threads_;
+        using pcl::search::Search<PointT>::nearestKSearch;
+        using pcl::search::Search<PointT>::radiusSearch;
+
+        typedef boost::shared_ptr<DynamicKdTree<PointT> > Ptr;
+        typedef boost::shared_ptr<const DynamicKdTree<PointT> > ConstPtr;
+
+        /** \brief Constructor.
+          * \param[in] sorted set to true if the radius search results need to be sorted in ascending order of
+          * their distance to the query point
+          */
+        DynamicKdTree (bool sorted = true);
+
+        /** \brief Destructor. */
+        virtual
+        ~DynamicKdTree ()
+        {
+        }
+
+        /** \brief Replace the content of the tree by the points of \a cloud. The internal cloud is a copy of
+          * \a cloud, so that the search results are indices in \a cloud until points are inserted or deleted.
+          * \param[in] cloud the const boost shared pointer to a PointCloud message
+          * \param[in] indices the point indices subset that is to be used from \a cloud
+          */
+        void
+        setInputCloud (const PointCloudConstPtr& cloud,
+                       const IndicesConstPtr& indices = IndicesConstPtr ());
+
+        /** \brief Insert a point.
+          * \param[in] point the point to insert
+          * \return the index of the point in the internal cloud, or -1 if the point is not finite
+          */
+        int
+        addPoint (const PointT &point);
+
+        /** \brief Insert a batch of points, which is cheaper than inserting them one by one.
+          * \param[in] cloud the points to insert
+          * \param[out] point_indices the index in the internal cloud of every point of \a cloud (-1 for the points
+          * that are not finite)
+          */
+        void
+        addPoints (const PointCloud &cloud, std::vector<int> &point_indices);
+
+        /** \brief Delete a point.
+          * \param[in] index the index of the point in the internal cloud
+          * \return false if \a index does not refer to a point of the tree
+          */
+        bool
+        removePoint (int index);
+
+        /** \brief Delete a batch of points.
+          * \param[in] point_indices the indices of the points in the internal cloud
+          * \return the number of points deleted
+          */
+        int
+        removePoints (const std::vector<int> &point_indices);
+
+        /** \brief Get the number of points in the tree. */
+        inline size_t
+        getNumberOfPoints () const
+        {
+          return (nr_points_);
+        }
+
+        /** \brief Get the number of static trees the points are currently spread over. */
+        inline size_t
+        getNumberOfTrees () const
+        {
+          return (trees_.size ());
+        }
+
+        /** \brief Search for the k-nearest neighbors for the given query point.
+          * \param[in] point the given query point
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \return number of neighbors found
+          */
+        int
+        nearestKSearch (const PointT &point, int k,
+                        std::vector<int> &k_indices,
+                        std::vector<float> &k_sqr_distances) const;
+
+        /** \brief Search for all the nearest neighbors of the query point in a given radius.
+          * \param[in] point the given query point
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value. If \a max_nn is set to
+          * 0 or to a number higher than the number of points in the tree, all neighbors in \a radius will be
+          * returned. Otherwise the \a max_nn closest ones are returned, sorted.
+          * \return number of neighbors found in radius
+          */
+        int
+        radiusSearch (const PointT& point, double radius,
+                      std::vector<int> &k_indices,
+                      std::vector<float> &k_sqr_distances,
+                      unsigned int max_nn = 0) const;
+
+      protected:
+        /** \brief A static tree of the forest, whose points can be invalidated. */
+        class Tree : public KdTree3D<PointT>
+        {
+          public:
+            Tree () : nr_removed_ (0) {}
+
+            /** \brief Add the k-nearest neighbor candidates of this tree to \a result. */
+            inline void
+            searchKnn (const float *query, KnnHeap &result) const
+            {
+              float offsets[3] = {0.0f, 0.0f, 0.0f};
+              KdTree3D<PointT>::searchKnn (1, query, offsets, 0.0f, result);
+            }
+
+            /** \brief Append the points of this tree closer than \a sqr_radius. */
+            inline void
+            searchRadius (const float *query, float sqr_radius,
+                          std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
+            {
+              float offsets[3] = {0.0f, 0.0f, 0.0f};
+              KdTree3D<PointT>::searchRadius (1, query, offsets, 0.0f, sqr_radius, k_indices, k_sqr_distances);
+            }
+
+            /** \brief Invalidate the point stored at \a position, so that no query returns it anymore. */
+            void
+            removeAt (int position);
+
+            /** \brief The number of points the tree was built with. */
+            inline int
+            size () const
+            {
+              return (static_cast<int> (this->point_indices_.size ()));
+            }
+
+            /** \brief The index in the internal cloud of every point of the tree, in storage order. */
+            inline const std::vector<int>&
+            getPointIndices () const
+            {
+              return (this->point_indices_);
+            }
+
+            /** \brief The number of points deleted since the tree was built. */
+            int nr_removed_;
+        };
+
+        typedef boost::shared_ptr<Tree> TreePtr;
+
+        /** \brief Allocate an index of the internal cloud for a new point. */
+        int
+        allocateSlot (const PointT &point);
+
+        /** \brief Build a tree over \a point_indices, after merging the smaller trees into it. */
+        void
+        insertTree (std::vector<int> &point_indices);
+
+        /** \brief Build a tree over \a point_indices, and register it as the owner of these points. */
+        TreePtr
+        buildTree (const std::vector<int> &point_indices);
+
+        /** \brief Release a tree: append its remaining points to \a point_indices, and free the indices of its
+          * deleted points.
+          */
+        void
+        releaseTree (const Tree &tree, std::vector<int> &point_indices);
+
+        /** \brief Keep the trees sorted by decreasing size. */
+        void
+        sortTrees ();
+
+        /** \brief Orders trees by decreasing size. */
+        static bool
+        compareTreeSize (const TreePtr &a, const TreePtr &b)
+        {
+          return (a->size () > b->size ());
+        }
+
+        /** \brief The internal cloud holding the points. */
+        PointCloudPtr cloud_;
+
+        /** \brief The static trees, by decreasing size. */
+        std::vector<TreePtr> trees_;
+
+        /** \brief The tree holding every index of the internal cloud (NULL for free indices). */
+        std::vector<Tree*> owner_;
+
+        /** \brief The position of every index of the internal cloud in its tree. */
+        std::vector<int> position_;
+
+        /** \brief The indices of the internal cloud which can be reused. */
+        std::vector<int> free_slots_;
+
+        /** \brief The number of points in the tree. */
+        size_t nr_points_;
+    };
+  }
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/search/impl/dynamic_kdtree.hpp>
+#endif
+
+#endif    // PCL_SEARCH_DYNAMIC_KDTREE_H_
@@ -39,295 +39,313 @@
 #define PCL_SEARCH_IMPL_BRUTE_FORCE_SEARCH_H_
 
 #include <pcl/search/brute_force.h>
-#include <queue>
+#include <algorithm>
+#include <limits>
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename PointT> float
-pcl::search::BruteForce<PointT>::getDistSqr (
-    const PointT& point1, const PointT& point2) const
+template <typename PointT> void
+pcl::search::BruteForce<PointT>::setInputCloud (
+    const PointCloudConstPtr& cloud, const IndicesConstPtr& indices)
 {
-  return (point1.getVector3fMap () - point2.getVector3fMap ()).squaredNorm ();
+  input_ = cloud;
+  indices_ = indices;
+
+  const size_t nr_input = indices != NULL ? indices->size () : cloud->points.size ();
+  x_.clear ();
+  y_.clear ();
+  z_.clear ();
+  point_indices_.clear ();
+  x_.reserve (nr_input);
+  y_.reserve (nr_input);
+  z_.reserve (nr_input);
+  point_indices_.reserve (nr_input);
+  for (size_t i = 0; i < nr_input; ++i)
+  {
+    const int index = indices != NULL ? (*indices)[i] : static_cast<int> (i);
+    const PointT &point = cloud->points[index];
+    if (!cloud->is_dense && !isFinite (point))
+      continue;
+    x_.push_back (point.x);
+    y_.push_back (point.y);
+    z_.push_back (point.z);
+    point_indices_.push_back (index);
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> int
-pcl::search::BruteForce<PointT>::nearestKSearch (
-    const PointT& point, int k, std::vector<int>& k_indices, std::vector<float>& k_distances) const
+pcl::search::BruteForce<PointT>::getTargetTileSize ()
 {
-  assert (isFinite (point) && "Invalid (NaN, Inf) point coordinates given to nearestKSearch!");
-  
-  k_indices.clear ();
-  k_distances.clear ();
-  if (k < 1)
-    return 0;
-
-  if (input_->is_dense)
-    return denseKSearch (point, k, k_indices, k_distances);
-  else
-    return sparseKSearch (point, k, k_indices, k_distances);
+  // A multiple of the widest SIMD width
+  return (L1_CACHE_SIZE / 2 / (3 * static_cast<int> (sizeof (float))) / 8 * 8);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> int
-pcl::search::BruteForce<PointT>::denseKSearch (
-    const PointT &point, int k, std::vector<int> &k_indices, std::vector<float> &k_distances) const
+pcl::search::BruteForce<PointT>::getQueryTileSize (int k)
 {
-  // container for first k elements -> O(1) for insertion, since order not required here
-  std::vector<Entry> result;
-  result.reserve (k);
-  std::priority_queue<Entry> queue;
-  if (indices_ != NULL)
-  {
-    std::vector<int>::const_iterator iIt =indices_->begin ();
-    std::vector<int>::const_iterator iEnd = indices_->begin () + std::min (static_cast<unsigned> (k), static_cast<unsigned> (indices_->size ()));
-    for (; iIt != iEnd; ++iIt)
-      result.push_back (Entry (*iIt, getDistSqr (input_->points[*iIt], point)));
-
-    queue = std::priority_queue<Entry> (result.begin (), result.end ());
+  const int candidate_size = static_cast<int> (sizeof (int) + sizeof (float));
+  const int size = L2_CACHE_SIZE / 2 / (std::max (k, 1) * candidate_size);
+  return (std::max (1, std::min (size, 256)));
+}
 
-    // add the rest
-    Entry entry;
-    for (; iIt != indices_->end (); ++iIt)
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::BruteForce<PointT>::scanNearestK (
+    const float *query, int begin, int end, KnnHeap &heap) const
+{
+  int i = begin;
+#if defined (__AVX__)
+  {
+    const __m256 qx = _mm256_set1_ps (query[0]);
+    const __m256 qy = _mm256_set1_ps (query[1]);
+    const __m256 qz = _mm256_set1_ps (query[2]);
+    __m256 worst = _mm256_set1_ps (heap.worst ());
+    for (; i + 8 <= end; i += 8)
     {
-      entry.distance = getDistSqr (input_->points[*iIt], point);
-      if (queue.top ().distance > entry.distance)
-      {
-        entry.index = *iIt;
-        queue.pop ();
-        queue.push (entry);
-      }
+      const __m256 dx = _mm256_sub_ps (_mm256_loadu_ps (&x_[i]), qx);
+      const __m256 dy = _mm256_sub_ps (_mm256_loadu_ps (&y_[i]), qy);
+      const __m256 dz = _mm256_sub_ps (_mm256_loadu_ps (&z_[i]), qz);
+      const __m256 sqr_dist = _mm256_add_ps (_mm256_mul_ps (dx, dx),
+                                             _mm256_add_ps (_mm256_mul_ps (dy, dy), _mm256_mul_ps (dz, dz)));
+      if (_mm256_movemask_ps (_mm256_cmp_ps (sqr_dist, worst, _CMP_LT_OQ)) == 0)
+        continue;
+
+      // At least one of the points beats the worst candidate, offer them one by one
+      float distances[8];
+      _mm256_storeu_ps (distances, sqr_dist);
+      for (int j = 0; j < 8; ++j)
+        if (distances[j] < heap.worst ())
+          heap.add (distances[j], point_indices_[i + j]);
+      worst = _mm256_set1_ps (heap.worst ());
     }
   }
-  else
+#endif
+#if defined (__SSE2__)
   {
-    Entry entry;
-    for (entry.index = 0; entry.index < std::min (static_cast<unsigned> (k), static_cast<unsigned> (input_->size ())); ++entry.index)
+    const __m128 qx = _mm_set1_ps (query[0]);
+    const __m128 qy = _mm_set1_ps (query[1]);
+    const __m128 qz = _mm_set1_ps (query[2]);
+    __m128 worst = _mm_set1_ps (heap.worst ());
+    for (; i + 4 <= end; i += 4)
     {
-      entry.distance = getDistSqr (input_->points[entry.index], point);
-      result.push_back (entry);
-    }
-
-    queue = std::priority_queue<Entry> (result.begin (), result.end ());
+      const __m128 dx = _mm_sub_ps (_mm_loadu_ps (&x_[i]), qx);
+      const __m128 dy = _mm_sub_ps (_mm_loadu_ps (&y_[i]), qy);
+      const __m128 dz = _mm_sub_ps (_mm_loadu_ps (&z_[i]), qz);
+      const __m128 sqr_dist = _mm_add_ps (_mm_mul_ps (dx, dx), _mm_add_ps (_mm_mul_ps (dy, dy), _mm_mul_ps (dz, dz)));
+      if (_mm_movemask_ps (_mm_cmplt_ps (sqr_dist, worst)) == 0)
+        continue;
 
-    // add the rest
-    for (; entry.index < input_->size (); ++entry.index)
-    {
-      entry.distance = getDistSqr (input_->points[entry.index], point);
-      if (queue.top ().distance > entry.distance)
-      {
-        queue.pop ();
-        queue.push (entry);
-      }      
+      float distances[4];
+      _mm_storeu_ps (distances, sqr_dist);
+      for (int j = 0; j < 4; ++j)
+        if (distances[j] < heap.worst ())
+          heap.add (distances[j], point_indices_[i + j]);
+      worst = _mm_set1_ps (heap.worst ());
     }
   }
-
-  k_indices.resize (queue.size ());
-  k_distances.resize (queue.size ());
-  size_t idx = queue.size () - 1;
-  while (!queue.empty ())
+#endif
+  for (; i < end; ++i)
   {
-    k_indices [idx] = queue.top ().index;
-    k_distances [idx] = queue.top ().distance;
-    queue.pop ();
-    --idx;
+    const float dx = x_[i] - query[0];
+    const float dy = y_[i] - query[1];
+    const float dz = z_[i] - query[2];
+    const float sqr_dist = dx * dx + (dy * dy + dz * dz);
+    if (sqr_dist < heap.worst ())
+      heap.add (sqr_dist, point_indices_[i]);
   }
-  
-  return (static_cast<int> (k_indices.size ()));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename PointT> int
-pcl::search::BruteForce<PointT>::sparseKSearch (
-    const PointT &point, int k, std::vector<int> &k_indices, std::vector<float> &k_distances) const
+template <typename PointT> bool
+pcl::search::BruteForce<PointT>::scanRadius (
+    const float *query, int begin, int end, double sqr_radius, size_t max_nn,
+    std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
 {
-  // result used to collect the first k neighbors -> unordered
-  std::vector<Entry> result;
-  result.reserve (k);
-  
-  std::priority_queue<Entry> queue;
-  if (indices_ != NULL)
+  // Every float distance within sqr_radius is also within its rounded float value, candidates that pass the
+  // SIMD test are checked exactly against sqr_radius. The squared distances are summed in the same order as
+  // Eigen's squaredNorm ().
+  int i = begin;
+#if defined (__AVX__)
   {
-    std::vector<int>::const_iterator iIt =indices_->begin ();
-    for (; iIt != indices_->end () && result.size () < static_cast<unsigned> (k); ++iIt)
-    {
-      if (pcl_isfinite (input_->points[*iIt].x))
-        result.push_back (Entry (*iIt, getDistSqr (input_->points[*iIt], point)));
-    }
-    
-    queue = std::priority_queue<Entry> (result.begin (), result.end ());
-
-    // either we have k elements, or there are none left to iterate >in either case we're fine
-    // add the rest
-    Entry entry;
-    for (; iIt != indices_->end (); ++iIt)
+    const __m256 qx = _mm256_set1_ps (query[0]);
+    const __m256 qy = _mm256_set1_ps (query[1]);
+    const __m256 qz = _mm256_set1_ps (query[2]);
+    const __m256 threshold = _mm256_set1_ps (static_cast<float> (sqr_radius));
+    for (; i + 8 <= end; i += 8)
     {
-      if (!pcl_isfinite (input_->points[*iIt].x))
+      const __m256 dx = _mm256_sub_ps (_mm256_loadu_ps (&x_[i]), qx);
+      const __m256 dy = _mm256_sub_ps (_mm256_loadu_ps (&y_[i]), qy);
+      const __m256 dz = _mm256_sub_ps (_mm256_loadu_ps (&z_[i]), qz);
+      const __m256 sqr_dist = _mm256_add_ps (_mm256_mul_ps (dx, dx),
+                                             _mm256_add_ps (_mm256_mul_ps (dy, dy), _mm256_mul_ps (dz, dz)));
+      if (_mm256_movemask_ps (_mm256_cmp_ps (sqr_dist, threshold, _CMP_LE_OQ)) == 0)
         continue;
 
-      entry.distance = getDistSqr (input_->points[*iIt], point);
-      if (queue.top ().distance > entry.distance)
+      float distances[8];
+      _mm256_storeu_ps (distances, sqr_dist);
+      for (int j = 0; j < 8; ++j)
       {
-        entry.index = *iIt;
-        queue.pop ();
-        queue.push (entry);
+        if (distances[j] > sqr_radius)
+          continue;
+        k_indices.push_back (point_indices_[i + j]);
+        k_sqr_distances.push_back (distances[j]);
+        if (k_indices.size () == max_nn) // never true if max_nn = 0
+          return (true);
       }
     }
   }
-  else
+#endif
+#if defined (__SSE2__)
   {
-    Entry entry;
-    for (entry.index = 0; entry.index < input_->size () && result.size () < static_cast<unsigned> (k); ++entry.index)
+    const __m128 qx = _mm_set1_ps (query[0]);
+    const __m128 qy = _mm_set1_ps (query[1]);
+    const __m128 qz = _mm_set1_ps (query[2]);
+    const __m128 threshold = _mm_set1_ps (static_cast<float> (sqr_radius));
+    for (; i + 4 <= end; i += 4)
     {
-      if (pcl_isfinite (input_->points[entry.index].x))
-      {
-        entry.distance = getDistSqr (input_->points[entry.index], point);
-        result.push_back (entry);
-      }
-    }
-    queue = std::priority_queue<Entry> (result.begin (), result.end ());
-    
-    // add the rest
-    for (; entry.index < input_->size (); ++entry.index)
-    {
-      if (!pcl_isfinite (input_->points[entry.index].x))
+      const __m128 dx = _mm_sub_ps (_mm_loadu_ps (&x_[i]), qx);
+      const __m128 dy = _mm_sub_ps (_mm_loadu_ps (&y_[i]), qy);
+      const __m128 dz = _mm_sub_ps (_mm_loadu_ps (&z_[i]), qz);
+      const __m128 sqr_dist = _mm_add_ps (_mm_mul_ps (dx, dx), _mm_add_ps (_mm_mul_ps (dy, dy), _mm_mul_ps (dz, dz)));
+      if (_mm_movemask_ps (_mm_cmple_ps (sqr_dist, threshold)) == 0)
         continue;
 
-      entry.distance = getDistSqr (input_->points[entry.index], point);
-      if (queue.top ().distance > entry.distance)
+      float distances[4];
+      _mm_storeu_ps (distances, sqr_dist);
+      for (int j = 0; j < 4; ++j)
       {
-        queue.pop ();
-        queue.push (entry);
+        if (distances[j] > sqr_radius)
+          continue;
+        k_indices.push_back (point_indices_[i + j]);
+        k_sqr_distances.push_back (distances[j]);
+        if (k_indices.size () == max_nn) // never true if max_nn = 0
+          return (true);
       }
     }
   }
-  
-  k_indices.resize (queue.size ());
-  k_distances.resize (queue.size ());
-  size_t idx = queue.size () - 1;
-  while (!queue.empty ())
+#endif
+  for (; i < end; ++i)
   {
-    k_indices [idx] = queue.top ().index;
-    k_distances [idx] = queue.top ().distance;
-    queue.pop ();
-    --idx;
+    const float dx = x_[i] - query[0];
+    const float dy = y_[i] - query[1];
+    const float dz = z_[i] - query[2];
+    const float sqr_dist = dx * dx + (dy * dy + dz * dz);
+    if (sqr_dist > sqr_radius)
+      continue;
+    k_indices.push_back (point_indices_[i]);
+    k_sqr_distances.push_back (sqr_dist);
+    if (k_indices.size () == max_nn) // never true if max_nn = 0
+      return (true);
   }
-  return (static_cast<int> (k_indices.size ()));
+  return (false);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> int
-pcl::search::BruteForce<PointT>::denseRadiusSearch (
-    const PointT& point, double radius,
-    std::vector<int> &k_indices, std::vector<float> &k_sqr_distances,
-    unsigned int max_nn) const
-{  
-  radius *= radius;
-
-  size_t reserve = max_nn;
-  if (reserve == 0)
-  {
-    if (indices_ != NULL)
-      reserve = std::min (indices_->size (), input_->size ());
-    else
-      reserve = input_->size ();
-  }
-  k_indices.reserve (reserve);
-  k_sqr_distances.reserve (reserve);
-  float distance;
-  if (indices_ != NULL)
-  {
-    for (std::vector<int>::const_iterator iIt =indices_->begin (); iIt != indices_->end (); ++iIt)
-    {
-      distance = getDistSqr (input_->points[*iIt], point);
-      if (distance <= radius)
-      {
-        k_indices.push_back (*iIt);
-        k_sqr_distances.push_back (distance);
-        if (k_indices.size () == max_nn) // max_nn = 0 -> never true
-          break;
-      }
-    }
-  }
-  else
-  {
-    for (unsigned index = 0; index < input_->size (); ++index)
-    {
-      distance = getDistSqr (input_->points[index], point);
-      if (distance <= radius)
-      {
-        k_indices.push_back (index);
-        k_sqr_distances.push_back (distance);
-        if (k_indices.size () == max_nn) // never true if max_nn = 0
-          break;
-      }
-    }
-  }
-
-  if (sorted_results_)
-    this->sortResults (k_indices, k_sqr_distances);
+pcl::search::BruteForce<PointT>::nearestKSearch (
+    const PointT& point, int k, std::vector<int>& k_indices, std::vector<float>& k_distances) const
+{
+  assert (isFinite (point) && "Invalid (NaN, Inf) point coordinates given to nearestKSearch!");
   
-  return (static_cast<int> (k_indices.size ()));
+  k_indices.clear ();
+  k_distances.clear ();
+  if (k < 1)
+    return 0;
+
+  const int nr_points = static_cast<int> (point_indices_.size ());
+  k = std::min (k, nr_points);
+  k_indices.resize (k);
+  k_distances.resize (k);
+  if (k == 0)
+    return 0;
+
+  const float query[3] = { point.x, point.y, point.z };
+  KnnHeap heap (&k_indices[0], &k_distances[0], k, std::numeric_limits<float>::max ());
+  scanNearestK (query, 0, nr_points, heap);
+  heap.sort ();
+  k_indices.resize (heap.size ());
+  k_distances.resize (heap.size ());
+  return (heap.size ());
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename PointT> int
-pcl::search::BruteForce<PointT>::sparseRadiusSearch (
-    const PointT& point, double radius,
-    std::vector<int> &k_indices, std::vector<float> &k_sqr_distances,
-    unsigned int max_nn) const
+template <typename PointT> void
+pcl::search::BruteForce<PointT>::batchNearestKSearch (
+    const PointCloud &cloud, const std::vector<int> &indices, int k,
+    std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
 {
-  radius *= radius;
+  const int nr_queries = static_cast<int> (indices.empty () ? cloud.points.size () : indices.size ());
+  if (k < 0)
+    k = 0;
+  k_indices.resize (static_cast<size_t> (nr_queries) * k);
+  k_sqr_distances.resize (static_cast<size_t> (nr_queries) * k);
+  if (k == 0)
+    return;
 
-  size_t reserve = max_nn;
-  if (reserve == 0)
-  {
-    if (indices_ != NULL)
-      reserve = std::min (indices_->size (), input_->size ());
-    else
-      reserve = input_->size ();
-  }
-  k_indices.reserve (reserve);
-  k_sqr_distances.reserve (reserve);
+  const int nr_points = static_cast<int> (point_indices_.size ());
+  const int nr_threads = getBatchThreads ();
+  const int target_tile = getTargetTileSize ();
+  // Keep a few tiles per thread for the load balancing
+  const int query_tile = std::max (1, std::min (getQueryTileSize (k), nr_queries / (4 * nr_threads)));
+  const int nr_query_tiles = (nr_queries + query_tile - 1) / query_tile;
 
-  float distance;
-  if (indices_ != NULL)
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
   {
-    for (std::vector<int>::const_iterator iIt =indices_->begin (); iIt != indices_->end (); ++iIt)
+    // The candidates of the tile's query points are kept in place in their output rows
+    std::vector<KnnHeap> heaps;
+    std::vector<float> queries;
+    std::vector<char> valid;
+    heaps.reserve (query_tile);
+    queries.reserve (3 * query_tile);
+    valid.reserve (query_tile);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+    for (int tile = 0; tile < nr_query_tiles; ++tile)
     {
-      if (!pcl_isfinite (input_->points[*iIt].x))
-        continue;
+      const int begin = tile * query_tile;
+      const int end = std::min (begin + query_tile, nr_queries);
+      heaps.clear ();
+      queries.clear ();
+      valid.clear ();
+      for (int i = begin; i < end; ++i)
+      {
+        const PointT &point = cloud.points[indices.empty () ? i : indices[i]];
+        const size_t row = static_cast<size_t> (i) * k;
+        heaps.push_back (KnnHeap (&k_indices[row], &k_sqr_distances[row], k, std::numeric_limits<float>::max ()));
+        // A query point that is not finite has no neighbor
+        valid.push_back (isFinite (point));
+        queries.push_back (point.x);
+        queries.push_back (point.y);
+        queries.push_back (point.z);
+      }
 
-      distance = getDistSqr (input_->points[*iIt], point);
-      if (distance <= radius)
+      // Every tile of input points is compared to all the query points of the tile while it is in the L1 cache
+      for (int target_begin = 0; target_begin < nr_points; target_begin += target_tile)
       {
-        k_indices.push_back (*iIt);
-        k_sqr_distances.push_back (distance);
-        if (k_indices.size () == max_nn) // never true if max_nn = 0
-          break;
+        const int target_end = std::min (target_begin + target_tile, nr_points);
+        for (size_t q = 0; q < heaps.size (); ++q)
+          if (valid[q])
+            scanNearestK (&queries[3 * q], target_begin, target_end, heaps[q]);
       }
-    }
-  }
-  else
-  {
-    for (unsigned index = 0; index < input_->size (); ++index)
-    {
-      if (!pcl_isfinite (input_->points[index].x))
-        continue;
-      distance = getDistSqr (input_->points[index], point);
-      if (distance <= radius)
+
+      for (int i = begin; i < end; ++i)
       {
-        k_indices.push_back (index);
-        k_sqr_distances.push_back (distance);
-        if (k_indices.size () == max_nn) // never true if max_nn = 0
-          break;
+        KnnHeap &heap = heaps[i - begin];
+        heap.sort ();
+        const size_t row = static_cast<size_t> (i) * k;
+        for (int j = heap.size (); j < k; ++j)
+        {
+          k_indices[row + j] = -1;
+          k_sqr_distances[row + j] = std::numeric_limits<float>::max ();
+        }
       }
     }
   }
-
-  if (sorted_results_)
-    this->sortResults (k_indices, k_sqr_distances);
-
-  return (static_cast<int> (k_indices.size ()));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -343,10 +361,101 @@ pcl::search::BruteForce<PointT>::radiusSearch (
   if (radius <= 0)
     return 0;
 
-  if (input_->is_dense)
-    return denseRadiusSearch (point, radius, k_indices, k_sqr_distances, max_nn);
-  else
-    return sparseRadiusSearch (point, radius, k_indices, k_sqr_distances, max_nn);
+  const float query[3] = { point.x, point.y, point.z };
+  scanRadius (query, 0, static_cast<int> (point_indices_.size ()), radius * radius, max_nn,
+              k_indices, k_sqr_distances);
+
+  if (sorted_results_)
+    this->sortResults (k_indices, k_sqr_distances);
+  
+  return (static_cast<int> (k_indices.size ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::BruteForce<PointT>::batchRadiusSearch (
+    const PointCloud &cloud, const std::vector<int> &indices, double radius,
+    std::vector<size_t> &offsets, std::vector<int> &k_indices,
+    std::vector<float> &k_sqr_distances, unsigned int max_nn) const
+{
+  const int nr_queries = static_cast<int> (indices.empty () ? cloud.points.size () : indices.size ());
+  const int nr_blocks = getBatchThreads ();
+  const int nr_points = static_cast<int> (point_indices_.size ());
+  const int target_tile = getTargetTileSize ();
+  const int query_tile = getQueryTileSize (1);
+  const double sqr_radius = radius * radius;
+
+  // Every block of queries is answered into its own buffers, which are copied to their final place once the
+  // number of neighbors of every query point is known
+  std::vector<std::vector<int> > block_indices (nr_blocks);
+  std::vector<std::vector<float> > block_dists (nr_blocks);
+  offsets.resize (nr_queries + 1);
+  offsets[0] = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nr_blocks)
+#endif
+  for (int block = 0; block < nr_blocks; ++block)
+  {
+    const int block_begin = static_cast<int> (static_cast<long long> (nr_queries) * block / nr_blocks);
+    const int block_end = static_cast<int> (static_cast<long long> (nr_queries) * (block + 1) / nr_blocks);
+    std::vector<std::vector<int> > nn_indices (query_tile);
+    std::vector<std::vector<float> > nn_dists (query_tile);
+    std::vector<char> done (query_tile);
+    std::vector<float> queries (3 * query_tile);
+
+    for (int begin = block_begin; begin < block_end; begin += query_tile)
+    {
+      const int end = std::min (begin + query_tile, block_end);
+      for (int i = begin; i < end; ++i)
+      {
+        const PointT &point = cloud.points[indices.empty () ? i : indices[i]];
+        const int q = i - begin;
+        nn_indices[q].clear ();
+        nn_dists[q].clear ();
+        done[q] = radius <= 0 || !isFinite (point);
+        queries[3 * q + 0] = point.x;
+        queries[3 * q + 1] = point.y;
+        queries[3 * q + 2] = point.z;
+      }
+
+      // The input points are visited in order by every query point, max_nn keeps the first neighbors found
+      for (int target_begin = 0; target_begin < nr_points; target_begin += target_tile)
+      {
+        const int target_end = std::min (target_begin + target_tile, nr_points);
+        for (int q = 0; q < end - begin; ++q)
+          if (!done[q])
+            done[q] = scanRadius (&queries[3 * q], target_begin, target_end, sqr_radius, max_nn,
+                                  nn_indices[q], nn_dists[q]);
+      }
+
+      for (int i = begin; i < end; ++i)
+      {
+        const int q = i - begin;
+        if (sorted_results_)
+          this->sortResults (nn_indices[q], nn_dists[q]);
+        block_indices[block].insert (block_indices[block].end (), nn_indices[q].begin (), nn_indices[q].end ());
+        block_dists[block].insert (block_dists[block].end (), nn_dists[q].begin (), nn_dists[q].end ());
+        // Store the count for now, the offsets are accumulated below
+        offsets[i + 1] = nn_indices[q].size ();
+      }
+    }
+  }
+
+  for (int i = 0; i < nr_queries; ++i)
+    offsets[i + 1] += offsets[i];
+  k_indices.resize (offsets[nr_queries]);
+  k_sqr_distances.resize (offsets[nr_queries]);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nr_blocks)
+#endif
+  for (int block = 0; block < nr_blocks; ++block)
+  {
+    const int begin = static_cast<int> (static_cast<long long> (nr_queries) * block / nr_blocks);
+    std::copy (block_indices[block].begin (), block_indices[block].end (), k_indices.begin () + offsets[begin]);
+    std::copy (block_dists[block].begin (), block_dists[block].end (), k_sqr_distances.begin () + offsets[begin]);
+  }
 }
 
 #define PCL_INSTANTIATE_BruteForce(T) template class PCL_EXPORTS pcl::search::BruteForce<T>;
@@ -0,0 +1,344 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_SEARCH_IMPL_DYNAMIC_KDTREE_H_
+#define PCL_SEARCH_IMPL_DYNAMIC_KDTREE_H_
+
+#include <pcl/search/dynamic_kdtree.h>
+#include <pcl/search/impl/kdtree_3d.hpp>
+#include <algorithm>
+#include <limits>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT>
+pcl::search::DynamicKdTree<PointT>::DynamicKdTree (bool sorted)
+  : Search<PointT> ("DynamicKdTree", sorted)
+  , cloud_ (new PointCloud ())
+  , trees_ ()
+  , owner_ ()
+  , position_ ()
+  , free_slots_ ()
+  , nr_points_ (0)
+{
+  input_ = cloud_;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::DynamicKdTree<PointT>::setInputCloud (
+    const PointCloudConstPtr& cloud, const IndicesConstPtr& indices)
+{
+  cloud_.reset (new PointCloud (*cloud));
+  input_ = cloud_;
+  // The tree grows past the given subset, so the results are always indices in the internal cloud
+  indices_.reset ();
+
+  trees_.clear ();
+  owner_.assign (cloud_->points.size (), NULL);
+  position_.assign (cloud_->points.size (), -1);
+  free_slots_.clear ();
+
+  std::vector<int> point_indices;
+  if (indices != NULL)
+  {
+    std::vector<bool> used (cloud_->points.size (), false);
+    for (size_t i = 0; i < indices->size (); ++i)
+    {
+      const int index = (*indices)[i];
+      if (!used[index] && isFinite (cloud_->points[index]))
+      {
+        used[index] = true;
+        point_indices.push_back (index);
+      }
+    }
+    for (int i = static_cast<int> (used.size ()) - 1; i >= 0; --i)
+      if (!used[i])
+        free_slots_.push_back (i);
+  }
+  else
+  {
+    for (int i = static_cast<int> (cloud_->points.size ()) - 1; i >= 0; --i)
+      if (!isFinite (cloud_->points[i]))
+        free_slots_.push_back (i);
+    point_indices.reserve (cloud_->points.size () - free_slots_.size ());
+    for (int i = 0; i < static_cast<int> (cloud_->points.size ()); ++i)
+      if (isFinite (cloud_->points[i]))
+        point_indices.push_back (i);
+  }
+
+  nr_points_ = point_indices.size ();
+  if (!point_indices.empty ())
+    trees_.push_back (buildTree (point_indices));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::DynamicKdTree<PointT>::addPoint (const PointT &point)
+{
+  if (!isFinite (point))
+    return (-1);
+  std::vector<int> point_indices (1, allocateSlot (point));
+  const int index = point_indices[0];
+  ++nr_points_;
+  insertTree (point_indices);
+  return (index);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::DynamicKdTree<PointT>::addPoints (const PointCloud &cloud, std::vector<int> &point_indices)
+{
+  point_indices.resize (cloud.points.size ());
+  std::vector<int> new_indices;
+  new_indices.reserve (cloud.points.size ());
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    if (!isFinite (cloud.points[i]))
+    {
+      point_indices[i] = -1;
+      continue;
+    }
+    point_indices[i] = allocateSlot (cloud.points[i]);
+    new_indices.push_back (point_indices[i]);
+  }
+  nr_points_ += new_indices.size ();
+  insertTree (new_indices);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::search::DynamicKdTree<PointT>::removePoint (int index)
+{
+  if (index < 0 || index >= static_cast<int> (owner_.size ()) || owner_[index] == NULL || position_[index] < 0)
+    return (false);
+
+  Tree *tree = owner_[index];
+  tree->removeAt (position_[index]);
+  // The index stays owned by the tree until it is rebuilt, so that it is not reused while still stored in it
+  position_[index] = -1;
+  --nr_points_;
+
+  if (tree->nr_removed_ * 2 > tree->size ())
+  {
+    std::vector<int> remaining;
+    releaseTree (*tree, remaining);
+    for (size_t i = 0; i < trees_.size (); ++i)
+    {
+      if (trees_[i].get () == tree)
+      {
+        trees_.erase (trees_.begin () + i);
+        break;
+      }
+    }
+    if (!remaining.empty ())
+      trees_.push_back (buildTree (remaining));
+    sortTrees ();
+  }
+  return (true);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::DynamicKdTree<PointT>::removePoints (const std::vector<int> &point_indices)
+{
+  int nr_removed = 0;
+  for (size_t i = 0; i < point_indices.size (); ++i)
+    if (removePoint (point_indices[i]))
+      ++nr_removed;
+  return (nr_removed);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::DynamicKdTree<PointT>::nearestKSearch (
+    const PointT &point, int k, std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
+{
+  if (k > static_cast<int> (nr_points_))
+    k = static_cast<int> (nr_points_);
+  if (k <= 0 || !isFinite (point))
+  {
+    k_indices.clear ();
+    k_sqr_distances.clear ();
+    return (0);
+  }
+
+  k_indices.resize (k);
+  k_sqr_distances.resize (k);
+  const float query[3] = {point.x, point.y, point.z};
+  KnnHeap result (&k_indices[0], &k_sqr_distances[0], k, std::numeric_limits<float>::max ());
+  // The largest tree comes first and gives the others a tight bound
+  for (size_t i = 0; i < trees_.size (); ++i)
+    trees_[i]->searchKnn (query, result);
+  result.sort ();
+  return (k);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::DynamicKdTree<PointT>::radiusSearch (
+    const PointT& point, double radius, std::vector<int> &k_indices,
+    std::vector<float> &k_sqr_distances, unsigned int max_nn) const
+{
+  k_indices.clear ();
+  k_sqr_distances.clear ();
+  if (nr_points_ == 0 || !isFinite (point))
+    return (0);
+
+  const float query[3] = {point.x, point.y, point.z};
+  const float sqr_radius = static_cast<float> (radius * radius);
+
+  if (max_nn > 0 && max_nn < nr_points_)
+  {
+    k_indices.resize (max_nn);
+    k_sqr_distances.resize (max_nn);
+    KnnHeap result (&k_indices[0], &k_sqr_distances[0], static_cast<int> (max_nn), sqr_radius);
+    for (size_t i = 0; i < trees_.size (); ++i)
+      trees_[i]->searchKnn (query, result);
+    result.sort ();
+    k_indices.resize (result.size ());
+    k_sqr_distances.resize (result.size ());
+    return (result.size ());
+  }
+
+  for (size_t i = 0; i < trees_.size (); ++i)
+    trees_[i]->searchRadius (query, sqr_radius, k_indices, k_sqr_distances);
+
+  if (sorted_results_ && k_indices.size () > 1)
+  {
+    std::vector<std::pair<float, int> > sorted (k_indices.size ());
+    for (size_t i = 0; i < k_indices.size (); ++i)
+      sorted[i] = std::make_pair (k_sqr_distances[i], k_indices[i]);
+    std::sort (sorted.begin (), sorted.end ());
+    for (size_t i = 0; i < k_indices.size (); ++i)
+    {
+      k_sqr_distances[i] = sorted[i].first;
+      k_indices[i] = sorted[i].second;
+    }
+  }
+  return (static_cast<int> (k_indices.size ()));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::DynamicKdTree<PointT>::allocateSlot (const PointT &point)
+{
+  if (!free_slots_.empty ())
+  {
+    const int index = free_slots_.back ();
+    free_slots_.pop_back ();
+    cloud_->points[index] = point;
+    return (index);
+  }
+  cloud_->push_back (point);
+  owner_.push_back (NULL);
+  position_.push_back (-1);
+  return (static_cast<int> (cloud_->points.size ()) - 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::DynamicKdTree<PointT>::insertTree (std::vector<int> &point_indices)
+{
+  // Absorb all the trees which are not larger than the new one, like the carry of a binary counter
+  while (!trees_.empty () && trees_.back ()->size () <= static_cast<int> (point_indices.size ()))
+  {
+    releaseTree (*trees_.back (), point_indices);
+    trees_.pop_back ();
+  }
+  if (!point_indices.empty ())
+    trees_.push_back (buildTree (point_indices));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> typename pcl::search::DynamicKdTree<PointT>::TreePtr
+pcl::search::DynamicKdTree<PointT>::buildTree (const std::vector<int> &point_indices)
+{
+  TreePtr tree (new Tree ());
+  tree->setNumberOfThreads (threads_);
+  tree->setInputCloud (cloud_, IndicesConstPtr (new std::vector<int> (point_indices)));
+
+  const std::vector<int> &stored = tree->getPointIndices ();
+  for (int position = 0; position < static_cast<int> (stored.size ()); ++position)
+  {
+    owner_[stored[position]] = tree.get ();
+    position_[stored[position]] = position;
+  }
+  return (tree);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::DynamicKdTree<PointT>::releaseTree (const Tree &tree, std::vector<int> &point_indices)
+{
+  const std::vector<int> &stored = tree.getPointIndices ();
+  for (size_t i = 0; i < stored.size (); ++i)
+  {
+    const int index = stored[i];
+    if (position_[index] >= 0)
+      point_indices.push_back (index);
+    else
+    {
+      owner_[index] = NULL;
+      free_slots_.push_back (index);
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::DynamicKdTree<PointT>::sortTrees ()
+{
+  std::sort (trees_.begin (), trees_.end (), compareTreeSize);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::DynamicKdTree<PointT>::Tree::removeAt (int position)
+{
+  const float nan = std::numeric_limits<float>::quiet_NaN ();
+  // A NaN coordinate fails every distance comparison of the leaf scans
+  this->x_[position] = nan;
+  this->y_[position] = nan;
+  this->z_[position] = nan;
+  ++nr_removed_;
+}
+
+#define PCL_INSTANTIATE_DynamicKdTree(T) template class PCL_EXPORTS pcl::search::DynamicKdTree<T>;
+
+#endif  //#ifndef PCL_SEARCH_IMPL_DYNAMIC_KDTREE_H_
@@ -92,6 +92,15 @@ pcl::search::KdTree<PointT,Tree>::nearestKSearch (
   return (tree_->nearestKSearch (point, k, k_indices, k_sqr_distances));
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, class Tree> int
+pcl::search::KdTree<PointT,Tree>::nearestKSearch (
+    const PointT &point, int k, std::vector<int> &k_indices, 
+    std::vector<float> &k_sqr_distances, SearchContext &context) const
+{
+  return (tree_->nearestKSearch (point, k, k_indices, k_sqr_distances, context));
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, class Tree> int
 pcl::search::KdTree<PointT,Tree>::radiusSearch (
@@ -102,6 +111,25 @@ pcl::search::KdTree<PointT,Tree>::radiusSearch (
   return (tree_->radiusSearch (point, radius, k_indices, k_sqr_distances, max_nn));
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, class Tree> int
+pcl::search::KdTree<PointT,Tree>::radiusSearch (
+    const PointT& point, double radius, 
+    std::vector<int> &k_indices, std::vector<float> &k_sqr_distances,
+    SearchContext &context, unsigned int max_nn) const
+{
+  return (tree_->radiusSearch (point, radius, k_indices, k_sqr_distances, context, max_nn));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, class Tree> void
+pcl::search::KdTree<PointT,Tree>::batchNearestKSearch (
+    const PointCloud &cloud, const std::vector<int> &indices, int k,
+    std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
+{
+  tree_->batchNearestKSearch (cloud, indices, k, k_indices, k_sqr_distances, threads_);
+}
+
 #define PCL_INSTANTIATE_KdTree(T) template class PCL_EXPORTS pcl::search::KdTree<T>;
 
 #endif  //#ifndef _PCL_SEARCH_KDTREE_IMPL_HPP_
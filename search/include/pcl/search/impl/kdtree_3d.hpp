@@ -0,0 +1,375 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_SEARCH_IMPL_KDTREE_3D_H_
+#define PCL_SEARCH_IMPL_KDTREE_3D_H_
+
+#include <pcl/search/kdtree_3d.h>
+#include <algorithm>
+#include <limits>
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::KdTree3D<PointT>::setInputCloud (
+    const PointCloudConstPtr& cloud, const IndicesConstPtr& indices)
+{
+  input_ = cloud;
+  indices_ = indices;
+
+  // Gather the valid points
+  const size_t nr_input = indices != NULL ? indices->size () : cloud->points.size ();
+  std::vector<BuildPoint> points;
+  points.reserve (nr_input);
+  for (size_t i = 0; i < nr_input; ++i)
+  {
+    const int index = indices != NULL ? (*indices)[i] : static_cast<int> (i);
+    const PointT &point = cloud->points[index];
+    if (!cloud->is_dense && !isFinite (point))
+      continue;
+    BuildPoint build_point;
+    build_point.xyz[0] = point.x;
+    build_point.xyz[1] = point.y;
+    build_point.xyz[2] = point.z;
+    build_point.index = index;
+    points.push_back (build_point);
+  }
+  const int nr_points = static_cast<int> (points.size ());
+
+  // Use the smallest power of two number of leaves that keeps every bucket within max_leaf_size_
+  nr_leaves_ = 1;
+  depth_ = 0;
+  while (static_cast<long long> (nr_leaves_) * max_leaf_size_ < nr_points)
+  {
+    nr_leaves_ *= 2;
+    ++depth_;
+  }
+  leaf_offsets_.resize (nr_leaves_ + 1);
+  for (int leaf = 0; leaf <= nr_leaves_; ++leaf)
+    leaf_offsets_[leaf] = static_cast<int> (static_cast<long long> (nr_points) * leaf / nr_leaves_);
+  split_axis_.assign (nr_leaves_, 0);
+  split_value_.assign (nr_leaves_, 0.0f);
+
+  for (int level = 0; level < depth_; ++level)
+    buildLevel (points, level);
+
+  // Store the coordinates in leaf order, one array per axis
+  x_.resize (nr_points);
+  y_.resize (nr_points);
+  z_.resize (nr_points);
+  point_indices_.resize (nr_points);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(getBatchThreads ())
+#endif
+  for (int i = 0; i < nr_points; ++i)
+  {
+    x_[i] = points[i].xyz[0];
+    y_[i] = points[i].xyz[1];
+    z_[i] = points[i].xyz[2];
+    point_indices_[i] = points[i].index;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::KdTree3D<PointT>::buildLevel (std::vector<BuildPoint> &points, int level)
+{
+  const int first_node = 1 << level;
+  const int leaves_per_node = nr_leaves_ >> level;
+#ifdef _OPENMP
+  const int nr_threads = std::min (first_node, getBatchThreads ());
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nr_threads)
+#endif
+  for (int node = first_node; node < 2 * first_node; ++node)
+  {
+    const int leaf = (node - first_node) * leaves_per_node;
+    const int begin = leaf_offsets_[leaf];
+    const int middle = leaf_offsets_[leaf + leaves_per_node / 2];
+    const int end = leaf_offsets_[leaf + leaves_per_node];
+    if (begin == end)
+      continue;
+
+    float min_pt[3], max_pt[3];
+    for (int d = 0; d < 3; ++d)
+      min_pt[d] = max_pt[d] = points[begin].xyz[d];
+    for (int i = begin + 1; i < end; ++i)
+    {
+      for (int d = 0; d < 3; ++d)
+      {
+        min_pt[d] = std::min (min_pt[d], points[i].xyz[d]);
+        max_pt[d] = std::max (max_pt[d], points[i].xyz[d]);
+      }
+    }
+    int axis = 0;
+    for (int d = 1; d < 3; ++d)
+      if (max_pt[d] - min_pt[d] > max_pt[axis] - min_pt[axis])
+        axis = d;
+
+    // Left child: [begin, middle), all <= split value. Right child: [middle, end), all >= split value.
+    std::nth_element (points.begin () + begin, points.begin () + middle, points.begin () + end, BuildPointLess (axis));
+    split_axis_[node] = static_cast<unsigned char> (axis);
+    split_value_[node] = middle < end ? points[middle].xyz[axis] : max_pt[axis];
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::KdTree3D<PointT>::nearestKSearch (
+    const PointT &point, int k, std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
+{
+  const int nr_points = static_cast<int> (point_indices_.size ());
+  if (k > nr_points)
+    k = nr_points;
+  if (k <= 0 || !isFinite (point))
+  {
+    k_indices.clear ();
+    k_sqr_distances.clear ();
+    return (0);
+  }
+
+  k_indices.resize (k);
+  k_sqr_distances.resize (k);
+  const float query[3] = {point.x, point.y, point.z};
+  float offsets[3] = {0.0f, 0.0f, 0.0f};
+  KnnHeap result (&k_indices[0], &k_sqr_distances[0], k, std::numeric_limits<float>::max ());
+  searchKnn (1, query, offsets, 0.0f, result);
+  result.sort ();
+  return (k);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::KdTree3D<PointT>::radiusSearch (
+    const PointT& point, double radius, std::vector<int> &k_indices,
+    std::vector<float> &k_sqr_distances, unsigned int max_nn) const
+{
+  k_indices.clear ();
+  k_sqr_distances.clear ();
+  const int nr_points = static_cast<int> (point_indices_.size ());
+  if (nr_points == 0 || !isFinite (point))
+    return (0);
+
+  const float query[3] = {point.x, point.y, point.z};
+  float offsets[3] = {0.0f, 0.0f, 0.0f};
+  const float sqr_radius = static_cast<float> (radius * radius);
+
+  // Bounded search: the max_nn closest points within the radius
+  if (max_nn > 0 && max_nn < static_cast<unsigned int> (nr_points))
+  {
+    k_indices.resize (max_nn);
+    k_sqr_distances.resize (max_nn);
+    KnnHeap result (&k_indices[0], &k_sqr_distances[0], static_cast<int> (max_nn), sqr_radius);
+    searchKnn (1, query, offsets, 0.0f, result);
+    result.sort ();
+    k_indices.resize (result.size ());
+    k_sqr_distances.resize (result.size ());
+    return (result.size ());
+  }
+
+  searchRadius (1, query, offsets, 0.0f, sqr_radius, k_indices, k_sqr_distances);
+
+  if (sorted_results_ && k_indices.size () > 1)
+  {
+    std::vector<std::pair<float, int> > sorted (k_indices.size ());
+    for (size_t i = 0; i < k_indices.size (); ++i)
+      sorted[i] = std::make_pair (k_sqr_distances[i], k_indices[i]);
+    std::sort (sorted.begin (), sorted.end ());
+    for (size_t i = 0; i < k_indices.size (); ++i)
+    {
+      k_sqr_distances[i] = sorted[i].first;
+      k_indices[i] = sorted[i].second;
+    }
+  }
+  return (static_cast<int> (k_indices.size ()));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::KdTree3D<PointT>::searchKnn (
+    int node, const float *query, float *offsets, float cell_distance, KnnHeap &result) const
+{
+  if (node >= nr_leaves_)
+  {
+    scanLeafKnn (node - nr_leaves_, query, result);
+    return;
+  }
+
+  const int axis = split_axis_[node];
+  const float diff = query[axis] - split_value_[node];
+  const int near_child = diff < 0 ? 2 * node : 2 * node + 1;
+  searchKnn (near_child, query, offsets, cell_distance, result);
+
+  // The far cell is at least |diff| away along the split axis
+  const float old_offset = offsets[axis];
+  const float far_distance = cell_distance - old_offset * old_offset + diff * diff;
+  if (far_distance < result.worst ())
+  {
+    offsets[axis] = diff;
+    searchKnn (near_child ^ 1, query, offsets, far_distance, result);
+    offsets[axis] = old_offset;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::KdTree3D<PointT>::searchRadius (
+    int node, const float *query, float *offsets, float cell_distance, float sqr_radius,
+    std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
+{
+  if (node >= nr_leaves_)
+  {
+    scanLeafRadius (node - nr_leaves_, query, sqr_radius, k_indices, k_sqr_distances);
+    return;
+  }
+
+  const int axis = split_axis_[node];
+  const float diff = query[axis] - split_value_[node];
+  const int near_child = diff < 0 ? 2 * node : 2 * node + 1;
+  searchRadius (near_child, query, offsets, cell_distance, sqr_radius, k_indices, k_sqr_distances);
+
+  const float old_offset = offsets[axis];
+  const float far_distance = cell_distance - old_offset * old_offset + diff * diff;
+  if (far_distance < sqr_radius)
+  {
+    offsets[axis] = diff;
+    searchRadius (near_child ^ 1, query, offsets, far_distance, sqr_radius, k_indices, k_sqr_distances);
+    offsets[axis] = old_offset;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::KdTree3D<PointT>::scanLeafKnn (int leaf, const float *query, KnnHeap &result) const
+{
+  const int end = leaf_offsets_[leaf + 1];
+  int i = leaf_offsets_[leaf];
+#if defined (__SSE2__)
+  const __m128 qx = _mm_set1_ps (query[0]);
+  const __m128 qy = _mm_set1_ps (query[1]);
+  const __m128 qz = _mm_set1_ps (query[2]);
+  for (; i + 4 <= end; i += 4)
+  {
+    const __m128 dx = _mm_sub_ps (_mm_loadu_ps (&x_[i]), qx);
+    const __m128 dy = _mm_sub_ps (_mm_loadu_ps (&y_[i]), qy);
+    const __m128 dz = _mm_sub_ps (_mm_loadu_ps (&z_[i]), qz);
+    const __m128 dist = _mm_add_ps (_mm_add_ps (_mm_mul_ps (dx, dx), _mm_mul_ps (dy, dy)), _mm_mul_ps (dz, dz));
+    const int mask = _mm_movemask_ps (_mm_cmplt_ps (dist, _mm_set1_ps (result.worst ())));
+    if (mask == 0)
+      continue;
+
+    EIGEN_ALIGN16 float lane_dists[4];
+    _mm_store_ps (lane_dists, dist);
+    for (int lane = 0; lane < 4; ++lane)
+    {
+      // The bound shrinks as candidates are added, so it is tested again
+      if ((mask >> lane) & 1 && lane_dists[lane] < result.worst ())
+        result.add (lane_dists[lane], point_indices_[i + lane]);
+    }
+  }
+#endif
+  for (; i < end; ++i)
+  {
+    const float dx = x_[i] - query[0];
+    const float dy = y_[i] - query[1];
+    const float dz = z_[i] - query[2];
+    const float dist = dx * dx + dy * dy + dz * dz;
+    if (dist < result.worst ())
+      result.add (dist, point_indices_[i]);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::KdTree3D<PointT>::scanLeafRadius (
+    int leaf, const float *query, float sqr_radius,
+    std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
+{
+  const int end = leaf_offsets_[leaf + 1];
+  int i = leaf_offsets_[leaf];
+#if defined (__SSE2__)
+  const __m128 qx = _mm_set1_ps (query[0]);
+  const __m128 qy = _mm_set1_ps (query[1]);
+  const __m128 qz = _mm_set1_ps (query[2]);
+  const __m128 bound = _mm_set1_ps (sqr_radius);
+  for (; i + 4 <= end; i += 4)
+  {
+    const __m128 dx = _mm_sub_ps (_mm_loadu_ps (&x_[i]), qx);
+    const __m128 dy = _mm_sub_ps (_mm_loadu_ps (&y_[i]), qy);
+    const __m128 dz = _mm_sub_ps (_mm_loadu_ps (&z_[i]), qz);
+    const __m128 dist = _mm_add_ps (_mm_add_ps (_mm_mul_ps (dx, dx), _mm_mul_ps (dy, dy)), _mm_mul_ps (dz, dz));
+    const int mask = _mm_movemask_ps (_mm_cmplt_ps (dist, bound));
+    if (mask == 0)
+      continue;
+
+    EIGEN_ALIGN16 float lane_dists[4];
+    _mm_store_ps (lane_dists, dist);
+    for (int lane = 0; lane < 4; ++lane)
+    {
+      if ((mask >> lane) & 1)
+      {
+        k_indices.push_back (point_indices_[i + lane]);
+        k_sqr_distances.push_back (lane_dists[lane]);
+      }
+    }
+  }
+#endif
+  for (; i < end; ++i)
+  {
+    const float dx = x_[i] - query[0];
+    const float dy = y_[i] - query[1];
+    const float dz = z_[i] - query[2];
+    const float dist = dx * dx + dy * dy + dz * dz;
+    if (dist < sqr_radius)
+    {
+      k_indices.push_back (point_indices_[i]);
+      k_sqr_distances.push_back (dist);
+    }
+  }
+}
+
+#define PCL_INSTANTIATE_KdTree3D(T) template class PCL_EXPORTS pcl::search::KdTree3D<T>;
+
+#endif  //#ifndef PCL_SEARCH_IMPL_KDTREE_3D_H_
@@ -39,6 +39,11 @@
 #define PCL_SEARCH_SEARCH_IMPL_HPP_
 
 #include <pcl/search/search.h>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT>
@@ -47,6 +52,7 @@ pcl::search::Search<PointT>::Search (const std::string& name, bool sorted)
   , indices_ ()
   , sorted_results_ (sorted)
   , name_ (name)
+  , threads_ (0)
 {
 }
 
@@ -91,6 +97,26 @@ pcl::search::Search<PointT>::nearestKSearch (
   return (nearestKSearch (cloud.points[index], k, k_indices, k_sqr_distances));
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::Search<PointT>::nearestKSearch (
+    const PointT &point, int k, std::vector<int> &k_indices,
+    std::vector<float> &k_sqr_distances, SearchContext &) const
+{
+  return (nearestKSearch (point, k, k_indices, k_sqr_distances));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::Search<PointT>::nearestKSearch (
+    const PointCloud &cloud, int index, int k,
+    std::vector<int> &k_indices, std::vector<float> &k_sqr_distances,
+    SearchContext &context) const
+{
+  assert (index >= 0 && index < static_cast<int> (cloud.points.size ()) && "Out-of-bounds error in nearestKSearch!");
+  return (nearestKSearch (cloud.points[index], k, k_indices, k_sqr_distances, context));
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> int
 pcl::search::Search<PointT>::nearestKSearch (
@@ -146,6 +172,26 @@ pcl::search::Search<PointT>::radiusSearch (
   return (radiusSearch(cloud.points[index], radius, k_indices, k_sqr_distances, max_nn));
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::Search<PointT>::radiusSearch (
+    const PointT &point, double radius, std::vector<int> &k_indices,
+    std::vector<float> &k_sqr_distances, SearchContext &, unsigned int max_nn) const
+{
+  return (radiusSearch (point, radius, k_indices, k_sqr_distances, max_nn));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::Search<PointT>::radiusSearch (
+    const PointCloud &cloud, int index, double radius,
+    std::vector<int> &k_indices, std::vector<float> &k_sqr_distances,
+    SearchContext &context, unsigned int max_nn) const
+{
+  assert (index >= 0 && index < static_cast<int> (cloud.points.size ()) && "Out-of-bounds error in radiusSearch!");
+  return (radiusSearch (cloud.points[index], radius, k_indices, k_sqr_distances, context, max_nn));
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> int
 pcl::search::Search<PointT>::radiusSearch (
@@ -190,6 +236,114 @@ pcl::search::Search<PointT>::radiusSearch (
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::Search<PointT>::batchNearestKSearch (
+    const PointCloud &cloud, const std::vector<int> &indices, int k,
+    std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
+{
+  const int nr_queries = static_cast<int> (indices.empty () ? cloud.points.size () : indices.size ());
+  if (k < 0)
+    k = 0;
+  k_indices.resize (static_cast<size_t> (nr_queries) * k);
+  k_sqr_distances.resize (static_cast<size_t> (nr_queries) * k);
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(getBatchThreads ())
+#endif
+  {
+    // Scratch buffers reused by all the queries of a thread
+    std::vector<int> nn_indices;
+    std::vector<float> nn_dists;
+    SearchContext context;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 64)
+#endif
+    for (int i = 0; i < nr_queries; ++i)
+    {
+      const size_t row = static_cast<size_t> (i) * k;
+      const int found = k == 0 ? 0 :
+          std::min (k, nearestKSearch (cloud.points[indices.empty () ? i : indices[i]], k, nn_indices, nn_dists, context));
+      for (int j = 0; j < found; ++j)
+      {
+        k_indices[row + j] = nn_indices[j];
+        k_sqr_distances[row + j] = nn_dists[j];
+      }
+      for (int j = std::max (found, 0); j < k; ++j)
+      {
+        k_indices[row + j] = -1;
+        k_sqr_distances[row + j] = std::numeric_limits<float>::max ();
+      }
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::Search<PointT>::batchRadiusSearch (
+    const PointCloud &cloud, const std::vector<int> &indices, double radius,
+    std::vector<size_t> &offsets, std::vector<int> &k_indices,
+    std::vector<float> &k_sqr_distances, unsigned int max_nn) const
+{
+  const int nr_queries = static_cast<int> (indices.empty () ? cloud.points.size () : indices.size ());
+  const int nr_blocks = getBatchThreads ();
+
+  // Every block of queries is answered into its own buffers, which are copied to their final place once the
+  // number of neighbors of every query point is known
+  std::vector<std::vector<int> > block_indices (nr_blocks);
+  std::vector<std::vector<float> > block_dists (nr_blocks);
+  offsets.resize (nr_queries + 1);
+  offsets[0] = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nr_blocks)
+#endif
+  for (int block = 0; block < nr_blocks; ++block)
+  {
+    const int begin = static_cast<int> (static_cast<long long> (nr_queries) * block / nr_blocks);
+    const int end = static_cast<int> (static_cast<long long> (nr_queries) * (block + 1) / nr_blocks);
+    std::vector<int> nn_indices;
+    std::vector<float> nn_dists;
+    SearchContext context;
+    for (int i = begin; i < end; ++i)
+    {
+      const int found = radiusSearch (cloud.points[indices.empty () ? i : indices[i]], radius,
+                                      nn_indices, nn_dists, context, max_nn);
+      const size_t count = found > 0 ? static_cast<size_t> (found) : 0;
+      block_indices[block].insert (block_indices[block].end (), nn_indices.begin (), nn_indices.begin () + count);
+      block_dists[block].insert (block_dists[block].end (), nn_dists.begin (), nn_dists.begin () + count);
+      // Store the count for now, the offsets are accumulated below
+      offsets[i + 1] = count;
+    }
+  }
+
+  for (int i = 0; i < nr_queries; ++i)
+    offsets[i + 1] += offsets[i];
+  k_indices.resize (offsets[nr_queries]);
+  k_sqr_distances.resize (offsets[nr_queries]);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nr_blocks)
+#endif
+  for (int block = 0; block < nr_blocks; ++block)
+  {
+    const int begin = static_cast<int> (static_cast<long long> (nr_queries) * block / nr_blocks);
+    std::copy (block_indices[block].begin (), block_indices[block].end (), k_indices.begin () + offsets[begin]);
+    std::copy (block_dists[block].begin (), block_dists[block].end (), k_sqr_distances.begin () + offsets[begin]);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::Search<PointT>::getBatchThreads () const
+{
+#ifdef _OPENMP
+  return (threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_));
+#else
+  return (1);
+#endif
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::search::Search<PointT>::sortResults (
@@ -0,0 +1,348 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_SEARCH_IMPL_VOXEL_HASH_H_
+#define PCL_SEARCH_IMPL_VOXEL_HASH_H_
+
+#include <pcl/search/voxel_hash.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::VoxelHash<PointT>::setInputCloud (
+    const PointCloudConstPtr& cloud, const IndicesConstPtr& indices)
+{
+  input_ = cloud;
+  indices_ = indices;
+
+  const double inverse_resolution = 1.0 / resolution_;
+  const size_t nr_input = indices != NULL ? indices->size () : cloud->points.size ();
+  std::vector<int> valid_indices;
+  std::vector<int> point_voxels;
+  valid_indices.reserve (nr_input);
+  point_voxels.reserve (nr_input);
+
+  // Find (or create) the voxel of every point, the end of a voxel counting its points for now
+  voxels_.clear ();
+  table_.assign (16, -1);
+  for (size_t i = 0; i < nr_input; ++i)
+  {
+    const int index = indices != NULL ? (*indices)[i] : static_cast<int> (i);
+    const PointT &point = cloud->points[index];
+    if (!cloud->is_dense && !isFinite (point))
+      continue;
+
+    // Keep the load factor of the hash table under one half
+    if (2 * (voxels_.size () + 1) > table_.size ())
+    {
+      table_.assign (2 * table_.size (), -1);
+      for (int voxel = 0; voxel < static_cast<int> (voxels_.size ()); ++voxel)
+        insertVoxel (voxel);
+    }
+
+    int key[3];
+    if (!getVoxelKey (point.x, inverse_resolution, key[0]) ||
+        !getVoxelKey (point.y, inverse_resolution, key[1]) ||
+        !getVoxelKey (point.z, inverse_resolution, key[2]))
+    {
+      PCL_ERROR ("[pcl::%s::setInputCloud] The resolution %g is too small for the input cloud, the voxel keys would overflow!\n",
+                 this->getName ().c_str (), resolution_);
+      voxels_.clear ();
+      table_.clear ();
+      x_.clear ();
+      y_.clear ();
+      z_.clear ();
+      point_indices_.clear ();
+      return;
+    }
+    size_t slot = hashKey (key[0], key[1], key[2]);
+    int voxel = table_[slot];
+    while (voxel != -1 &&
+           (voxels_[voxel].key[0] != key[0] || voxels_[voxel].key[1] != key[1] || voxels_[voxel].key[2] != key[2]))
+    {
+      slot = (slot + 1) & (table_.size () - 1);
+      voxel = table_[slot];
+    }
+    if (voxel == -1)
+    {
+      Voxel new_voxel;
+      std::copy (key, key + 3, new_voxel.key);
+      new_voxel.begin = 0;
+      new_voxel.end = 0;
+      voxel = static_cast<int> (voxels_.size ());
+      voxels_.push_back (new_voxel);
+      table_[slot] = voxel;
+    }
+    ++voxels_[voxel].end;
+    valid_indices.push_back (index);
+    point_voxels.push_back (voxel);
+  }
+
+  // Turn the counts into ranges, and store the points grouped by voxel, in input order within a voxel
+  std::vector<int> cursors (voxels_.size ());
+  int offset = 0;
+  for (size_t voxel = 0; voxel < voxels_.size (); ++voxel)
+  {
+    voxels_[voxel].begin = offset;
+    cursors[voxel] = offset;
+    offset += voxels_[voxel].end;
+    voxels_[voxel].end = offset;
+  }
+
+  x_.resize (valid_indices.size ());
+  y_.resize (valid_indices.size ());
+  z_.resize (valid_indices.size ());
+  point_indices_.resize (valid_indices.size ());
+  for (size_t i = 0; i < valid_indices.size (); ++i)
+  {
+    const int position = cursors[point_voxels[i]]++;
+    const PointT &point = cloud->points[valid_indices[i]];
+    x_[position] = point.x;
+    y_[position] = point.y;
+    z_[position] = point.z;
+    point_indices_[position] = valid_indices[i];
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::VoxelHash<PointT>::nearestKSearch (
+    const PointT &point, int k, std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
+{
+  if (k > static_cast<int> (point_indices_.size ()))
+    k = static_cast<int> (point_indices_.size ());
+  const double inverse_resolution = 1.0 / resolution_;
+  int key[3];
+  if (k <= 0 || !isFinite (point) ||
+      !getVoxelKey (point.x, inverse_resolution, key[0]) ||
+      !getVoxelKey (point.y, inverse_resolution, key[1]) ||
+      !getVoxelKey (point.z, inverse_resolution, key[2]))
+  {
+    k_indices.clear ();
+    k_sqr_distances.clear ();
+    return (0);
+  }
+
+  k_indices.resize (k);
+  k_sqr_distances.resize (k);
+  const float query[3] = {point.x, point.y, point.z};
+
+  KnnHeap result (&k_indices[0], &k_sqr_distances[0], k, std::numeric_limits<float>::max ());
+
+  // The voxel of the query first, for a tight bound on the others
+  const Voxel *center = findVoxel (key[0], key[1], key[2]);
+  if (center)
+    scanVoxel (*center, query, result);
+
+  for (int dx = -search_extent_; dx <= search_extent_; ++dx)
+  {
+    for (int dy = -search_extent_; dy <= search_extent_; ++dy)
+    {
+      for (int dz = -search_extent_; dz <= search_extent_; ++dz)
+      {
+        if (dx == 0 && dy == 0 && dz == 0)
+          continue;
+        const Voxel *voxel = findVoxel (key[0] + dx, key[1] + dy, key[2] + dz);
+        if (voxel && sqrDistanceToVoxel (query, *voxel) < result.worst ())
+          scanVoxel (*voxel, query, result);
+      }
+    }
+  }
+
+  result.sort ();
+  k_indices.resize (result.size ());
+  k_sqr_distances.resize (result.size ());
+  return (result.size ());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::VoxelHash<PointT>::radiusSearch (
+    const PointT& point, double radius, std::vector<int> &k_indices,
+    std::vector<float> &k_sqr_distances, unsigned int max_nn) const
+{
+  k_indices.clear ();
+  k_sqr_distances.clear ();
+  if (point_indices_.empty () || !isFinite (point))
+    return (0);
+
+  const float query[3] = {point.x, point.y, point.z};
+  const float sqr_radius = static_cast<float> (radius * radius);
+  const double inverse_resolution = 1.0 / resolution_;
+  int min_key[3], max_key[3];
+  double nr_range_voxels = 1.0;
+  for (int d = 0; d < 3; ++d)
+  {
+    // No voxel lies beyond MAX_KEY, so the range is clamped to it
+    min_key[d] = static_cast<int> ((std::max) (std::floor ((query[d] - radius) * inverse_resolution), static_cast<double> (-MAX_KEY)));
+    max_key[d] = static_cast<int> ((std::min) (std::floor ((query[d] + radius) * inverse_resolution), static_cast<double> (MAX_KEY)));
+    if (min_key[d] > max_key[d])
+      return (0);
+    nr_range_voxels *= max_key[d] - min_key[d] + 1;
+  }
+
+  // Bounded search: the max_nn closest points within the radius
+  const bool bounded = max_nn > 0 && max_nn < point_indices_.size ();
+  if (bounded)
+  {
+    k_indices.resize (max_nn);
+    k_sqr_distances.resize (max_nn);
+  }
+  KnnHeap result (bounded ? &k_indices[0] : NULL, bounded ? &k_sqr_distances[0] : NULL,
+                  static_cast<int> (max_nn), sqr_radius);
+
+  // Look the voxels of the range up, or go through the occupied voxels if there are less of them
+  const bool scan_all = nr_range_voxels > static_cast<double> (voxels_.size ());
+  const int nr_candidates = scan_all ? static_cast<int> (voxels_.size ()) : static_cast<int> (nr_range_voxels);
+  const int size_x = max_key[0] - min_key[0] + 1;
+  const int size_y = max_key[1] - min_key[1] + 1;
+  for (int candidate = 0; candidate < nr_candidates; ++candidate)
+  {
+    const Voxel *voxel;
+    if (scan_all)
+      voxel = &voxels_[candidate];
+    else
+      voxel = findVoxel (min_key[0] + candidate % size_x,
+                         min_key[1] + (candidate / size_x) % size_y,
+                         min_key[2] + candidate / (size_x * size_y));
+    if (!voxel || sqrDistanceToVoxel (query, *voxel) >= sqr_radius)
+      continue;
+
+    if (bounded)
+    {
+      scanVoxel (*voxel, query, result);
+      continue;
+    }
+    for (int i = voxel->begin; i < voxel->end; ++i)
+    {
+      const float dx = x_[i] - query[0];
+      const float dy = y_[i] - query[1];
+      const float dz = z_[i] - query[2];
+      const float dist = dx * dx + dy * dy + dz * dz;
+      if (dist < sqr_radius)
+      {
+        k_indices.push_back (point_indices_[i]);
+        k_sqr_distances.push_back (dist);
+      }
+    }
+  }
+
+  if (bounded)
+  {
+    result.sort ();
+    k_indices.resize (result.size ());
+    k_sqr_distances.resize (result.size ());
+  }
+  else if (sorted_results_ && k_indices.size () > 1)
+  {
+    std::vector<std::pair<float, int> > sorted (k_indices.size ());
+    for (size_t i = 0; i < k_indices.size (); ++i)
+      sorted[i] = std::make_pair (k_sqr_distances[i], k_indices[i]);
+    std::sort (sorted.begin (), sorted.end ());
+    for (size_t i = 0; i < k_indices.size (); ++i)
+    {
+      k_sqr_distances[i] = sorted[i].first;
+      k_indices[i] = sorted[i].second;
+    }
+  }
+  return (static_cast<int> (k_indices.size ()));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> const typename pcl::search::VoxelHash<PointT>::Voxel*
+pcl::search::VoxelHash<PointT>::findVoxel (int kx, int ky, int kz) const
+{
+  if (table_.empty ())
+    return (NULL);
+  size_t slot = hashKey (kx, ky, kz);
+  for (int voxel = table_[slot]; voxel != -1; voxel = table_[slot])
+  {
+    const Voxel &candidate = voxels_[voxel];
+    if (candidate.key[0] == kx && candidate.key[1] == ky && candidate.key[2] == kz)
+      return (&candidate);
+    slot = (slot + 1) & (table_.size () - 1);
+  }
+  return (NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::VoxelHash<PointT>::insertVoxel (int voxel)
+{
+  size_t slot = hashKey (voxels_[voxel].key[0], voxels_[voxel].key[1], voxels_[voxel].key[2]);
+  while (table_[slot] != -1)
+    slot = (slot + 1) & (table_.size () - 1);
+  table_[slot] = voxel;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> float
+pcl::search::VoxelHash<PointT>::sqrDistanceToVoxel (const float *query, const Voxel &voxel) const
+{
+  float sqr_distance = 0.0f;
+  for (int d = 0; d < 3; ++d)
+  {
+    const float low = static_cast<float> (voxel.key[d] * resolution_);
+    const float high = static_cast<float> ((voxel.key[d] + 1) * resolution_);
+    const float offset = query[d] < low ? low - query[d] : (query[d] > high ? query[d] - high : 0.0f);
+    sqr_distance += offset * offset;
+  }
+  return (sqr_distance);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::VoxelHash<PointT>::scanVoxel (const Voxel &voxel, const float *query, KnnHeap &result) const
+{
+  for (int i = voxel.begin; i < voxel.end; ++i)
+  {
+    const float dx = x_[i] - query[0];
+    const float dy = y_[i] - query[1];
+    const float dz = z_[i] - query[2];
+    const float dist = dx * dx + dy * dy + dz * dz;
+    if (dist < result.worst ())
+      result.add (dist, point_indices_[i]);
+  }
+}
+
+#define PCL_INSTANTIATE_VoxelHash(T) template class PCL_EXPORTS pcl::search::VoxelHash<T>;
+
+#endif  //#ifndef PCL_SEARCH_IMPL_VOXEL_HASH_H_
@@ -67,6 +67,7 @@ namespace pcl
 
         typedef boost::shared_ptr<std::vector<int> > IndicesPtr;
         typedef boost::shared_ptr<const std::vector<int> > IndicesConstPtr;
+        typedef typename Search<PointT>::SearchContext SearchContext;
 
         using pcl::search::Search<PointT>::indices_;
         using pcl::search::Search<PointT>::input_;
@@ -75,6 +76,7 @@ namespace pcl
         using pcl::search::Search<PointT>::nearestKSearch;
         using pcl::search::Search<PointT>::radiusSearch;
         using pcl::search::Search<PointT>::sorted_results_;
+        using pcl::search::Search<PointT>::threads_;
 
         typedef boost::shared_ptr<KdTree<PointT, Tree> > Ptr;
         typedef boost::shared_ptr<const KdTree<PointT, Tree> > ConstPtr;
@@ -130,6 +132,23 @@ namespace pcl
           return (tree_->getEpsilon ());
         }
 
+        /** \brief Set the order in which the points are stored in the tree, see
+          * \ref pcl::KdTreeFLANN::setSpatialOrder. Takes effect at the next \ref setInputCloud.
+          * \param[in] order the space-filling curve to store the points along
+          */
+        inline void
+        setSpatialOrder (SpatialOrder order)
+        {
+          tree_->setSpatialOrder (order);
+        }
+
+        /** \brief Get the order in which the points are stored in the tree. */
+        inline SpatialOrder
+        getSpatialOrder () const
+        {
+          return (tree_->getSpatialOrder ());
+        }
+
         /** \brief Provide a pointer to the input dataset.
           * \param[in] cloud the const boost shared pointer to a PointCloud message
           * \param[in] indices the point indices subset that is to be used from \a cloud 
@@ -151,6 +170,21 @@ namespace pcl
                         std::vector<int> &k_indices, 
                         std::vector<float> &k_sqr_distances) const;
 
+        /** \brief Search for the k-nearest neighbors for the given query point, reusing the scratch buffers of
+          * \a context across calls.
+          * \param[in] point the given query point
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in,out] context the scratch buffers to use, which must not be shared between threads
+          * \return number of neighbors found
+          */
+        int
+        nearestKSearch (const PointT &point, int k, 
+                        std::vector<int> &k_indices, 
+                        std::vector<float> &k_sqr_distances,
+                        SearchContext &context) const;
+
         /** \brief Search for all the nearest neighbors of the query point in a given radius.
           * \param[in] point the given query point
           * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
@@ -166,6 +200,37 @@ namespace pcl
                       std::vector<int> &k_indices, 
                       std::vector<float> &k_sqr_distances,
                       unsigned int max_nn = 0) const;
+
+        /** \brief Search for all the nearest neighbors of the query point in a given radius, reusing the scratch
+          * buffers of \a context across calls.
+          * \param[in] point the given query point
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in,out] context the scratch buffers to use, which must not be shared between threads
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value. If \a max_nn is set to
+          * 0 or to a number higher than the number of points in the input cloud, all neighbors in \a radius will be
+          * returned.
+          * \return number of neighbors found in radius
+          */
+        int
+        radiusSearch (const PointT& point, double radius, 
+                      std::vector<int> &k_indices, 
+                      std::vector<float> &k_sqr_distances,
+                      SearchContext &context,
+                      unsigned int max_nn = 0) const;
+
+        /** \brief Search for the k-nearest neighbors of a batch of query points, in parallel. The queries are
+          * answered in blocks by the underlying tree, see \ref Search::batchNearestKSearch for the output layout.
+          * \param[in] cloud the point cloud data
+          * \param[in] indices the indices in \a cloud of the query points. If indices is empty, all points are queried.
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points, one row of \a k entries per query point
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points, in the same layout
+          */
+        void
+        batchNearestKSearch (const PointCloud &cloud, const std::vector<int> &indices, int k,
+                             std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const;
       protected:
         /** \brief A pointer to the internal KdTree object. */
         KdTreePtr tree_;
@@ -0,0 +1,243 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_SEARCH_KDTREE_3D_H_
+#define PCL_SEARCH_KDTREE_3D_H_
+
+#include <pcl/search/search.h>
+#include <pcl/search/knn_heap.h>
+
+namespace pcl
+{
+  namespace search
+  {
+    /** \brief KdTree3D is a kd-tree written for the three-dimensional case, without going through FLANN and
+      * \ref pcl::PointRepresentation.
+      *
+      * The tree is balanced and implicit: node \a i has the children \a 2i and \a 2i+1, and only the split axis and
+      * value of the inner nodes are stored. The points are reordered so that every leaf is a contiguous bucket of
+      * at most \ref getMaxLeafSize () points, stored as separate x, y and z arrays which are scanned 4 points at a
+      * time with SSE2 when available. The levels of the tree are built one after the other, the nodes of a level
+      * in parallel (see \ref setNumberOfThreads).
+      *
+      * The k-nearest neighbor results are always sorted by increasing distance; the radius search results are
+      * sorted if requested in the constructor.
+      *
+      * \ingroup search
+      */
+    template<typename PointT>
+    class KdTree3D: public Search<PointT>
+    {
+      public:
+        typedef typename Search<PointT>::PointCloud PointCloud;
+        typedef typename Search<PointT>::PointCloudConstPtr PointCloudConstPtr;
+
+        typedef boost::shared_ptr<std::vector<int> > IndicesPtr;
+        typedef boost::shared_ptr<const std::vector<int> > IndicesConstPtr;
+
+        using pcl::search::Search<PointT>::input_;
+        using pcl::search::Search<PointT>::indices_;
+        using pcl::search::Search<PointT>::sorted_results_;
+        using pcl::search::Search<PointT>::nearestKSearch;
+        using pcl::search::Search<PointT>::radiusSearch;
+        using pcl::search::Search<PointT>::getBatchThreads;
+
+        typedef boost::shared_ptr<KdTree3D<PointT> > Ptr;
+        typedef boost::shared_ptr<const KdTree3D<PointT> > ConstPtr;
+
+        /** \brief Constructor.
+          * \param[in] sorted set to true if the radius search results need to be sorted in ascending order of
+          * their distance to the query point
+          */
+        KdTree3D (bool sorted = true)
+          : Search<PointT> ("KdTree3D", sorted)
+          , max_leaf_size_ (16)
+          , nr_leaves_ (0)
+          , depth_ (0)
+          , split_axis_ ()
+          , split_value_ ()
+          , leaf_offsets_ ()
+          , x_ (), y_ (), z_ ()
+          , point_indices_ ()
+        {
+        }
+
+        /** \brief Destructor. */
+        virtual
+        ~KdTree3D ()
+        {
+        }
+
+        /** \brief Set the maximum number of points in a leaf bucket. Takes effect at the next \ref setInputCloud.
+          * \param[in] max_leaf_size the maximum number of points in a leaf (at least 1)
+          */
+        inline void
+        setMaxLeafSize (int max_leaf_size)
+        {
+          max_leaf_size_ = max_leaf_size > 0 ? max_leaf_size : 1;
+        }
+
+        /** \brief Get the maximum number of points in a leaf bucket. */
+        inline int
+        getMaxLeafSize () const
+        {
+          return (max_leaf_size_);
+        }
+
+        /** \brief Provide a pointer to the input dataset, and build the tree.
+          * \param[in] cloud the const boost shared pointer to a PointCloud message
+          * \param[in] indices the point indices subset that is to be used from \a cloud
+          */
+        void
+        setInputCloud (const PointCloudConstPtr& cloud,
+                       const IndicesConstPtr& indices = IndicesConstPtr ());
+
+        /** \brief Search for the k-nearest neighbors for the given query point.
+          * \param[in] point the given query point
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \return number of neighbors found
+          */
+        int
+        nearestKSearch (const PointT &point, int k,
+                        std::vector<int> &k_indices,
+                        std::vector<float> &k_sqr_distances) const;
+
+        /** \brief Search for all the nearest neighbors of the query point in a given radius.
+          * \param[in] point the given query point
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value. If \a max_nn is set to
+          * 0 or to a number higher than the number of points in the input cloud, all neighbors in \a radius will be
+          * returned. Otherwise the \a max_nn closest ones are returned, sorted.
+          * \return number of neighbors found in radius
+          */
+        int
+        radiusSearch (const PointT& point, double radius,
+                      std::vector<int> &k_indices,
+                      std::vector<float> &k_sqr_distances,
+                      unsigned int max_nn = 0) const;
+
+      protected:
+        /** \brief A point being sorted into the leaves while the tree is built. */
+        struct BuildPoint
+        {
+          float xyz[3];
+          int index;
+        };
+
+        /** \brief Orders the points being built along one axis. */
+        struct BuildPointLess
+        {
+          BuildPointLess (int axis) : axis_ (axis) {}
+
+          inline bool
+          operator () (const BuildPoint &a, const BuildPoint &b) const
+          {
+            return (a.xyz[axis_] < b.xyz[axis_]);
+          }
+
+          int axis_;
+        };
+
+        /** \brief Split the nodes of one level of the tree along the largest extent of their points.
+          * \param[in,out] points the points, reordered so that every node of \a level gets its half of the range
+          * \param[in] level the level to split (0 is the root)
+          */
+        void
+        buildLevel (std::vector<BuildPoint> &points, int level);
+
+        /** \brief Recursively search the subtree of \a node for the k-nearest neighbors of \a query.
+          * \param[in] node the node to search
+          * \param[in] query the query coordinates
+          * \param[in,out] offsets the per-axis distance of the query to the cell of \a node
+          * \param[in] cell_distance the squared distance of the query to the cell of \a node
+          * \param[in,out] result the candidates found so far
+          */
+        void
+        searchKnn (int node, const float *query, float *offsets, float cell_distance, KnnHeap &result) const;
+
+        /** \brief Recursively search the subtree of \a node for all the points closer than \a sqr_radius. */
+        void
+        searchRadius (int node, const float *query, float *offsets, float cell_distance, float sqr_radius,
+                      std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const;
+
+        /** \brief Scan a leaf bucket for the k-nearest neighbor search. */
+        void
+        scanLeafKnn (int leaf, const float *query, KnnHeap &result) const;
+
+        /** \brief Scan a leaf bucket for the radius search. */
+        void
+        scanLeafRadius (int leaf, const float *query, float sqr_radius,
+                        std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const;
+
+        /** \brief The maximum number of points in a leaf bucket. */
+        int max_leaf_size_;
+
+        /** \brief The number of leaves, a power of two. Node \a nr_leaves_ + j is the j-th leaf. */
+        int nr_leaves_;
+
+        /** \brief The depth of the tree, i.e. log2 (\a nr_leaves_). */
+        int depth_;
+
+        /** \brief The split axis of every inner node (index 0 is unused). */
+        std::vector<unsigned char> split_axis_;
+
+        /** \brief The split value of every inner node (index 0 is unused). */
+        std::vector<float> split_value_;
+
+        /** \brief The first point of every leaf, plus the total number of points. */
+        std::vector<int> leaf_offsets_;
+
+        /** \brief The coordinates of the points, in leaf order. */
+        std::vector<float> x_, y_, z_;
+
+        /** \brief The index in the input cloud of every point, in leaf order. */
+        std::vector<int> point_indices_;
+    };
+  }
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/search/impl/kdtree_3d.hpp>
+#endif
+
+#endif    // PCL_SEARCH_KDTREE_3D_H_
@@ -0,0 +1,153 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_SEARCH_KNN_HEAP_H_
+#define PCL_SEARCH_KNN_HEAP_H_
+
+namespace pcl
+{
+  namespace search
+  {
+    /** \brief The best candidates of a k-nearest neighbor search, kept as a max-heap on the squared distance
+      * in arrays provided by the caller (usually its output vectors), so that collecting them does not allocate.
+      * \ingroup search
+      */
+    class KnnHeap
+    {
+      public:
+        /** \brief Constructor.
+          * \param[out] indices storage for at least \a capacity indices
+          * \param[out] distances storage for at least \a capacity squared distances
+          * \param[in] capacity the number of candidates to keep
+          * \param[in] bound the squared distance a candidate has to beat while the heap is not full
+          */
+        KnnHeap (int *indices, float *distances, int capacity, float bound)
+          : indices_ (indices), distances_ (distances), capacity_ (capacity), size_ (0), bound_ (bound)
+        {
+        }
+
+        /** \brief The squared distance a candidate has to beat. */
+        inline float
+        worst () const
+        {
+          return (size_ < capacity_ ? bound_ : distances_[0]);
+        }
+
+        /** \brief The number of candidates kept so far. */
+        inline int
+        size () const
+        {
+          return (size_);
+        }
+
+        /** \brief Add a candidate, which must be closer than \ref worst (). */
+        inline void
+        add (float distance, int index)
+        {
+          int pos;
+          if (size_ < capacity_)
+          {
+            // Sift the new candidate up from the end of the heap
+            pos = size_++;
+            while (pos > 0)
+            {
+              const int parent = (pos - 1) / 2;
+              if (distances_[parent] >= distance)
+                break;
+              distances_[pos] = distances_[parent];
+              indices_[pos] = indices_[parent];
+              pos = parent;
+            }
+          }
+          else
+            // Replace the worst candidate
+            pos = siftDown (distance, size_);
+          distances_[pos] = distance;
+          indices_[pos] = index;
+        }
+
+        /** \brief Sort the candidates by increasing distance. The heap is not usable afterwards. */
+        inline void
+        sort ()
+        {
+          // Heap sort: move the current worst candidate behind the shrinking heap
+          for (int last = size_ - 1; last > 0; --last)
+          {
+            const float distance = distances_[last];
+            const int index = indices_[last];
+            distances_[last] = distances_[0];
+            indices_[last] = indices_[0];
+            const int pos = siftDown (distance, last);
+            distances_[pos] = distance;
+            indices_[pos] = index;
+          }
+        }
+
+      private:
+        /** \brief Move the hole at the root of the heap of \a size elements down to where \a distance fits. */
+        inline int
+        siftDown (float distance, int size)
+        {
+          int pos = 0;
+          for (;;)
+          {
+            int child = 2 * pos + 1;
+            if (child >= size)
+              break;
+            if (child + 1 < size && distances_[child + 1] > distances_[child])
+              ++child;
+            if (distances_[child] <= distance)
+              break;
+            distances_[pos] = distances_[child];
+            indices_[pos] = indices_[child];
+            pos = child;
+          }
+          return (pos);
+        }
+
+        int *indices_;
+        float *distances_;
+        int capacity_;
+        int size_;
+        float bound_;
+    };
+  }
+}
+
+#endif    // PCL_SEARCH_KNN_HEAP_H_
@@ -43,6 +43,7 @@
 #include <pcl/for_each_type.h>
 #include <pcl/common/concatenate.h>
 #include <pcl/common/copy_point.h>
+#include <pcl/kdtree/kdtree.h>
 
 namespace pcl
 {
@@ -84,6 +85,8 @@ namespace pcl
         typedef boost::shared_ptr<std::vector<int> > IndicesPtr;
         typedef boost::shared_ptr<const std::vector<int> > IndicesConstPtr;
 
+        typedef pcl::NeighborSearchContext SearchContext;
+
         /** Constructor. */
         Search (const std::string& name = "", bool sorted = false);
 
@@ -134,6 +137,16 @@ namespace pcl
           return (indices_);
         }
 
+        /** \brief Set the number of threads used by the batch searches.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        inline void
+        setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+        /** \brief Get the number of threads used by the batch searches (0 means automatic). */
+        inline unsigned int
+        getNumberOfThreads () const { return (threads_); }
+
         /** \brief Search for the k-nearest neighbors for the given query point.
           * \param[in] point the given query point
           * \param[in] k the number of neighbors to search for
@@ -185,6 +198,34 @@ namespace pcl
                         std::vector<int> &k_indices, 
                         std::vector<float> &k_sqr_distances) const;
 
+        /** \brief Search for k-nearest neighbors for the given query point, reusing the scratch buffers of
+          * \a context across calls. Searchers that need no temporaries simply ignore \a context.
+          * \param[in] point the given query point
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in,out] context the scratch buffers to use, which must not be shared between threads
+          * \return number of neighbors found
+          */
+        virtual int
+        nearestKSearch (const PointT &point, int k, std::vector<int> &k_indices,
+                        std::vector<float> &k_sqr_distances, SearchContext &context) const;
+
+        /** \brief Search for k-nearest neighbors for the given query point, reusing the scratch buffers of
+          * \a context across calls.
+          * \param[in] cloud the point cloud data
+          * \param[in] index a \a valid index in \a cloud representing a \a valid (i.e., finite) query point
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in,out] context the scratch buffers to use, which must not be shared between threads
+          * \return number of neighbors found
+          */
+        virtual int
+        nearestKSearch (const PointCloud &cloud, int index, int k,
+                        std::vector<int> &k_indices, std::vector<float> &k_sqr_distances,
+                        SearchContext &context) const;
+
         /** \brief Search for k-nearest neighbors for the given query point (zero-copy).
           *
           * \attention This method does not do any bounds checking for the input index
@@ -314,6 +355,41 @@ namespace pcl
                       std::vector<int> &k_indices, std::vector<float> &k_sqr_distances,
                       unsigned int max_nn = 0) const;
 
+        /** \brief Search for all the nearest neighbors of the query point in a given radius, reusing the scratch
+          * buffers of \a context across calls. Searchers that need no temporaries simply ignore \a context.
+          * \param[in] point the given query point
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in,out] context the scratch buffers to use, which must not be shared between threads
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value. If \a max_nn is set to
+          * 0 or to a number higher than the number of points in the input cloud, all neighbors in \a radius will be
+          * returned.
+          * \return number of neighbors found in radius
+          */
+        virtual int
+        radiusSearch (const PointT& point, double radius, std::vector<int>& k_indices,
+                      std::vector<float>& k_sqr_distances, SearchContext &context,
+                      unsigned int max_nn = 0) const;
+
+        /** \brief Search for all the nearest neighbors of the query point in a given radius, reusing the scratch
+          * buffers of \a context across calls.
+          * \param[in] cloud the point cloud data
+          * \param[in] index a \a valid index in \a cloud representing a \a valid (i.e., finite) query point
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in,out] context the scratch buffers to use, which must not be shared between threads
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value. If \a max_nn is set to
+          * 0 or to a number higher than the number of points in the input cloud, all neighbors in \a radius will be
+          * returned.
+          * \return number of neighbors found in radius
+          */
+        virtual int
+        radiusSearch (const PointCloud &cloud, int index, double radius,
+                      std::vector<int> &k_indices, std::vector<float> &k_sqr_distances,
+                      SearchContext &context, unsigned int max_nn = 0) const;
+
         /** \brief Search for all the nearest neighbors of the query point in a given radius (zero-copy).
           *
           * \attention This method does not do any bounds checking for the input index
@@ -396,14 +472,55 @@ namespace pcl
           }
         }
 
+        /** \brief Search for the k-nearest neighbors of a batch of query points, using \ref setNumberOfThreads
+          * threads. The results are written to flat buffers instead of one vector per query point.
+          * \param[in] cloud the point cloud data
+          * \param[in] indices the indices in \a cloud of the query points. If indices is empty, all points are queried.
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points, as a row-major matrix with one row of
+          * \a k entries per query point. The rows of query points with less than \a k neighbors are padded with -1.
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points, in the same layout.
+          * Padded entries are set to std::numeric_limits<float>::max ().
+          * \note The output vectors are only resized, so reusing them across calls avoids any reallocation.
+          */
+        virtual void
+        batchNearestKSearch (const PointCloud &cloud, const std::vector<int> &indices, int k,
+                             std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const;
+
+        /** \brief Search for all the nearest neighbors of a batch of query points in a given radius, using
+          * \ref setNumberOfThreads threads. The results are written to flat buffers in compressed sparse row layout
+          * instead of one vector per query point.
+          * \param[in] cloud the point cloud data
+          * \param[in] indices the indices in \a cloud of the query points. If indices is empty, all points are queried.
+          * \param[in] radius the radius of the sphere bounding all of the neighbors
+          * \param[out] offsets the neighbors of the query point i are stored in the range [offsets[i], offsets[i + 1])
+          * of \a k_indices and \a k_sqr_distances, i.e. \a offsets has one entry more than the number of query points
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in] max_nn if given, bounds the maximum returned neighbors per query point to this value. If \a max_nn
+          * is set to 0 or to a number higher than the number of points in the input cloud, all neighbors in \a radius
+          * will be returned.
+          */
+        virtual void
+        batchRadiusSearch (const PointCloud &cloud, const std::vector<int> &indices, double radius,
+                           std::vector<size_t> &offsets, std::vector<int> &k_indices,
+                           std::vector<float> &k_sqr_distances, unsigned int max_nn = 0) const;
+
       protected:
         void 
         sortResults (std::vector<int>& indices, std::vector<float>& distances) const;
 
+        /** \brief Get the number of threads to use for a batch search. */
+        int
+        getBatchThreads () const;
+
         PointCloudConstPtr input_;
         IndicesConstPtr indices_;
         bool sorted_results_;
         std::string name_;
+
+        /** \brief The number of threads the batch searches should use. */
+        unsigned int threads_;
         
       private:
         struct Compare
@@ -0,0 +1,265 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_SEARCH_VOXEL_HASH_H_
+#define PCL_SEARCH_VOXEL_HASH_H_
+
+#include <pcl/search/search.h>
+#include <pcl/search/knn_heap.h>
+#include <cmath>
+
+namespace pcl
+{
+  namespace search
+  {
+    /** \brief VoxelHash is an approximate nearest neighbor search on a hashed voxel grid, meant for clouds with a
+      * known, roughly uniform density such as voxel-downsampled maps.
+      *
+      * The points are bucketed by voxel, and the occupied voxels are found through an open addressing hash table,
+      * so a lookup costs O(1) whatever the size of the cloud.
+      *
+      * The k-nearest neighbor search only looks at the voxels within \ref getSearchExtent () voxels of the voxel of
+      * the query point. Its results are exact up to the distance \a extent * \a resolution: a neighbor closer than
+      * this is never missed, while farther neighbors may be missing or replaced by other points (the search
+      * returns less than \a k points if the searched voxels do not hold enough). The radius search visits every
+      * voxel overlapping the sphere and is exact.
+      *
+      * \note The voxel keys are limited to [-\ref MAX_KEY, \ref MAX_KEY] along each axis: \ref setInputCloud
+      * rejects a cloud extending beyond them, and query points beyond them have no k-nearest neighbors.
+      *
+      * \ingroup search
+      */
+    template<typename PointT>
+    class VoxelHash: public Search<PointT>
+    {
+      public:
+        typedef typename Search<PointT>::PointCloud PointCloud;
+        typedef typename Search<PointT>::PointCloudConstPtr PointCloudConstPtr;
+
+        typedef boost::shared_ptr<std::vector<int> > IndicesPtr;
+        typedef boost::shared_ptr<const std::vector<int> > IndicesConstPtr;
+
+        using pcl::search::Search<PointT>::input_;
+        using pcl::search::Search<PointT>::indices_;
+        using pcl::search::Search<PointT>::sorted_results_;
+        using pcl::search::Search<PointT>::nearestKSearch;
+        using pcl::search::Search<PointT>::radiusSearch;
+
+        typedef boost::shared_ptr<VoxelHash<PointT> > Ptr;
+        typedef boost::shared_ptr<const VoxelHash<PointT> > ConstPtr;
+
+        /** \brief The largest absolute voxel key, small enough for the keys of the searched ranges to fit in an int. */
+        static const int MAX_KEY = 1 << 29;
+
+        /** \brief Constructor.
+          * \param[in] resolution the edge length of the voxels, typically the spacing of the points
+          * \param[in] sorted set to true if the radius search results need to be sorted in ascending order of
+          * their distance to the query point
+          */
+        VoxelHash (double resolution, bool sorted = true)
+          : Search<PointT> ("VoxelHash", sorted)
+          , resolution_ (resolution)
+          , search_extent_ (1)
+          , voxels_ ()
+          , table_ ()
+          , x_ (), y_ (), z_ ()
+          , point_indices_ ()
+        {
+        }
+
+        /** \brief Destructor. */
+        virtual
+        ~VoxelHash ()
+        {
+        }
+
+        /** \brief Set the edge length of the voxels. Takes effect at the next \ref setInputCloud. */
+        inline void
+        setResolution (double resolution)
+        {
+          resolution_ = resolution;
+        }
+
+        /** \brief Get the edge length of the voxels. */
+        inline double
+        getResolution () const
+        {
+          return (resolution_);
+        }
+
+        /** \brief Set the number of voxels searched around the voxel of the query point by the k-nearest neighbor
+          * search along each axis, i.e. the search visits (2 * extent + 1)^3 voxels.
+          * \param[in] extent the number of voxels (at least 1, at most \ref MAX_KEY)
+          */
+        inline void
+        setSearchExtent (int extent)
+        {
+          if (extent > MAX_KEY)
+            extent = MAX_KEY;
+          search_extent_ = extent > 0 ? extent : 1;
+        }
+
+        /** \brief Get the number of voxels searched around the voxel of the query point. */
+        inline int
+        getSearchExtent () const
+        {
+          return (search_extent_);
+        }
+
+        /** \brief Get the distance up to which the k-nearest neighbor search is exact. */
+        inline double
+        getExactDistance () const
+        {
+          return (search_extent_ * resolution_);
+        }
+
+        /** \brief Provide a pointer to the input dataset, and hash its points.
+          * \note If a voxel key of a point exceeds \ref MAX_KEY, an error is printed and the search holds no point.
+          * \param[in] cloud the const boost shared pointer to a PointCloud message
+          * \param[in] indices the point indices subset that is to be used from \a cloud
+          */
+        void
+        setInputCloud (const PointCloudConstPtr& cloud,
+                       const IndicesConstPtr& indices = IndicesConstPtr ());
+
+        /** \brief Search for the k-nearest neighbors for the given query point, among the points of the voxels
+          * around the query point (see the class description).
+          * \param[in] point the given query point
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \return number of neighbors found, which may be less than \a k
+          */
+        int
+        nearestKSearch (const PointT &point, int k,
+                        std::vector<int> &k_indices,
+                        std::vector<float> &k_sqr_distances) const;
+
+        /** \brief Search for all the nearest neighbors of the query point in a given radius.
+          * \param[in] point the given query point
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value. If \a max_nn is set to
+          * 0 or to a number higher than the number of points in the input cloud, all neighbors in \a radius will be
+          * returned. Otherwise the \a max_nn closest ones are returned, sorted.
+          * \return number of neighbors found in radius
+          */
+        int
+        radiusSearch (const PointT& point, double radius,
+                      std::vector<int> &k_indices,
+                      std::vector<float> &k_sqr_distances,
+                      unsigned int max_nn = 0) const;
+
+      protected:
+        /** \brief An occupied voxel, whose points are stored from \a begin to \a end. */
+        struct Voxel
+        {
+          int key[3];
+          int begin;
+          int end;
+        };
+
+        /** \brief Compute the voxel key of a coordinate.
+          * \param[in] value the coordinate
+          * \param[in] inverse_resolution the inverse of the edge length of the voxels
+          * \param[out] key the voxel key
+          * \return false if the key is outside of [-MAX_KEY, MAX_KEY]
+          */
+        static inline bool
+        getVoxelKey (float value, double inverse_resolution, int &key)
+        {
+          const double k = std::floor (value * inverse_resolution);
+          if (!(k >= -MAX_KEY && k <= MAX_KEY))
+            return (false);
+          key = static_cast<int> (k);
+          return (true);
+        }
+
+        /** \brief Compute the slot of a voxel key in the hash table. */
+        inline size_t
+        hashKey (int kx, int ky, int kz) const
+        {
+          return ((static_cast<size_t> (static_cast<unsigned int> (kx) * 73856093u ^
+                                        static_cast<unsigned int> (ky) * 19349663u ^
+                                        static_cast<unsigned int> (kz) * 83492791u)) & (table_.size () - 1));
+        }
+
+        /** \brief Get the voxel of the given key, or NULL if it holds no point. */
+        const Voxel*
+        findVoxel (int kx, int ky, int kz) const;
+
+        /** \brief Insert a voxel into the hash table, which must have a free slot. */
+        void
+        insertVoxel (int voxel);
+
+        /** \brief Compute the squared distance of a query point to the box of a voxel. */
+        float
+        sqrDistanceToVoxel (const float *query, const Voxel &voxel) const;
+
+        /** \brief Add the points of a voxel closer than the current bound to \a result. */
+        void
+        scanVoxel (const Voxel &voxel, const float *query, KnnHeap &result) const;
+
+        /** \brief The edge length of the voxels. */
+        double resolution_;
+
+        /** \brief The number of voxels searched around the voxel of the query point. */
+        int search_extent_;
+
+        /** \brief The occupied voxels. */
+        std::vector<Voxel> voxels_;
+
+        /** \brief The hash table, holding voxel numbers (-1 for empty slots). Its size is a power of two. */
+        std::vector<int> table_;
+
+        /** \brief The coordinates of the points, grouped by voxel. */
+        std::vector<float> x_, y_, z_;
+
+        /** \brief The index in the input cloud of every point, grouped by voxel. */
+        std::vector<int> point_indices_;
+    };
+  }
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/search/impl/voxel_hash.hpp>
+#endif
+
+#endif    // PCL_SEARCH_VOXEL_HASH_H_
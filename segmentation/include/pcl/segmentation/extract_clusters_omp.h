@@ -0,0 +1,147 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_SEGMENTATION_EXTRACT_CLUSTERS_OMP_H_
+#define PCL_SEGMENTATION_EXTRACT_CLUSTERS_OMP_H_
+
+#include <pcl/segmentation/extract_clusters.h>
+
+namespace pcl
+{
+  /** \brief EuclideanClusterExtractionOMP is a parallel version of \ref EuclideanClusterExtraction, using the
+    * OpenMP standard.
+    *
+    * Instead of growing one cluster at a time with a breadth-first search, the radius queries of all the points
+    * are issued in parallel and the clusters are obtained as the connected components of the resulting
+    * neighborhood graph, using a union-find forest. Every thread links the points of a contiguous block on its own;
+    * the few edges that cross block boundaries are merged afterwards. Every component is rooted at its point that
+    * comes first in the indices, so the clusters (including the order of clusters of equal size) are identical to
+    * the ones returned by \ref EuclideanClusterExtraction, independently of the number of threads.
+    *
+    * \note The search object must support concurrent const queries, which is the case for all the
+    * \ref pcl::search::Search implementations shipped with PCL.
+    * \ingroup segmentation
+    */
+  template <typename PointT>
+  class EuclideanClusterExtractionOMP: public EuclideanClusterExtraction<PointT>
+  {
+    typedef EuclideanClusterExtraction<PointT> BaseClass;
+
+    public:
+      typedef typename BaseClass::PointCloud PointCloud;
+      typedef typename BaseClass::KdTree KdTree;
+      typedef typename BaseClass::KdTreePtr KdTreePtr;
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      EuclideanClusterExtractionOMP (unsigned int nr_threads = 0) : threads_ (nr_threads)
+      {
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+      /** \brief Get the number of threads the scheduler is set to use (0 means automatic). */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
+      /** \brief Cluster extraction in a PointCloud given by <setInputCloud (), setIndices ()>, in parallel.
+        * \param[out] clusters the resultant point clusters
+        */
+      void
+      extract (std::vector<PointIndices> &clusters);
+
+    protected:
+      using BaseClass::input_;
+      using BaseClass::indices_;
+      using BaseClass::initCompute;
+      using BaseClass::deinitCompute;
+      using BaseClass::tree_;
+      using BaseClass::cluster_tolerance_;
+      using BaseClass::min_pts_per_cluster_;
+      using BaseClass::max_pts_per_cluster_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
+      /** \brief Find the root of a node in the union-find forest, halving the path on the way.
+        * \param[in,out] parent the parent of every node
+        * \param[in] node the node to look up
+        */
+      static inline int
+      findRoot (std::vector<int> &parent, int node)
+      {
+        while (parent[node] != node)
+        {
+          parent[node] = parent[parent[node]];
+          node = parent[node];
+        }
+        return (node);
+      }
+
+      /** \brief Merge the trees of two nodes, keeping the smallest node as the root.
+        * \param[in,out] parent the parent of every node
+        * \param[in] a the first node
+        * \param[in] b the second node
+        */
+      static inline void
+      unite (std::vector<int> &parent, int a, int b)
+      {
+        const int root_a = findRoot (parent, a);
+        const int root_b = findRoot (parent, b);
+        if (root_a < root_b)
+          parent[root_b] = root_a;
+        else if (root_b < root_a)
+          parent[root_a] = root_b;
+      }
+
+      /** \brief Class getName method. */
+      virtual std::string getClassName () const { return ("EuclideanClusterExtractionOMP"); }
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/segmentation/impl/extract_clusters_omp.hpp>
+#endif
+
+#endif  //#ifndef PCL_SEGMENTATION_EXTRACT_CLUSTERS_OMP_H_
@@ -0,0 +1,205 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_SEGMENTATION_IMPL_EXTRACT_CLUSTERS_OMP_H_
+#define PCL_SEGMENTATION_IMPL_EXTRACT_CLUSTERS_OMP_H_
+
+#include <pcl/segmentation/extract_clusters_omp.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::EuclideanClusterExtractionOMP<PointT>::extract (std::vector<PointIndices> &clusters)
+{
+  if (!initCompute () || 
+      (input_ != 0   && input_->points.empty ()) ||
+      (indices_ != 0 && indices_->empty ()))
+  {
+    clusters.clear ();
+    return;
+  }
+
+  // Initialize the spatial locator
+  if (!tree_)
+  {
+    if (input_->isOrganized ())
+      tree_.reset (new pcl::search::OrganizedNeighbor<PointT> ());
+    else
+      tree_.reset (new pcl::search::KdTree<PointT> (false));
+  }
+
+  // Send the input dataset to the spatial locator
+  tree_->setInputCloud (input_, indices_);
+
+  const std::vector<int> &indices = *indices_;
+  const float tolerance = static_cast<float> (cluster_tolerance_);
+
+  // The nodes of the neighborhood graph are the distinct points of the indices, numbered in order of first
+  // appearance, which is the order in which the serial version seeds its clusters
+  std::vector<int> node_of_point (input_->points.size (), -1);
+  std::vector<int> node_point;
+  node_point.reserve (indices.size ());
+  for (size_t i = 0; i < indices.size (); ++i)
+  {
+    if (node_of_point[indices[i]] != -1)
+      continue;
+    node_of_point[indices[i]] = static_cast<int> (node_point.size ());
+    node_point.push_back (indices[i]);
+  }
+  const int nr_nodes = static_cast<int> (node_point.size ());
+
+  std::vector<int> parent (nr_nodes);
+  for (int v = 0; v < nr_nodes; ++v)
+    parent[v] = v;
+
+#ifdef _OPENMP
+  const int nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+#else
+  const int nr_threads = 1;
+#endif
+
+  // Edges leaving the block of nodes owned by a thread, and whether a thread hit a search error
+  std::vector<std::vector<std::pair<int, int> > > cross_edges (nr_threads);
+  std::vector<char> search_failed (nr_threads, 0);
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+  {
+#ifdef _OPENMP
+    const int tid = omp_get_thread_num ();
+    const int nr_blocks = omp_get_num_threads ();
+#else
+    const int tid = 0;
+    const int nr_blocks = 1;
+#endif
+    // Every thread owns a contiguous block of nodes and is the only one touching their parents
+    const int begin = static_cast<int> (static_cast<long long> (nr_nodes) * tid / nr_blocks);
+    const int end = static_cast<int> (static_cast<long long> (nr_nodes) * (tid + 1) / nr_blocks);
+
+    std::vector<int> nn_indices;
+    std::vector<float> nn_distances;
+    for (int v = begin; v < end; ++v)
+    {
+      if (tree_->radiusSearch (input_->points[node_point[v]], tolerance, nn_indices, nn_distances) == -1)
+      {
+        search_failed[tid] = 1;
+        break;
+      }
+
+      for (size_t j = 0; j < nn_indices.size (); ++j)
+      {
+        if (nn_indices[j] == -1)
+          continue;
+        const int u = node_of_point[nn_indices[j]];
+        if (u == -1 || u == v)
+          continue;
+        if (u >= begin && u < end)
+          unite (parent, v, u);
+        else
+          cross_edges[tid].push_back (std::make_pair (v, u));
+      }
+    }
+  }
+
+  for (int t = 0; t < nr_threads; ++t)
+  {
+    if (search_failed[t])
+    {
+      PCL_ERROR ("[pcl::%s::extract] Received error code -1 from radiusSearch\n", getClassName ().c_str ());
+      deinitCompute ();
+      return;
+    }
+  }
+
+  // Merge the blocks along the edges crossing their boundaries
+  for (int t = 0; t < nr_threads; ++t)
+    for (size_t e = 0; e < cross_edges[t].size (); ++e)
+      unite (parent, cross_edges[t][e].first, cross_edges[t][e].second);
+
+  // Every root is the first node of its component, so numbering the roots in increasing order yields the
+  // clusters in the order the serial version emits them
+  std::vector<int> root (nr_nodes);
+  std::vector<int> component_size (nr_nodes, 0);
+  for (int v = 0; v < nr_nodes; ++v)
+  {
+    root[v] = findRoot (parent, v);
+    ++component_size[root[v]];
+  }
+
+  const size_t first_cluster = clusters.size ();
+  std::vector<int> cluster_of_root (nr_nodes, -1);
+  for (int v = 0; v < nr_nodes; ++v)
+  {
+    if (root[v] != v)
+      continue;
+    if (component_size[v] < min_pts_per_cluster_ || component_size[v] > max_pts_per_cluster_)
+      continue;
+    cluster_of_root[v] = static_cast<int> (clusters.size () - first_cluster);
+    clusters.push_back (pcl::PointIndices ());
+    clusters.back ().indices.reserve (component_size[v]);
+    clusters.back ().header = input_->header;
+  }
+
+  for (int v = 0; v < nr_nodes; ++v)
+  {
+    const int c = cluster_of_root[root[v]];
+    if (c != -1)
+      clusters[first_cluster + c].indices.push_back (node_point[v]);
+  }
+
+  const int nr_clusters = static_cast<int> (clusters.size () - first_cluster);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nr_threads)
+#endif
+  for (int c = 0; c < nr_clusters; ++c)
+    std::sort (clusters[first_cluster + c].indices.begin (), clusters[first_cluster + c].indices.end ());
+
+  // Sort the clusters based on their size (largest one first)
+  std::sort (clusters.rbegin (), clusters.rend (), comparePointClusters);
+
+  deinitCompute ();
+}
+
+#define PCL_INSTANTIATE_EuclideanClusterExtractionOMP(T) template class PCL_EXPORTS pcl::EuclideanClusterExtractionOMP<T>;
+
+#endif        // PCL_SEGMENTATION_IMPL_EXTRACT_CLUSTERS_OMP_H_
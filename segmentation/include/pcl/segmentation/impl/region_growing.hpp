@@ -52,6 +52,10 @@
 #include <cmath>
 #include <time.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename NormalT>
 pcl::RegionGrowing<PointT, NormalT>::RegionGrowing () :
@@ -67,11 +71,14 @@ pcl::RegionGrowing<PointT, NormalT>::RegionGrowing () :
   search_ (),
   normals_ (),
   point_neighbours_ (0),
+  point_neighbour_offsets_ (0),
   point_labels_ (0),
   normal_flag_ (true),
   num_pts_in_segment_ (0),
   clusters_ (0),
-  number_of_segments_ (0)
+  number_of_segments_ (0),
+  threads_ (0),
+  parallel_growing_flag_ (false)
 {
 }
 
@@ -85,6 +92,7 @@ pcl::RegionGrowing<PointT, NormalT>::~RegionGrowing ()
     normals_.reset ();
 
   point_neighbours_.clear ();
+  point_neighbour_offsets_.clear ();
   point_labels_.clear ();
   num_pts_in_segment_.clear ();
   clusters_.clear ();
@@ -256,6 +264,34 @@ pcl::RegionGrowing<PointT, NormalT>::setInputNormals (const NormalPtr& norm)
   normals_ = norm;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename NormalT> unsigned int
+pcl::RegionGrowing<PointT, NormalT>::getNumberOfThreads () const
+{
+  return (threads_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename NormalT> void
+pcl::RegionGrowing<PointT, NormalT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename NormalT> bool
+pcl::RegionGrowing<PointT, NormalT>::getParallelGrowingFlag () const
+{
+  return (parallel_growing_flag_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename NormalT> void
+pcl::RegionGrowing<PointT, NormalT>::setParallelGrowingFlag (bool value)
+{
+  parallel_growing_flag_ = value;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename NormalT> void
 pcl::RegionGrowing<PointT, NormalT>::extract (std::vector <pcl::PointIndices>& clusters)
@@ -263,6 +299,7 @@ pcl::RegionGrowing<PointT, NormalT>::extract (std::vector <pcl::PointIndices>& c
   clusters_.clear ();
   clusters.clear ();
   point_neighbours_.clear ();
+  point_neighbour_offsets_.clear ();
   point_labels_.clear ();
   num_pts_in_segment_.clear ();
   number_of_segments_ = 0;
@@ -352,33 +389,90 @@ pcl::RegionGrowing<PointT, NormalT>::prepareForSegmentation ()
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename NormalT> void
 pcl::RegionGrowing<PointT, NormalT>::findPointNeighbours ()
+{
+  computePointNeighbours (neighbour_number_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename NormalT> void
+pcl::RegionGrowing<PointT, NormalT>::computePointNeighbours (unsigned int neighbour_number, std::vector<float>* distances)
 {
   int point_number = static_cast<int> (indices_->size ());
-  std::vector<int> neighbours;
-  std::vector<float> distances;
+  int number_of_points = static_cast<int> (input_->points.size ());
 
-  point_neighbours_.resize (input_->points.size (), neighbours);
-  if (input_->is_dense)
+#ifdef _OPENMP
+  const int nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+#else
+  const int nr_threads = 1;
+#endif
+
+  // Every block of indices is searched into its own buffer, the buffers are copied to their final place
+  // once the number of neighbours of every point is known
+  std::vector<std::vector<int> > block_neighbours (nr_threads);
+  std::vector<std::vector<float> > block_distances (nr_threads);
+  std::vector<int> neighbour_count (point_number, 0);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nr_threads)
+#endif
+  for (int i_block = 0; i_block < nr_threads; i_block++)
   {
-    for (int i_point = 0; i_point < point_number; i_point++)
+    int begin = static_cast<int> (static_cast<long long> (point_number) * i_block / nr_threads);
+    int end = static_cast<int> (static_cast<long long> (point_number) * (i_block + 1) / nr_threads);
+    std::vector<int> neighbours;
+    std::vector<float> nghbr_distances;
+    for (int i_point = begin; i_point < end; i_point++)
     {
-      int point_index = (*indices_)[i_point];
-      neighbours.clear ();
-      search_->nearestKSearch (i_point, neighbour_number_, neighbours, distances);
-      point_neighbours_[point_index].swap (neighbours);
+      if (!input_->is_dense && !pcl::isFinite (input_->points[(*indices_)[i_point]]))
+        continue;
+      search_->nearestKSearch (i_point, neighbour_number, neighbours, nghbr_distances);
+      neighbour_count[i_point] = static_cast<int> (neighbours.size ());
+      block_neighbours[i_block].insert (block_neighbours[i_block].end (), neighbours.begin (), neighbours.end ());
+      if (distances)
+        block_distances[i_block].insert (block_distances[i_block].end (), nghbr_distances.begin (), nghbr_distances.end ());
     }
   }
-  else
+
+  // If a point is listed several times in the indices, its last search is kept
+  std::vector<int> owner (number_of_points, -1);
+  for (int i_point = 0; i_point < point_number; i_point++)
+    owner[(*indices_)[i_point]] = i_point;
+
+  point_neighbour_offsets_.resize (number_of_points + 1);
+  point_neighbour_offsets_[0] = 0;
+  for (int i_point = 0; i_point < number_of_points; i_point++)
+  {
+    size_t count = owner[i_point] == -1 ? 0 : neighbour_count[owner[i_point]];
+    point_neighbour_offsets_[i_point + 1] = point_neighbour_offsets_[i_point] + count;
+  }
+  point_neighbours_.resize (point_neighbour_offsets_[number_of_points]);
+  if (distances)
+    distances->resize (point_neighbour_offsets_[number_of_points]);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nr_threads)
+#endif
+  for (int i_block = 0; i_block < nr_threads; i_block++)
   {
-    for (int i_point = 0; i_point < point_number; i_point++)
+    int begin = static_cast<int> (static_cast<long long> (point_number) * i_block / nr_threads);
+    int end = static_cast<int> (static_cast<long long> (point_number) * (i_block + 1) / nr_threads);
+    size_t position = 0;
+    for (int i_point = begin; i_point < end; i_point++)
     {
-      neighbours.clear ();
       int point_index = (*indices_)[i_point];
-      if (!pcl::isFinite (input_->points[point_index]))
-        continue;
-      search_->nearestKSearch (i_point, neighbour_number_, neighbours, distances);
-      point_neighbours_[point_index].swap (neighbours);
+      int count = neighbour_count[i_point];
+      if (owner[point_index] == i_point)
+      {
+        std::copy (block_neighbours[i_block].begin () + position, block_neighbours[i_block].begin () + position + count,
+                   point_neighbours_.begin () + point_neighbour_offsets_[point_index]);
+        if (distances)
+          std::copy (block_distances[i_block].begin () + position, block_distances[i_block].begin () + position + count,
+                     distances->begin () + point_neighbour_offsets_[point_index]);
+      }
+      position += count;
     }
+    std::vector<int> ().swap (block_neighbours[i_block]);
+    std::vector<float> ().swap (block_distances[i_block]);
   }
 }
 
@@ -386,6 +480,12 @@ pcl::RegionGrowing<PointT, NormalT>::findPointNeighbours ()
 template <typename PointT, typename NormalT> void
 pcl::RegionGrowing<PointT, NormalT>::applySmoothRegionGrowingAlgorithm ()
 {
+  if (parallel_growing_flag_ && (smooth_mode_flag_ || !normal_flag_))
+  {
+    applyParallelRegionGrowingAlgorithm ();
+    return;
+  }
+
   int num_of_pts = static_cast<int> (indices_->size ());
   point_labels_.resize (input_->points.size (), -1);
 
@@ -438,6 +538,251 @@ pcl::RegionGrowing<PointT, NormalT>::applySmoothRegionGrowingAlgorithm ()
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename NormalT> void
+pcl::RegionGrowing<PointT, NormalT>::applyParallelRegionGrowingAlgorithm ()
+{
+  int num_of_pts = static_cast<int> (indices_->size ());
+  int number_of_points = static_cast<int> (input_->points.size ());
+  point_labels_.resize (number_of_points, -1);
+
+#ifdef _OPENMP
+  const int nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+#else
+  const int nr_threads = 1;
+#endif
+
+  // Test every edge of the neighbourhood graph: a seed edge leads to a neighbour that can grow the segment further,
+  // an attach edge to a neighbour that only belongs to the segment
+  const unsigned char seed_edge = 1;
+  const unsigned char attach_edge = 2;
+  std::vector<unsigned char> edge_type (point_neighbours_.size (), 0);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 256) num_threads(nr_threads)
+#endif
+  for (int i_point = 0; i_point < number_of_points; i_point++)
+  {
+    size_t first_nghbr = point_neighbour_offsets_[i_point];
+    size_t last_nghbr = std::min<size_t> (point_neighbour_offsets_[i_point + 1], first_nghbr + neighbour_number_);
+    for (size_t i_nghbr = first_nghbr; i_nghbr < last_nghbr; i_nghbr++)
+    {
+      bool is_a_seed = false;
+      if (validatePoint (i_point, i_point, point_neighbours_[i_nghbr], is_a_seed))
+        edge_type[i_nghbr] = is_a_seed ? seed_edge : attach_edge;
+    }
+  }
+
+  // Every thread works on a block of consecutive points, the trees of the union-find forest are rooted at their
+  // smallest point index whatever the order of the merges, so the labels do not depend on the number of threads
+  const int block_size = std::max (1, (number_of_points + nr_threads - 1) / nr_threads);
+  const int nr_blocks = (number_of_points + block_size - 1) / block_size;
+
+  // Merge the points along the seed edges leaving the points that pass the curvature test
+  std::vector<int> parent (number_of_points);
+  std::vector<int> root (number_of_points);
+  std::vector<unsigned char> unite_edge (point_neighbours_.size (), 0);
+  std::vector<unsigned char> is_grown (number_of_points, 0);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(nr_threads)
+#endif
+  for (int i_point = 0; i_point < number_of_points; i_point++)
+  {
+    parent[i_point] = i_point;
+    if (curvature_flag_ && normals_->points[i_point].curvature > curvature_threshold_)
+      continue;
+    for (size_t i_nghbr = point_neighbour_offsets_[i_point]; i_nghbr < point_neighbour_offsets_[i_point + 1]; i_nghbr++)
+      unite_edge[i_nghbr] = edge_type[i_nghbr] == seed_edge;
+  }
+
+  uniteAlongEdges (unite_edge, block_size, parent, &is_grown);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(nr_threads)
+#endif
+  for (int i_point = 0; i_point < number_of_points; i_point++)
+  {
+    int point_root = i_point;
+    while (parent[point_root] != point_root)
+      point_root = parent[point_root];
+    root[i_point] = point_root;
+  }
+  parent.swap (root);
+
+  // The points that were not reached by any seed edge join the first grown segment that attaches them. Every
+  // block sorts its attachments by the block of the attached points, which then takes them in the order of
+  // the grown points
+  std::vector<std::vector<std::pair<int, int> > > attachments (nr_blocks * nr_blocks);
+  std::vector<unsigned char> is_attached (number_of_points, 0);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nr_threads)
+#endif
+  for (int i_block = 0; i_block < nr_blocks; i_block++)
+  {
+    const int begin = i_block * block_size;
+    const int end = std::min (begin + block_size, number_of_points);
+    for (int i_point = begin; i_point < end; i_point++)
+    {
+      if (!is_grown[i_point])
+        continue;
+      for (size_t i_nghbr = point_neighbour_offsets_[i_point]; i_nghbr < point_neighbour_offsets_[i_point + 1]; i_nghbr++)
+      {
+        int index = point_neighbours_[i_nghbr];
+        if (edge_type[i_nghbr] == attach_edge && !is_grown[index])
+          attachments[(index / block_size) * nr_blocks + i_block].push_back (std::make_pair (index, parent[i_point]));
+      }
+    }
+  }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nr_threads)
+#endif
+  for (int i_block = 0; i_block < nr_blocks; i_block++)
+  {
+    for (int i_source = 0; i_source < nr_blocks; i_source++)
+    {
+      std::vector<std::pair<int, int> >& block_attachments = attachments[i_block * nr_blocks + i_source];
+      for (size_t i_attachment = 0; i_attachment < block_attachments.size (); i_attachment++)
+      {
+        int index = block_attachments[i_attachment].first;
+        if (is_attached[index])
+          continue;
+        parent[index] = block_attachments[i_attachment].second;
+        is_attached[index] = 1;
+      }
+      std::vector<std::pair<int, int> > ().swap (block_attachments);
+    }
+  }
+
+  // The remaining points, which would be used as the last seeds by the sequential algorithm, are grouped
+  // along all the edges that pass the tests
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(nr_threads)
+#endif
+  for (int i_point = 0; i_point < number_of_points; i_point++)
+  {
+    bool is_left = !is_grown[i_point] && !is_attached[i_point];
+    for (size_t i_nghbr = point_neighbour_offsets_[i_point]; i_nghbr < point_neighbour_offsets_[i_point + 1]; i_nghbr++)
+    {
+      int index = point_neighbours_[i_nghbr];
+      unite_edge[i_nghbr] = is_left && edge_type[i_nghbr] != 0 && !is_grown[index] && !is_attached[index];
+    }
+  }
+
+  uniteAlongEdges (unite_edge, block_size, parent);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(nr_threads)
+#endif
+  for (int i_point = 0; i_point < number_of_points; i_point++)
+  {
+    int point_root = i_point;
+    while (parent[point_root] != point_root)
+      point_root = parent[point_root];
+    root[i_point] = point_root;
+  }
+
+  // Number the segments by their smallest point index
+  std::vector<bool> is_indexed (number_of_points, false);
+  for (int i_point = 0; i_point < num_of_pts; i_point++)
+    is_indexed[(*indices_)[i_point]] = true;
+
+  std::vector<int> segment_of_root (number_of_points, -1);
+  for (int i_point = 0; i_point < number_of_points; i_point++)
+  {
+    if (!is_indexed[i_point])
+      continue;
+    int point_root = root[i_point];
+    if (segment_of_root[point_root] == -1)
+    {
+      segment_of_root[point_root] = static_cast<int> (num_pts_in_segment_.size ());
+      num_pts_in_segment_.push_back (0);
+    }
+    point_labels_[i_point] = segment_of_root[point_root];
+    num_pts_in_segment_[segment_of_root[point_root]]++;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename NormalT> void
+pcl::RegionGrowing<PointT, NormalT>::uniteAlongEdges (const std::vector<unsigned char>& edge_flag, int block_size,
+                                                      std::vector<int>& parent, std::vector<unsigned char>* is_merged)
+{
+  int number_of_points = static_cast<int> (parent.size ());
+  int nr_blocks = (number_of_points + block_size - 1) / block_size;
+  int nr_levels = 0;
+  while ((1 << nr_levels) < nr_blocks)
+    nr_levels++;
+
+#ifdef _OPENMP
+  const int nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+#else
+  const int nr_threads = 1;
+#endif
+
+  // An edge between two blocks is kept for the first level at which both blocks belong to the same group, the
+  // groups of level l being made of 2^l consecutive blocks
+  std::vector<std::vector<std::pair<int, int> > > cross_edges (nr_blocks * nr_levels);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nr_threads)
+#endif
+  for (int i_block = 0; i_block < nr_blocks; i_block++)
+  {
+    const int begin = i_block * block_size;
+    const int end = std::min (begin + block_size, number_of_points);
+    for (int i_point = begin; i_point < end; i_point++)
+    {
+      for (size_t i_nghbr = point_neighbour_offsets_[i_point]; i_nghbr < point_neighbour_offsets_[i_point + 1]; i_nghbr++)
+      {
+        if (!edge_flag[i_nghbr])
+          continue;
+        int index = point_neighbours_[i_nghbr];
+        int nghbr_block = index / block_size;
+        if (is_merged)
+          (*is_merged)[i_point] = 1;
+        if (nghbr_block == i_block)
+        {
+          unite (parent, i_point, index);
+          if (is_merged)
+            (*is_merged)[index] = 1;
+          continue;
+        }
+        int level = 1;
+        while ((i_block >> level) != (nghbr_block >> level))
+          level++;
+        cross_edges[i_block * nr_levels + level - 1].push_back (std::make_pair (i_point, index));
+      }
+    }
+  }
+
+  // The trees of a group only hold points of the group, so the groups of a level are merged independently
+  for (int level = 1; level <= nr_levels; level++)
+  {
+    int nr_groups = (nr_blocks + (1 << level) - 1) >> level;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nr_threads)
+#endif
+    for (int i_group = 0; i_group < nr_groups; i_group++)
+    {
+      const int first_block = i_group << level;
+      const int last_block = std::min ((i_group + 1) << level, nr_blocks);
+      for (int i_block = first_block; i_block < last_block; i_block++)
+      {
+        const std::vector<std::pair<int, int> >& edges = cross_edges[i_block * nr_levels + level - 1];
+        for (size_t i_edge = 0; i_edge < edges.size (); i_edge++)
+        {
+          unite (parent, edges[i_edge].first, edges[i_edge].second);
+          if (is_merged)
+            (*is_merged)[edges[i_edge].second] = 1;
+        }
+      }
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename NormalT> int
 pcl::RegionGrowing<PointT, NormalT>::growRegion (int initial_seed, int segment_number)
@@ -454,10 +799,12 @@ pcl::RegionGrowing<PointT, NormalT>::growRegion (int initial_seed, int segment_n
     curr_seed = seeds.front ();
     seeds.pop ();
 
+    size_t first_nghbr = point_neighbour_offsets_[curr_seed];
+    size_t number_of_neighbours = point_neighbour_offsets_[curr_seed + 1] - first_nghbr;
     size_t i_nghbr = 0;
-    while ( i_nghbr < neighbour_number_ && i_nghbr < point_neighbours_[curr_seed].size () )
+    while ( i_nghbr < neighbour_number_ && i_nghbr < number_of_neighbours )
     {
-      int index = point_neighbours_[curr_seed][i_nghbr];
+      int index = point_neighbours_[first_nghbr + i_nghbr];
       if (point_labels_[index] != -1)
       {
         i_nghbr++;
@@ -602,6 +949,7 @@ pcl::RegionGrowing<PointT, NormalT>::getSegmentFromPoint (int index, pcl::PointI
     if (clusters_.empty ())
     {
       point_neighbours_.clear ();
+      point_neighbour_offsets_.clear ();
       point_labels_.clear ();
       num_pts_in_segment_.clear ();
       number_of_segments_ = 0;
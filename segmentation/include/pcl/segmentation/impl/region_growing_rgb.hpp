@@ -165,6 +165,7 @@ pcl::RegionGrowingRGB<PointT, NormalT>::extract (std::vector <pcl::PointIndices>
   clusters_.clear ();
   clusters.clear ();
   point_neighbours_.clear ();
+  point_neighbour_offsets_.clear ();
   point_labels_.clear ();
   num_pts_in_segment_.clear ();
   point_distances_.clear ();
@@ -271,22 +272,7 @@ pcl::RegionGrowingRGB<PointT, NormalT>::prepareForSegmentation ()
 template <typename PointT, typename NormalT> void
 pcl::RegionGrowingRGB<PointT, NormalT>::findPointNeighbours ()
 {
-  int point_number = static_cast<int> (indices_->size ());
-  std::vector<int> neighbours;
-  std::vector<float> distances;
-
-  point_neighbours_.resize (input_->points.size (), neighbours);
-  point_distances_.resize (input_->points.size (), distances);
-
-  for (int i_point = 0; i_point < point_number; i_point++)
-  {
-    int point_index = (*indices_)[i_point];
-    neighbours.clear ();
-    distances.clear ();
-    search_->nearestKSearch (i_point, region_neighbour_number_, neighbours, distances);
-    point_neighbours_[point_index].swap (neighbours);
-    point_distances_[point_index].swap (distances);
-  }
+  computePointNeighbours (region_neighbour_number_, &point_distances_);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -321,20 +307,21 @@ pcl::RegionGrowingRGB<PointT, NormalT>::findRegionsKNN (int index, int nghbr_num
   for (int i_point = 0; i_point < number_of_points; i_point++)
   {
     int point_index = clusters_[index].indices[i_point];
-    int number_of_neighbours = static_cast<int> (point_neighbours_[point_index].size ());
+    int first_nghbr = static_cast<int> (point_neighbour_offsets_[point_index]);
+    int number_of_neighbours = static_cast<int> (point_neighbour_offsets_[point_index + 1]) - first_nghbr;
     //loop throug every neighbour of the current point, find out to which segment it belongs
     //and if it belongs to neighbouring segment and is close enough then remember segment and its distance
     for (int i_nghbr = 0; i_nghbr < number_of_neighbours; i_nghbr++)
     {
       // find segment
       int segment_index = -1;
-      segment_index = point_labels_[ point_neighbours_[point_index][i_nghbr] ];
+      segment_index = point_labels_[ point_neighbours_[first_nghbr + i_nghbr] ];
 
       if ( segment_index != index )
       {
         // try to push it to the queue
-        if (distances[segment_index] > point_distances_[point_index][i_nghbr])
-          distances[segment_index] = point_distances_[point_index][i_nghbr];
+        if (distances[segment_index] > point_distances_[first_nghbr + i_nghbr])
+          distances[segment_index] = point_distances_[first_nghbr + i_nghbr];
       }
     }
   }// next point
@@ -715,6 +702,7 @@ pcl::RegionGrowingRGB<PointT, NormalT>::getSegmentFromPoint (int index, pcl::Poi
     {
       clusters_.clear ();
       point_neighbours_.clear ();
+      point_neighbour_offsets_.clear ();
       point_labels_.clear ();
       num_pts_in_segment_.clear ();
       point_distances_.clear ();
@@ -201,6 +201,36 @@ namespace pcl
       void
       setInputNormals (const NormalPtr& norm);
 
+      /** \brief Returns the number of threads used for the neighbour search and the parallel growing (0 means automatic). */
+      unsigned int
+      getNumberOfThreads () const;
+
+      /** \brief Allows to set the number of threads used for finding the neighbours of the points and for the
+        * parallel region growing algorithm.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Returns the flag that signalizes if the parallel region growing algorithm is used. */
+      bool
+      getParallelGrowingFlag () const;
+
+      /** \brief Allows to turn on/off the parallel region growing algorithm. Instead of growing the segments one
+        * after another from the seed points, it tests all the edges of the neighbourhood graph in parallel and
+        * merges the points with a union-find forest. An edge from a point that passes the curvature test to one of
+        * its neighbours joins both points if the neighbour passes all the tests as a seed; if the neighbour only
+        * belongs to the segment without being a seed, it is attached to the first grown segment that reaches it.
+        * The points left over are grouped along all the edges that pass the tests. Since the points are never
+        * visited in curvature order, the segments may slightly differ from the ones obtained with the sequential
+        * algorithm, and they are ordered by their smallest point index.
+        * The parallel algorithm is only used in smooth mode (or when the normal test is off), since otherwise
+        * the test depends on the initial seed of each segment.
+        * \param[in] value if set to true then the parallel algorithm will be used
+        */
+      void
+      setParallelGrowingFlag (bool value);
+
       /** \brief This method launches the segmentation algorithm and returns the clusters that were
         * obtained during the segmentation.
         * \param[out] clusters clusters that were obtained. Each cluster is an array of point indices.
@@ -247,6 +277,14 @@ namespace pcl
       virtual void
       findPointNeighbours ();
 
+      /** \brief Finds the KNN of every point in parallel and stores them contiguously in point_neighbours_,
+        * with their offsets in point_neighbour_offsets_.
+        * \param[in] neighbour_number the number of neighbours to find
+        * \param[out] distances if not null, receives the squared distances to the neighbours, in the same layout
+        */
+      void
+      computePointNeighbours (unsigned int neighbour_number, std::vector<float>* distances = 0);
+
       /** \brief This function implements the algorithm described in the article
         * "Segmentation of point clouds using smoothness constraint"
         * by T. Rabbania, F. A. van den Heuvelb, G. Vosselmanc.
@@ -254,6 +292,24 @@ namespace pcl
       void
       applySmoothRegionGrowingAlgorithm ();
 
+      /** \brief This function labels the points with the union-find version of the region growing algorithm,
+        * see setParallelGrowingFlag ().
+        */
+      void
+      applyParallelRegionGrowingAlgorithm ();
+
+      /** \brief Merges the points along the flagged edges of the neighbourhood graph. Every block of points is
+        * merged by its own thread, then the edges between the blocks are merged by groups of 2, 4, 8... blocks,
+        * so that a tree is never changed by two threads at once.
+        * \param[in] edge_flag tells which edges to merge along, in the layout of point_neighbours_
+        * \param[in] block_size the number of points in a block
+        * \param[in,out] parent the parent of every point
+        * \param[out] is_merged if not null, is set for both ends of every flagged edge
+        */
+      void
+      uniteAlongEdges (const std::vector<unsigned char>& edge_flag, int block_size, std::vector<int>& parent,
+                       std::vector<unsigned char>* is_merged = 0);
+
       /** \brief This method grows a segment for the given seed point. And returns the number of its points.
         * \param[in] initial_seed index of the point that will serve as the seed point
         * \param[in] segment_number indicates which number this segment will have
@@ -277,6 +333,37 @@ namespace pcl
       void
       assembleRegions ();
 
+      /** \brief Find the root of a point in the union-find forest, halving the path on the way.
+        * \param[in,out] parent the parent of every point
+        * \param[in] point the point to look up
+        */
+      static inline int
+      findRoot (std::vector<int>& parent, int point)
+      {
+        while (parent[point] != point)
+        {
+          parent[point] = parent[parent[point]];
+          point = parent[point];
+        }
+        return (point);
+      }
+
+      /** \brief Merge the trees of two points, keeping the smallest index as the root.
+        * \param[in,out] parent the parent of every point
+        * \param[in] first the first point
+        * \param[in] second the second point
+        */
+      static inline void
+      unite (std::vector<int>& parent, int first, int second)
+      {
+        const int first_root = findRoot (parent, first);
+        const int second_root = findRoot (parent, second);
+        if (first_root < second_root)
+          parent[second_root] = first_root;
+        else if (second_root < first_root)
+          parent[first_root] = second_root;
+      }
+
     protected:
 
       /** \brief Stores the minimum number of points that a cluster needs to contain in order to be considered valid. */
@@ -312,8 +399,13 @@ namespace pcl
       /** \brief Contains normals of the points that will be segmented. */
       NormalPtr normals_;
 
-      /** \brief Contains neighbours of each point. */
-      std::vector<std::vector<int> > point_neighbours_;
+      /** \brief Contains neighbours of each point. The neighbours of the point i are stored in the range
+        * [point_neighbour_offsets_[i], point_neighbour_offsets_[i + 1]) of this array.
+        */
+      std::vector<int> point_neighbours_;
+
+      /** \brief Offset of the neighbours of each point in point_neighbours_, with one extra entry at the end. */
+      std::vector<size_t> point_neighbour_offsets_;
 
       /** \brief Point labels that tells to which segment each point belongs. */
       std::vector<int> point_labels_;
@@ -332,6 +424,12 @@ namespace pcl
       /** \brief Stores the number of segments. */
       int number_of_segments_;
 
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
+      /** \brief If set to true then the union-find version of the region growing algorithm is used. */
+      bool parallel_growing_flag_;
+
     public:
       EIGEN_MAKE_ALIGNED_OPERATOR_NEW
   };
@@ -72,6 +72,8 @@ namespace pcl
       using RegionGrowing<PointT, NormalT>::theta_threshold_;
       using RegionGrowing<PointT, NormalT>::curvature_threshold_;
       using RegionGrowing<PointT, NormalT>::point_neighbours_;
+      using RegionGrowing<PointT, NormalT>::point_neighbour_offsets_;
+      using RegionGrowing<PointT, NormalT>::computePointNeighbours;
       using RegionGrowing<PointT, NormalT>::point_labels_;
       using RegionGrowing<PointT, NormalT>::num_pts_in_segment_;
       using RegionGrowing<PointT, NormalT>::clusters_;
@@ -261,8 +263,8 @@ namespace pcl
       /** \brief Number of neighbouring segments to find. */
       unsigned int region_neighbour_number_;
 
-      /** \brief Stores distances for the point neighbours from point_neighbours_ */
-      std::vector< std::vector<float> > point_distances_;
+      /** \brief Stores distances for the point neighbours from point_neighbours_, in the same layout. */
+      std::vector<float> point_distances_;
 
       /** \brief Stores the neighboures for the corresponding segments. */
       std::vector< std::vector<int> > segment_neighbours_;
@@ -41,16 +41,20 @@
 #include <pcl/point_types.h>
 #include <pcl/segmentation/extract_clusters.h>
 #include <pcl/segmentation/impl/extract_clusters.hpp>
+#include <pcl/segmentation/extract_clusters_omp.h>
+#include <pcl/segmentation/impl/extract_clusters_omp.hpp>
 #include <pcl/segmentation/extract_labeled_clusters.h>
 #include <pcl/segmentation/impl/extract_labeled_clusters.hpp>
 
 // Instantiations of specific point types
 #ifdef PCL_ONLY_CORE_POINT_TYPES
   PCL_INSTANTIATE(EuclideanClusterExtraction, (pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGBA)(pcl::PointXYZRGB))
+  PCL_INSTANTIATE(EuclideanClusterExtractionOMP, (pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGBA)(pcl::PointXYZRGB))
   PCL_INSTANTIATE(extractEuclideanClusters, (pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGBA)(pcl::PointXYZRGB))
   PCL_INSTANTIATE(extractEuclideanClusters_indices, (pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGBA)(pcl::PointXYZRGB))
 #else
   PCL_INSTANTIATE(EuclideanClusterExtraction, PCL_XYZ_POINT_TYPES)
+  PCL_INSTANTIATE(EuclideanClusterExtractionOMP, PCL_XYZ_POINT_TYPES)
   PCL_INSTANTIATE(extractEuclideanClusters, PCL_XYZ_POINT_TYPES)
   PCL_INSTANTIATE(extractEuclideanClusters_indices, PCL_XYZ_POINT_TYPES)
 #endif
@@ -779,6 +779,76 @@ TEST (PCL, computeMeanAndCovariance)
   EXPECT_EQ (covariance_matrix (2, 2), 1);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, computeMeanAndCovarianceFarFromOrigin)
+{
+  // A small planar patch far away from the origin, with a few invalid points, covering both the blocks and the
+  // remaining points of the vectorized accumulation
+  PointCloud<PointXYZ> cloud;
+  std::vector<int> indices;
+  PointXYZ point;
+  for (int i = 0; i < 23; ++i)
+  {
+    point.x = 1000.0f + 0.01f * static_cast<float> (i % 5);
+    point.y = -2000.0f + 0.01f * static_cast<float> (i / 5);
+    point.z = 500.0f;
+    cloud.push_back (point);
+    if (i % 7 == 3)
+    {
+      PointXYZ nan_point;
+      nan_point.x = nan_point.y = nan_point.z = std::numeric_limits<float>::quiet_NaN ();
+      cloud.push_back (nan_point);
+    }
+  }
+  cloud.is_dense = false;
+  // All the points, in reverse order
+  for (int i = static_cast<int> (cloud.size ()) - 1; i >= 0; --i)
+    indices.push_back (i);
+
+  // Reference computed in two passes, in double precision
+  Eigen::Vector4d centroid_d = Eigen::Vector4d::Zero ();
+  unsigned valid = 0;
+  for (size_t i = 0; i < cloud.size (); ++i)
+    if (isFinite (cloud[i]))
+    {
+      centroid_d += cloud[i].getVector4fMap ().cast<double> ();
+      ++valid;
+    }
+  centroid_d /= valid;
+  Eigen::Matrix3d covariance_d = Eigen::Matrix3d::Zero ();
+  for (size_t i = 0; i < cloud.size (); ++i)
+    if (isFinite (cloud[i]))
+    {
+      Eigen::Vector3d d = cloud[i].getVector3fMap ().cast<double> () - centroid_d.head<3> ();
+      covariance_d += d * d.transpose ();
+    }
+  covariance_d /= valid;
+
+  Eigen::Matrix3f covariance_matrix;
+  Eigen::Vector4f centroid;
+  EXPECT_EQ (computeMeanAndCovarianceMatrix (cloud, covariance_matrix, centroid), valid);
+  for (int i = 0; i < 3; ++i)
+  {
+    EXPECT_NEAR (centroid[i], centroid_d[i], 1e-3);
+    for (int j = 0; j < 3; ++j)
+      EXPECT_NEAR (covariance_matrix (i, j), covariance_d (i, j), 1e-6);
+  }
+
+  EXPECT_EQ (computeMeanAndCovarianceMatrix (cloud, indices, covariance_matrix, centroid), valid);
+  for (int i = 0; i < 3; ++i)
+  {
+    EXPECT_NEAR (centroid[i], centroid_d[i], 1e-3);
+    for (int j = 0; j < 3; ++j)
+      EXPECT_NEAR (covariance_matrix (i, j), covariance_d (i, j), 1e-6);
+  }
+
+  // The covariance matrix about a given centroid is not normalized
+  EXPECT_EQ (computeCovarianceMatrix (cloud, indices, centroid, covariance_matrix), valid);
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j)
+      EXPECT_NEAR (covariance_matrix (i, j), covariance_d (i, j) * valid, 1e-4);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, CentroidPoint)
 {
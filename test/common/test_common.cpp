@@ -43,6 +43,7 @@
 #include <pcl/common/intersections.h>
 #include <pcl/common/io.h>
 #include <pcl/common/eigen.h>
+#include <pcl/common/spatial_order.h>
 #include <pcl/point_types.h>
 #include <pcl/point_cloud.h>
 
@@ -50,6 +51,15 @@
 
 using namespace pcl;
 
+struct CompareCodes
+{
+  bool
+  operator () (const std::pair<uint64_t, Eigen::Vector3i> &a, const std::pair<uint64_t, Eigen::Vector3i> &b) const
+  {
+    return (a.first < b.first);
+  }
+};
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, PointXYZRGB)
 {
@@ -522,6 +532,62 @@ TEST (PCL, HasField)
   EXPECT_FALSE ((pcl::traits::has_label<pcl::Normal>::value));
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, SpatialOrder)
+{
+  EXPECT_EQ (0x54u, pcl::computeMortonCode (1, 2, 4));
+
+  // The first 8^3 cells of the Hilbert curve fill a cube, each one next to the previous one
+  std::vector<std::pair<uint64_t, Eigen::Vector3i> > cells;
+  for (int x = 0; x < 8; ++x)
+    for (int y = 0; y < 8; ++y)
+      for (int z = 0; z < 8; ++z)
+        cells.push_back (std::make_pair (pcl::computeHilbertCode (x, y, z), Eigen::Vector3i (x, y, z)));
+  std::sort (cells.begin (), cells.end (), CompareCodes ());
+  for (size_t i = 0; i < cells.size (); ++i)
+  {
+    EXPECT_EQ (i, cells[i].first);
+    if (i > 0)
+    {
+      EXPECT_EQ (1, (cells[i].second - cells[i - 1].second).cwiseAbs ().sum ());
+    }
+  }
+
+  // Sort a grid along both curves, with an invalid point
+  PointCloud<PointXYZ> cloud;
+  for (int i = 0; i < 512; ++i)
+    cloud.push_back (PointXYZ (static_cast<float> (i / 64), static_cast<float> (i / 8 % 8), static_cast<float> (i % 8)));
+  cloud.push_back (PointXYZ (std::numeric_limits<float>::quiet_NaN (), 0.0f, 0.0f));
+  cloud.is_dense = false;
+
+  for (int type = MORTON_ORDER; type <= HILBERT_ORDER; ++type)
+  {
+    PointCloud<PointXYZ> sorted;
+    std::vector<int> permutation;
+    reorderPointCloud (cloud, static_cast<SpatialOrder> (type), sorted, permutation);
+    ASSERT_EQ (cloud.points.size (), sorted.points.size ());
+    ASSERT_EQ (cloud.points.size (), permutation.size ());
+    EXPECT_EQ (513u, sorted.width);
+    EXPECT_EQ (512, permutation.back ());
+
+    std::vector<int> sorted_permutation (permutation);
+    std::sort (sorted_permutation.begin (), sorted_permutation.end ());
+    float total_step = 0.0f;
+    for (size_t i = 0; i < 512; ++i)
+    {
+      EXPECT_EQ (static_cast<int> (i), sorted_permutation[i]);
+      EXPECT_EQ (cloud.points[permutation[i]].x, sorted.points[i].x);
+      if (i > 0)
+        total_step += (sorted.points[i].getVector3fMap () - sorted.points[i - 1].getVector3fMap ()).norm ();
+    }
+    // The Hilbert curve only moves to neighboring points, the Morton curve jumps once in a while
+    if (type == HILBERT_ORDER)
+      EXPECT_FLOAT_EQ (511.0f, total_step);
+    else
+      EXPECT_GT (total_step, 511.0f);
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -799,6 +799,54 @@ TEST (PCL, eigen33f)
   EXPECT_LE (float(r_fail_count) / float(iterations), 0.01);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, computeSmallestRoot)
+{
+  typedef Eigen::Matrix<float, 3, 3> Matrix3f;
+  typedef Eigen::Matrix<double, 3, 3> Matrix3d;
+  Matrix3f f_matrix;
+  Matrix3d d_matrix;
+  Eigen::Vector3f f_roots;
+  Eigen::Vector3d d_roots;
+  const unsigned iterations = 100000;
+  unsigned fail_count = 0;
+
+  for (unsigned idx = 0; idx < iterations; ++idx)
+  {
+    generateSymPosMatrix3x3 (d_matrix);
+    d_matrix /= d_matrix.cwiseAbs ().maxCoeff () + 1;
+    f_matrix = d_matrix.cast<float> ();
+
+    computeRoots (d_matrix, d_roots);
+    if (fabs (computeSmallestRoot (d_matrix) - d_roots[0]) > 1e-8)
+      ++fail_count;
+    computeRoots (f_matrix, f_roots);
+    if (fabs (computeSmallestRoot (f_matrix) - f_roots[0]) > 1e-3f)
+      ++fail_count;
+  }
+
+  // less than 1% failure rate
+  EXPECT_LE (float (fail_count) / float (2 * iterations), 0.01);
+
+  // A flat, plane like matrix, with a well separated smallest eigenvalue
+  d_matrix << 1.0, 0.2, 0.0,
+              0.2, 0.5, 0.0,
+              0.0, 0.0, 1e-4;
+  EXPECT_NEAR (computeSmallestRoot (d_matrix), 1e-4, 1e-12);
+  f_matrix = d_matrix.cast<float> ();
+  EXPECT_NEAR (computeSmallestRoot (f_matrix), 1e-4f, 1e-7f);
+
+  // A slightly indefinite matrix: the negative root is clamped to 0, as computeRoots does
+  d_matrix << 1.0, 0.2, 0.0,
+              0.2, 0.5, 0.0,
+              0.0, 0.0, -1e-4;
+  computeRoots (d_matrix, d_roots);
+  EXPECT_EQ (0.0, d_roots[0]);
+  EXPECT_EQ (0.0, computeSmallestRoot (d_matrix));
+  f_matrix = d_matrix.cast<float> ();
+  EXPECT_EQ (0.0f, computeSmallestRoot (f_matrix));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, transformLine)
 {
@@ -143,6 +143,36 @@ TEST (PCL, PrincipalCurvaturesEstimation)
   EXPECT_NEAR (pcs->points[indices.size () - 1].pc2, 0.17906941473484039, 1e-4);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PrincipalCurvaturesEstimationThreads)
+{
+  NormalEstimation<PointXYZ, Normal> n;
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
+  n.setInputCloud (cloud.makeShared ());
+  n.setSearchMethod (tree);
+  n.setKSearch (10);
+  n.compute (*normals);
+
+  PrincipalCurvaturesEstimation<PointXYZ, Normal, PrincipalCurvatures> pc;
+  pc.setInputCloud (cloud.makeShared ());
+  pc.setInputNormals (normals);
+  pc.setSearchMethod (tree);
+  pc.setKSearch (20);
+
+  PointCloud<PrincipalCurvatures> serial, parallel;
+  pc.compute (serial);
+  pc.setNumberOfThreads (0);
+  pc.compute (parallel);
+  ASSERT_EQ (parallel.points.size (), serial.points.size ());
+  for (size_t i = 0; i < serial.points.size (); ++i)
+  {
+    for (int d = 0; d < 3; ++d)
+      EXPECT_EQ (parallel.points[i].principal_curvature[d], serial.points[i].principal_curvature[d]);
+    EXPECT_EQ (parallel.points[i].pc1, serial.points[i].pc1);
+    EXPECT_EQ (parallel.points[i].pc2, serial.points[i].pc2);
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -490,6 +490,185 @@ TEST (PCL, IINormalEstimationSimple3DGradient)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, IINormalEstimationRowsAndThreads)
+{
+  // curved surface with holes, so that the rectangle sizes and the normals vary along the rows
+  PointCloud<PointXYZ>::Ptr surface (new PointCloud<PointXYZ>);
+  surface->width = 160;
+  surface->height = 120;
+  surface->is_dense = false;
+  surface->points.resize (surface->width * surface->height);
+  for (unsigned v = 0; v < surface->height; ++v)
+  {
+    for (unsigned u = 0; u < surface->width; ++u)
+    {
+      PointXYZ &point = (*surface) (u, v);
+      point.z = 2.0f + 0.2f * sinf (0.1f * static_cast<float> (u)) * cosf (0.07f * static_cast<float> (v));
+      point.x = (static_cast<float> (u) - 80.0f) * point.z / 525.0f;
+      point.y = (static_cast<float> (v) - 60.0f) * point.z / 525.0f;
+      if ((u / 11 + v / 7) % 9 == 0)
+        point.x = point.y = point.z = std::numeric_limits<float>::quiet_NaN ();
+    }
+  }
+
+  // with BORDER_POLICY_IGNORE, the normals of the whole image are not computed within the smoothing size of
+  // the image border, the points are therefore chosen from the interior
+  boost::shared_ptr<std::vector<int> > indices (new std::vector<int>);
+  for (int idx = 0; idx < static_cast<int> (surface->points.size ()); idx += 13)
+  {
+    const int u = idx % surface->width;
+    const int v = idx / surface->width;
+    if (u >= 8 && v >= 8 && u < static_cast<int> (surface->width) - 8 && v < static_cast<int> (surface->height) - 8)
+      indices->push_back (idx);
+  }
+
+  IntegralImageNormalEstimation<PointXYZ, Normal> estimation;
+  estimation.setInputCloud (surface);
+  estimation.setNormalSmoothingSize (8.0f);
+  estimation.setMaxDepthChangeFactor (0.02f);
+  for (int method = 0; method < 4; ++method)
+  {
+    for (int policy = 0; policy < 2; ++policy)
+    {
+      if (method == estimation.SIMPLE_3D_GRADIENT && policy == estimation.BORDER_POLICY_MIRROR)
+        continue;
+      estimation.setNormalEstimationMethod (static_cast<IntegralImageNormalEstimation<PointXYZ, Normal>::NormalEstimationMethod> (method));
+      estimation.setBorderPolicy (static_cast<IntegralImageNormalEstimation<PointXYZ, Normal>::BorderPolicy> (policy));
+
+      // the normals of a whole image, computed row by row, do not depend on the number of threads
+      PointCloud<Normal> output, output_threads, output_ordered, output_part;
+      estimation.setIndices (IndicesPtr ());
+      estimation.setNumberOfThreads (1);
+      estimation.compute (output);
+      // the integral images are kept until the input is set again, setting it rebuilds them with 4 threads
+      estimation.setNumberOfThreads (4);
+      estimation.setInputCloud (surface);
+      estimation.compute (output_threads);
+      // The normals are written at the positions of their pixels, so the spatial order is ignored
+      estimation.setSpatialOrder (MORTON_ORDER);
+      estimation.compute (output_ordered);
+      estimation.setSpatialOrder (NO_SPATIAL_ORDER);
+      ASSERT_EQ (output.points.size (), surface->points.size ());
+      ASSERT_EQ (output_threads.points.size (), surface->points.size ());
+      ASSERT_EQ (output_ordered.points.size (), surface->points.size ());
+
+      int finite = 0;
+      for (size_t idx = 0; idx < output.points.size (); ++idx)
+      {
+        if (!pcl_isfinite (output.points[idx].normal_x))
+        {
+          EXPECT_FALSE (pcl_isfinite (output_threads.points[idx].normal_x));
+          EXPECT_FALSE (pcl_isfinite (output_ordered.points[idx].normal_x));
+          continue;
+        }
+        ++finite;
+        EXPECT_EQ (output.points[idx].normal_x, output_threads.points[idx].normal_x);
+        EXPECT_EQ (output.points[idx].normal_y, output_threads.points[idx].normal_y);
+        EXPECT_EQ (output.points[idx].normal_z, output_threads.points[idx].normal_z);
+        EXPECT_EQ (output.points[idx].normal_x, output_ordered.points[idx].normal_x);
+        EXPECT_EQ (output.points[idx].normal_z, output_ordered.points[idx].normal_z);
+      }
+      EXPECT_GT (finite, static_cast<int> (surface->points.size () / 2));
+
+      // ... and match the ones computed point by point
+      estimation.setIndices (indices);
+      estimation.compute (output_part);
+      ASSERT_EQ (output_part.points.size (), indices->size ());
+      for (size_t idx = 0; idx < indices->size (); ++idx)
+      {
+        const Normal &normal = output.points[(*indices)[idx]];
+        if (!pcl_isfinite (normal.normal_x))
+        {
+          EXPECT_FALSE (pcl_isfinite (output_part.points[idx].normal_x));
+          continue;
+        }
+        EXPECT_NEAR (normal.normal_x, output_part.points[idx].normal_x, 1e-4);
+        EXPECT_NEAR (normal.normal_y, output_part.points[idx].normal_y, 1e-4);
+        EXPECT_NEAR (normal.normal_z, output_part.points[idx].normal_z, 1e-4);
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, IntegralImage2D)
+{
+  // XYZ points with padding and holes, in an image whose sizes are not multiples of the SIMD width
+  const unsigned width = 45;
+  const unsigned height = 31;
+  const unsigned element_stride = 4;
+  std::vector<float> data (width * height * element_stride, 0.0f);
+  for (unsigned v = 0; v < height; ++v)
+  {
+    for (unsigned u = 0; u < width; ++u)
+    {
+      float *element = &data[(v * width + u) * element_stride];
+      element[0] = 0.01f * static_cast<float> (u) - 0.2f;
+      element[1] = 0.02f * static_cast<float> (v) + 0.1f;
+      element[2] = 1.0f + 0.3f * sinf (0.2f * static_cast<float> (u + 2 * v));
+      if ((u * 7 + v * 3) % 11 == 0)
+        element[2] = std::numeric_limits<float>::quiet_NaN ();
+    }
+  }
+
+  // the integral images do not depend on the number of threads
+  IntegralImage2D<float, 3> integral_image (true);
+  integral_image.setNumberOfThreads (1);
+  integral_image.setInput (&data[0], width, height, element_stride, width * element_stride);
+  IntegralImage2D<float, 3> integral_image_threads (true);
+  integral_image_threads.setNumberOfThreads (4);
+  integral_image_threads.setInput (&data[0], width, height, element_stride, width * element_stride);
+
+  for (unsigned start_y = 0; start_y < height; start_y += 3)
+  {
+    for (unsigned start_x = 0; start_x < width; start_x += 2)
+    {
+      const unsigned rect_width = std::min (7u, width - start_x);
+      const unsigned rect_height = std::min (5u, height - start_y);
+      EXPECT_EQ (integral_image.getFiniteElementsCount (start_x, start_y, rect_width, rect_height),
+                 integral_image_threads.getFiniteElementsCount (start_x, start_y, rect_width, rect_height));
+      EXPECT_TRUE (integral_image.getFirstOrderSum (start_x, start_y, rect_width, rect_height) ==
+                   integral_image_threads.getFirstOrderSum (start_x, start_y, rect_width, rect_height));
+      EXPECT_TRUE (integral_image.getSecondOrderSum (start_x, start_y, rect_width, rect_height) ==
+                   integral_image_threads.getSecondOrderSum (start_x, start_y, rect_width, rect_height));
+    }
+  }
+
+  // the batched getters give the sums of the single rectangle getters, in the same order of operations
+  typedef IntegralImage2D<float, 3>::IntegralType IntegralType;
+  const unsigned second_order_size = IntegralImage2D<float, 3>::second_order_size;
+  const unsigned rect_sizes[][2] = {{1, 1}, {3, 5}, {8, 2}, {13, 9}};
+  for (int size_idx = 0; size_idx < 4; ++size_idx)
+  {
+    const unsigned rect_width = rect_sizes[size_idx][0];
+    const unsigned rect_height = rect_sizes[size_idx][1];
+    const unsigned start_x = 1;
+    const unsigned count = width - rect_width - start_x + 1;
+    std::vector<IntegralType> first_order_sums (3 * count);
+    std::vector<IntegralType> second_order_sums (second_order_size * count);
+    std::vector<unsigned> counts (count);
+    for (unsigned start_y = 0; start_y + rect_height <= height; start_y += 4)
+    {
+      integral_image_threads.getFirstOrderSums (start_x, start_y, rect_width, rect_height, count, &first_order_sums[0]);
+      integral_image_threads.getSecondOrderSums (start_x, start_y, rect_width, rect_height, count, &second_order_sums[0]);
+      integral_image_threads.getFiniteElementsCounts (start_x, start_y, rect_width, rect_height, count, &counts[0]);
+      for (unsigned i = 0; i < count; ++i)
+      {
+        const IntegralImage2D<float, 3>::ElementType first_order_sum =
+          integral_image.getFirstOrderSum (start_x + i, start_y, rect_width, rect_height);
+        const IntegralImage2D<float, 3>::SecondOrderType second_order_sum =
+          integral_image.getSecondOrderSum (start_x + i, start_y, rect_width, rect_height);
+        EXPECT_EQ (integral_image.getFiniteElementsCount (start_x + i, start_y, rect_width, rect_height), counts[i]);
+        for (unsigned dim = 0; dim < 3; ++dim)
+          EXPECT_EQ (first_order_sum[dim], first_order_sums[dim * count + i]);
+        for (unsigned idx = 0; idx < second_order_size; ++idx)
+          EXPECT_EQ (second_order_sum[idx], second_order_sums[idx * count + i]);
+      }
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, IINormalEstimationSimple3DGradientUnorganized)
 {
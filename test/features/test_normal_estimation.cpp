@@ -41,6 +41,7 @@
 #include <pcl/point_cloud.h>
 #include <pcl/features/normal_3d.h>
 #include <pcl/features/normal_3d_omp.h>
+#include <pcl/features/boundary.h>
 #include <pcl/io/pcd_io.h>
 
 using namespace pcl;
@@ -213,6 +214,57 @@ TEST (PCL, NormalEstimationOpenMP)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, NormalEstimationSpatialOrder)
+{
+  NormalEstimation<PointXYZ, Normal> n;
+  PointCloud<Normal> normals, ordered_normals;
+  n.setInputCloud (cloud.makeShared ());
+  n.setSearchMethod (tree);
+  n.setKSearch (10);
+  n.compute (normals);
+
+  // Processing the points along a curve gives the same normals, in the same order
+  n.setSpatialOrder (MORTON_ORDER);
+  EXPECT_EQ (MORTON_ORDER, n.getSpatialOrder ());
+  n.compute (ordered_normals);
+  ASSERT_EQ (normals.points.size (), ordered_normals.points.size ());
+  for (size_t i = 0; i < normals.points.size (); ++i)
+  {
+    EXPECT_EQ (normals.points[i].normal[0], ordered_normals.points[i].normal[0]);
+    EXPECT_EQ (normals.points[i].normal[1], ordered_normals.points[i].normal[1]);
+    EXPECT_EQ (normals.points[i].normal[2], ordered_normals.points[i].normal[2]);
+    EXPECT_EQ (normals.points[i].curvature, ordered_normals.points[i].curvature);
+  }
+
+  // The indices given by the user are left untouched
+  boost::shared_ptr<vector<int> > subset (new vector<int> ());
+  for (int i = static_cast<int> (cloud.points.size ()) - 1; i >= 0; i -= 3)
+    subset->push_back (i);
+  const vector<int> subset_copy (*subset);
+  n.setIndices (subset);
+  n.setSpatialOrder (HILBERT_ORDER);
+  n.compute (ordered_normals);
+  EXPECT_EQ (subset, n.getIndices ());
+  EXPECT_TRUE (subset_copy == *subset);
+  ASSERT_EQ (subset->size (), ordered_normals.points.size ());
+  for (size_t i = 0; i < subset->size (); ++i)
+    EXPECT_EQ (normals.points[(*subset)[i]].normal[2], ordered_normals.points[i].normal[2]);
+
+  // Also when a check of the estimator fails after the checks common to all the features (no normals given)
+  BoundaryEstimation<PointXYZ, Normal, Boundary> b;
+  PointCloud<Boundary> boundaries;
+  b.setInputCloud (cloud.makeShared ());
+  b.setIndices (subset);
+  b.setSearchMethod (tree);
+  b.setKSearch (10);
+  b.setSpatialOrder (MORTON_ORDER);
+  b.compute (boundaries);
+  EXPECT_EQ (0, boundaries.points.size ());
+  EXPECT_EQ (subset, b.getIndices ());
+  EXPECT_TRUE (subset_copy == *subset);
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -48,6 +48,8 @@
 #include <pcl/filters/frustum_culling.h>
 #include <pcl/filters/sampling_surface_normal.h>
 #include <pcl/filters/voxel_grid.h>
+#include <pcl/filters/voxel_grid_omp.h>
+#include <pcl/filters/hashed_voxel_grid.h>
 #include <pcl/filters/voxel_grid_covariance.h>
 #include <pcl/filters/extract_indices.h>
 #include <pcl/filters/project_inliers.h>
@@ -972,6 +974,159 @@ TEST (VoxelGrid_XYZNormal, Filters)
 
 #endif
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (VoxelGridOMP, Filters)
+{
+  // Reverse the indices, so that the parallel sort also has to order the point indices
+  std::vector<int> reversed_indices (indices_.rbegin (), indices_.rend ());
+
+  PointCloud<PointXYZ> output, output_omp;
+  VoxelGrid<PointXYZ> grid;
+  VoxelGridOMP<PointXYZ> grid_omp;
+
+  for (unsigned int nr_threads = 1; nr_threads <= 4; ++nr_threads)
+  {
+    for (int test = 0; test < 4; ++test)
+    {
+      grid.setLeafSize (0.01f, 0.01f, 0.01f);
+      grid.setInputCloud (cloud);
+      grid.setIndices (boost::make_shared<std::vector<int> > (test % 2 == 0 ? indices_ : reversed_indices));
+      grid.setMinimumPointsNumberPerVoxel (test < 2 ? 0 : 2);
+      grid.setSaveLeafLayout (true);
+      if (test == 3)
+      {
+        grid.setFilterFieldName ("z");
+        grid.setFilterLimits (0.05, 0.1);
+      }
+      grid.filter (output);
+
+      grid_omp.setNumberOfThreads (nr_threads);
+      grid_omp.setLeafSize (0.01f, 0.01f, 0.01f);
+      grid_omp.setInputCloud (cloud);
+      grid_omp.setIndices (boost::make_shared<std::vector<int> > (test % 2 == 0 ? indices_ : reversed_indices));
+      grid_omp.setMinimumPointsNumberPerVoxel (test < 2 ? 0 : 2);
+      grid_omp.setSaveLeafLayout (true);
+      if (test == 3)
+      {
+        grid_omp.setFilterFieldName ("z");
+        grid_omp.setFilterLimits (0.05, 0.1);
+      }
+      grid_omp.filter (output_omp);
+
+      // The parallel filter must produce exactly the same output as the serial one
+      ASSERT_EQ (output.points.size (), output_omp.points.size ());
+      EXPECT_EQ (output.width, output_omp.width);
+      EXPECT_EQ (output.height, output_omp.height);
+      for (size_t i = 0; i < output.points.size (); ++i)
+      {
+        EXPECT_EQ (output.points[i].x, output_omp.points[i].x);
+        EXPECT_EQ (output.points[i].y, output_omp.points[i].y);
+        EXPECT_EQ (output.points[i].z, output_omp.points[i].z);
+        EXPECT_EQ (grid.getCentroidIndex (output.points[i]), grid_omp.getCentroidIndex (output_omp.points[i]));
+      }
+    }
+  }
+
+  // Organized RGB cloud with NaNs, downsampling all the fields
+  PointCloud<PointXYZRGB> output_rgb, output_rgb_omp;
+  VoxelGrid<PointXYZRGB> grid_rgb;
+  grid_rgb.setLeafSize (0.02f, 0.02f, 0.02f);
+  grid_rgb.setInputCloud (cloud_organized);
+  grid_rgb.filter (output_rgb);
+
+  VoxelGridOMP<PointXYZRGB> grid_rgb_omp (4);
+  grid_rgb_omp.setLeafSize (0.02f, 0.02f, 0.02f);
+  grid_rgb_omp.setInputCloud (cloud_organized);
+  grid_rgb_omp.filter (output_rgb_omp);
+
+  ASSERT_EQ (output_rgb.points.size (), output_rgb_omp.points.size ());
+  EXPECT_EQ (bool (output_rgb_omp.is_dense), true);
+  for (size_t i = 0; i < output_rgb.points.size (); ++i)
+  {
+    EXPECT_EQ (output_rgb.points[i].x, output_rgb_omp.points[i].x);
+    EXPECT_EQ (output_rgb.points[i].y, output_rgb_omp.points[i].y);
+    EXPECT_EQ (output_rgb.points[i].z, output_rgb_omp.points[i].z);
+    EXPECT_EQ (output_rgb.points[i].rgba, output_rgb_omp.points[i].rgba);
+  }
+}
+
+template <typename PointT> bool
+lessXYZ (const PointT &p1, const PointT &p2)
+{
+  if (p1.x != p2.x)
+    return (p1.x < p2.x);
+  if (p1.y != p2.y)
+    return (p1.y < p2.y);
+  return (p1.z < p2.z);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (HashedVoxelGrid, Filters)
+{
+  PointCloud<PointXYZ> output, output_hashed;
+  VoxelGrid<PointXYZ> grid;
+  HashedVoxelGrid<PointXYZ> hashed_grid;
+
+  for (unsigned int min_points = 0; min_points < 4; min_points += 3)
+  {
+    grid.setLeafSize (0.02f, 0.02f, 0.02f);
+    grid.setMinimumPointsNumberPerVoxel (min_points);
+    grid.setInputCloud (cloud);
+    grid.filter (output);
+
+    hashed_grid.setLeafSize (0.02f, 0.02f, 0.02f);
+    hashed_grid.setMinimumPointsNumberPerVoxel (min_points);
+    hashed_grid.setInputCloud (cloud);
+    hashed_grid.filter (output_hashed);
+
+    EXPECT_EQ (output_hashed.width, output_hashed.points.size ());
+    EXPECT_EQ (int (output_hashed.height), 1);
+    EXPECT_EQ (bool (output_hashed.is_dense), true);
+
+    // Same voxels as VoxelGrid, possibly in a different order
+    ASSERT_EQ (output.points.size (), output_hashed.points.size ());
+    std::sort (output.points.begin (), output.points.end (), lessXYZ<PointXYZ>);
+    std::sort (output_hashed.points.begin (), output_hashed.points.end (), lessXYZ<PointXYZ>);
+    for (size_t i = 0; i < output.points.size (); ++i)
+    {
+      EXPECT_NEAR (output.points[i].x, output_hashed.points[i].x, 1e-6);
+      EXPECT_NEAR (output.points[i].y, output_hashed.points[i].y, 1e-6);
+      EXPECT_NEAR (output.points[i].z, output_hashed.points[i].z, 1e-6);
+    }
+  }
+  EXPECT_EQ (int (output_hashed.points.size ()), 68);
+
+  // A leaf size this small makes VoxelGrid give up, every point now gets its own voxel
+  hashed_grid.setLeafSize (1e-5f, 1e-5f, 1e-5f);
+  hashed_grid.setMinimumPointsNumberPerVoxel (0);
+  hashed_grid.filter (output_hashed);
+  EXPECT_EQ (output_hashed.points.size (), cloud->points.size ());
+
+  // Organized RGB cloud with NaNs, downsampling all the fields
+  PointCloud<PointXYZRGB> output_rgb, output_rgb_hashed;
+  VoxelGrid<PointXYZRGB> grid_rgb;
+  grid_rgb.setLeafSize (0.02f, 0.02f, 0.02f);
+  grid_rgb.setInputCloud (cloud_organized);
+  grid_rgb.filter (output_rgb);
+
+  HashedVoxelGrid<PointXYZRGB> hashed_grid_rgb;
+  hashed_grid_rgb.setLeafSize (0.02f, 0.02f, 0.02f);
+  hashed_grid_rgb.setInputCloud (cloud_organized);
+  hashed_grid_rgb.filter (output_rgb_hashed);
+
+  ASSERT_EQ (output_rgb.points.size (), output_rgb_hashed.points.size ());
+  EXPECT_EQ (bool (output_rgb_hashed.is_dense), true);
+  std::sort (output_rgb.points.begin (), output_rgb.points.end (), lessXYZ<PointXYZRGB>);
+  std::sort (output_rgb_hashed.points.begin (), output_rgb_hashed.points.end (), lessXYZ<PointXYZRGB>);
+  for (size_t i = 0; i < output_rgb.points.size (); ++i)
+  {
+    EXPECT_NEAR (output_rgb.points[i].x, output_rgb_hashed.points[i].x, 1e-6);
+    EXPECT_NEAR (output_rgb.points[i].y, output_rgb_hashed.points[i].y, 1e-6);
+    EXPECT_NEAR (output_rgb.points[i].z, output_rgb_hashed.points[i].z, 1e-6);
+    EXPECT_EQ (output_rgb.points[i].rgba, output_rgb_hashed.points[i].rgba);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (VoxelGridCovariance, Filters)
 {
@@ -1053,6 +1208,28 @@ TEST (VoxelGridCovariance, Filters)
   EXPECT_NEAR (leaves[2]->getMean ()[0], -0.00936106, 1e-4);
   EXPECT_NEAR (leaves[2]->getMean ()[1], 0.0516725, 1e-4);
   EXPECT_NEAR (leaves[2]->getMean ()[2], 0.0508024, 1e-4);
+
+  // A point on a voxel boundary, where x / 0.1f and x * (1 / 0.1f) fall in different voxels: the neighborhood
+  // lookup finds the voxel the filter put the point in
+  PointCloud<PointXYZ>::Ptr boundary_cloud (new PointCloud<PointXYZ> ());
+  const float boundary_x = 1.3f;
+  ASSERT_NE (floor (boundary_x / 0.1f), floor (boundary_x * (1.0f / 0.1f)));
+  for (int i = 0; i < 8; ++i)
+  {
+    boundary_cloud->push_back (PointXYZ (boundary_x + 0.01f * static_cast<float> (i % 2), 0.01f * static_cast<float> (i + 1),
+                                         0.01f * static_cast<float> ((3 * i) % 8 + 1)));
+    boundary_cloud->push_back (PointXYZ (boundary_x - 0.02f - 0.01f * static_cast<float> (i % 2), 0.01f * static_cast<float> (i + 1),
+                                         0.01f * static_cast<float> ((5 * i) % 8 + 1)));
+  }
+  VoxelGridCovariance<PointXYZ> boundary_grid;
+  boundary_grid.setLeafSize (0.1f, 0.1f, 0.1f);
+  boundary_grid.setInputCloud (boundary_cloud);
+  boundary_grid.filter (output, true);
+
+  vector<VoxelGridCovariance<PointXYZ>::LeafConstPtr> boundary_leaves;
+  ASSERT_EQ (1, boundary_grid.getNeighborhoodAtPoint (Eigen::MatrixXi::Zero (3, 1), boundary_cloud->points[0], boundary_leaves));
+  EXPECT_EQ (boundary_grid.getLeaf (boundary_cloud->points[0]), boundary_leaves[0]);
+  EXPECT_GT (boundary_leaves[0]->getMean ()[0], boundary_x);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -207,6 +207,40 @@ TEST (PCL, KdTreeFLANN_nearestKSearch)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, KdTreeFLANN_spatialOrder)
+{
+  PointCloud<MyPoint> points;
+  for (int i = 0; i < 2000; ++i)
+    points.points.push_back (MyPoint (static_cast<float> (rand ()) / RAND_MAX, static_cast<float> (rand ()) / RAND_MAX,
+                                      static_cast<float> (rand ()) / RAND_MAX));
+  points.width = static_cast<uint32_t> (points.points.size ());
+  points.height = 1;
+
+  KdTreeFLANN<MyPoint> kdtree;
+  kdtree.setInputCloud (points.makeShared ());
+  KdTreeFLANN<MyPoint> ordered_kdtree;
+  ordered_kdtree.setSpatialOrder (HILBERT_ORDER);
+  EXPECT_EQ (HILBERT_ORDER, ordered_kdtree.getSpatialOrder ());
+  ordered_kdtree.setInputCloud (points.makeShared ());
+
+  // The indices returned still refer to the input cloud
+  vector<int> k_indices, ordered_k_indices;
+  vector<float> k_distances, ordered_k_distances;
+  for (size_t i = 0; i < 100; ++i)
+  {
+    const MyPoint query (static_cast<float> (rand ()) / RAND_MAX, static_cast<float> (rand ()) / RAND_MAX,
+                         static_cast<float> (rand ()) / RAND_MAX);
+    kdtree.nearestKSearch (query, 10, k_indices, k_distances);
+    ordered_kdtree.nearestKSearch (query, 10, ordered_k_indices, ordered_k_distances);
+    EXPECT_TRUE (k_indices == ordered_k_indices);
+
+    kdtree.radiusSearch (query, 0.1, k_indices, k_distances);
+    ordered_kdtree.radiusSearch (query, 0.1, ordered_k_indices, ordered_k_distances);
+    EXPECT_TRUE (k_indices == ordered_k_indices);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 class MyPointRepresentationXY : public PointRepresentation<MyPoint>
 {
@@ -36,6 +36,7 @@
 #include <gtest/gtest.h>
 
 #include <vector>
+#include <set>
 
 #include <stdio.h>
 
@@ -1156,6 +1157,93 @@ TEST (PCL, Octree_Pointcloud_Voxel_Centroid_Test)
 
 }
 
+TEST (PCL, Octree_Pointcloud_Bulk_Build_Test)
+{
+  const unsigned int test_runs = 10;
+  unsigned int test_id;
+
+  srand (static_cast<unsigned int> (time (NULL)));
+
+  for (test_id = 0; test_id < test_runs; test_id++)
+  {
+    PointCloud<PointXYZ>::Ptr cloudIn (new PointCloud<PointXYZ> ());
+    boost::shared_ptr<std::vector<int> > indices (new std::vector<int> ());
+
+    cloudIn->width = 1000 + rand () % 4000;
+    cloudIn->height = 1;
+    cloudIn->points.resize (cloudIn->width * cloudIn->height);
+
+    // generate point data for point cloud, including non-finite points
+    for (size_t i = 0; i < cloudIn->points.size (); i++)
+    {
+      cloudIn->points[i] = PointXYZ (static_cast<float> (20.0 * rand () / RAND_MAX - 10.0),
+                                     static_cast<float> (10.0 * rand () / RAND_MAX),
+                                     static_cast<float> (5.0 * rand () / RAND_MAX + 20.0));
+      if (i % 97 == 0)
+        cloudIn->points[i].y = std::numeric_limits<float>::quiet_NaN ();
+      if (rand () % 3)
+        indices->push_back (static_cast<int> (i));
+    }
+
+    const double resolution = 0.1 + 0.5 * rand () / RAND_MAX;
+
+    // bulk build
+    OctreePointCloudPointVector<PointXYZ> octreeBulk (resolution);
+    octreeBulk.setNumberOfThreads (1 + test_id % 4);
+    octreeBulk.setInputCloud (cloudIn, indices);
+    octreeBulk.addPointsFromInputCloud ();
+
+    // point by point insertion
+    OctreePointCloudPointVector<PointXYZ> octreeSerial (resolution);
+    octreeSerial.setInputCloud (cloudIn);
+    for (size_t i = 0; i < indices->size (); i++)
+      if (isFinite (cloudIn->points[(*indices)[i]]))
+        octreeSerial.addPointFromCloud ((*indices)[i], OctreePointCloudPointVector<PointXYZ>::IndicesPtr ());
+
+    ASSERT_EQ (octreeSerial.getTreeDepth (), octreeBulk.getTreeDepth ());
+    ASSERT_EQ (octreeSerial.getLeafCount (), octreeBulk.getLeafCount ());
+    ASSERT_EQ (octreeSerial.getBranchCount (), octreeBulk.getBranchCount ());
+
+    // both octrees must contain the same leaf nodes holding the same points in the same order
+    OctreePointCloudPointVector<PointXYZ>::LeafNodeIterator itSerial = octreeSerial.leaf_begin ();
+    OctreePointCloudPointVector<PointXYZ>::LeafNodeIterator itBulk = octreeBulk.leaf_begin ();
+    size_t leafCount = 0;
+    for (; *itSerial && *itBulk; ++itSerial, ++itBulk, ++leafCount)
+    {
+      EXPECT_TRUE (itSerial.getCurrentOctreeKey () == itBulk.getCurrentOctreeKey ());
+
+      std::vector<int> pointsSerial, pointsBulk;
+      itSerial.getLeafContainer ().getPointIndices (pointsSerial);
+      itBulk.getLeafContainer ().getPointIndices (pointsBulk);
+      EXPECT_TRUE (pointsSerial == pointsBulk);
+    }
+    EXPECT_EQ (octreeSerial.getLeafCount (), leafCount);
+    EXPECT_TRUE (*itSerial == 0);
+    EXPECT_TRUE (*itBulk == 0);
+
+    // voxel centroids accumulate the points in the same order
+    OctreePointCloudVoxelCentroid<PointXYZ> centroidBulk (resolution);
+    centroidBulk.setInputCloud (cloudIn, indices);
+    centroidBulk.addPointsFromInputCloud ();
+
+    OctreePointCloudVoxelCentroid<PointXYZ> centroidSerial (resolution);
+    centroidSerial.setInputCloud (cloudIn);
+    for (size_t i = 0; i < indices->size (); i++)
+      if (isFinite (cloudIn->points[(*indices)[i]]))
+        centroidSerial.addPointFromCloud ((*indices)[i], OctreePointCloudPointVector<PointXYZ>::IndicesPtr ());
+
+    pcl::PointCloud<PointXYZ>::VectorType voxelCentroidsBulk, voxelCentroidsSerial;
+    ASSERT_EQ (centroidSerial.getVoxelCentroids (voxelCentroidsSerial),
+               centroidBulk.getVoxelCentroids (voxelCentroidsBulk));
+    for (size_t i = 0; i < voxelCentroidsSerial.size (); i++)
+    {
+      EXPECT_EQ (voxelCentroidsSerial[i].x, voxelCentroidsBulk[i].x);
+      EXPECT_EQ (voxelCentroidsSerial[i].y, voxelCentroidsBulk[i].y);
+      EXPECT_EQ (voxelCentroidsSerial[i].z, voxelCentroidsBulk[i].z);
+    }
+  }
+}
+
 // helper class for priority queue
 class prioPointQueueEntry
 {
@@ -1620,6 +1708,108 @@ TEST (PCL, Octree_Pointcloud_Ray_Traversal)
 
 }
 
+TEST (PCL, Octree_Pointcloud_Concurrent_Search)
+{
+  const int nr_queries = 1000;
+
+  PointCloud<PointXYZ>::Ptr cloudIn (new PointCloud<PointXYZ> ());
+  cloudIn->width = 5000;
+  cloudIn->height = 1;
+  cloudIn->points.resize (cloudIn->width * cloudIn->height);
+
+  srand (static_cast<unsigned int> (time (NULL)));
+
+  for (size_t i = 0; i < cloudIn->points.size (); i++)
+  {
+    cloudIn->points[i] = PointXYZ (static_cast<float> (10.0 * rand () / RAND_MAX),
+                                   static_cast<float> (10.0 * rand () / RAND_MAX),
+                                   static_cast<float> (10.0 * rand () / RAND_MAX));
+  }
+
+  OctreePointCloudSearch<PointXYZ> octree (0.25);
+  octree.setInputCloud (cloudIn);
+  octree.addPointsFromInputCloud ();
+
+  // queries and rays
+  std::vector<PointXYZ, Eigen::aligned_allocator<PointXYZ> > queries (nr_queries);
+  std::vector<Eigen::Vector3f> origins (nr_queries), directions (nr_queries);
+  for (int i = 0; i < nr_queries; i++)
+  {
+    queries[i] = PointXYZ (static_cast<float> (10.0 * rand () / RAND_MAX),
+                           static_cast<float> (10.0 * rand () / RAND_MAX),
+                           static_cast<float> (10.0 * rand () / RAND_MAX));
+    origins[i] = Eigen::Vector3f (static_cast<float> (12.0 * rand () / RAND_MAX), 
+                                  static_cast<float> (12.0 * rand () / RAND_MAX),
+                                  static_cast<float> (12.0 * rand () / RAND_MAX));
+    directions[i] = queries[i].getVector3fMap () - origins[i];
+  }
+
+  // sequential reference results
+  std::vector<std::vector<int> > knnIndices (nr_queries), radiusIndices (nr_queries), boxIndices (nr_queries), rayIndices (nr_queries);
+  std::vector<int> approxIndices (nr_queries);
+  for (int i = 0; i < nr_queries; i++)
+  {
+    std::vector<float> distances;
+    float approxDistance;
+    const Eigen::Vector3f offset (0.5f, 0.5f, 0.5f);
+    octree.nearestKSearch (queries[i], 10, knnIndices[i], distances);
+    octree.radiusSearch (queries[i], 0.5, radiusIndices[i], distances);
+    octree.boxSearch (queries[i].getVector3fMap () - offset, queries[i].getVector3fMap () + offset, boxIndices[i]);
+    octree.getIntersectedVoxelIndices (origins[i], directions[i], rayIndices[i]);
+    octree.approxNearestSearch (queries[i], approxIndices[i], approxDistance);
+  }
+
+  // concurrent queries must return the same results
+  int nr_mismatches = 0;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(4) reduction(+: nr_mismatches)
+#endif
+  for (int i = 0; i < nr_queries; i++)
+  {
+    std::vector<int> indices;
+    std::vector<float> distances;
+    int approxIndex;
+    float approxDistance;
+    const Eigen::Vector3f offset (0.5f, 0.5f, 0.5f);
+
+    octree.nearestKSearch (queries[i], 10, indices, distances);
+    nr_mismatches += indices != knnIndices[i];
+    octree.radiusSearch (queries[i], 0.5, indices, distances);
+    nr_mismatches += indices != radiusIndices[i];
+    octree.boxSearch (queries[i].getVector3fMap () - offset, queries[i].getVector3fMap () + offset, indices);
+    nr_mismatches += indices != boxIndices[i];
+    octree.getIntersectedVoxelIndices (origins[i], directions[i], indices);
+    nr_mismatches += indices != rayIndices[i];
+    octree.approxNearestSearch (queries[i], approxIndex, approxDistance);
+    nr_mismatches += approxIndex != approxIndices[i];
+  }
+  EXPECT_EQ (0, nr_mismatches);
+
+  // batch ray casting
+  std::vector<std::vector<int> > batchIndices;
+  int voxelCount = 0;
+  for (int i = 0; i < nr_queries; i++)
+  {
+    OctreePointCloudSearch<PointXYZ>::AlignedPointTVector voxelCenters;
+    voxelCount += octree.getIntersectedVoxelCenters (origins[i], directions[i], voxelCenters);
+  }
+
+  octree.setNumberOfThreads (4);
+  EXPECT_EQ (voxelCount, octree.getIntersectedVoxelIndices (origins, directions, batchIndices));
+  ASSERT_EQ (rayIndices.size (), batchIndices.size ());
+  for (int i = 0; i < nr_queries; i++)
+    EXPECT_TRUE (rayIndices[i] == batchIndices[i]);
+
+  // first intersected voxel only
+  octree.getIntersectedVoxelIndices (origins, directions, batchIndices, 1);
+  for (int i = 0; i < nr_queries; i++)
+  {
+    std::vector<int> indices;
+    octree.getIntersectedVoxelIndices (origins[i], directions[i], indices, 1);
+    EXPECT_TRUE (indices == batchIndices[i]);
+  }
+}
+
 TEST (PCL, Octree_Pointcloud_Adjacency)
 {
 
@@ -1699,6 +1889,193 @@ TEST (PCL, Octree_Pointcloud_Adjacency)
   }
 
 }
+
+TEST (PCL, Octree_Pointcloud_Linear_Test)
+{
+  const unsigned int test_runs = 10;
+  unsigned int test_id;
+
+  srand (static_cast<unsigned int> (time (NULL)));
+
+  for (test_id = 0; test_id < test_runs; test_id++)
+  {
+    PointCloud<PointXYZ>::Ptr cloudIn (new PointCloud<PointXYZ> ());
+
+    cloudIn->width = 1000;
+    cloudIn->height = 1;
+    cloudIn->points.resize (cloudIn->width * cloudIn->height);
+    for (size_t i = 0; i < cloudIn->points.size (); i++)
+    {
+      cloudIn->points[i] = PointXYZ (static_cast<float> (5.0  * rand () / RAND_MAX),
+                                     static_cast<float> (10.0 * rand () / RAND_MAX),
+                                     static_cast<float> (10.0 * rand () / RAND_MAX));
+    }
+    cloudIn->points[rand () % 1000].x = std::numeric_limits<float>::quiet_NaN ();
+
+    OctreePointCloudLinear<PointXYZ> octree (0.2 + 0.5 * rand () / RAND_MAX);
+    octree.setInputCloud (cloudIn);
+    octree.addPointsFromInputCloud ();
+
+    // every finite point is stored in exactly one leaf, which contains its voxel
+    size_t leafCount = 0;
+    std::vector<int> leafIndices;
+    OctreePointCloudLinear<PointXYZ>::LeafNodeIterator leafIt;
+    for (leafIt = octree.leaf_begin (); leafIt != octree.leaf_end (); ++leafIt, ++leafCount)
+    {
+      ASSERT_TRUE (leafIt.isLeafNode ());
+      leafIt.getLeafContainer ().getPointIndices (leafIndices);
+    }
+    EXPECT_EQ (octree.getLeafCount (), leafCount);
+    ASSERT_EQ (cloudIn->points.size () - 1, leafIndices.size ());
+
+    // depth-first traversal visits all nodes and the leaves in the same order
+    size_t nodeCount = 0;
+    leafIt = octree.leaf_begin ();
+    OctreePointCloudLinear<PointXYZ>::DepthFirstIterator depthIt;
+    for (depthIt = octree.depth_begin (); depthIt != octree.depth_end (); ++depthIt, ++nodeCount)
+    {
+      if (depthIt.isLeafNode ())
+      {
+        EXPECT_TRUE (depthIt.getCurrentOctreeKey () == leafIt.getCurrentOctreeKey ());
+        ++leafIt;
+      }
+    }
+    EXPECT_EQ (octree.getLeafCount () + octree.getBranchCount (), nodeCount);
+
+    PointXYZ searchPoint (static_cast<float> (10.0 * rand () / RAND_MAX),
+                          static_cast<float> (10.0 * rand () / RAND_MAX),
+                          static_cast<float> (10.0 * rand () / RAND_MAX));
+
+    // bruteforce distances
+    std::vector<std::pair<float, int> > bruteforce;
+    for (size_t i = 0; i < cloudIn->points.size (); i++)
+    {
+      if (isFinite (cloudIn->points[i]))
+        bruteforce.push_back (std::make_pair ((cloudIn->points[i].getVector3fMap () - searchPoint.getVector3fMap ()).squaredNorm (),
+                                              static_cast<int> (i)));
+    }
+    std::sort (bruteforce.begin (), bruteforce.end ());
+
+    // nearest neighbor search
+    const int K = 1 + rand () % 10;
+    std::vector<int> k_indices;
+    std::vector<float> k_sqr_distances;
+    ASSERT_EQ (K, octree.nearestKSearch (searchPoint, K, k_indices, k_sqr_distances));
+    for (int i = 0; i < K; i++)
+    {
+      EXPECT_EQ (bruteforce[i].second, k_indices[i]);
+      EXPECT_EQ (bruteforce[i].first, k_sqr_distances[i]);
+    }
+
+    int approxIndex;
+    float approxDistance;
+    octree.approxNearestSearch (searchPoint, approxIndex, approxDistance);
+    EXPECT_GE (approxIndex, 0);
+    EXPECT_GE (approxDistance, bruteforce[0].first);
+
+    // radius search
+    const double searchRadius = 5.0 * rand () / RAND_MAX;
+    std::set<int> radiusBruteforce;
+    for (size_t i = 0; i < bruteforce.size () && bruteforce[i].first <= searchRadius * searchRadius; i++)
+      radiusBruteforce.insert (bruteforce[i].second);
+
+    octree.radiusSearch (searchPoint, searchRadius, k_indices, k_sqr_distances);
+    EXPECT_TRUE (radiusBruteforce == std::set<int> (k_indices.begin (), k_indices.end ()));
+    EXPECT_EQ (radiusBruteforce.size (), k_indices.size ());
+
+    // box search
+    Eigen::Vector3f lowerBoxCorner (4.0f * rand () / RAND_MAX, 4.0f * rand () / RAND_MAX, 4.0f * rand () / RAND_MAX);
+    Eigen::Vector3f upperBoxCorner = lowerBoxCorner + Eigen::Vector3f (3.0f, 3.0f, 3.0f);
+    std::set<int> boxBruteforce;
+    for (size_t i = 0; i < cloudIn->points.size (); i++)
+    {
+      const PointXYZ& point = cloudIn->points[i];
+      if (point.x >= lowerBoxCorner (0) && point.x <= upperBoxCorner (0) &&
+          point.y >= lowerBoxCorner (1) && point.y <= upperBoxCorner (1) &&
+          point.z >= lowerBoxCorner (2) && point.z <= upperBoxCorner (2))
+        boxBruteforce.insert (static_cast<int> (i));
+    }
+    octree.boxSearch (lowerBoxCorner, upperBoxCorner, k_indices);
+    EXPECT_TRUE (boxBruteforce == std::set<int> (k_indices.begin (), k_indices.end ()));
+
+    // the voxel of a point contains the point itself
+    std::vector<int> voxelIndices;
+    ASSERT_TRUE (octree.voxelSearch (bruteforce[0].second, voxelIndices));
+    EXPECT_TRUE (std::find (voxelIndices.begin (), voxelIndices.end (), bruteforce[0].second) != voxelIndices.end ());
+
+    // serialization round trip
+    std::vector<char> buffer, bufferOut;
+    octree.serializeTree (buffer);
+
+    OctreePointCloudLinear<PointXYZ> octreeIn (1.0);
+    ASSERT_TRUE (octreeIn.deserializeTree (buffer));
+    octreeIn.setInputCloud (cloudIn);
+    octreeIn.serializeTree (bufferOut);
+    EXPECT_TRUE (buffer == bufferOut);
+    EXPECT_EQ (octree.getResolution (), octreeIn.getResolution ());
+    EXPECT_EQ (octree.getTreeDepth (), octreeIn.getTreeDepth ());
+    EXPECT_EQ (octree.getLeafCount (), octreeIn.getLeafCount ());
+    EXPECT_EQ (octree.getBranchCount (), octreeIn.getBranchCount ());
+
+    octreeIn.nearestKSearch (searchPoint, K, k_indices, k_sqr_distances);
+    for (int i = 0; i < K; i++)
+      EXPECT_EQ (bruteforce[i].second, k_indices[i]);
+
+    // corrupted buffers: the root pointing to itself, a negative point index, a truncated buffer
+    const size_t headerSize = 4 * sizeof (double) + sizeof (uint32_t) + 2 * sizeof (uint64_t);
+    std::vector<char> corrupted (buffer);
+    const uint32_t rootFirst = 0;
+    memcpy (&corrupted[headerSize + sizeof (uint64_t)], &rootFirst, sizeof (rootFirst));
+    EXPECT_FALSE (octreeIn.deserializeTree (corrupted));
+    EXPECT_EQ (0u, octreeIn.getLeafCount ());
+    corrupted = buffer;
+    const int negativeIndex = -1;
+    memcpy (&corrupted[corrupted.size () - sizeof (int)], &negativeIndex, sizeof (negativeIndex));
+    EXPECT_FALSE (octreeIn.deserializeTree (corrupted));
+
+    buffer.resize (buffer.size () - 1);
+    EXPECT_FALSE (octreeIn.deserializeTree (buffer));
+
+    // ray traversal: points on a ray, each in its own voxel
+    PointCloud<PointXYZ>::Ptr rayCloud (new PointCloud<PointXYZ> ());
+    const Eigen::Vector3f origin (12.0f, 12.0f, 12.0f);
+    const Eigen::Vector3f target (static_cast<float> (10.0 * rand () / RAND_MAX),
+                                  static_cast<float> (10.0 * rand () / RAND_MAX),
+                                  static_cast<float> (10.0 * rand () / RAND_MAX));
+    const Eigen::Vector3f direction (target - origin);
+    for (int j = 0; j < 4; j++)
+    {
+      const Eigen::Vector3f point = origin + (1.0f - 0.25f * static_cast<float> (j)) * direction;
+      rayCloud->push_back (PointXYZ (point[0], point[1], point[2]));
+    }
+    OctreePointCloudLinear<PointXYZ> rayOctree (0.02);
+    rayOctree.setInputCloud (rayCloud);
+    rayOctree.addPointsFromInputCloud ();
+
+    OctreePointCloudLinear<PointXYZ>::AlignedPointTVector voxelsInRay;
+    std::vector<int> indicesInRay;
+    ASSERT_EQ (4, rayOctree.getIntersectedVoxelCenters (origin, direction, voxelsInRay));
+    ASSERT_EQ (4, rayOctree.getIntersectedVoxelIndices (origin, direction, indicesInRay));
+    ASSERT_EQ (4u, voxelsInRay.size ());
+    ASSERT_EQ (4u, indicesInRay.size ());
+    // sorted along the ray, the closest point to the origin first
+    for (int j = 0; j < 4; j++)
+    {
+      EXPECT_EQ (3 - j, indicesInRay[j]);
+      EXPECT_NEAR (voxelsInRay[j].x, rayCloud->points[3 - j].x, 0.02);
+      EXPECT_NEAR (voxelsInRay[j].y, rayCloud->points[3 - j].y, 0.02);
+      EXPECT_NEAR (voxelsInRay[j].z, rayCloud->points[3 - j].z, 0.02);
+    }
+
+    ASSERT_EQ (1, rayOctree.getIntersectedVoxelIndices (origin, direction, indicesInRay, 1));
+    ASSERT_EQ (1u, indicesInRay.size ());
+    EXPECT_EQ (3, indicesInRay[0]);
+
+    // a ray pointing away from the points misses them
+    EXPECT_EQ (0, rayOctree.getIntersectedVoxelIndices (origin, -direction, indicesInRay));
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -38,8 +38,10 @@
 #include <gtest/gtest.h>
 #include <pcl/io/pcd_io.h>
 #include <pcl/registration/correspondence_estimation_normal_shooting.h>
+#include <pcl/registration/correspondence_estimation_omp.h>
 #include <pcl/features/normal_3d.h>
 #include <pcl/kdtree/kdtree.h>
+#include <pcl/search/voxel_hash.h>
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (CorrespondenceEstimation, CorrespondenceEstimationNormalShooting)
@@ -119,6 +121,93 @@ TEST (CorrespondenceEstimation, CorrespondenceEstimationSetSearchMethod)
   
 }
 
+//////////////////////////////////////////////////////////////////////////////////////
+TEST (CorrespondenceEstimation, CorrespondenceEstimationOMP)
+{
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud1 (new pcl::PointCloud<pcl::PointXYZ> ());
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud2 (new pcl::PointCloud<pcl::PointXYZ> ());
+  for (size_t i = 0; i < 500; i++)
+  {
+    cloud1->points.push_back (pcl::PointXYZ (float (rand () % 1000), float (rand () % 1000), float (rand () % 1000)));
+    cloud2->points.push_back (pcl::PointXYZ (float (rand () % 1000), float (rand () % 1000), float (rand () % 1000)));
+  }
+
+  pcl::registration::CorrespondenceEstimation<pcl::PointXYZ, pcl::PointXYZ> ce;
+  ce.setInputSource (cloud1);
+  ce.setInputTarget (cloud2);
+  pcl::Correspondences corr, corr_reciprocal, corr_max_distance;
+  ce.determineCorrespondences (corr);
+  ce.determineReciprocalCorrespondences (corr_reciprocal);
+  ce.determineCorrespondences (corr_max_distance, 50.0);
+  EXPECT_EQ (corr.size (), cloud1->points.size ());
+  EXPECT_LT (corr_reciprocal.size (), corr.size ());
+  EXPECT_LT (corr_max_distance.size (), corr.size ());
+
+  // The parallel estimator must give the very same correspondences, in the same order
+  for (unsigned int nr_threads = 1; nr_threads <= 4; ++nr_threads)
+  {
+    pcl::registration::CorrespondenceEstimationOMP<pcl::PointXYZ, pcl::PointXYZ> ce_omp (nr_threads);
+    ce_omp.setInputSource (cloud1);
+    ce_omp.setInputTarget (cloud2);
+    pcl::Correspondences corr_omp, corr_reciprocal_omp, corr_max_distance_omp;
+    ce_omp.determineCorrespondences (corr_omp);
+    ce_omp.determineReciprocalCorrespondences (corr_reciprocal_omp);
+    ce_omp.determineCorrespondences (corr_max_distance_omp, 50.0);
+
+    ASSERT_EQ (corr.size (), corr_omp.size ());
+    for (size_t i = 0; i < corr.size (); i++)
+    {
+      EXPECT_EQ (corr[i].index_query, corr_omp[i].index_query);
+      EXPECT_EQ (corr[i].index_match, corr_omp[i].index_match);
+      EXPECT_EQ (corr[i].distance, corr_omp[i].distance);
+    }
+    ASSERT_EQ (corr_reciprocal.size (), corr_reciprocal_omp.size ());
+    for (size_t i = 0; i < corr_reciprocal.size (); i++)
+    {
+      EXPECT_EQ (corr_reciprocal[i].index_query, corr_reciprocal_omp[i].index_query);
+      EXPECT_EQ (corr_reciprocal[i].index_match, corr_reciprocal_omp[i].index_match);
+    }
+    ASSERT_EQ (corr_max_distance.size (), corr_max_distance_omp.size ());
+    for (size_t i = 0; i < corr_max_distance.size (); i++)
+    {
+      EXPECT_EQ (corr_max_distance[i].index_query, corr_max_distance_omp[i].index_query);
+      EXPECT_EQ (corr_max_distance[i].index_match, corr_max_distance_omp[i].index_match);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////
+TEST (CorrespondenceEstimation, CorrespondenceEstimationVoxelHash)
+{
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud1 (new pcl::PointCloud<pcl::PointXYZ> ());
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud2 (new pcl::PointCloud<pcl::PointXYZ> ());
+  for (size_t i = 0; i < 500; i++)
+  {
+    cloud1->points.push_back (pcl::PointXYZ (float (rand () % 1000), float (rand () % 1000), float (rand () % 1000)));
+    cloud2->points.push_back (pcl::PointXYZ (float (rand () % 1000), float (rand () % 1000), float (rand () % 1000)));
+  }
+
+  pcl::registration::CorrespondenceEstimation<pcl::PointXYZ, pcl::PointXYZ> ce;
+  ce.setInputSource (cloud1);
+  ce.setInputTarget (cloud2);
+  pcl::Correspondences corr;
+  ce.determineCorrespondences (corr, 50.0);
+
+  // Within the exact distance of the voxel hash, the correspondences are the same as with the kd-tree
+  pcl::search::VoxelHash<pcl::PointXYZ>::Ptr voxel_hash (new pcl::search::VoxelHash<pcl::PointXYZ> (50.0));
+  ce.setSearchMethodTarget (voxel_hash);
+  EXPECT_EQ (voxel_hash, ce.getSearchMethodTarget ());
+  pcl::Correspondences corr_voxel_hash;
+  ce.determineCorrespondences (corr_voxel_hash, 50.0);
+
+  ASSERT_EQ (corr.size (), corr_voxel_hash.size ());
+  for (size_t i = 0; i < corr.size (); i++)
+  {
+    EXPECT_EQ (corr[i].index_query, corr_voxel_hash[i].index_query);
+    EXPECT_EQ (corr[i].distance, corr_voxel_hash[i].distance);
+  }
+}
+
 /* ---[ */
 int
   main (int argc, char** argv)
@@ -49,6 +49,7 @@
 #include <pcl/registration/icp_nl.h>
 #include <pcl/registration/gicp.h>
 #include <pcl/registration/gicp6d.h>
+#include <pcl/registration/gicp_omp.h>
 #include <pcl/registration/transformation_estimation_point_to_plane.h>
 #include <pcl/registration/transformation_validation_euclidean.h>
 #include <pcl/registration/correspondence_rejection_median_distance.h>
@@ -60,6 +61,7 @@
 #include <pcl/features/ppf.h>
 #include <pcl/registration/ppf_registration.h>
 #include <pcl/registration/ndt.h>
+#include <pcl/registration/ndt_omp.h>
 #include <pcl/registration/sample_consensus_prerejective.h>
 // We need Histogram<2> to function, so we'll explicitely add kdtree_flann.hpp here
 #include <pcl/kdtree/impl/kdtree_flann.hpp>
@@ -524,6 +526,71 @@ TEST (PCL, GeneralizedIterativeClosestPoint)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, GeneralizedIterativeClosestPointOMP)
+{
+  typedef PointXYZ PointT;
+  PointCloud<PointT>::Ptr src (new PointCloud<PointT>);
+  copyPointCloud (cloud_source, *src);
+  PointCloud<PointT>::Ptr tgt (new PointCloud<PointT>);
+  copyPointCloud (cloud_target, *tgt);
+  PointCloud<PointT> output;
+
+  GeneralizedIterativeClosestPoint<PointT, PointT> reg;
+  reg.setInputSource (src);
+  reg.setInputTarget (tgt);
+  reg.setMaximumIterations (50);
+  reg.setTransformationEpsilon (1e-8);
+  reg.align (output);
+
+  GeneralizedIterativeClosestPointOMP<PointT, PointT> reg_omp (4);
+  reg_omp.setInputSource (src);
+  reg_omp.setInputTarget (tgt);
+  reg_omp.setMaximumIterations (50);
+  reg_omp.setTransformationEpsilon (1e-8);
+
+  // Register
+  reg_omp.align (output);
+  EXPECT_EQ (int (output.points.size ()), int (cloud_source.points.size ()));
+  EXPECT_LT (reg_omp.getFitnessScore (), 0.001);
+  EXPECT_TRUE (reg_omp.getFinalTransformation ().isApprox (reg.getFinalTransformation (), 1e-3f));
+
+  // The result must not depend on the number of threads beyond rounding
+  Eigen::Matrix4f transformation_4 = reg_omp.getFinalTransformation ();
+  reg_omp.setNumberOfThreads (1);
+  reg_omp.align (output);
+  EXPECT_TRUE (reg_omp.getFinalTransformation ().isApprox (transformation_4, 1e-3f));
+
+  // Aligning again without new clouds reuses the covariances of both clouds
+  ASSERT_EQ (src->size (), reg_omp.getSourceCovariances ().size ());
+  ASSERT_EQ (tgt->size (), reg_omp.getTargetCovariances ().size ());
+  const Eigen::Matrix3d *source_covariances = &reg_omp.getSourceCovariances ()[0];
+  const Eigen::Matrix3d *target_covariances = &reg_omp.getTargetCovariances ()[0];
+  const Eigen::Matrix3d first_target_covariance = reg_omp.getTargetCovariances ()[0];
+  reg_omp.align (output);
+  EXPECT_EQ (source_covariances, &reg_omp.getSourceCovariances ()[0]);
+  EXPECT_EQ (target_covariances, &reg_omp.getTargetCovariances ()[0]);
+
+  // Setting the same target again keeps the covariances when asked to
+  reg_omp.setReuseTargetCovariances (true);
+  reg_omp.setInputTarget (tgt);
+  EXPECT_EQ (tgt->size (), reg_omp.getTargetCovariances ().size ());
+  reg_omp.setInputSource (src);
+  EXPECT_TRUE (reg_omp.getSourceCovariances ().empty ());
+  reg_omp.setNumberOfThreads (0);
+  reg_omp.align (output);
+  EXPECT_EQ (int (output.points.size ()), int (cloud_source.points.size ()));
+  EXPECT_LT (reg_omp.getFitnessScore (), 0.001);
+  ASSERT_EQ (tgt->size (), reg_omp.getTargetCovariances ().size ());
+  EXPECT_EQ (target_covariances, &reg_omp.getTargetCovariances ()[0]);
+  EXPECT_TRUE (reg_omp.getTargetCovariances ()[0] == first_target_covariance);
+
+  // Without reuse, setting the target drops its covariances
+  reg_omp.setReuseTargetCovariances (false);
+  reg_omp.setInputTarget (tgt);
+  EXPECT_TRUE (reg_omp.getTargetCovariances ().empty ());
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, GeneralizedIterativeClosestPoint6D)
 {
@@ -625,6 +692,52 @@ TEST (PCL, NormalDistributionsTransform)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, NormalDistributionsTransformOMP)
+{
+  typedef PointXYZ PointT;
+  PointCloud<PointT>::Ptr src (new PointCloud<PointT>);
+  copyPointCloud (cloud_source, *src);
+  PointCloud<PointT>::Ptr tgt (new PointCloud<PointT>);
+  copyPointCloud (cloud_target, *tgt);
+  PointCloud<PointT> output;
+
+  NormalDistributionsTransform<PointT, PointT> reg;
+  reg.setStepSize (0.05);
+  reg.setResolution (0.025f);
+  reg.setInputSource (src);
+  reg.setInputTarget (tgt);
+  reg.setMaximumIterations (50);
+  reg.setTransformationEpsilon (1e-8);
+  reg.align (output);
+
+  NormalDistributionsTransformOMP<PointT, PointT> reg_omp (4);
+  reg_omp.setStepSize (0.05);
+  reg_omp.setResolution (0.025f);
+  reg_omp.setInputSource (src);
+  reg_omp.setInputTarget (tgt);
+  reg_omp.setMaximumIterations (50);
+  reg_omp.setTransformationEpsilon (1e-8);
+
+  // The kd-tree neighborhood gives the same result as the serial implementation
+  reg_omp.align (output);
+  EXPECT_EQ (int (output.points.size ()), int (cloud_source.points.size ()));
+  EXPECT_LT (reg_omp.getFitnessScore (), 0.001);
+  EXPECT_TRUE (reg_omp.getFinalTransformation ().isApprox (reg.getFinalTransformation (), 1e-3f));
+
+  // Direct voxel lookups
+  const NormalDistributionsTransformOMP<PointT, PointT>::NeighborSearchMethod methods[] =
+    { NormalDistributionsTransformOMP<PointT, PointT>::DIRECT26,
+      NormalDistributionsTransformOMP<PointT, PointT>::DIRECT7 };
+  for (int m = 0; m < 2; ++m)
+  {
+    reg_omp.setNeighborhoodSearchMethod (methods[m]);
+    reg_omp.align (output);
+    EXPECT_EQ (int (output.points.size ()), int (cloud_source.points.size ()));
+    EXPECT_LT (reg_omp.getFitnessScore (), 0.001);
+  }
+}
+
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, SampleConsensusInitialAlignment)
@@ -106,6 +106,71 @@ TEST (SampleConsensusModelLine, RANSAC)
   EXPECT_XYZ_NEAR (PointXYZ (16.0, 17.0, 18.0), proj_points.points[5], 1e-4);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelLine, CountWithinDistance)
+{
+  // Points spread at various distances around a line, in a number which is not a multiple of the SIMD width
+  PointCloud<PointXYZ> cloud;
+  cloud.points.resize (1001);
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    const float t = 0.01f * static_cast<float> (i);
+    const float offset = 0.0005f * static_cast<float> (i % 200);
+    cloud.points[i].getVector3fMap () << 1.0f + t + offset, 2.0f + t - offset, 3.0f + t;
+  }
+
+  SampleConsensusModelLinePtr model (new SampleConsensusModelLine<PointXYZ> (cloud.makeShared ()));
+
+  Eigen::VectorXf coeff (6);
+  coeff << 1.0f, 2.0f, 3.0f, 1.0f, 1.0f, 1.0f;
+
+  const double thresholds[] = {0.001, 0.01, 0.03, 0.1};
+  for (int t = 0; t < 4; ++t)
+  {
+    std::vector<int> inliers;
+    model->selectWithinDistance (coeff, thresholds[t], inliers);
+    EXPECT_EQ (static_cast<int> (inliers.size ()), model->countWithinDistance (coeff, thresholds[t]));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelLine, CountWithinDistanceBoundary)
+{
+  // The squared threshold rounds down to 0.25f in single precision: points at exactly 0.5 from the line are on
+  // the boundary, and every kernel must classify them the same way
+  const double threshold = 0.5 + 1e-9;
+  ASSERT_LT (static_cast<double> (static_cast<float> (threshold * threshold)), threshold * threshold);
+
+  // Boundary points, inliers and outliers, in a number which is not a multiple of the SIMD width
+  PointCloud<PointXYZ> cloud;
+  cloud.points.resize (27);
+  int nr_inliers = 0;
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    const float sign = (i % 2) ? -1.0f : 1.0f;
+    const float distances[] = {0.5f, 0.25f, 1.0f};
+    cloud.points[i].getVector3fMap () << 0.1f * static_cast<float> (i), 0.0f, sign * distances[i % 3];
+    if (i % 3 == 1)
+      ++nr_inliers;
+  }
+
+  SampleConsensusModelLinePtr model (new SampleConsensusModelLine<PointXYZ> (cloud.makeShared ()));
+
+  Eigen::VectorXf coeff (6);
+  coeff << 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f;
+
+  std::vector<int> inliers;
+  model->selectWithinDistance (coeff, threshold, inliers);
+  EXPECT_EQ (nr_inliers, static_cast<int> (inliers.size ()));
+  EXPECT_EQ (static_cast<int> (inliers.size ()), model->countWithinDistance (coeff, threshold));
+
+  // Ranges starting off the SIMD blocks test the points with other kernels, which must agree
+  for (size_t begin = 1; begin < 8; ++begin)
+    EXPECT_EQ (static_cast<int> (inliers.size ()),
+               model->countWithinDistanceRange (coeff, threshold, 0, begin) +
+               model->countWithinDistanceRange (coeff, threshold, begin, cloud.points.size ()));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (SampleConsensusModelParallelLine, RANSAC)
 {
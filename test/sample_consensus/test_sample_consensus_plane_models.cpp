@@ -43,10 +43,13 @@
 #include <pcl/point_types.h>
 
 #include <pcl/sample_consensus/msac.h>
+#include <pcl/sample_consensus/msac_omp.h>
 #include <pcl/sample_consensus/lmeds.h>
+#include <pcl/sample_consensus/lmeds_omp.h>
 #include <pcl/sample_consensus/rmsac.h>
 #include <pcl/sample_consensus/mlesac.h>
 #include <pcl/sample_consensus/ransac.h>
+#include <pcl/sample_consensus/ransac_omp.h>
 #include <pcl/sample_consensus/rransac.h>
 #include <pcl/sample_consensus/sac_model_plane.h>
 #include <pcl/sample_consensus/sac_model_normal_plane.h>
@@ -133,6 +136,81 @@ TEST (SampleConsensusModelPlane, Base)
   ASSERT_EQ (indices_.size (), indices->size ());
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, CountWithinDistance)
+{
+  // Use a number of indices that is not a multiple of the SIMD width, so the scalar tail is exercised too
+  std::vector<int> indices (indices_.begin (), indices_.begin () + (indices_.size () / 8) * 8 - 3);
+  SampleConsensusModelPlanePtr model (new SampleConsensusModelPlane<PointXYZ> (cloud_, indices));
+
+  Eigen::VectorXf coeff (4);
+  coeff << -0.8964f, -0.5868f, -1.208f, 1.0f;
+  coeff /= coeff.head<3> ().norm ();
+
+  const double thresholds[] = {0.001, 0.01, 0.03, 0.1};
+  for (int t = 0; t < 4; ++t)
+  {
+    std::vector<int> inliers;
+    model->selectWithinDistance (coeff, thresholds[t], inliers);
+    EXPECT_EQ (static_cast<int> (inliers.size ()), model->countWithinDistance (coeff, thresholds[t]));
+
+    // The inliers are selected in the order of the indices, and agree with the distances up to rounding
+    std::vector<double> distances;
+    model->getDistancesToModel (coeff, distances);
+    size_t next = 0;
+    for (size_t i = 0; i < indices.size (); ++i)
+    {
+      if (next < inliers.size () && inliers[next] == indices[i])
+      {
+        EXPECT_LT (distances[i], thresholds[t] + 1e-6);
+        ++next;
+      }
+      else
+        EXPECT_GE (distances[i], thresholds[t] - 1e-6);
+    }
+    EXPECT_EQ (inliers.size (), next);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, CountWithinDistanceBoundary)
+{
+  // The threshold rounds down to 0.25f in single precision: points at exactly 0.25 from the plane are on the
+  // boundary, and every kernel must classify them the same way
+  const double threshold = 0.25 + 1e-9;
+  ASSERT_LT (static_cast<double> (static_cast<float> (threshold)), threshold);
+
+  // Boundary points, inliers and outliers, in a number which is not a multiple of the SIMD width
+  PointCloud<PointXYZ> cloud;
+  cloud.points.resize (27);
+  int nr_inliers = 0;
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    const float sign = (i % 2) ? -1.0f : 1.0f;
+    const float distances[] = {0.25f, 0.125f, 0.5f};
+    cloud.points[i].getVector3fMap () << 0.1f * static_cast<float> (i), -0.2f * static_cast<float> (i),
+                                         sign * distances[i % 3];
+    if (i % 3 == 1)
+      ++nr_inliers;
+  }
+
+  SampleConsensusModelPlanePtr model (new SampleConsensusModelPlane<PointXYZ> (cloud.makeShared ()));
+
+  Eigen::VectorXf coeff (4);
+  coeff << 0.0f, 0.0f, 1.0f, 0.0f;
+
+  std::vector<int> inliers;
+  model->selectWithinDistance (coeff, threshold, inliers);
+  EXPECT_EQ (nr_inliers, static_cast<int> (inliers.size ()));
+  EXPECT_EQ (static_cast<int> (inliers.size ()), model->countWithinDistance (coeff, threshold));
+
+  // Ranges starting off the SIMD blocks test the points with other kernels, which must agree
+  for (size_t begin = 1; begin < 8; ++begin)
+    EXPECT_EQ (static_cast<int> (inliers.size ()),
+               model->countWithinDistanceRange (coeff, threshold, 0, begin) +
+               model->countWithinDistanceRange (coeff, threshold, begin, cloud.points.size ()));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (SampleConsensusModelPlane, RANSAC)
 {
@@ -147,6 +225,39 @@ TEST (SampleConsensusModelPlane, RANSAC)
   verifyPlaneSac (model, sac);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, RANSACSPRT)
+{
+  // Create a shared plane model pointer directly
+  SampleConsensusModelPlanePtr model (new SampleConsensusModelPlane<PointXYZ> (cloud_));
+
+  // Create the RANSAC object, verifying the hypotheses with early termination
+  RandomSampleConsensus<PointXYZ> sac (model, 0.03);
+  sac.setUseSPRT (true);
+  ASSERT_TRUE (sac.getUseSPRT ());
+
+  verifyPlaneSac (model, sac);
+
+  // The partial counts used by the test add up to the full count
+  Eigen::VectorXf coeff;
+  sac.getModelCoefficients (coeff);
+  const size_t half = cloud_->points.size () / 2 + 5;
+  EXPECT_EQ (model->countWithinDistance (coeff, 0.03),
+             model->countWithinDistanceRange (coeff, 0.03, 0, half) +
+             model->countWithinDistanceRange (coeff, 0.03, half, cloud_->points.size ()));
+
+  // A good model is never rejected, a bad one is rejected early
+  size_t nr_tested = 0;
+  const double epsilon = 0.5, delta = 0.05;
+  const double decision_threshold = SampleConsensusModel<PointXYZ>::computeSPRTDecisionThreshold (epsilon, delta);
+  model->countWithinDistanceSPRT (coeff, 0.03, epsilon, delta, decision_threshold, nr_tested);
+  EXPECT_EQ (cloud_->points.size (), nr_tested);
+  Eigen::VectorXf bad_coeff (4);
+  bad_coeff << 0.0f, 0.0f, 1.0f, -100.0f;
+  EXPECT_EQ (0, model->countWithinDistanceSPRT (bad_coeff, 0.03, epsilon, delta, decision_threshold, nr_tested));
+  EXPECT_GT (cloud_->points.size (), nr_tested);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (SampleConsensusModelPlane, LMedS)
 {
@@ -175,6 +286,69 @@ TEST (SampleConsensusModelPlane, MSAC)
   verifyPlaneSac (model, sac);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, RANSACOMP)
+{
+  // Create a shared plane model pointer directly
+  SampleConsensusModelPlanePtr model (new SampleConsensusModelPlane<PointXYZ> (cloud_));
+
+  // Create the parallel RANSAC object
+  RandomSampleConsensusOMP<PointXYZ> sac (model, 0.03);
+
+  verifyPlaneSac (model, sac);
+
+  // The result only depends on the seed, not on the number of threads
+  std::vector<int> sample_1, sample_4, inliers_1, inliers_4;
+  RandomSampleConsensusOMP<PointXYZ> sac_1 (model, 0.03, 1);
+  ASSERT_TRUE (sac_1.computeModel ());
+  sac_1.getModel (sample_1);
+  sac_1.getInliers (inliers_1);
+  RandomSampleConsensusOMP<PointXYZ> sac_4 (model, 0.03, 4);
+  ASSERT_TRUE (sac_4.computeModel ());
+  sac_4.getModel (sample_4);
+  sac_4.getInliers (inliers_4);
+  EXPECT_TRUE (sample_1 == sample_4);
+  ASSERT_EQ (inliers_1.size (), inliers_4.size ());
+  for (size_t i = 0; i < inliers_1.size (); ++i)
+    EXPECT_EQ (inliers_1[i], inliers_4[i]);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, LMedSOMP)
+{
+  // Create a shared plane model pointer directly
+  SampleConsensusModelPlanePtr model (new SampleConsensusModelPlane<PointXYZ> (cloud_));
+
+  // Create the parallel LMedS object
+  LeastMedianSquaresOMP<PointXYZ> sac (model, 0.03);
+
+  verifyPlaneSac (model, sac);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, MSACOMP)
+{
+  // Create a shared plane model pointer directly
+  SampleConsensusModelPlanePtr model (new SampleConsensusModelPlane<PointXYZ> (cloud_));
+
+  // Create the parallel MSAC object
+  MEstimatorSampleConsensusOMP<PointXYZ> sac (model, 0.03);
+
+  verifyPlaneSac (model, sac);
+
+  // The result only depends on the seed, not on the number of threads
+  Eigen::VectorXf coeff_1, coeff_3;
+  MEstimatorSampleConsensusOMP<PointXYZ> sac_1 (model, 0.03, 1);
+  ASSERT_TRUE (sac_1.computeModel ());
+  sac_1.getModelCoefficients (coeff_1);
+  MEstimatorSampleConsensusOMP<PointXYZ> sac_3 (model, 0.03, 3);
+  ASSERT_TRUE (sac_3.computeModel ());
+  sac_3.getModelCoefficients (coeff_3);
+  ASSERT_EQ (coeff_1.size (), coeff_3.size ());
+  for (int i = 0; i < coeff_1.size (); ++i)
+    EXPECT_EQ (coeff_1[i], coeff_3[i]);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (SampleConsensusModelPlane, RRANSAC)
 {
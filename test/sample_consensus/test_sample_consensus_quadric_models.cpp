@@ -107,6 +107,76 @@ TEST (SampleConsensusModelSphere, RANSAC)
   EXPECT_NEAR (2, coeff_refined[2] / coeff_refined[3], 1e-2);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelSphere, CountWithinDistance)
+{
+  // Points spread at various distances around a unit sphere, in a number which is not a multiple of the SIMD width
+  PointCloud<PointXYZ> cloud;
+  cloud.points.resize (1001);
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    const float theta = 0.1f * static_cast<float> (i);
+    const float phi = 0.037f * static_cast<float> (i);
+    const float r = 1.0f + 0.0005f * static_cast<float> (i % 200) - 0.05f;
+    cloud.points[i].x = 2.0f + r * cosf (theta) * sinf (phi);
+    cloud.points[i].y = 2.0f + r * sinf (theta) * sinf (phi);
+    cloud.points[i].z = 2.0f + r * cosf (phi);
+  }
+
+  SampleConsensusModelSpherePtr model (new SampleConsensusModelSphere<PointXYZ> (cloud.makeShared ()));
+
+  Eigen::VectorXf coeff (4);
+  coeff << 2.0f, 2.0f, 2.0f, 1.0f;
+
+  const double thresholds[] = {0.001, 0.01, 0.03, 0.1};
+  for (int t = 0; t < 4; ++t)
+  {
+    std::vector<int> inliers;
+    model->selectWithinDistance (coeff, thresholds[t], inliers);
+    EXPECT_EQ (static_cast<int> (inliers.size ()), model->countWithinDistance (coeff, thresholds[t]));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelSphere, CountWithinDistanceBoundary)
+{
+  // The threshold rounds down to 0.25f in single precision: points at exactly 0.25 from the sphere are on the
+  // boundary, and every kernel must classify them the same way
+  const double threshold = 0.25 + 1e-9;
+  ASSERT_LT (static_cast<double> (static_cast<float> (threshold)), threshold);
+
+  // Boundary points, inliers and outliers on the axes, so that their distances to the center are exact, in a
+  // number which is not a multiple of the SIMD width
+  PointCloud<PointXYZ> cloud;
+  cloud.points.resize (27);
+  int nr_inliers = 0;
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    const float sign = (i % 2) ? -1.0f : 1.0f;
+    const float radii[] = {1.25f, 1.125f, 1.5f};
+    cloud.points[i].getVector3fMap () = Eigen::Vector3f::Zero ();
+    cloud.points[i].data[(i / 3) % 3] = sign * radii[i % 3];
+    if (i % 3 == 1)
+      ++nr_inliers;
+  }
+
+  SampleConsensusModelSpherePtr model (new SampleConsensusModelSphere<PointXYZ> (cloud.makeShared ()));
+
+  Eigen::VectorXf coeff (4);
+  coeff << 0.0f, 0.0f, 0.0f, 1.0f;
+
+  std::vector<int> inliers;
+  model->selectWithinDistance (coeff, threshold, inliers);
+  EXPECT_EQ (nr_inliers, static_cast<int> (inliers.size ()));
+  EXPECT_EQ (static_cast<int> (inliers.size ()), model->countWithinDistance (coeff, threshold));
+
+  // Ranges starting off the SIMD blocks test the points with other kernels, which must agree
+  for (size_t begin = 1; begin < 8; ++begin)
+    EXPECT_EQ (static_cast<int> (inliers.size ()),
+               model->countWithinDistanceRange (coeff, threshold, 0, begin) +
+               model->countWithinDistanceRange (coeff, threshold, begin, cloud.points.size ()));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (SampleConsensusModelNormalSphere, RANSAC)
 {
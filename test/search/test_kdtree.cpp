@@ -39,6 +39,10 @@
 #include <gtest/gtest.h>
 #include <pcl/common/time.h>
 #include <pcl/search/pcl_search.h>
+#include <pcl/search/brute_force.h>
+#include <pcl/search/kdtree_3d.h>
+#include <pcl/search/dynamic_kdtree.h>
+#include <pcl/search/voxel_hash.h>
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
 #include <pcl/common/distances.h>
@@ -195,6 +199,382 @@ TEST (PCL, KdTree_multipointKnnSearch)
   }
 }
 
+/* Test the searches reusing a scratch context against the plain ones */
+TEST (PCL, KdTree_searchContext)
+{
+  pcl::search::Search<PointXYZ>* kdtree = new pcl::search::KdTree<PointXYZ> ();
+  kdtree->setInputCloud (cloud.makeShared ());
+
+  pcl::search::Search<PointXYZ>::SearchContext context;
+  vector<int> k_indices, context_indices;
+  vector<float> k_distances, context_distances;
+  for (size_t i = 0; i < cloud.points.size (); i += 7)
+  {
+    kdtree->nearestKSearch (cloud.points[i], 10, k_indices, k_distances);
+    kdtree->nearestKSearch (cloud, static_cast<int> (i), 10, context_indices, context_distances, context);
+    EXPECT_EQ (k_indices, context_indices);
+    EXPECT_EQ (k_distances, context_distances);
+
+    kdtree->radiusSearch (cloud.points[i], 0.15, k_indices, k_distances);
+    kdtree->radiusSearch (cloud, static_cast<int> (i), 0.15, context_indices, context_distances, context);
+    EXPECT_EQ (k_indices, context_indices);
+    EXPECT_EQ (k_distances, context_distances);
+  }
+  delete kdtree;
+}
+
+/* Test the flat batch searches against the single point searches */
+TEST (PCL, KdTree_batchSearch)
+{
+  unsigned int no_of_neighbors = 10;
+  double radius = 0.15;
+
+  pcl::search::KdTree<PointXYZ> kdtree;
+  kdtree.setInputCloud (cloud.makeShared ());
+  pcl::search::BruteForce<PointXYZ> brute_force;
+  brute_force.setInputCloud (cloud.makeShared ());
+
+  std::vector<int> query_indices;
+  for (size_t i = 0; i < cloud.points.size (); i += 3)
+    query_indices.push_back (static_cast<int> (i));
+
+  for (unsigned int nr_threads = 1; nr_threads <= 4; nr_threads += 3)
+  {
+    kdtree.setNumberOfThreads (nr_threads);
+    brute_force.setNumberOfThreads (nr_threads);
+
+    vector<int> batch_indices, brute_force_indices;
+    vector<float> batch_distances, brute_force_distances;
+    kdtree.batchNearestKSearch (cloud, query_indices, no_of_neighbors, batch_indices, batch_distances);
+    brute_force.batchNearestKSearch (cloud, query_indices, no_of_neighbors, brute_force_indices, brute_force_distances);
+    ASSERT_EQ (query_indices.size () * no_of_neighbors, batch_indices.size ());
+    ASSERT_EQ (query_indices.size () * no_of_neighbors, brute_force_indices.size ());
+
+    vector<size_t> offsets;
+    vector<int> radius_indices;
+    vector<float> radius_distances;
+    kdtree.batchRadiusSearch (cloud, query_indices, radius, offsets, radius_indices, radius_distances);
+    ASSERT_EQ (query_indices.size () + 1, offsets.size ());
+
+    vector<int> k_indices;
+    vector<float> k_distances;
+    for (size_t i = 0; i < query_indices.size (); ++i)
+    {
+      kdtree.nearestKSearch (cloud.points[query_indices[i]], no_of_neighbors, k_indices, k_distances);
+      for (size_t j = 0; j < no_of_neighbors; ++j)
+      {
+        size_t entry = i * no_of_neighbors + j;
+        EXPECT_TRUE (k_indices[j] == batch_indices[entry] || k_distances[j] == batch_distances[entry]);
+        EXPECT_NEAR (k_distances[j], brute_force_distances[entry], 1e-6);
+      }
+
+      kdtree.radiusSearch (cloud.points[query_indices[i]], radius, k_indices, k_distances);
+      ASSERT_EQ (k_indices.size (), offsets[i + 1] - offsets[i]);
+      for (size_t j = 0; j < k_indices.size (); ++j)
+      {
+        EXPECT_EQ (k_indices[j], radius_indices[offsets[i] + j]);
+        EXPECT_EQ (k_distances[j], radius_distances[offsets[i] + j]);
+      }
+    }
+  }
+
+  // Rows of queries with less than k neighbors are padded
+  vector<int> batch_indices;
+  vector<float> batch_distances;
+  kdtree.batchNearestKSearch (cloud, query_indices, static_cast<int> (cloud.points.size ()) + 1, batch_indices, batch_distances);
+  EXPECT_EQ (-1, batch_indices[cloud.points.size ()]);
+  EXPECT_EQ (std::numeric_limits<float>::max (), batch_distances[cloud.points.size ()]);
+}
+
+/* Test the tiled brute force searches against a naive search, on more points than fit in a tile */
+TEST (PCL, BruteForce_tiles)
+{
+  PointCloud<PointXYZ>::Ptr sparse (new PointCloud<PointXYZ> ());
+  srand (11);
+  for (int i = 0; i < 4003; ++i)
+  {
+    sparse->points.push_back (PointXYZ (static_cast<float> (rand ()) / RAND_MAX, static_cast<float> (rand ()) / RAND_MAX,
+                                        static_cast<float> (rand ()) / RAND_MAX));
+    if (i % 300 == 0)
+      sparse->points.push_back (PointXYZ (0.0f, std::numeric_limits<float>::quiet_NaN (), 0.0f));
+  }
+  sparse->width = static_cast<uint32_t> (sparse->points.size ());
+  sparse->height = 1;
+  sparse->is_dense = false;
+
+  pcl::search::BruteForce<PointXYZ> brute_force;
+  brute_force.setInputCloud (sparse);
+
+  std::vector<int> query_indices;
+  for (size_t i = 0; i < sparse->points.size (); i += 7)
+    query_indices.push_back (static_cast<int> (i));
+
+  const int k = 9;
+  const double radius = 0.1;
+  const unsigned int max_nn = 4;
+  for (unsigned int nr_threads = 1; nr_threads <= 3; nr_threads += 2)
+  {
+    brute_force.setNumberOfThreads (nr_threads);
+    vector<int> batch_indices, radius_indices;
+    vector<float> batch_distances, radius_distances;
+    vector<size_t> offsets;
+    brute_force.batchNearestKSearch (*sparse, query_indices, k, batch_indices, batch_distances);
+    brute_force.batchRadiusSearch (*sparse, query_indices, radius, offsets, radius_indices, radius_distances, max_nn);
+    ASSERT_EQ (query_indices.size () * k, batch_indices.size ());
+    ASSERT_EQ (query_indices.size () + 1, offsets.size ());
+
+    vector<int> k_indices;
+    vector<float> k_distances;
+    for (size_t i = 0; i < query_indices.size (); ++i)
+    {
+      const PointXYZ &query = sparse->points[query_indices[i]];
+      if (!pcl_isfinite (query.y))
+      {
+        EXPECT_EQ (-1, batch_indices[i * k]);
+        EXPECT_EQ (0, offsets[i + 1] - offsets[i]);
+        continue;
+      }
+
+      // Naive search, in input order
+      multimap<float, int> sorted_result;
+      vector<int> first_in_radius;
+      for (size_t j = 0; j < sparse->points.size (); ++j)
+      {
+        if (!pcl_isfinite (sparse->points[j].y))
+          continue;
+        const float distance = (sparse->points[j].getVector3fMap () - query.getVector3fMap ()).squaredNorm ();
+        sorted_result.insert (make_pair (distance, static_cast<int> (j)));
+        if (distance <= radius * radius && first_in_radius.size () < max_nn)
+          first_in_radius.push_back (static_cast<int> (j));
+      }
+
+      ASSERT_EQ (k, brute_force.nearestKSearch (query, k, k_indices, k_distances));
+      multimap<float, int>::const_iterator it = sorted_result.begin ();
+      for (int j = 0; j < k; ++j, ++it)
+      {
+        EXPECT_EQ (it->first, k_distances[j]);
+        EXPECT_EQ (k_indices[j], batch_indices[i * k + j]);
+        EXPECT_EQ (k_distances[j], batch_distances[i * k + j]);
+      }
+
+      brute_force.radiusSearch (query, radius, k_indices, k_distances, max_nn);
+      EXPECT_EQ (first_in_radius, k_indices);
+      ASSERT_EQ (k_indices.size (), offsets[i + 1] - offsets[i]);
+      for (size_t j = 0; j < k_indices.size (); ++j)
+        EXPECT_EQ (k_indices[j], radius_indices[offsets[i] + j]);
+    }
+  }
+}
+
+/* Test the native 3D kd-tree against a brute force search */
+TEST (PCL, KdTree3D)
+{
+  // Random points, some duplicated, some invalid
+  PointCloud<PointXYZ>::Ptr sparse (new PointCloud<PointXYZ> ());
+  srand (42);
+  for (int i = 0; i < 3000; ++i)
+  {
+    PointXYZ point (static_cast<float> (rand ()) / RAND_MAX, static_cast<float> (rand ()) / RAND_MAX,
+                    static_cast<float> (rand ()) / RAND_MAX);
+    sparse->points.push_back (point);
+    if (i % 100 == 0)
+      sparse->points.push_back (point);
+    if (i % 250 == 0)
+      sparse->points.push_back (PointXYZ (std::numeric_limits<float>::quiet_NaN (), 0.0f, 0.0f));
+  }
+  sparse->width = static_cast<uint32_t> (sparse->points.size ());
+  sparse->height = 1;
+  sparse->is_dense = false;
+
+  boost::shared_ptr<vector<int> > subset (new vector<int> ());
+  for (size_t i = 0; i < sparse->points.size (); i += 2)
+    subset->push_back (static_cast<int> (i));
+
+  for (int run = 0; run < 2; ++run)
+  {
+    pcl::search::KdTree3D<PointXYZ> kdtree_3d;
+    kdtree_3d.setMaxLeafSize (run == 0 ? 16 : 5);
+    pcl::search::BruteForce<PointXYZ> brute_force (true);
+    if (run == 0)
+    {
+      kdtree_3d.setInputCloud (sparse);
+      brute_force.setInputCloud (sparse);
+    }
+    else
+    {
+      kdtree_3d.setInputCloud (sparse, subset);
+      brute_force.setInputCloud (sparse, subset);
+    }
+
+    vector<int> tree_indices, brute_indices;
+    vector<float> tree_distances, brute_distances;
+    for (size_t i = 0; i < sparse->points.size (); i += 13)
+    {
+      const PointXYZ &query = sparse->points[i];
+      if (!pcl_isfinite (query.x))
+      {
+        EXPECT_EQ (0, kdtree_3d.nearestKSearch (query, 5, tree_indices, tree_distances));
+        continue;
+      }
+
+      const int ks[] = {1, 7, 50};
+      for (int j = 0; j < 3; ++j)
+      {
+        ASSERT_EQ (brute_force.nearestKSearch (query, ks[j], brute_indices, brute_distances),
+                   kdtree_3d.nearestKSearch (query, ks[j], tree_indices, tree_distances));
+        for (size_t n = 0; n < tree_indices.size (); ++n)
+        {
+          EXPECT_FLOAT_EQ (brute_distances[n], tree_distances[n]);
+          EXPECT_NEAR (euclideanDistance (query, sparse->points[tree_indices[n]]), sqrt (tree_distances[n]), 1e-6);
+        }
+      }
+
+      kdtree_3d.radiusSearch (query, 0.08, tree_indices, tree_distances);
+      brute_force.radiusSearch (query, 0.08, brute_indices, brute_distances);
+      ASSERT_EQ (brute_indices.size (), tree_indices.size ());
+      for (size_t n = 0; n < tree_indices.size (); ++n)
+        EXPECT_FLOAT_EQ (brute_distances[n], tree_distances[n]);
+
+      kdtree_3d.radiusSearch (query, 0.08, tree_indices, tree_distances, 3);
+      EXPECT_EQ (std::min<size_t> (3, brute_indices.size ()), tree_indices.size ());
+      for (size_t n = 0; n < tree_indices.size (); ++n)
+        EXPECT_FLOAT_EQ (brute_distances[n], tree_distances[n]);
+    }
+  }
+}
+
+/* Test the dynamic kd-tree through a sequence of insertions and deletions */
+TEST (PCL, DynamicKdTree)
+{
+  srand (7);
+  PointCloud<PointXYZ>::Ptr initial (new PointCloud<PointXYZ> ());
+  for (int i = 0; i < 500; ++i)
+    initial->push_back (PointXYZ (static_cast<float> (rand ()) / RAND_MAX, static_cast<float> (rand ()) / RAND_MAX,
+                                  static_cast<float> (rand ()) / RAND_MAX));
+
+  pcl::search::DynamicKdTree<PointXYZ> dynamic_tree;
+  dynamic_tree.setInputCloud (initial);
+  vector<int> live;
+  for (int i = 0; i < 500; ++i)
+    live.push_back (i);
+
+  vector<int> tree_indices, brute_indices;
+  vector<float> tree_distances, brute_distances;
+  for (int step = 0; step < 40; ++step)
+  {
+    // Insert a scan, of one point every few steps
+    PointCloud<PointXYZ> scan;
+    const int nr_new = step % 5 == 0 ? 1 : 100;
+    for (int i = 0; i < nr_new; ++i)
+      scan.push_back (PointXYZ (static_cast<float> (rand ()) / RAND_MAX, static_cast<float> (rand ()) / RAND_MAX,
+                                static_cast<float> (rand ()) / RAND_MAX));
+    scan.push_back (PointXYZ (std::numeric_limits<float>::quiet_NaN (), 0.0f, 0.0f));
+    vector<int> scan_indices;
+    dynamic_tree.addPoints (scan, scan_indices);
+    EXPECT_EQ (-1, scan_indices.back ());
+    live.insert (live.end (), scan_indices.begin (), scan_indices.end () - 1);
+
+    // Drop the oldest points
+    const size_t nr_dropped = std::min<size_t> (live.size () / 4, 120);
+    vector<int> dropped (live.begin (), live.begin () + nr_dropped);
+    live.erase (live.begin (), live.begin () + nr_dropped);
+    EXPECT_EQ (static_cast<int> (nr_dropped), dynamic_tree.removePoints (dropped));
+    EXPECT_FALSE (dynamic_tree.removePoint (dropped[0]));
+    ASSERT_EQ (live.size (), dynamic_tree.getNumberOfPoints ());
+
+    // Compare with a brute force search over the remaining points
+    pcl::search::BruteForce<PointXYZ> brute_force (true);
+    brute_force.setInputCloud (dynamic_tree.getInputCloud (), boost::shared_ptr<vector<int> > (new vector<int> (live)));
+    for (int q = 0; q < 10; ++q)
+    {
+      PointXYZ query (static_cast<float> (rand ()) / RAND_MAX, static_cast<float> (rand ()) / RAND_MAX,
+                      static_cast<float> (rand ()) / RAND_MAX);
+      ASSERT_EQ (brute_force.nearestKSearch (query, 8, brute_indices, brute_distances),
+                 dynamic_tree.nearestKSearch (query, 8, tree_indices, tree_distances));
+      for (size_t n = 0; n < tree_indices.size (); ++n)
+        EXPECT_FLOAT_EQ (brute_distances[n], tree_distances[n]);
+
+      brute_force.radiusSearch (query, 0.1, brute_indices, brute_distances);
+      dynamic_tree.radiusSearch (query, 0.1, tree_indices, tree_distances);
+      ASSERT_EQ (brute_indices.size (), tree_indices.size ());
+      for (size_t n = 0; n < tree_indices.size (); ++n)
+        EXPECT_FLOAT_EQ (brute_distances[n], tree_distances[n]);
+    }
+  }
+  // The deleted indices are reused, so the internal cloud stays bounded
+  EXPECT_LT (dynamic_tree.getInputCloud ()->points.size (), 3 * live.size ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, VoxelHash)
+{
+  srand (11);
+  PointCloud<PointXYZ>::Ptr points (new PointCloud<PointXYZ> ());
+  for (int i = 0; i < 5000; ++i)
+    points->push_back (PointXYZ (2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f,
+                                 2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f,
+                                 2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f));
+
+  pcl::search::BruteForce<PointXYZ> brute_force (true);
+  brute_force.setInputCloud (points);
+  pcl::search::VoxelHash<PointXYZ> voxel_hash (0.1);
+  voxel_hash.setInputCloud (points);
+  const float exact_distance = static_cast<float> (voxel_hash.getExactDistance ());
+
+  vector<int> hash_indices, brute_indices;
+  vector<float> hash_distances, brute_distances;
+  for (int q = 0; q < 200; ++q)
+  {
+    PointXYZ query (2.4f * static_cast<float> (rand ()) / RAND_MAX - 1.2f,
+                    2.4f * static_cast<float> (rand ()) / RAND_MAX - 1.2f,
+                    2.4f * static_cast<float> (rand ()) / RAND_MAX - 1.2f);
+
+    // The neighbors within the exact distance are always found, the others are at least as far
+    brute_force.nearestKSearch (query, 10, brute_indices, brute_distances);
+    const int nr_found = voxel_hash.nearestKSearch (query, 10, hash_indices, hash_distances);
+    EXPECT_LE (nr_found, 10);
+    for (int n = 0; n < 10; ++n)
+    {
+      if (brute_distances[n] < exact_distance * exact_distance)
+      {
+        ASSERT_LT (n, nr_found);
+        EXPECT_FLOAT_EQ (brute_distances[n], hash_distances[n]);
+      }
+      else if (n < nr_found)
+      {
+        EXPECT_GE (hash_distances[n], brute_distances[n] * (1.0f - 1e-6f));
+      }
+    }
+
+    // The radius search is exact, including for radii larger than the searched voxels
+    const double radius = q % 2 == 0 ? 0.15 : 0.5;
+    brute_force.radiusSearch (query, radius, brute_indices, brute_distances);
+    voxel_hash.radiusSearch (query, radius, hash_indices, hash_distances);
+    ASSERT_EQ (brute_indices.size (), hash_indices.size ());
+    for (size_t n = 0; n < hash_indices.size (); ++n)
+      EXPECT_FLOAT_EQ (brute_distances[n], hash_distances[n]);
+
+    // With max_nn, the closest points in the radius are kept
+    voxel_hash.radiusSearch (query, radius, hash_indices, hash_distances, 5);
+    ASSERT_EQ (std::min<size_t> (brute_indices.size (), 5), hash_indices.size ());
+    for (size_t n = 0; n < hash_indices.size (); ++n)
+      EXPECT_FLOAT_EQ (brute_distances[n], hash_distances[n]);
+  }
+
+  // A radius reaching beyond the largest voxel key, and a query point beyond it
+  PointXYZ query (0.0f, 0.0f, 0.0f);
+  EXPECT_EQ (static_cast<int> (points->size ()), voxel_hash.radiusSearch (query, 1e9, hash_indices, hash_distances));
+  query.x = 1e9f;
+  EXPECT_EQ (0, voxel_hash.nearestKSearch (query, 10, hash_indices, hash_distances));
+
+  // Voxel keys that would not fit in an int are rejected
+  points->push_back (PointXYZ (1e9f, 0.0f, 0.0f));
+  voxel_hash.setInputCloud (points);
+  query.x = 0.0f;
+  EXPECT_EQ (0, voxel_hash.nearestKSearch (query, 10, hash_indices, hash_distances));
+  EXPECT_EQ (0, voxel_hash.radiusSearch (query, 1.0, hash_indices, hash_distances));
+}
+
 int
 main (int argc, char** argv)
 {
@@ -45,6 +45,7 @@
 #include <pcl/search/search.h>
 #include <pcl/features/normal_3d.h>
 
+#include <pcl/segmentation/extract_clusters_omp.h>
 #include <pcl/segmentation/extract_polygonal_prism_data.h>
 #include <pcl/segmentation/segment_differences.h>
 #include <pcl/segmentation/region_growing.h>
@@ -93,6 +94,87 @@ TEST (RegionGrowingTest, Segment)
   EXPECT_NE (0, num_of_segments);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (RegionGrowingTest, SegmentMultithreaded)
+{
+  std::vector <pcl::PointIndices> clusters[2];
+  for (int parallel_growing = 0; parallel_growing < 2; parallel_growing++)
+  {
+    for (unsigned int nr_threads = 1; nr_threads <= 4; nr_threads++)
+    {
+      pcl::RegionGrowing<pcl::PointXYZ, pcl::Normal> rg;
+      rg.setInputCloud (cloud_);
+      rg.setInputNormals (normals_);
+      rg.setNumberOfThreads (nr_threads);
+      rg.setParallelGrowingFlag (parallel_growing == 1);
+
+      std::vector <pcl::PointIndices> segments;
+      rg.extract (segments);
+      EXPECT_NE (0, static_cast<int> (segments.size ()));
+
+      // every point is labeled, since the minimum cluster size is 1
+      size_t number_of_points = 0;
+      for (size_t i_segment = 0; i_segment < segments.size (); i_segment++)
+        number_of_points += segments[i_segment].indices.size ();
+      EXPECT_EQ (cloud_->points.size (), number_of_points);
+
+      // the result does not depend on the number of threads
+      if (nr_threads == 1)
+        clusters[parallel_growing] = segments;
+      else
+      {
+        ASSERT_EQ (clusters[parallel_growing].size (), segments.size ());
+        for (size_t i_segment = 0; i_segment < segments.size (); i_segment++)
+          EXPECT_TRUE (clusters[parallel_growing][i_segment].indices == segments[i_segment].indices);
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (RegionGrowingRGBTest, SegmentParallelGrowing)
+{
+  RegionGrowingRGB<pcl::PointXYZRGB> rg;
+
+  rg.setInputCloud (colored_cloud);
+  rg.setDistanceThreshold (10);
+  rg.setRegionColorThreshold (5);
+  rg.setPointColorThreshold (6);
+  rg.setMinClusterSize (20);
+
+  std::vector <pcl::PointIndices> serial_clusters;
+  rg.extract (serial_clusters);
+  ASSERT_NE (0, static_cast<int> (serial_clusters.size ()));
+
+  RegionGrowingRGB<pcl::PointXYZRGB> rg_parallel;
+  rg_parallel.setInputCloud (colored_cloud);
+  rg_parallel.setDistanceThreshold (10);
+  rg_parallel.setRegionColorThreshold (5);
+  rg_parallel.setPointColorThreshold (6);
+  rg_parallel.setMinClusterSize (20);
+  rg_parallel.setParallelGrowingFlag (true);
+  rg_parallel.setNumberOfThreads (4);
+
+  std::vector <pcl::PointIndices> clusters;
+  rg_parallel.extract (clusters);
+
+  // the parallel growing finds the same clusters as the serial one, possibly in another order
+  ASSERT_EQ (serial_clusters.size (), clusters.size ());
+  std::vector <std::vector <int> > serial_sets (serial_clusters.size ());
+  std::vector <std::vector <int> > sets (clusters.size ());
+  for (size_t i_segment = 0; i_segment < clusters.size (); i_segment++)
+  {
+    serial_sets[i_segment] = serial_clusters[i_segment].indices;
+    std::sort (serial_sets[i_segment].begin (), serial_sets[i_segment].end ());
+    sets[i_segment] = clusters[i_segment].indices;
+    std::sort (sets[i_segment].begin (), sets[i_segment].end ());
+  }
+  std::sort (serial_sets.begin (), serial_sets.end ());
+  std::sort (sets.begin (), sets.end ());
+  for (size_t i_segment = 0; i_segment < sets.size (); i_segment++)
+    EXPECT_TRUE (serial_sets[i_segment] == sets[i_segment]);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (RegionGrowingTest, SegmentWithoutCloud)
 {
@@ -388,6 +470,47 @@ TEST (ExtractPolygonalPrism, Segmentation)
   EXPECT_EQ (static_cast<int> (output.indices.size ()), 0);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (EuclideanClusterExtractionOMP, Segmentation)
+{
+  // Keep every other point, with a few duplicates, so that the cloud breaks into several clusters
+  IndicesPtr indices (new std::vector<int>);
+  for (int i = 0; i < static_cast<int> (cloud_->points.size ()); i += 2)
+    indices->push_back (i);
+  indices->push_back (indices->front ());
+  indices->push_back ((*indices)[indices->size () / 2]);
+
+  EuclideanClusterExtraction<PointXYZ> ec;
+  ec.setInputCloud (cloud_);
+  ec.setIndices (indices);
+  ec.setClusterTolerance (0.006);
+  ec.setMinClusterSize (2);
+  ec.setMaxClusterSize (150);
+  std::vector<PointIndices> clusters;
+  ec.extract (clusters);
+  ASSERT_GT (clusters.size (), 1);
+
+  for (unsigned int nr_threads = 1; nr_threads <= 4; ++nr_threads)
+  {
+    EuclideanClusterExtractionOMP<PointXYZ> ec_omp (nr_threads);
+    ec_omp.setInputCloud (cloud_);
+    ec_omp.setIndices (indices);
+    ec_omp.setClusterTolerance (0.006);
+    ec_omp.setMinClusterSize (2);
+    ec_omp.setMaxClusterSize (150);
+    std::vector<PointIndices> clusters_omp;
+    ec_omp.extract (clusters_omp);
+
+    ASSERT_EQ (clusters.size (), clusters_omp.size ());
+    for (size_t c = 0; c < clusters.size (); ++c)
+    {
+      ASSERT_EQ (clusters[c].indices.size (), clusters_omp[c].indices.size ());
+      for (size_t i = 0; i < clusters[c].indices.size (); ++i)
+        EXPECT_EQ (clusters[c].indices[i], clusters_omp[c].indices[i]);
+    }
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)